@@ -5,15 +5,22 @@
 #include <SDL2/SDL.h>
 #include <SHADERed/EditorEngine.h>
 #include <SHADERed/Objects/CommandLineOptionParser.h>
+#include <SHADERed/Objects/FrameProfiler.h>
+#include <SHADERed/Objects/FunctionVariableManager.h>
+#include <SHADERed/Objects/HeadlessContext.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
 #include <SHADERed/Objects/Export/ExportCPP.h>
+#include <SHADERed/Objects/Export/ExportImage.h>
 #include <glslang/Public/ShaderLang.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <thread>
 #include <string>
 
@@ -41,6 +48,9 @@ extern "C" {
 
 void SetIcon(SDL_Window* wnd);
 void SetDpiAware();
+bool InitHeadless(ed::HeadlessContext& context);
+bool RenderHeadless(ed::CommandLineOptionParser& options);
+bool RunBenchmark(ed::CommandLineOptionParser& options);
 
 int main(int argc, char* argv[])
 {
@@ -145,6 +155,19 @@ int main(int argc, char* argv[])
 	stbi_flip_vertically_on_write(1);
 	stbi_set_flip_vertically_on_load(1);
 
+	// load, compile & render the given projects and report the timings (headless only)
+	if (coptsParser.Benchmark) {
+		bool benchmarked = RunBenchmark(coptsParser);
+		ed::Logger::Get().Save();
+		return benchmarked ? 0 : 1;
+	}
+
+	// render to file without opening a window (falls back to a hidden window if no headless context is available)
+	if (coptsParser.Render && !coptsParser.ConvertCPP && RenderHeadless(coptsParser)) {
+		ed::Logger::Get().Save();
+		return 0;
+	}
+
 	// init sdl2
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) < 0) {
 		ed::Logger::Get().Log("Failed to initialize SDL2", true);
@@ -453,6 +476,242 @@ void SetIcon(SDL_Window* wnd)
 
 	stbi_set_flip_vertically_on_load(1);
 }
+bool InitHeadless(ed::HeadlessContext& context)
+{
+	if (!context.Create(3, 3))
+		return false;
+
+	// init glew
+	glewExperimental = true;
+	GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// GLX build of GLEW complains about the missing X display even though the GL functions were loaded
+	if (glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)
+		glewStatus = GLEW_OK;
+#endif
+	if (glewStatus != GLEW_OK) {
+		ed::Logger::Get().Log("Failed to initialize GLEW with the headless context", true);
+		return false;
+	}
+	ed::Logger::Get().Log("Initialized GLEW (headless)");
+
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_STENCIL_TEST);
+
+	ed::Settings::Instance().Load();
+
+	return true;
+}
+bool RenderHeadless(ed::CommandLineOptionParser& options)
+{
+	ed::HeadlessContext context;
+	if (!InitHeadless(context))
+		return false;
+
+	// no GUIManager -> no ImGui, no plugins
+	ed::InterfaceManager data(nullptr);
+	ed::FunctionVariableManager::Instance().Initialize(&data.Pipeline, &data.Debugger, &data.Renderer);
+	data.Renderer.AllowComputeShaders(GLEW_ARB_compute_shader);
+	data.Renderer.AllowTessellationShaders(GLEW_ARB_tessellation_shader);
+
+	// projects that need a plugin are rendered by the SDL path
+	if (!data.Parser.Open(options.ProjectFile))
+		return false;
+	data.Objects.FinishTextureLoading();
+
+	ed::ExportImageOptions opts;
+	opts.Path = options.RenderPath;
+	opts.Size = glm::ivec2(options.RenderWidth, options.RenderHeight);
+	opts.Supersample = 1;
+	if (options.RenderSupersampling == 2 || options.RenderSupersampling == 4 || options.RenderSupersampling == 8)
+		opts.Supersample = options.RenderSupersampling;
+	opts.CachedTime = options.RenderTime;
+	opts.TimeDelta = 1 / 60.0f;
+	opts.FrameIndex = options.RenderFrameIndex;
+	opts.Sequence = options.RenderSequence;
+	opts.SequenceDuration = options.RenderSequenceDuration;
+	opts.SequenceFPS = options.RenderSequenceFPS;
+
+	printf("Rendering to file...\n");
+	ed::ExportImage::Export(&data.Renderer, opts);
+
+	// GL objects have to be released while the context is still alive
+	data.Pipeline.Clear();
+	data.Objects.Clear();
+
+	ed::Logger::Get().Log("Finished rendering to file (headless)");
+
+	return true;
+}
+bool RunBenchmark(ed::CommandLineOptionParser& options)
+{
+	// find the projects - the examples & templates that ship with SHADERed by default
+	std::vector<std::string> searchPaths = options.BenchmarkPaths;
+	if (searchPaths.empty()) {
+		searchPaths.push_back((std::filesystem::current_path() / "examples").generic_string());
+		searchPaths.push_back((std::filesystem::current_path() / "templates").generic_string());
+	}
+
+	std::error_code fsError;
+	std::vector<std::string> projects;
+	for (const std::string& path : searchPaths) {
+		if (std::filesystem::is_directory(path, fsError)) {
+			std::vector<std::string> found;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(path, fsError))
+				if (entry.is_regular_file() && entry.path().extension() == ".sprj")
+					found.push_back(entry.path().generic_string());
+
+			// directory iteration order isn't specified - keep the results comparable between runs
+			std::sort(found.begin(), found.end());
+			projects.insert(projects.end(), found.begin(), found.end());
+		} else if (std::filesystem::exists(path, fsError))
+			projects.push_back(path);
+		else
+			fprintf(stderr, "Benchmark path \"%s\" doesn't exist\n", path.c_str());
+	}
+
+	if (projects.empty()) {
+		fprintf(stderr, "No projects to benchmark\n");
+		return false;
+	}
+
+	ed::HeadlessContext context;
+	if (!InitHeadless(context)) {
+		fprintf(stderr, "Failed to create a headless OpenGL context - the benchmark requires SHADERed built with EGL support\n");
+		return false;
+	}
+
+	ed::InterfaceManager data(nullptr);
+	ed::FunctionVariableManager::Instance().Initialize(&data.Pipeline, &data.Debugger, &data.Renderer);
+	data.Renderer.AllowComputeShaders(GLEW_ARB_compute_shader);
+	data.Renderer.AllowTessellationShaders(GLEW_ARB_tessellation_shader);
+
+	int width = std::max<int>(1, options.RenderWidth);
+	int height = std::max<int>(1, options.RenderHeight);
+	int frameCount = std::max<int>(1, options.BenchmarkFrames);
+
+	auto now = []() { return std::chrono::high_resolution_clock::now(); };
+	auto elapsed = [](std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end) {
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	};
+
+	std::stringstream json;
+	json.setf(std::ios::fixed);
+	json.precision(3);
+
+	json << "{\n";
+	json << "\t\"renderer\": \"" << ed::FrameProfiler::EscapeJSON((const char*)glGetString(GL_RENDERER)) << "\",\n";
+	json << "\t\"version\": \"" << ed::FrameProfiler::EscapeJSON((const char*)glGetString(GL_VERSION)) << "\",\n";
+	json << "\t\"width\": " << width << ",\n";
+	json << "\t\"height\": " << height << ",\n";
+	json << "\t\"frames\": " << frameCount << ",\n";
+	json << "\t\"projects\": [";
+
+	ed::SystemVariableManager::Instance().SetSavingToFile(true);
+
+	for (int p = 0; p < projects.size(); p++) {
+		const std::string& project = projects[p];
+		ed::Logger::Get().Log("Benchmarking " + project);
+
+		// everything from the previous project has to be gone before the timers start
+		data.Renderer.FlushCache();
+		data.Pipeline.Clear();
+		data.Objects.Clear();
+		glFinish();
+
+		// models are loaded while parsing, textures are loaded on worker threads
+		auto start = now();
+		bool loaded = data.Parser.Open(project);
+		auto parsed = now();
+
+		// no plugins in headless mode - projects that need one (or that can't be parsed) aren't measured
+		json << (p == 0 ? "\n" : ",\n");
+		if (!loaded) {
+			fprintf(stderr, "Skipping \"%s\" - the project couldn't be loaded\n", project.c_str());
+
+			json << "\t\t{\n";
+			json << "\t\t\t\"project\": \"" << ed::FrameProfiler::EscapeJSON(project) << "\",\n";
+			json << "\t\t\t\"status\": \"skipped\"\n";
+			json << "\t\t}";
+			continue;
+		}
+
+		data.Objects.FinishTextureLoading();
+		auto texturesLoaded = now();
+		data.Renderer.Cache();
+		glFinish();
+		auto compiled = now();
+
+		double modelTime = data.Parser.GetModelLoadTime() * 1000.0;
+
+		// first frame also creates the render targets, so it's reported separately
+		std::vector<double> frameTimes;
+		double firstFrameTime = 0.0;
+		for (int i = 0; i <= frameCount; i++) {
+			ed::SystemVariableManager::Instance().CopyState();
+			ed::SystemVariableManager::Instance().SetTimeDelta(1 / 60.0f);
+			ed::SystemVariableManager::Instance().SetFrameIndex(i);
+
+			auto frameStart = now();
+			data.Renderer.Render(width, height);
+			glFinish();
+			double frameTime = elapsed(frameStart, now());
+
+			if (i == 0)
+				firstFrameTime = frameTime;
+			else
+				frameTimes.push_back(frameTime);
+		}
+		std::sort(frameTimes.begin(), frameTimes.end());
+
+		double frameSum = 0.0;
+		for (double t : frameTimes)
+			frameSum += t;
+
+		json << "\t\t{\n";
+		json << "\t\t\t\"project\": \"" << ed::FrameProfiler::EscapeJSON(project) << "\",\n";
+		json << "\t\t\t\"status\": \"ok\",\n";
+		json << "\t\t\t\"items\": " << data.Pipeline.GetList().size() << ",\n";
+		json << "\t\t\t\"compiled\": " << (data.Messages.CanRenderPreview() ? "true" : "false") << ",\n";
+		json << "\t\t\t\"parse_ms\": " << elapsed(start, parsed) - modelTime << ",\n";
+		json << "\t\t\t\"model_ms\": " << modelTime << ",\n";
+		json << "\t\t\t\"texture_ms\": " << elapsed(parsed, texturesLoaded) << ",\n";
+		json << "\t\t\t\"shader_ms\": " << elapsed(texturesLoaded, compiled) << ",\n";
+		json << "\t\t\t\"first_frame_ms\": " << firstFrameTime << ",\n";
+		json << "\t\t\t\"frame_ms\": { ";
+		json << "\"min\": " << frameTimes.front() << ", ";
+		json << "\"avg\": " << frameSum / frameTimes.size() << ", ";
+		json << "\"median\": " << frameTimes[frameTimes.size() / 2] << ", ";
+		json << "\"p99\": " << frameTimes[(frameTimes.size() - 1) * 99 / 100] << ", ";
+		json << "\"max\": " << frameTimes.back() << " }\n";
+		json << "\t\t}";
+	}
+
+	json << "\n\t]\n}\n";
+
+	ed::SystemVariableManager::Instance().SetSavingToFile(false);
+
+	// GL objects have to be released while the context is still alive
+	data.Renderer.FlushCache();
+	data.Pipeline.Clear();
+	data.Objects.Clear();
+
+	if (options.BenchmarkOutput.empty())
+		printf("%s", json.str().c_str());
+	else {
+		std::ofstream out(options.BenchmarkOutput);
+		out << json.str();
+		if (!out.good()) {
+			fprintf(stderr, "Failed to write the benchmark results to \"%s\"\n", options.BenchmarkOutput.c_str());
+			return false;
+		}
+		fprintf(stderr, "Benchmark results saved to \"%s\"\n", options.BenchmarkOutput.c_str());
+	}
+
+	ed::Logger::Get().Log("Finished the benchmark (headless)");
+
+	return true;
+}
 void SetDpiAware()
 {
 #if defined(_WIN32)
@@ -0,0 +1,192 @@
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Engine/Ray.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdint.h>
+
+#define BVH_LEAF_SIZE 4
+#define BVH_MAX_DEPTH 64
+
+namespace ed {
+	namespace eng {
+		bool intersectNode(const glm::vec3& orig, const glm::vec3& invDir, const glm::vec3& minp, const glm::vec3& maxp, float maxDist, float& distHit)
+		{
+			glm::vec3 t0 = (minp - orig) * invDir;
+			glm::vec3 t1 = (maxp - orig) * invDir;
+			glm::vec3 tsmaller = glm::min(t0, t1);
+			glm::vec3 tbigger = glm::max(t0, t1);
+
+			float tmin = std::max(std::max(tsmaller.x, tsmaller.y), std::max(tsmaller.z, 0.0f));
+			float tmax = std::min(std::min(tbigger.x, tbigger.y), std::min(tbigger.z, maxDist));
+
+			distHit = tmin;
+			return tmin <= tmax;
+		}
+
+		BVH::BVH()
+		{
+			m_built = false;
+		}
+		void BVH::Clear()
+		{
+			m_nodes.clear();
+			m_triangles.clear();
+			m_built = false;
+		}
+		void BVH::Build(const void* positions, size_t stride, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+		{
+			Clear();
+			m_built = true;
+
+			const uint8_t* posData = (const uint8_t*)positions;
+			auto getPosition = [&](size_t index) -> glm::vec3 {
+				return *(const glm::vec3*)(posData + index * stride);
+			};
+
+			// gather the triangles
+			size_t triCount = (indices != nullptr ? indexCount : vertexCount) / 3;
+			std::vector<glm::vec3> verts;
+			verts.reserve(triCount * 3);
+			for (size_t t = 0; t < triCount; t++) {
+				bool valid = true;
+				size_t ids[3];
+				for (int v = 0; v < 3; v++) {
+					ids[v] = indices != nullptr ? indices[t * 3 + v] : t * 3 + v;
+					valid &= ids[v] < vertexCount;
+				}
+				if (!valid)
+					continue;
+
+				for (int v = 0; v < 3; v++)
+					verts.push_back(getPosition(ids[v]));
+			}
+			triCount = verts.size() / 3;
+			if (triCount == 0)
+				return;
+
+			std::vector<int> order(triCount);
+			std::vector<glm::vec3> centroids(triCount);
+			for (size_t t = 0; t < triCount; t++) {
+				order[t] = t;
+				centroids[t] = (verts[t * 3 + 0] + verts[t * 3 + 1] + verts[t * 3 + 2]) / 3.0f;
+			}
+
+			// top-down build: split every node at the median of its longest centroid axis
+			m_nodes.reserve(triCount / BVH_LEAF_SIZE * 2 + 1);
+			m_nodes.push_back(Node { glm::vec3(0.0f), glm::vec3(0.0f), 0, (int)triCount });
+
+			struct BuildTask {
+				int Node;
+				int Depth;
+			};
+			std::vector<BuildTask> tasks;
+			tasks.push_back({ 0, 0 });
+			while (!tasks.empty()) {
+				BuildTask task = tasks.back();
+				tasks.pop_back();
+
+				int start = m_nodes[task.Node].Start;
+				int count = m_nodes[task.Node].Count;
+
+				glm::vec3 minb(std::numeric_limits<float>::max()), maxb(-std::numeric_limits<float>::max());
+				glm::vec3 cminb = minb, cmaxb = maxb;
+				for (int i = start; i < start + count; i++) {
+					int t = order[i];
+					for (int v = 0; v < 3; v++) {
+						minb = glm::min(minb, verts[t * 3 + v]);
+						maxb = glm::max(maxb, verts[t * 3 + v]);
+					}
+					cminb = glm::min(cminb, centroids[t]);
+					cmaxb = glm::max(cmaxb, centroids[t]);
+				}
+				m_nodes[task.Node].Min = minb;
+				m_nodes[task.Node].Max = maxb;
+
+				if (count <= BVH_LEAF_SIZE || task.Depth >= BVH_MAX_DEPTH)
+					continue;
+
+				glm::vec3 extent = cmaxb - cminb;
+				int axis = 0;
+				if (extent.y > extent[axis]) axis = 1;
+				if (extent.z > extent[axis]) axis = 2;
+				if (extent[axis] <= 0.0f) // all centroids in one point - can't split
+					continue;
+
+				int mid = start + count / 2;
+				std::nth_element(order.begin() + start, order.begin() + mid, order.begin() + start + count, [&](int a, int b) {
+					return centroids[a][axis] < centroids[b][axis];
+				});
+
+				int left = m_nodes.size();
+				m_nodes.push_back(Node { glm::vec3(0.0f), glm::vec3(0.0f), start, mid - start });
+				m_nodes.push_back(Node { glm::vec3(0.0f), glm::vec3(0.0f), mid, start + count - mid });
+
+				m_nodes[task.Node].Start = left;
+				m_nodes[task.Node].Count = 0;
+
+				tasks.push_back({ left, task.Depth + 1 });
+				tasks.push_back({ left + 1, task.Depth + 1 });
+			}
+
+			// store the triangles in the leaf order
+			m_triangles.resize(triCount * 3);
+			for (size_t i = 0; i < triCount; i++)
+				for (int v = 0; v < 3; v++)
+					m_triangles[i * 3 + v] = verts[order[i] * 3 + v];
+		}
+		bool BVH::Intersect(const glm::vec3& orig, const glm::vec3& dir, float& distHit) const
+		{
+			if (m_nodes.empty())
+				return false;
+
+			glm::vec3 invDir = 1.0f / dir;
+			float closest = std::numeric_limits<float>::infinity();
+
+			float nodeDist = 0.0f;
+			if (!intersectNode(orig, invDir, m_nodes[0].Min, m_nodes[0].Max, closest, nodeDist))
+				return false;
+
+			int stack[BVH_MAX_DEPTH * 2 + 2];
+			int stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while (stackSize > 0) {
+				const Node& node = m_nodes[stack[--stackSize]];
+
+				if (node.Count > 0) {
+					for (int t = node.Start; t < node.Start + node.Count; t++) {
+						float triDist = 0.0f;
+						if (ray::IntersectTriangle(orig, dir, m_triangles[t * 3 + 0], m_triangles[t * 3 + 1], m_triangles[t * 3 + 2], triDist) && triDist < closest)
+							closest = triDist;
+					}
+					continue;
+				}
+
+				// visit the closer child first
+				float distA = 0.0f, distB = 0.0f;
+				bool hitA = intersectNode(orig, invDir, m_nodes[node.Start].Min, m_nodes[node.Start].Max, closest, distA);
+				bool hitB = intersectNode(orig, invDir, m_nodes[node.Start + 1].Min, m_nodes[node.Start + 1].Max, closest, distB);
+
+				if (hitA && hitB) {
+					if (distA < distB) {
+						stack[stackSize++] = node.Start + 1;
+						stack[stackSize++] = node.Start;
+					} else {
+						stack[stackSize++] = node.Start;
+						stack[stackSize++] = node.Start + 1;
+					}
+				} else if (hitA)
+					stack[stackSize++] = node.Start;
+				else if (hitB)
+					stack[stackSize++] = node.Start + 1;
+			}
+
+			if (closest == std::numeric_limits<float>::infinity())
+				return false;
+
+			distHit = closest;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		// bounding volume hierarchy over a triangle list - used to pick meshes with a ray without testing every triangle
+		class BVH {
+		public:
+			BVH();
+
+			// positions are read with the given stride (in bytes), indices can be nullptr (every 3 vertices form a triangle)
+			void Build(const void* positions, size_t stride, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+			void Clear();
+
+			inline bool IsBuilt() const { return m_built; }
+			inline size_t GetTriangleCount() const { return m_triangles.size() / 3; }
+
+			// distance to the closest hit, in the units of dir (same as ray::IntersectTriangle)
+			bool Intersect(const glm::vec3& orig, const glm::vec3& dir, float& distHit) const;
+
+		private:
+			struct Node {
+				glm::vec3 Min, Max;
+				int Start; // first triangle (leaf) or the first of the two child nodes
+				int Count; // 0 for inner nodes
+			};
+
+			bool m_built;
+			std::vector<Node> m_nodes;
+			std::vector<glm::vec3> m_triangles; // 3 vertices per triangle, ordered so that every leaf is one range
+		};
+	}
+}
@@ -188,8 +188,13 @@ namespace ed {
 		}
 
 		void CreateVAO(GLuint& geoVAO, GLuint geoVBO, const std::vector<InputLayoutItem>& ilayout, GLuint geoEBO, GLuint bufVBO, std::vector<ed::ShaderVariable::ValueType> types)
+		{
+			CreateVAO(geoVAO, geoVBO, VertexFormat(), ilayout, geoEBO, bufVBO, types);
+		}
+		void CreateVAO(GLuint& geoVAO, GLuint geoVBO, const VertexFormat& vertexFormat, const std::vector<InputLayoutItem>& ilayout, GLuint geoEBO, GLuint bufVBO, std::vector<ed::ShaderVariable::ValueType> types)
 		{
 			int fmtIndex = 0;
+			GLsizei stride = vertexFormat.GetStride();
 
 			if (geoVAO != 0)
 				glDeleteVertexArrays(1, &geoVAO);
@@ -202,15 +207,34 @@ namespace ed {
 			GLuint layOffset = 0;
 			for (const auto& layitem : ilayout) {
 				GLint size = InputLayoutItem::GetValueSize(layitem.Value);
-				GLint offset = InputLayoutItem::GetValueOffset(layitem.Value) * sizeof(GLfloat);
+				GLint offset = vertexFormat.GetOffset(layitem.Value);
+				GLenum type = GL_FLOAT;
+				GLboolean normalized = GL_FALSE;
 				if (layitem.Value >= InputLayoutValue::BufferFloat && layitem.Value <= InputLayoutValue::BufferInt4)
 					offset = layOffset;
 
-				// vertex positions
-				glVertexAttribPointer(fmtIndex, size, GL_FLOAT, GL_FALSE, 18 * sizeof(float), (void*)offset);
-				glEnableVertexAttribArray(fmtIndex);
+				// compact formats
+				if (vertexFormat.PackedNormals && (layitem.Value == InputLayoutValue::Normal || layitem.Value == InputLayoutValue::Tangent || layitem.Value == InputLayoutValue::Binormal)) {
+					size = 4;
+					type = GL_INT_2_10_10_10_REV;
+					normalized = GL_TRUE;
+				} else if (vertexFormat.HalfTexcoords && layitem.Value == InputLayoutValue::Texcoord)
+					type = GL_HALF_FLOAT;
+				else if (vertexFormat.ByteColors && layitem.Value == InputLayoutValue::Color) {
+					type = GL_UNSIGNED_BYTE;
+					normalized = GL_TRUE;
+				}
+
+				if (layitem.Value == InputLayoutValue::Color && !vertexFormat.Colors) {
+					// not stored in the VBO - the current attribute value is used instead
+					glDisableVertexAttribArray(fmtIndex);
+					glVertexAttrib4f(fmtIndex, 1.0f, 1.0f, 1.0f, 1.0f);
+				} else {
+					glVertexAttribPointer(fmtIndex, size, type, normalized, stride, (void*)offset);
+					glEnableVertexAttribArray(fmtIndex);
+				}
 				fmtIndex++;
-				layOffset += size;
+				layOffset += InputLayoutItem::GetValueSize(layitem.Value);
 			}
 
 			// user defined
@@ -276,40 +300,9 @@ namespace ed {
 				return;
 			}
 
-			std::vector<ShaderVariable::ValueType> tData = objs->ParseBufferFormat(buffer->ViewFormat);
-
-			int stride = 0;
-			for (const auto& dataEl : tData)
-				stride += ShaderVariable::GetSize(dataEl, true);
-
-			GLfloat* bufPtr = (GLfloat*)malloc(buffer->Size);
-
-			glBindBuffer(GL_ARRAY_BUFFER, buffer->ID);
-			glGetBufferSubData(GL_ARRAY_BUFFER, 0, buffer->Size, &bufPtr[0]);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			int rows = buffer->Size / stride;
-
-			if (tData.size() > 0) {
-				minPosItem = glm::vec3(0.0f);
-				maxPosItem = glm::vec3(0.0f);
-
-				int rowStride = stride / 4;
-
-				for (int r = 0; r < rows; r++) {
-					GLfloat* curPtr = bufPtr + r * rowStride;
-
-					int elCount = ShaderVariable::GetSize(tData[0]) / 4;
-					if (elCount >= 4) elCount = 3;
-
-					for (int c = 0; c < elCount; c++) {
-						minPosItem[c] = glm::min(minPosItem[c], curPtr[c]);
-						maxPosItem[c] = glm::max(maxPosItem[c], curPtr[c]);
-					}
-				}
-			}
-
-			free(bufPtr);
+			const ObjectManager::BufferGeometry& geo = objs->GetBufferGeometry(buffer);
+			minPosItem = geo.MinBound;
+			maxPosItem = geo.MaxBound;
 		}
 
 		bool isAllDigits(const std::string& str)
@@ -326,7 +319,8 @@ namespace ed {
 			std::istringstream f(str);
 			std::string line;
 			while (std::getline(f, line)) {
-				if (line.find("ERROR:") != std::string::npos) {
+				bool isWarning = line.find("WARNING:") != std::string::npos;
+				if (line.find("ERROR:") != std::string::npos || isWarning) {
 					size_t firstD = line.find_first_of(':');
 					size_t secondD = line.find_first_of(':', firstD + 1);
 					size_t thirdD = line.find_first_of(':', secondD + 1);
@@ -339,8 +333,9 @@ namespace ed {
 					if (isAllDigits(lineStr))
 						lineNr = std::stoi(lineStr);
 					std::string msg = line.substr(thirdD + 2);
-					ret.push_back(MessageStack::Message(MessageStack::Type::Error, owner, msg, lineNr, stage));
-				} else if (line.size() > 0 && line[0] == '(' && line.find("error") != std::string::npos) {
+					ret.push_back(MessageStack::Message(isWarning ? MessageStack::Type::Warning : MessageStack::Type::Error, owner, msg, lineNr, stage));
+				} else if (line.size() > 0 && line[0] == '(' && (line.find("error") != std::string::npos || line.find("warning") != std::string::npos)) {
+					isWarning = line.find("error") == std::string::npos;
 					size_t firstP = line.find_first_of(')');
 
 					int lineNr = -1;
@@ -350,7 +345,7 @@ namespace ed {
 
 					if (line.size() > firstP + 3) {
 						std::string msg = line.substr(firstP + 3);
-						ret.push_back(MessageStack::Message(MessageStack::Type::Error, owner, msg, lineNr, stage));
+						ret.push_back(MessageStack::Message(isWarning ? MessageStack::Type::Warning : MessageStack::Type::Error, owner, msg, lineNr, stage));
 					}
 				}
 			}
@@ -9,6 +9,9 @@
 #endif
 #include <glm/gtc/constants.hpp>
 
+#include <map>
+#include <tuple>
+
 namespace ed {
 	namespace eng {
 		const int GeometryFactory::VertexCount[] = {
@@ -21,6 +24,60 @@ namespace ed {
 			6,			 /* SCREEQUADNDC */
 		};
 
+		// geometry with the same shape & size shares the vertex buffer
+		enum class SharedShape {
+			Cube,
+			Circle,
+			Plane,
+			Sphere,
+			Triangle,
+			ScreenQuadNDC
+		};
+		struct SharedBufferKey {
+			SharedShape Shape;
+			float X, Y, Z;
+
+			bool operator<(const SharedBufferKey& other) const
+			{
+				return std::tie(Shape, X, Y, Z) < std::tie(other.Shape, other.X, other.Y, other.Z);
+			}
+		};
+		struct SharedBuffer {
+			GLuint VBO;
+			int References;
+		};
+		static std::map<SharedBufferKey, SharedBuffer> sharedBuffers;
+
+		// returns false if the buffer doesn't exist yet
+		static bool acquireSharedBuffer(SharedShape shape, float x, float y, float z, unsigned int& vbo)
+		{
+			auto it = sharedBuffers.find({ shape, x, y, z });
+			if (it == sharedBuffers.end())
+				return false;
+
+			it->second.References++;
+			vbo = it->second.VBO;
+			return true;
+		}
+		static GLuint createSharedBuffer(SharedShape shape, float x, float y, float z, const GLfloat* data, size_t size)
+		{
+			GLuint vbo = 0;
+			glGenBuffers(1, &vbo);
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			sharedBuffers[{ shape, x, y, z }] = { vbo, 1 };
+
+			return vbo;
+		}
+		static GLuint createVAO(GLuint vbo, const std::vector<InputLayoutItem>& inp)
+		{
+			GLuint vao = 0;
+			gl::CreateVAO(vao, vbo, inp);
+			return vao;
+		}
+
 		void generateFace(GLfloat* verts, float radius, float sx, float sy, int x, int y)
 		{
 			float phi = y * sy;
@@ -196,6 +253,9 @@ namespace ed {
 
 		unsigned int GeometryFactory::CreateCube(unsigned int& vbo, float sx, float sy, float sz, const std::vector<InputLayoutItem>& inp)
 		{
+			if (acquireSharedBuffer(SharedShape::Cube, sx, sy, sz, vbo))
+				return createVAO(vbo, inp);
+
 			float halfX = sx / 2.0f;
 			float halfY = sy / 2.0f;
 			float halfZ = sz / 2.0f;
@@ -255,19 +315,15 @@ namespace ed {
 
 			calcBinormalAndTangents(&cubeData[0], 36);
 
-			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 36 * 18 * sizeof(GLfloat), cubeData, GL_STATIC_DRAW | GL_STATIC_READ);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(SharedShape::Cube, sx, sy, sz, cubeData, 36 * 18 * sizeof(GLfloat));
 
-			GLuint vao = 0;
-			gl::CreateVAO(vao, vbo, inp);
-
-			return vao;
+			return createVAO(vbo, inp);
 		}
 		unsigned int GeometryFactory::CreateCircle(unsigned int& vbo, float rx, float ry, const std::vector<InputLayoutItem>& inp)
 		{
+			if (acquireSharedBuffer(SharedShape::Circle, rx, ry, 0.0f, vbo))
+				return createVAO(vbo, inp);
+
 			const int numPoints = 32 * 3;
 			const int numSegs = numPoints / 3;
 
@@ -295,19 +351,15 @@ namespace ed {
 
 			calcBinormalAndTangents(&circleData[0], numPoints);
 
-			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, numPoints * 18 * sizeof(GLfloat), circleData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			GLuint vao = 0;
-			gl::CreateVAO(vao, vbo, inp);
+			vbo = createSharedBuffer(SharedShape::Circle, rx, ry, 0.0f, circleData, numPoints * 18 * sizeof(GLfloat));
 
-			return vao;
+			return createVAO(vbo, inp);
 		}
 		unsigned int GeometryFactory::CreatePlane(unsigned int& vbo, float sx, float sy, const std::vector<InputLayoutItem>& inp)
 		{
+			if (acquireSharedBuffer(SharedShape::Plane, sx, sy, 0.0f, vbo))
+				return createVAO(vbo, inp);
+
 			float halfX = sx / 2;
 			float halfY = sy / 2;
 
@@ -324,19 +376,15 @@ namespace ed {
 
 			calcBinormalAndTangents(&planeData[0], 6);
 
-			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 6 * 18 * sizeof(GLfloat), planeData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			GLuint vao = 0;
-			gl::CreateVAO(vao, vbo, inp);
+			vbo = createSharedBuffer(SharedShape::Plane, sx, sy, 0.0f, planeData, 6 * 18 * sizeof(GLfloat));
 
-			return vao;
+			return createVAO(vbo, inp);
 		}
 		unsigned int GeometryFactory::CreateSphere(unsigned int& vbo, float r, const std::vector<InputLayoutItem>& inp)
 		{
+			if (acquireSharedBuffer(SharedShape::Sphere, r, 0.0f, 0.0f, vbo))
+				return createVAO(vbo, inp);
+
 			const size_t stackCount = 20;
 			const size_t sliceCount = 20;
 
@@ -358,19 +406,15 @@ namespace ed {
 
 			calcBinormalAndTangents(&sphereData[0], count);
 
-			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, count * 18 * sizeof(GLfloat), sphereData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			vbo = createSharedBuffer(SharedShape::Sphere, r, 0.0f, 0.0f, sphereData, count * 18 * sizeof(GLfloat));
 
-			GLuint vao = 0;
-			gl::CreateVAO(vao, vbo, inp);
-
-			return vao;
+			return createVAO(vbo, inp);
 		}
 		unsigned int GeometryFactory::CreateTriangle(unsigned int& vbo, float s, const std::vector<InputLayoutItem>& inp)
 		{
+			if (acquireSharedBuffer(SharedShape::Triangle, s, 0.0f, 0.0f, vbo))
+				return createVAO(vbo, inp);
+
 			float rightOffs = s / tan(glm::radians(30.0f));
 			// clang-format off
 			GLfloat triData[] = {
@@ -382,16 +426,9 @@ namespace ed {
 
 			calcBinormalAndTangents(&triData[0], 3);
 
-			// create vbo
-			glGenBuffers(1, &vbo);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glBufferData(GL_ARRAY_BUFFER, 3 * 18 * sizeof(GLfloat), triData, GL_STATIC_DRAW);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			GLuint vao = 0;
-			gl::CreateVAO(vao, vbo, inp);
+			vbo = createSharedBuffer(SharedShape::Triangle, s, 0.0f, 0.0f, triData, 3 * 18 * sizeof(GLfloat));
 
-			return vao;
+			return createVAO(vbo, inp);
 		}
 		unsigned int GeometryFactory::CreateScreenQuadNDC(unsigned int& vbo, const std::vector<InputLayoutItem>& inp)
 		{
@@ -406,19 +443,16 @@ namespace ed {
 			};
 			// clang-format on
 
+			if (!acquireSharedBuffer(SharedShape::ScreenQuadNDC, 0.0f, 0.0f, 0.0f, vbo))
+				vbo = createSharedBuffer(SharedShape::ScreenQuadNDC, 0.0f, 0.0f, 0.0f, sqData, 6 * 4 * sizeof(GLfloat));
+
 			GLuint vao;
 
 			// create vao
 			glGenVertexArrays(1, &vao);
 			glBindVertexArray(vao);
-
-			// create vbo
-			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-			// vbo data
-			glBufferData(GL_ARRAY_BUFFER, 6 * 4 * sizeof(GLfloat), sqData, GL_STATIC_DRAW);
-
 			// vertex positions
 			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
 			glEnableVertexAttribArray(0);
@@ -432,5 +466,16 @@ namespace ed {
 
 			return vao;
 		}
+		void GeometryFactory::Release(unsigned int vbo)
+		{
+			for (auto it = sharedBuffers.begin(); it != sharedBuffers.end(); it++)
+				if (it->second.VBO == vbo) {
+					if (--it->second.References <= 0) {
+						glDeleteBuffers(1, &vbo);
+						sharedBuffers.erase(it);
+					}
+					return;
+				}
+		}
 	}
 }
\ No newline at end of file
@@ -19,12 +19,15 @@ namespace ed {
 
 			static const int VertexCount[7];
 
+			// these return a new VAO, but the VBO is shared between all geometry with the same shape & size - it
+			// has to be freed with Release() instead of glDeleteBuffers
 			static unsigned int CreateCube(unsigned int& vbo, float sx, float sy, float sz, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateCircle(unsigned int& vbo, float rx, float ry, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreatePlane(unsigned int& vbo, float sx, float sy, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateSphere(unsigned int& vbo, float r, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateTriangle(unsigned int& vbo, float s, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateScreenQuadNDC(unsigned int& vbo, const std::vector<InputLayoutItem>& inp);
+			static void Release(unsigned int vbo);
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,566 @@
+#include <SHADERed/Engine/MeshOptimizer.h>
+#include <SHADERed/Objects/ShaderCache.h>
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define VERTEX_CACHE_OPT_SIZE 32 // LRU cache size used by OptimizeVertexCache()
+#define VERTEX_CACHE_SIM_SIZE 16 // FIFO cache size used to split the triangles into clusters in OptimizeOverdraw()
+
+namespace ed {
+	namespace eng {
+		// Forsyth's vertex score: recently used vertices and vertices with few remaining triangles are preferred
+		static float getVertexScore(int cachePosition, unsigned int remainingTriangles)
+		{
+			if (remainingTriangles == 0)
+				return -1.0f;
+
+			float ret = 0.0f;
+			if (cachePosition >= 0) {
+				// the last triangle's vertices get a fixed score so that the next triangle doesn't just reuse one of them
+				if (cachePosition < 3)
+					ret = 0.75f;
+				else
+					ret = powf(1.0f - (cachePosition - 3) * (1.0f / (VERTEX_CACHE_OPT_SIZE - 3)), 1.5f);
+			}
+
+			return ret + 2.0f * powf((float)remainingTriangles, -0.5f);
+		}
+
+		// FIFO cache simulation used by the overdraw optimizer & the statistics
+		class FIFOCache {
+		public:
+			FIFOCache(size_t vertexCount, int size)
+					: m_timestamps(vertexCount, 0)
+					, m_time(size + 1)
+					, m_size(size)
+			{
+			}
+			inline int Process(unsigned int a, unsigned int b, unsigned int c)
+			{
+				return m_process(a) + m_process(b) + m_process(c);
+			}
+			inline void Reset() { m_time += m_size + 1; }
+
+		private:
+			std::vector<unsigned int> m_timestamps;
+			unsigned int m_time;
+			int m_size;
+
+			inline int m_process(unsigned int v)
+			{
+				// vertex is in the cache if it was added less than m_size misses ago
+				if (m_time - m_timestamps[v] < (unsigned int)m_size)
+					return 0;
+				m_timestamps[v] = ++m_time;
+				return 1;
+			}
+		};
+
+		size_t MeshOptimizer::DeduplicateVertices(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount)
+		{
+			unsigned char* data = (unsigned char*)vertices;
+
+			// open addressing hash table that stores the index of the unique vertex (+1, 0 = empty slot)
+			size_t tableSize = 1;
+			while (tableSize < vertexCount * 2)
+				tableSize *= 2;
+			std::vector<unsigned int> table(tableSize, 0);
+
+			std::vector<unsigned int> remap(vertexCount);
+			size_t uniqueCount = 0;
+
+			for (size_t i = 0; i < vertexCount; i++) {
+				const unsigned char* vertex = data + i * vertexSize;
+				size_t slot = ShaderCache::HashData(vertex, vertexSize) & (tableSize - 1);
+
+				while (table[slot] != 0 && memcmp(data + (table[slot] - 1) * vertexSize, vertex, vertexSize) != 0)
+					slot = (slot + 1) & (tableSize - 1);
+
+				if (table[slot] == 0) {
+					// unique vertices are compacted to the front
+					if (uniqueCount != i)
+						memcpy(data + uniqueCount * vertexSize, vertex, vertexSize);
+					table[slot] = ++uniqueCount;
+				}
+
+				remap[i] = table[slot] - 1;
+			}
+
+			for (size_t i = 0; i < indexCount; i++)
+				indices[i] = remap[indices[i]];
+
+			return uniqueCount;
+		}
+
+		void MeshOptimizer::OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount)
+		{
+			size_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+				return;
+
+			// active triangles of each vertex: adjacency[offsets[v] .. offsets[v] + remaining[v])
+			std::vector<unsigned int> remaining(vertexCount, 0), offsets(vertexCount + 1, 0);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+				remaining[indices[i]]++;
+			for (size_t v = 0; v < vertexCount; v++)
+				offsets[v + 1] = offsets[v] + remaining[v];
+
+			std::vector<unsigned int> adjacency(triangleCount * 3), fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+				adjacency[fill[indices[i]]++] = i / 3;
+
+			std::vector<int> cachePosition(vertexCount, -1);
+			std::vector<float> vertexScore(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+				vertexScore[v] = getVertexScore(-1, remaining[v]);
+
+			std::vector<float> triangleScore(triangleCount);
+			std::vector<bool> emitted(triangleCount, false);
+			for (size_t t = 0; t < triangleCount; t++)
+				triangleScore[t] = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+			std::vector<unsigned int> result;
+			result.reserve(triangleCount * 3);
+
+			unsigned int cache[VERTEX_CACHE_OPT_SIZE + 3], newCache[VERTEX_CACHE_OPT_SIZE + 3];
+			int cacheCount = 0;
+
+			int best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+			size_t cursor = 0;
+
+			while (result.size() < triangleCount * 3) {
+				// nothing in the cache is useful, continue with the next triangle that wasn't emitted yet
+				if (best < 0) {
+					while (emitted[cursor])
+						cursor++;
+					best = cursor;
+				}
+
+				const unsigned int* triangle = indices + best * 3;
+				result.insert(result.end(), triangle, triangle + 3);
+				emitted[best] = true;
+
+				// remove the triangle from the active lists
+				for (int k = 0; k < 3; k++) {
+					unsigned int v = triangle[k];
+					unsigned int* list = adjacency.data() + offsets[v];
+					for (unsigned int i = 0; i < remaining[v]; i++)
+						if (list[i] == (unsigned int)best) {
+							std::swap(list[i], list[remaining[v] - 1]);
+							remaining[v]--;
+							break;
+						}
+				}
+
+				// move the triangle's vertices to the front of the LRU cache
+				int newCount = 0;
+				for (int k = 0; k < 3; k++)
+					if (std::find(newCache, newCache + newCount, triangle[k]) == newCache + newCount)
+						newCache[newCount++] = triangle[k];
+				for (int i = 0; i < cacheCount; i++)
+					if (cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2])
+						newCache[newCount++] = cache[i];
+
+				for (int i = 0; i < newCount; i++)
+					cachePosition[newCache[i]] = i < VERTEX_CACHE_OPT_SIZE ? i : -1;
+
+				// update the scores of the vertices that were (or still are) in the cache
+				for (int i = 0; i < newCount; i++) {
+					unsigned int v = newCache[i];
+					float score = getVertexScore(cachePosition[v], remaining[v]);
+					float diff = score - vertexScore[v];
+					vertexScore[v] = score;
+
+					const unsigned int* list = adjacency.data() + offsets[v];
+					for (unsigned int j = 0; j < remaining[v]; j++)
+						triangleScore[list[j]] += diff;
+				}
+
+				cacheCount = std::min(newCount, VERTEX_CACHE_OPT_SIZE);
+				memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+				// next triangle is one of the triangles that use a vertex from the cache
+				best = -1;
+				float bestScore = 0.0f;
+				for (int i = 0; i < cacheCount; i++) {
+					const unsigned int* list = adjacency.data() + offsets[cache[i]];
+					for (unsigned int j = 0; j < remaining[cache[i]]; j++)
+						if (triangleScore[list[j]] > bestScore) {
+							bestScore = triangleScore[list[j]];
+							best = list[j];
+						}
+				}
+			}
+
+			memcpy(indices, result.data(), result.size() * sizeof(unsigned int));
+		}
+
+		void MeshOptimizer::OptimizeOverdraw(unsigned int* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride, float threshold)
+		{
+			size_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+				return;
+
+			const unsigned char* positionData = (const unsigned char*)positions;
+			auto getPosition = [&](unsigned int v) -> const float* {
+				return (const float*)(positionData + v * positionStride);
+			};
+
+			// hard boundaries: triangles where the cache optimizer had to start over (every vertex is a miss)
+			std::vector<size_t> hardClusters;
+			FIFOCache cache(vertexCount, VERTEX_CACHE_SIM_SIZE);
+			for (size_t t = 0; t < triangleCount; t++)
+				if (cache.Process(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]) == 3 || t == 0)
+					hardClusters.push_back(t);
+			hardClusters.push_back(triangleCount);
+
+			// soft boundaries: split the hard clusters where the ACMR is still close to the cluster's ACMR
+			std::vector<size_t> clusters;
+			for (size_t c = 0; c + 1 < hardClusters.size(); c++) {
+				size_t start = hardClusters[c], end = hardClusters[c + 1];
+
+				cache.Reset();
+				size_t misses = 0;
+				for (size_t t = start; t < end; t++)
+					misses += cache.Process(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+				float clusterThreshold = threshold * misses / (end - start);
+
+				cache.Reset();
+				clusters.push_back(start);
+				size_t clusterStart = start;
+				misses = 0;
+				for (size_t t = start; t < end; t++) {
+					misses += cache.Process(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+
+					if (t + 1 < end && misses <= clusterThreshold * (t + 1 - clusterStart)) {
+						clusters.push_back(t + 1);
+						clusterStart = t + 1;
+						misses = 0;
+						cache.Reset();
+					}
+				}
+			}
+			clusters.push_back(triangleCount);
+
+			// area weighted centroid and normal of every cluster
+			size_t clusterCount = clusters.size() - 1;
+			std::vector<float> centroids(clusterCount * 3, 0.0f), normals(clusterCount * 3, 0.0f);
+			float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+			float meshArea = 0.0f;
+
+			for (size_t c = 0; c < clusterCount; c++) {
+				float* centroid = &centroids[c * 3];
+				float* normal = &normals[c * 3];
+				float clusterArea = 0.0f;
+
+				for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+					const float* p0 = getPosition(indices[t * 3 + 0]);
+					const float* p1 = getPosition(indices[t * 3 + 1]);
+					const float* p2 = getPosition(indices[t * 3 + 2]);
+
+					float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+					float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+					float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+					float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+					for (int k = 0; k < 3; k++) {
+						centroid[k] += (p0[k] + p1[k] + p2[k]) / 3.0f * area;
+						normal[k] += n[k];
+					}
+					clusterArea += area;
+				}
+
+				for (int k = 0; k < 3; k++) {
+					meshCentroid[k] += centroid[k];
+					centroid[k] /= std::max(clusterArea, 1e-20f);
+				}
+				meshArea += clusterArea;
+			}
+			for (int k = 0; k < 3; k++)
+				meshCentroid[k] /= std::max(meshArea, 1e-20f);
+
+			// clusters that face away from the center are usually in front of the others
+			std::vector<float> sortKey(clusterCount);
+			for (size_t c = 0; c < clusterCount; c++) {
+				const float* centroid = &centroids[c * 3];
+				const float* normal = &normals[c * 3];
+				float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				float dot = (centroid[0] - meshCentroid[0]) * normal[0] + (centroid[1] - meshCentroid[1]) * normal[1] + (centroid[2] - meshCentroid[2]) * normal[2];
+				sortKey[c] = length > 0.0f ? dot / length : 0.0f;
+			}
+
+			std::vector<unsigned int> order(clusterCount);
+			for (size_t c = 0; c < clusterCount; c++)
+				order[c] = c;
+			std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+				return sortKey[a] > sortKey[b];
+			});
+
+			std::vector<unsigned int> result;
+			result.reserve(triangleCount * 3);
+			for (unsigned int c : order)
+				result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+
+			memcpy(indices, result.data(), result.size() * sizeof(unsigned int));
+		}
+
+		size_t MeshOptimizer::OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount)
+		{
+			const unsigned int unused = ~0u;
+			std::vector<unsigned int> remap(vertexCount, unused);
+
+			size_t newCount = 0;
+			for (size_t i = 0; i < indexCount; i++) {
+				unsigned int& v = remap[indices[i]];
+				if (v == unused)
+					v = newCount++;
+				indices[i] = v;
+			}
+
+			std::vector<unsigned char> copy((unsigned char*)vertices, (unsigned char*)vertices + vertexCount * vertexSize);
+			for (size_t v = 0; v < vertexCount; v++)
+				if (remap[v] != unused)
+					memcpy((unsigned char*)vertices + remap[v] * vertexSize, copy.data() + v * vertexSize, vertexSize);
+
+			return newCount;
+		}
+
+		// symmetric 4x4 matrix (sum of the squared distances to the planes) + the sum of the weights
+		struct Quadric {
+			double A[10]; // a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+			double Weight;
+		};
+		static void addPlane(Quadric& q, const float* n, float d, float weight)
+		{
+			q.A[0] += weight * n[0] * n[0];
+			q.A[1] += weight * n[0] * n[1];
+			q.A[2] += weight * n[0] * n[2];
+			q.A[3] += weight * n[0] * d;
+			q.A[4] += weight * n[1] * n[1];
+			q.A[5] += weight * n[1] * n[2];
+			q.A[6] += weight * n[1] * d;
+			q.A[7] += weight * n[2] * n[2];
+			q.A[8] += weight * n[2] * d;
+			q.A[9] += weight * d * d;
+			q.Weight += weight;
+		}
+		static void addQuadric(Quadric& q, const Quadric& other)
+		{
+			for (int i = 0; i < 10; i++)
+				q.A[i] += other.A[i];
+			q.Weight += other.Weight;
+		}
+		// average squared distance of p to the planes of a and b
+		static float getCollapseError(const Quadric& a, const Quadric& b, const float* p)
+		{
+			double q[10];
+			for (int i = 0; i < 10; i++)
+				q[i] = a.A[i] + b.A[i];
+			double x = p[0], y = p[1], z = p[2];
+			double ret = q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+				+ q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+				+ q[7] * z * z + 2 * q[8] * z
+				+ q[9];
+			double weight = a.Weight + b.Weight;
+			return weight > 0.0 ? (float)std::max(ret / weight, 0.0) : 0.0f;
+		}
+		static void getNormal(const float* a, const float* b, const float* c, float* out)
+		{
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		}
+
+		size_t MeshOptimizer::Simplify(unsigned int* destination, const unsigned int* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride, size_t targetIndexCount, float targetError, float* resultError)
+		{
+			const unsigned char* positionData = (const unsigned char*)positions;
+			auto getPosition = [&](unsigned int v) -> const float* {
+				return (const float*)(positionData + v * positionStride);
+			};
+
+			std::vector<unsigned int> result(indices, indices + indexCount - indexCount % 3);
+
+			// the error is measured relative to the mesh's extent
+			float minBound[3] = { INFINITY, INFINITY, INFINITY }, maxBound[3] = { -INFINITY, -INFINITY, -INFINITY };
+			for (unsigned int v : result)
+				for (int k = 0; k < 3; k++) {
+					minBound[k] = std::min(minBound[k], getPosition(v)[k]);
+					maxBound[k] = std::max(maxBound[k], getPosition(v)[k]);
+				}
+			float extent = std::max(std::max(maxBound[0] - minBound[0], maxBound[1] - minBound[1]), maxBound[2] - minBound[2]);
+			float errorLimit = (targetError * extent) * (targetError * extent);
+
+			// triangles around each vertex: adjacency[offsets[v] .. offsets[v + 1])
+			std::vector<unsigned int> offsets(vertexCount + 1, 0), adjacency, fill(vertexCount);
+			auto buildAdjacency = [&]() {
+				std::fill(fill.begin(), fill.end(), 0);
+				for (unsigned int v : result)
+					fill[v]++;
+				for (size_t v = 0; v < vertexCount; v++)
+					offsets[v + 1] = offsets[v] + fill[v];
+				adjacency.resize(result.size());
+				for (size_t i = 0; i < result.size(); i++)
+					adjacency[offsets[result[i]] + (--fill[result[i]])] = i / 3;
+			};
+			buildAdjacency();
+
+			// an edge that doesn't have a matching edge in the opposite direction is on a border or an attribute seam
+			std::vector<bool> locked(vertexCount, false);
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (int k = 0; k < 3; k++) {
+					unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+
+					bool hasOpposite = false;
+					for (unsigned int j = offsets[b]; j < offsets[b + 1] && !hasOpposite; j++) {
+						const unsigned int* triangle = &result[adjacency[j] * 3];
+						for (int l = 0; l < 3; l++)
+							hasOpposite |= triangle[l] == b && triangle[(l + 1) % 3] == a;
+					}
+
+					if (!hasOpposite)
+						locked[a] = locked[b] = true;
+				}
+
+			// area weighted planes of the triangles around each vertex
+			std::vector<Quadric> quadrics(vertexCount, Quadric { { 0.0 }, 0.0 });
+			for (size_t i = 0; i < result.size(); i += 3) {
+				float normal[3];
+				getNormal(getPosition(result[i + 0]), getPosition(result[i + 1]), getPosition(result[i + 2]), normal);
+
+				float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				if (length == 0.0f)
+					continue;
+				normal[0] /= length;
+				normal[1] /= length;
+				normal[2] /= length;
+
+				const float* p = getPosition(result[i]);
+				float d = -(normal[0] * p[0] + normal[1] * p[1] + normal[2] * p[2]);
+				for (int k = 0; k < 3; k++)
+					addPlane(quadrics[result[i + k]], normal, d, length * 0.5f);
+			}
+
+			struct Collapse {
+				unsigned int From, To;
+				float Error;
+			};
+			std::vector<Collapse> collapses;
+			std::vector<unsigned int> collapseTarget(vertexCount);
+			std::vector<bool> touched(vertexCount);
+			float maxError = 0.0f;
+
+			// every pass collapses the cheapest edges that don't share any triangles
+			while (result.size() > targetIndexCount) {
+				size_t triangleCount = result.size() / 3;
+
+				// edges between unlocked vertices are shared by two triangles, only add them once
+				collapses.clear();
+				for (size_t i = 0; i < result.size(); i += 3)
+					for (int k = 0; k < 3; k++) {
+						unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+						if (a > b)
+							continue;
+						if (!locked[a])
+							collapses.push_back({ a, b, getCollapseError(quadrics[a], quadrics[b], getPosition(b)) });
+						if (!locked[b])
+							collapses.push_back({ b, a, getCollapseError(quadrics[a], quadrics[b], getPosition(a)) });
+					}
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+					return a.Error < b.Error;
+				});
+
+				for (size_t v = 0; v < vertexCount; v++)
+					collapseTarget[v] = v;
+				std::fill(touched.begin(), touched.end(), false);
+
+				size_t removed = 0, collapsed = 0;
+				for (const Collapse& collapse : collapses) {
+					if (collapse.Error > errorLimit || (triangleCount - removed) * 3 <= targetIndexCount)
+						break;
+					if (touched[collapse.From] || touched[collapse.To])
+						continue;
+
+					// moving From to To's position mustn't flip any of the remaining triangles
+					const float* target = getPosition(collapse.To);
+					bool flips = false;
+					size_t degenerate = 0;
+					for (unsigned int j = offsets[collapse.From]; j < offsets[collapse.From + 1] && !flips; j++) {
+						const unsigned int* triangle = &result[adjacency[j] * 3];
+						if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To) {
+							degenerate++;
+							continue;
+						}
+
+						const float* before[3] = { getPosition(triangle[0]), getPosition(triangle[1]), getPosition(triangle[2]) };
+						const float* after[3] = { before[0], before[1], before[2] };
+						for (int k = 0; k < 3; k++)
+							if (triangle[k] == collapse.From)
+								after[k] = target;
+
+						float n0[3], n1[3];
+						getNormal(before[0], before[1], before[2], n0);
+						getNormal(after[0], after[1], after[2], n1);
+						flips = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0f;
+					}
+					if (flips)
+						continue;
+
+					collapseTarget[collapse.From] = collapse.To;
+					addQuadric(quadrics[collapse.To], quadrics[collapse.From]);
+					maxError = std::max(maxError, collapse.Error);
+
+					// the triangles around From can't be changed by another collapse in this pass
+					for (unsigned int j = offsets[collapse.From]; j < offsets[collapse.From + 1]; j++)
+						for (int k = 0; k < 3; k++)
+							touched[result[adjacency[j] * 3 + k]] = true;
+
+					removed += degenerate;
+					collapsed++;
+				}
+
+				if (collapsed == 0)
+					break;
+
+				// remove the triangles that became degenerate
+				size_t newSize = 0;
+				for (size_t i = 0; i < result.size(); i += 3) {
+					unsigned int a = collapseTarget[result[i + 0]], b = collapseTarget[result[i + 1]], c = collapseTarget[result[i + 2]];
+					if (a == b || b == c || c == a)
+						continue;
+					result[newSize++] = a;
+					result[newSize++] = b;
+					result[newSize++] = c;
+				}
+				result.resize(newSize);
+
+				buildAdjacency();
+			}
+
+			if (resultError)
+				*resultError = extent > 0.0f ? sqrtf(maxError) / extent : 0.0f;
+
+			memcpy(destination, result.data(), result.size() * sizeof(unsigned int));
+			return result.size();
+		}
+
+		VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, int cacheSize)
+		{
+			FIFOCache cache(vertexCount, cacheSize);
+
+			size_t misses = 0;
+			for (size_t i = 0; i + 2 < indexCount; i += 3)
+				misses += cache.Process(indices[i + 0], indices[i + 1], indices[i + 2]);
+
+			VertexCacheStats ret;
+			ret.ACMR = indexCount >= 3 ? (float)misses / (indexCount / 3) : 0.0f;
+			ret.ATVR = vertexCount > 0 ? (float)misses / vertexCount : 0.0f;
+			return ret;
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+
+namespace ed {
+	namespace eng {
+		// post-transform vertex cache statistics of a triangle list (simulated FIFO cache)
+		struct VertexCacheStats {
+			float ACMR; // average cache miss ratio: transformed vertices per triangle (0.5 - 3, lower is better)
+			float ATVR; // average transformed vertex ratio: transformed vertices per vertex (1 is the best)
+		};
+
+		// reorders triangle lists and their vertices so that the GPU has to transform & fetch less data - everything
+		// works on plain CPU arrays, vertices are treated as vertexSize bytes
+		class MeshOptimizer {
+		public:
+			// merge vertices with identical bytes - returns the new vertex count (vertices & indices are updated in place)
+			static size_t DeduplicateVertices(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount);
+
+			// reorder the triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm)
+			static void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+			// reorder clusters of an already cache optimized triangle list so that the outer ones are drawn first - each
+			// cluster's ACMR can get worse by at most threshold (positions = 3 floats, read with the given stride in bytes)
+			static void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+			// reorder the vertices in the order in which they're first used - returns the new vertex count (unused vertices are removed)
+			static size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, unsigned int* indices, size_t indexCount);
+
+			// quadric error edge collapse - writes the simplified triangle list to destination (at least indexCount elements) and
+			// returns its index count, stops at targetIndexCount or when the error would get larger than targetError (relative
+			// to the mesh's extent). Vertices on borders & attribute seams aren't moved and the vertices aren't modified.
+			static size_t Simplify(unsigned int* destination, const unsigned int* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride, size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+			static VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, int cacheSize = 16);
+		};
+	}
+}
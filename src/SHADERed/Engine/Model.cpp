@@ -1,5 +1,8 @@
+#include <SHADERed/Engine/MeshOptimizer.h>
 #include <SHADERed/Engine/Model.h>
+#include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/ModelCache.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -11,56 +14,185 @@
 #include <GL/gl.h>
 #endif
 
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
 #include <iostream>
+#include <string.h>
+
+#define MODEL_LOD_MAX_LEVELS 4
+#define MODEL_LOD_MIN_TRIANGLES 256 // don't simplify meshes that are already cheap to draw
+#define MODEL_LOD_MAX_ERROR 0.1f	// relative to the mesh's extent
 
 namespace ed {
 	namespace eng {
-		Model::Mesh::Mesh(const std::string& name, const std::vector<Model::Mesh::Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Model::Mesh::Texture>& textures)
+		static void optimizeMesh(const std::string& name, std::vector<Model::Mesh::Vertex>& vertices, std::vector<unsigned int>& indices)
+		{
+			VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+			vertices.resize(MeshOptimizer::DeduplicateVertices(vertices.data(), vertices.size(), sizeof(Model::Mesh::Vertex), indices.data(), indices.size()));
+			MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+			MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), &vertices[0].Position, vertices.size(), sizeof(Model::Mesh::Vertex));
+			vertices.resize(MeshOptimizer::OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(Model::Mesh::Vertex), indices.data(), indices.size()));
+
+			VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+			ed::Logger::Get().Log("Optimized mesh \"" + name + "\": ACMR " + std::to_string(before.ACMR) + " -> " + std::to_string(after.ACMR) + ", ATVR " + std::to_string(before.ATVR) + " -> " + std::to_string(after.ATVR));
+		}
+		static void generateLODChain(const std::string& name, const std::vector<Model::Mesh::Vertex>& vertices, const std::vector<unsigned int>& indices, std::vector<unsigned int>& lodIndices, std::vector<Model::Mesh::LOD>& lods)
+		{
+			glm::vec3 minBound = vertices[0].Position, maxBound = vertices[0].Position;
+			for (const auto& vertex : vertices) {
+				minBound = glm::min(minBound, vertex.Position);
+				maxBound = glm::max(maxBound, vertex.Position);
+			}
+			glm::vec3 size = maxBound - minBound;
+			float extent = std::max(std::max(size.x, size.y), size.z);
+
+			// every level halves the triangle count of the previous one
+			std::vector<unsigned int> source = indices;
+			float error = 0.0f;
+			std::string triangleCounts = std::to_string(indices.size() / 3);
+			for (int level = 1; level <= MODEL_LOD_MAX_LEVELS; level++) {
+				size_t targetIndexCount = source.size() / 6 * 3;
+				if (targetIndexCount / 3 < MODEL_LOD_MIN_TRIANGLES)
+					break;
+
+				std::vector<unsigned int> lod(source.size());
+				float levelError = 0.0f;
+				lod.resize(MeshOptimizer::Simplify(lod.data(), source.data(), source.size(), &vertices[0].Position, vertices.size(), sizeof(Model::Mesh::Vertex), targetIndexCount, MODEL_LOD_MAX_ERROR, &levelError));
+
+				// locked borders & seams or the error limit
+				if (lod.size() > source.size() * 9 / 10)
+					break;
+
+				MeshOptimizer::OptimizeVertexCache(lod.data(), lod.size(), vertices.size());
+
+				// each level is simplified from the previous one
+				error += levelError * extent;
+
+				Model::Mesh::LOD info;
+				info.IndexOffset = lodIndices.size();
+				info.IndexCount = lod.size();
+				info.Error = error;
+				lods.push_back(info);
+
+				lodIndices.insert(lodIndices.end(), lod.begin(), lod.end());
+				triangleCounts += ", " + std::to_string(lod.size() / 3);
+				source = std::move(lod);
+			}
+
+			if (!lods.empty())
+				ed::Logger::Get().Log("Generated " + std::to_string(lods.size()) + " LOD levels for mesh \"" + name + "\" (triangles: " + triangleCounts + ")");
+		}
+
+		Model::Mesh::Mesh(const std::string& name, const std::vector<Model::Mesh::Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Model::Mesh::Texture>& textures, bool compact)
 		{
 			Name = name;
 			Vertices = vertices;
 			Indices = indices;
 			Textures = textures;
-			m_setup();
+			m_setup(compact);
 		}
-		void Model::Mesh::m_setup()
+		Model::Mesh::Mesh(const std::string& name, std::vector<Model::Mesh::Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Model::Mesh::Texture>&& textures, bool compact)
 		{
-			glGenVertexArrays(1, &VAO);
+			Name = name;
+			Vertices = std::move(vertices);
+			Indices = std::move(indices);
+			Textures = std::move(textures);
+			m_setup(compact);
+		}
+		void Model::Mesh::m_setup(bool compact)
+		{
+			VAO = 0;
 			glGenBuffers(1, &VBO);
 			glGenBuffers(1, &EBO);
-			glBindVertexArray(VAO);
 
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), &Vertices[0],
-				GL_STATIC_DRAW);
-
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int),
-				&Indices[0], GL_STATIC_DRAW);
-
-			// vertex positions
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)0);
-			glEnableVertexAttribArray(0);
+			if (compact) {
+				Format.HalfTexcoords = true;
+				Format.PackedNormals = true;
+				Format.ByteColors = true;
+
+				// most models don't have vertex colors
+				Format.Colors = std::any_of(Vertices.begin(), Vertices.end(), [](const Vertex& v) {
+					return v.Color != glm::vec4(1.0f);
+				});
+
+				size_t stride = Format.GetStride();
+				std::vector<unsigned char> data(Vertices.size() * stride);
+				for (size_t i = 0; i < Vertices.size(); i++) {
+					const Vertex& vertex = Vertices[i];
+					unsigned char* out = data.data() + i * stride;
+
+					uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.Normal, 0.0f));
+					uint32_t texcoords = glm::packHalf2x16(vertex.TexCoords);
+					uint32_t tangent = glm::packSnorm3x10_1x2(glm::vec4(vertex.Tangent, 0.0f));
+					uint32_t binormal = glm::packSnorm3x10_1x2(glm::vec4(vertex.Binormal, 0.0f));
+
+					memcpy(out + Format.GetOffset(InputLayoutValue::Position), &vertex.Position, sizeof(glm::vec3));
+					memcpy(out + Format.GetOffset(InputLayoutValue::Normal), &normal, sizeof(uint32_t));
+					memcpy(out + Format.GetOffset(InputLayoutValue::Texcoord), &texcoords, sizeof(uint32_t));
+					memcpy(out + Format.GetOffset(InputLayoutValue::Tangent), &tangent, sizeof(uint32_t));
+					memcpy(out + Format.GetOffset(InputLayoutValue::Binormal), &binormal, sizeof(uint32_t));
+					if (Format.Colors) {
+						uint32_t color = glm::packUnorm4x8(vertex.Color);
+						memcpy(out + Format.GetOffset(InputLayoutValue::Color), &color, sizeof(uint32_t));
+					}
+				}
 
-			// vertex normals
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)offsetof(Vertex, Normal));
-			glEnableVertexAttribArray(1);
+				glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+			} else
+				glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), &Vertices[0], GL_STATIC_DRAW);
 
-			// vertex texture coords
-			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)offsetof(Vertex, TexCoords));
-			glEnableVertexAttribArray(2);
+			// the EBO is attached to the VAO in CreateVAO()
+			m_uploadIndices();
 
-			glBindVertexArray(0);
+			// positions, normals and texture coordinates
+			gl::CreateVAO(VAO, VBO, Format, gl::CreateDefaultInputLayout(), EBO);
+		}
+		void Model::Mesh::m_uploadIndices()
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, EBO);
+			glBufferData(GL_ARRAY_BUFFER, (Indices.size() + LODIndices.size()) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, Indices.size() * sizeof(unsigned int), Indices.data());
+			glBufferSubData(GL_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int), LODIndices.size() * sizeof(unsigned int), LODIndices.data());
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		void Model::Mesh::SetLODs(std::vector<unsigned int>&& lodIndices, std::vector<LOD>&& lods)
+		{
+			LODIndices = std::move(lodIndices);
+			LODs = std::move(lods);
+			m_uploadIndices();
+		}
+		int Model::Mesh::GetLOD(float maxError) const
+		{
+			for (int i = LODs.size() - 1; i >= 0; i--)
+				if (LODs[i].Error <= maxError)
+					return i + 1;
+			return 0;
+		}
+		const BVH& Model::Mesh::GetBVH()
+		{
+			if (!m_bvh.IsBuilt() && !Vertices.empty())
+				m_bvh.Build(&Vertices[0].Position, sizeof(Vertex), Vertices.size(), Indices.empty() ? nullptr : Indices.data(), Indices.size());
+			return m_bvh;
 		}
-		void Model::Mesh::Draw(bool instanced, int iCount)
+		void Model::Mesh::Draw(bool instanced, int iCount, int lod)
 		{
+			size_t indexOffset = 0, indexCount = Indices.size();
+			lod = std::min<int>(lod, LODs.size());
+			if (lod > 0) {
+				indexOffset = Indices.size() + LODs[lod - 1].IndexOffset;
+				indexCount = LODs[lod - 1].IndexCount;
+			}
+
 			// draw mesh
 			glBindVertexArray(VAO);
 
 			if (instanced)
-				glDrawElementsInstanced(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, nullptr, iCount);
+				glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)(indexOffset * sizeof(unsigned int)), iCount);
 			else
-				glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
+				glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)(indexOffset * sizeof(unsigned int)));
 		}
 
 		Model::~Model()
@@ -72,17 +204,27 @@ namespace ed {
 			}
 		}
 
-		bool Model::LoadFromFile(const std::string& path, int modelImportFlag)
+		bool Model::LoadFromFile(const std::string& path, int modelImportFlag, bool optimize, bool compactVertices, bool generateLODs)
 		{
 			ed::Logger::Get().Log("Loading a 3D model from file \"" + path + "\"");
 
-			// read file via ASSIMP
-			Assimp::Importer importer;
-
 			int modelImportFlagUsing = modelImportFlag;
 			if (modelImportFlagUsing == 0) //At lease need aiProcess_Triangulate
 				modelImportFlagUsing = aiProcess_Triangulate | aiProcess_FlipUVs;
 
+			Directory = path.substr(0, path.find_last_of("/\\"));
+
+			// skip assimp if the model was already imported with the same options
+			uint64_t cacheKey = ModelCache::GetKey(path, modelImportFlagUsing, optimize, generateLODs);
+			if (ModelCache::Instance().Load(cacheKey, Meshes, compactVertices)) {
+				ed::Logger::Get().Log("Loaded the 3D model from the model cache");
+				m_findBounds();
+				return true;
+			}
+
+			// read file via ASSIMP
+			Assimp::Importer importer;
+
 			const aiScene* scene = importer.ReadFile(path, modelImportFlagUsing);
 
 			// check for errors
@@ -92,8 +234,9 @@ namespace ed {
 				return false;
 			}
 
-			Directory = path.substr(0, path.find_last_of("/\\"));
-			m_processNode(scene->mRootNode, scene);
+			m_processNode(scene->mRootNode, scene, optimize, compactVertices, generateLODs);
+
+			ModelCache::Instance().Save(cacheKey, Meshes);
 
 			m_findBounds();
 
@@ -127,23 +270,30 @@ namespace ed {
 			for (unsigned int i = 0; i < Meshes.size(); i++)
 				Meshes[i].Draw(inst, iCount);
 		}
+		int Model::GetLODCount()
+		{
+			int ret = 1;
+			for (const auto& mesh : Meshes)
+				ret = std::max(ret, mesh.GetLODCount());
+			return ret;
+		}
 		void Model::Draw(const std::string& mesh)
 		{
 			for (unsigned int i = 0; i < Meshes.size(); i++)
 				if (Meshes[i].Name == mesh)
 					Meshes[i].Draw();
 		}
-		void Model::m_processNode(aiNode* node, const aiScene* scene)
+		void Model::m_processNode(aiNode* node, const aiScene* scene, bool optimize, bool compactVertices, bool generateLODs)
 		{
 			for (unsigned int i = 0; i < node->mNumMeshes; i++) {
 				aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-				Meshes.push_back(m_processMesh(mesh, scene));
+				Meshes.push_back(m_processMesh(mesh, scene, optimize, compactVertices, generateLODs));
 			}
 
 			for (unsigned int i = 0; i < node->mNumChildren; i++)
-				m_processNode(node->mChildren[i], scene);
+				m_processNode(node->mChildren[i], scene, optimize, compactVertices, generateLODs);
 		}
-		Model::Mesh Model::m_processMesh(aiMesh* mesh, const aiScene* scene)
+		Model::Mesh Model::m_processMesh(aiMesh* mesh, const aiScene* scene, bool optimize, bool compactVertices, bool generateLODs)
 		{
 			// data to fill
 			std::vector<Model::Mesh::Vertex> vertices(mesh->mNumVertices);
@@ -211,20 +361,52 @@ namespace ed {
 					vertex.Color = glm::vec4(1, 1, 1, 1);
 			}
 
-			// now walk through each of the mesh's faces
+			// now walk through each of the mesh's faces (triangulated in most cases)
+			indices.reserve(mesh->mNumFaces * 3);
 			for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-				aiFace face = mesh->mFaces[i];
+				const aiFace& face = mesh->mFaces[i];
 				for (unsigned int j = 0; j < face.mNumIndices; j++)
 					indices.push_back(face.mIndices[j]);
 			}
 
+			// points & lines aren't affected by the vertex cache and can't be simplified
+			bool isTriangleList = mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE && !vertices.empty() && indices.size() % 3 == 0;
+			if (optimize && isTriangleList)
+				optimizeMesh(mesh->mName.data, vertices, indices);
+
+			std::vector<unsigned int> lodIndices;
+			std::vector<Model::Mesh::LOD> lods;
+			if (generateLODs && isTriangleList) {
+				if (optimize)
+					generateLODChain(mesh->mName.data, vertices, indices, lodIndices, lods);
+				else {
+					// the importer doesn't always weld the vertices - every edge would be a seam. Simplify a welded copy
+					// and point the LODs back to the original vertices so that LOD0 stays the way it was loaded
+					std::vector<Model::Mesh::Vertex> welded = vertices;
+					std::vector<unsigned int> weldedIndices = indices;
+					welded.resize(MeshOptimizer::DeduplicateVertices(welded.data(), welded.size(), sizeof(Model::Mesh::Vertex), weldedIndices.data(), weldedIndices.size()));
+
+					// welded vertices have the same bytes as every vertex that was merged into them
+					std::vector<unsigned int> originalIndex(welded.size(), 0);
+					for (size_t i = 0; i < indices.size(); i++)
+						originalIndex[weldedIndices[i]] = indices[i];
+
+					generateLODChain(mesh->mName.data, welded, weldedIndices, lodIndices, lods);
+					for (unsigned int& index : lodIndices)
+						index = originalIndex[index];
+				}
+			}
+
 			// process materials
 			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
 			// TODO: textures
 
 			// return a mesh object created from the extracted mesh data
-			return Model::Mesh(mesh->mName.data, vertices, indices, textures);
+			Model::Mesh ret(mesh->mName.data, std::move(vertices), std::move(indices), std::move(textures), compactVertices);
+			if (!lods.empty())
+				ret.SetLODs(std::move(lodIndices), std::move(lods));
+			return ret;
 		}
 	}
 }
\ No newline at end of file
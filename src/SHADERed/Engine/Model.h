@@ -2,6 +2,8 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Objects/InputLayout.h>
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
@@ -24,6 +26,11 @@ namespace ed {
 					unsigned int ID;
 					std::string Type;
 				};
+				struct LOD {
+					unsigned int IndexOffset; // in LODIndices
+					unsigned int IndexCount;
+					float Error; // in model space units
+				};
 
 				std::string Name;
 
@@ -31,14 +38,31 @@ namespace ed {
 				std::vector<unsigned int> Indices;
 				std::vector<Texture> Textures;
 
-				Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Texture>& textures);
+				// simplified versions of the mesh (level 1 - N, level 0 is Indices) - stored after Indices in the EBO
+				std::vector<unsigned int> LODIndices;
+				std::vector<LOD> LODs;
+
+				// compact -> half float texcoords, packed normals/tangents/binormals and byte colors in the VBO
+				Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Texture>& textures, bool compact = false);
+				Mesh(const std::string& name, std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<Texture>&& textures, bool compact = false);
+
+				void Draw(bool instanced = false, int iCount = 0, int lod = 0);
 
-				void Draw(bool instanced = false, int iCount = 0);
+				void SetLODs(std::vector<unsigned int>&& lodIndices, std::vector<LOD>&& lods); // uploads the indices
+				inline int GetLODCount() const { return LODs.size() + 1; }
+				int GetLOD(float maxError) const; // the coarsest level with a smaller error
+
+				// built on the first call (mesh data doesn't change after it's loaded)
+				const BVH& GetBVH();
 
 				unsigned int VAO, VBO, EBO;
+				VertexFormat Format; // layout of the data in the VBO, Vertices always stores the full vertex
 
 			private:
-				void m_setup();
+				void m_setup(bool compact);
+				void m_uploadIndices();
+
+				BVH m_bvh;
 			};
 
 			~Model();
@@ -47,10 +71,12 @@ namespace ed {
 			std::string Directory;
 
 			std::vector<std::string> GetMeshNames();
-			bool LoadFromFile(const std::string& path, int modelImportFlag = 0 /*0 will use default flag*/);
+			bool LoadFromFile(const std::string& path, int modelImportFlag = 0 /*0 will use default flag*/, bool optimize = false, bool compactVertices = false, bool generateLODs = false);
 			void Draw(bool instanced = false, int iCount = 0);
 			void Draw(const std::string& mesh);
 
+			int GetLODCount();
+
 			inline glm::vec3 GetMinBound() { return m_minBound; }
 			inline glm::vec3 GetMaxBound() { return m_maxBound; }
 
@@ -58,8 +84,8 @@ namespace ed {
 			void m_findBounds();
 
 			glm::vec3 m_minBound, m_maxBound;
-			void m_processNode(aiNode* node, const aiScene* scene);
-			Model::Mesh m_processMesh(aiMesh* mesh, const aiScene* scene);
+			void m_processNode(aiNode* node, const aiScene* scene, bool optimize, bool compactVertices, bool generateLODs);
+			Model::Mesh m_processMesh(aiMesh* mesh, const aiScene* scene, bool optimize, bool compactVertices, bool generateLODs);
 		};
 	}
 }
\ No newline at end of file
@@ -44,7 +44,7 @@ namespace ed {
 	InterfaceManager::InterfaceManager(GUIManager* gui)
 			: Renderer(&Pipeline, &Objects, &Parser, &Messages, &Plugins, &Debugger)
 			, Pipeline(&Parser, &Plugins)
-			, Objects(&Parser, &Renderer)
+			, Objects(&Parser, &Renderer, &Messages)
 			, Parser(&Pipeline, &Objects, &Renderer, &Plugins, &Messages, &Debugger, gui)
 			, Debugger(&Objects, &Renderer, &Messages)
 			, Analysis(&Debugger, &Renderer, &Pipeline, &Objects, &Messages)
@@ -43,6 +43,10 @@ namespace ed {
 		RenderSequenceFPS = 30;
 		RenderSequenceDuration = 0.5f;
 
+		Benchmark = false;
+		BenchmarkOutput = "";
+		BenchmarkFrames = 100;
+
 		ConvertCPP = false;
 		CMakePath = "";
 	}
@@ -177,6 +181,32 @@ namespace ed {
 				}
 				RenderTime = std::max<float>(0.0f, tm);
 			}
+			// --benchmark, -bench [path]
+			else if (strcmp(argv[i], "--benchmark") == 0 || strcmp(argv[i], "-bench") == 0) {
+				Benchmark = true;
+
+				if (i + 1 < argc && argv[i + 1][0] != '-') {
+					BenchmarkPaths.push_back((cmdDir / argv[i + 1]).generic_string());
+					i++;
+				}
+			}
+			// --benchframes, -bf [count]
+			else if (strcmp(argv[i], "--benchframes") == 0 || strcmp(argv[i], "-bf") == 0) {
+				int frames = 0;
+				if (i + 1 < argc) {
+					frames = atoi(argv[i + 1]);
+					i++;
+				}
+				BenchmarkFrames = std::max<int>(1, frames);
+			}
+			// --benchoutput, -bo [file]
+			else if (strcmp(argv[i], "--benchoutput") == 0 || strcmp(argv[i], "-bo") == 0) {
+				BenchmarkOutput = "";
+				if (i + 1 < argc) {
+					BenchmarkOutput = (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
 			// --compile, -c [file]
 			else if (strcmp(argv[i], "--compile") == 0 || strcmp(argv[i], "-c") == 0) {
 				CompilePath = "";
@@ -316,6 +346,10 @@ namespace ed {
 					{ "--renderseqfps | -rseqfps <index>", "set sequence FPS" },
 					{ "--renderseqduration | -rseqdur <time>", "set sequence duration" },
 
+					{ "--benchmark | -bench [path]", "time loading, compiling & rendering of the projects in the path (examples & templates by default) without a window; -rw/-rh set the resolution" },
+					{ "--benchframes | -bf <count>", "number of frames rendered per project in the benchmark" },
+					{ "--benchoutput | -bo <file>", "save the benchmark results (JSON) to a file instead of printing them" },
+
 					{ "--compile | -c <file>", "compile a shader file" },
 					{ "--language | -cl <language>", "compiler input language" },
 					{ "--stage | -cs <stage>", "compiler input stage; stage can be one of these: vert, geom, tesc, tese, frag, comp" },
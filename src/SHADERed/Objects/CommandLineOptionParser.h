@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <filesystem>
 #include <SHADERed/Objects/ShaderStage.h>
 #include <SHADERed/Objects/ShaderLanguage.h>
@@ -27,6 +28,11 @@ namespace ed {
 		int RenderWidth, RenderHeight, RenderSupersampling, RenderFrameIndex, RenderSequenceFPS;
 		float RenderTime, RenderSequenceDuration;
 
+		bool Benchmark;
+		std::vector<std::string> BenchmarkPaths; // projects or directories with projects
+		std::string BenchmarkOutput;
+		int BenchmarkFrames;
+
 		bool Fullscreen;
 		bool Maximized;
 		bool PerformanceMode;
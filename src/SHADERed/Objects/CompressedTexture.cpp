@@ -0,0 +1,935 @@
+#include <SHADERed/Objects/CompressedTexture.h>
+
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+extern "C" {
+#include <misc/dds.h>
+}
+
+#define DDS_MAGIC 0x20534444 // "DDS "
+#define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+#define DDS_DIMENSION_TEXTURE3D 4
+#define DDS_FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+namespace ed {
+	/* file formats */
+	static GLenum formatFromDXGI(uint32_t dxgi)
+	{
+		switch (dxgi) {
+		case 70: // typeless
+		case 71: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case 72: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+		case 73:
+		case 74: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		case 75: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+		case 76:
+		case 77: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case 78: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+		case 79:
+		case 80: return GL_COMPRESSED_RED_RGTC1;
+		case 81: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+		case 82:
+		case 83: return GL_COMPRESSED_RG_RGTC2;
+		case 84: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+		case 94:
+		case 95: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 96: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 97:
+		case 98: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case 99: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		}
+		return 0;
+	}
+	static GLenum formatFromFourCC(uint32_t fourCC)
+	{
+		if (fourCC == DDS_FOURCC('D', 'X', 'T', '1')) return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		if (fourCC == DDS_FOURCC('D', 'X', 'T', '2') || fourCC == DDS_FOURCC('D', 'X', 'T', '3')) return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		if (fourCC == DDS_FOURCC('D', 'X', 'T', '4') || fourCC == DDS_FOURCC('D', 'X', 'T', '5')) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		if (fourCC == DDS_FOURCC('A', 'T', 'I', '1') || fourCC == DDS_FOURCC('B', 'C', '4', 'U')) return GL_COMPRESSED_RED_RGTC1;
+		if (fourCC == DDS_FOURCC('B', 'C', '4', 'S')) return GL_COMPRESSED_SIGNED_RED_RGTC1;
+		if (fourCC == DDS_FOURCC('A', 'T', 'I', '2') || fourCC == DDS_FOURCC('B', 'C', '5', 'U')) return GL_COMPRESSED_RG_RGTC2;
+		if (fourCC == DDS_FOURCC('B', 'C', '5', 'S')) return GL_COMPRESSED_SIGNED_RG_RGTC2;
+		return 0;
+	}
+	static GLenum formatFromVulkan(uint32_t vkFormat)
+	{
+		switch (vkFormat) {
+		case 131: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case 132: return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+		case 133: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case 134: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+		case 135: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		case 136: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+		case 137: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case 138: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+		case 139: return GL_COMPRESSED_RED_RGTC1;
+		case 140: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+		case 141: return GL_COMPRESSED_RG_RGTC2;
+		case 142: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+		case 143: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 144: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 145: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case 146: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		}
+		return 0;
+	}
+
+	// fill the level list for tightly packed levels - returns the size of the whole mip chain
+	static size_t computeLevels(CompressedImage& img, int levelCount)
+	{
+		int blockSize = CompressedTexture::GetBlockSize(img.Format);
+		size_t offset = 0;
+
+		img.Levels.clear();
+		for (int i = 0; i < levelCount; i++) {
+			CompressedImage::Level level;
+			level.Width = std::max(1, img.Width >> i);
+			level.Height = std::max(1, img.Height >> i);
+			level.Depth = std::max(1, img.Depth >> i);
+			level.Offset = offset;
+			level.Size = (size_t)((level.Width + 3) / 4) * ((level.Height + 3) / 4) * level.Depth * blockSize;
+			offset += level.Size;
+
+			img.Levels.push_back(level);
+
+			if (level.Width == 1 && level.Height == 1 && level.Depth == 1)
+				break;
+		}
+
+		return offset;
+	}
+
+	static bool loadDDS(const std::vector<char>& file, CompressedImage& img, std::string& error)
+	{
+		// magic + header
+		if (file.size() < sizeof(uint32_t) + sizeof(dds_header))
+			return false;
+
+		uint32_t magic;
+		dds_header header;
+		memcpy(&magic, file.data(), sizeof(uint32_t));
+		memcpy(&header, file.data() + sizeof(uint32_t), sizeof(dds_header));
+		if (magic != DDS_MAGIC || header.size != sizeof(dds_header))
+			return false;
+
+		// uncompressed files are still loaded by dds.c
+		if ((header.pixel_format.flags & DDPF_FOURCC) == 0)
+			return false;
+
+		bool isCube = header.caps2 & DDSCAPS2_CUBEMAP;
+		bool isVolume = (header.caps2 & DDSCAPS2_VOLUME) && (header.flags & DDSD_DEPTH);
+
+		size_t dataOffset = sizeof(uint32_t) + sizeof(dds_header);
+		if (header.pixel_format.four_cc == DDS_FOURCC('D', 'X', '1', '0')) {
+			if (file.size() < dataOffset + sizeof(dds_header_dxt10))
+				return false;
+
+			dds_header_dxt10 header10;
+			memcpy(&header10, file.data() + dataOffset, sizeof(dds_header_dxt10));
+			dataOffset += sizeof(dds_header_dxt10);
+
+			img.Format = formatFromDXGI(header10.dxgi_format);
+			if (img.Format != 0 && header10.array_size > 1) {
+				error = "texture arrays aren't supported";
+				return false;
+			}
+			if (header10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE)
+				isCube = true;
+			if (header10.resource_dimension == DDS_DIMENSION_TEXTURE3D && (header.flags & DDSD_DEPTH))
+				isVolume = true;
+		} else
+			img.Format = formatFromFourCC(header.pixel_format.four_cc);
+
+		if (img.Format == 0)
+			return false;
+
+		if (isCube) {
+			error = "cube maps stored in a single file aren't supported";
+			return false;
+		}
+
+		img.Width = std::max<uint32_t>(1, header.width);
+		img.Height = std::max<uint32_t>(1, header.height);
+		img.Depth = isVolume ? std::max<uint32_t>(1, header.depth) : 1;
+
+		size_t size = computeLevels(img, ((header.flags & DDSD_MIPMAPCOUNT) && header.mipmap_count > 0) ? header.mipmap_count : 1);
+		if (dataOffset + size > file.size()) {
+			error = "file is too small";
+			return false;
+		}
+
+		img.Data.assign(file.begin() + dataOffset, file.begin() + dataOffset + size);
+
+		return true;
+	}
+	static bool loadKTX(const std::vector<char>& file, CompressedImage& img, std::string& error)
+	{
+		static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		if (file.size() < 64 || memcmp(file.data(), identifier, 12) != 0)
+			return false;
+
+		// endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat, pixelWidth, pixelHeight,
+		// pixelDepth, numberOfArrayElements, numberOfFaces, numberOfMipmapLevels, bytesOfKeyValueData
+		uint32_t header[13];
+		memcpy(header, file.data() + 12, sizeof(header));
+
+		if (header[0] != 0x04030201) {
+			error = "big endian KTX files aren't supported";
+			return false;
+		}
+
+		img.Format = header[4];
+		if (header[1] != 0 || !CompressedTexture::IsCompressedFormat(img.Format))
+			return false;
+
+		if (header[9] > 1 || header[10] != 1) {
+			error = "texture arrays and cube maps aren't supported";
+			return false;
+		}
+
+		img.Width = std::max<uint32_t>(1, header[6]);
+		img.Height = std::max<uint32_t>(1, header[7]);
+		img.Depth = std::max<uint32_t>(1, header[8]);
+		computeLevels(img, std::max<uint32_t>(1, header[11]));
+
+		// every level is prefixed with its size and padded to 4 bytes
+		size_t ptr = 64 + header[12];
+		std::vector<unsigned char> data;
+		for (CompressedImage::Level& level : img.Levels) {
+			uint32_t imageSize = 0;
+			if (ptr + 4 > file.size())
+				break;
+			memcpy(&imageSize, file.data() + ptr, 4);
+			ptr += 4;
+
+			if (imageSize != level.Size || ptr + imageSize > file.size()) {
+				error = "invalid mip level size";
+				return false;
+			}
+
+			level.Offset = data.size();
+			data.insert(data.end(), file.begin() + ptr, file.begin() + ptr + imageSize);
+			ptr += (imageSize + 3) & ~3;
+		}
+
+		if (data.size() != img.Levels.back().Offset + img.Levels.back().Size) {
+			error = "file is too small";
+			return false;
+		}
+
+		img.Data = std::move(data);
+
+		return true;
+	}
+	static bool loadKTX2(const std::vector<char>& file, CompressedImage& img, std::string& error)
+	{
+		static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		if (file.size() < 80 || memcmp(file.data(), identifier, 12) != 0)
+			return false;
+
+		// vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme
+		uint32_t header[9];
+		memcpy(header, file.data() + 12, sizeof(header));
+
+		img.Format = formatFromVulkan(header[0]);
+		if (img.Format == 0)
+			return false;
+
+		if (header[8] != 0) {
+			error = "supercompressed KTX2 files aren't supported";
+			return false;
+		}
+		if (header[5] > 1 || header[6] != 1) {
+			error = "texture arrays and cube maps aren't supported";
+			return false;
+		}
+
+		img.Width = std::max<uint32_t>(1, header[2]);
+		img.Height = std::max<uint32_t>(1, header[3]);
+		img.Depth = std::max<uint32_t>(1, header[4]);
+		computeLevels(img, std::max<uint32_t>(1, header[7]));
+
+		// level index (byteOffset, byteLength, uncompressedByteLength) starts after the DFD/KVD/SGD index
+		size_t indexOffset = 80;
+		if (indexOffset + img.Levels.size() * 24 > file.size()) {
+			error = "file is too small";
+			return false;
+		}
+
+		std::vector<unsigned char> data;
+		for (int i = 0; i < img.Levels.size(); i++) {
+			uint64_t levelIndex[3];
+			memcpy(levelIndex, file.data() + indexOffset + i * 24, sizeof(levelIndex));
+
+			CompressedImage::Level& level = img.Levels[i];
+			if (levelIndex[1] != level.Size || levelIndex[0] + levelIndex[1] > file.size()) {
+				error = "invalid mip level size";
+				return false;
+			}
+
+			level.Offset = data.size();
+			data.insert(data.end(), file.begin() + levelIndex[0], file.begin() + levelIndex[0] + levelIndex[1]);
+		}
+
+		img.Data = std::move(data);
+
+		return true;
+	}
+
+	/* block decoders */
+	class BlockBits {
+	public:
+		BlockBits(const unsigned char* block)
+				: m_block(block)
+				, m_pos(0)
+		{
+		}
+		inline unsigned int Read(int count)
+		{
+			unsigned int ret = 0;
+			for (int i = 0; i < count; i++, m_pos++)
+				ret |= ((m_block[m_pos >> 3] >> (m_pos & 7)) & 1) << i;
+			return ret;
+		}
+
+	private:
+		const unsigned char* m_block;
+		int m_pos;
+	};
+
+	// BC1 color block - BC2 & BC3 always use the four color mode
+	static void decodeColorBlock(const unsigned char* block, unsigned char* out, bool hasAlpha, bool fourColors)
+	{
+		uint16_t c0 = block[0] | (block[1] << 8);
+		uint16_t c1 = block[2] | (block[3] << 8);
+		uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+
+		unsigned char colors[4][4];
+		for (int i = 0; i < 2; i++) {
+			uint16_t c = i == 0 ? c0 : c1;
+			int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+			colors[i][0] = (r << 3) | (r >> 2);
+			colors[i][1] = (g << 2) | (g >> 4);
+			colors[i][2] = (b << 3) | (b >> 2);
+			colors[i][3] = 255;
+		}
+
+		if (c0 > c1 || fourColors) {
+			for (int c = 0; c < 3; c++) {
+				colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+				colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+			}
+			colors[2][3] = colors[3][3] = 255;
+		} else {
+			for (int c = 0; c < 3; c++) {
+				colors[2][c] = (colors[0][c] + colors[1][c]) / 2;
+				colors[3][c] = 0;
+			}
+			colors[2][3] = 255;
+			colors[3][3] = hasAlpha ? 0 : 255;
+		}
+
+		for (int i = 0; i < 16; i++)
+			memcpy(out + i * 4, colors[(indices >> (i * 2)) & 3], 4);
+	}
+
+	// BC4 block (also used for the BC3 alpha and both BC5 channels)
+	static void decodeSingleChannel(const unsigned char* block, float* out, bool isSigned)
+	{
+		// interpolate in the 8 bit integer domain (rounded to the nearest value)
+		int values[8];
+		int v0 = isSigned ? std::max<int>(-127, (signed char)block[0]) : block[0];
+		int v1 = isSigned ? std::max<int>(-127, (signed char)block[1]) : block[1];
+		values[0] = v0;
+		values[1] = v1;
+		if (v0 > v1) {
+			for (int i = 2; i < 8; i++)
+				values[i] = (int)roundf(((8 - i) * v0 + (i - 1) * v1) / 7.0f);
+		} else {
+			for (int i = 2; i < 6; i++)
+				values[i] = (int)roundf(((6 - i) * v0 + (i - 1) * v1) / 5.0f);
+			values[6] = isSigned ? -127 : 0;
+			values[7] = isSigned ? 127 : 255;
+		}
+
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; i++)
+			indices |= (uint64_t)block[2 + i] << (i * 8);
+
+		for (int i = 0; i < 16; i++)
+			out[i] = isSigned ? values[(indices >> (i * 3)) & 7] / 127.0f : values[(indices >> (i * 3)) & 7];
+	}
+
+	// BC7 & BC6H partitions
+	const unsigned char partitions2[64][16] = {
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1 }, { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1 }, { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 },
+		{ 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 1 }, { 0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0 }, { 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0 },
+		{ 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0 }, { 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1 },
+		{ 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0 }, { 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0 }, { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0 }, { 0, 0, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 0 },
+		{ 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0 }, { 0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 0 }, { 0, 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1 }, { 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1 }, { 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0 }, { 0, 0, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0 },
+		{ 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0 }, { 0, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1 }, { 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 1 },
+		{ 0, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 0 }, { 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0 }, { 0, 0, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 0, 0 }, { 0, 0, 1, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1, 1, 0, 0 },
+		{ 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 }, { 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1 }, { 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1 }, { 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0 },
+		{ 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0 }, { 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0 }, { 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0 },
+		{ 0, 1, 1, 0, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 0, 1, 0, 0, 1 }, { 0, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0 }, { 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0 },
+		{ 0, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 1 }, { 0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1 }, { 0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1 }, { 0, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0 }, { 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1 }
+	};
+	const unsigned char partitions3[64][16] = {
+		{ 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 }, { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+		{ 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 }, { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+		{ 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 }, { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 }, { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+		{ 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 }, { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 }, { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+		{ 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+		{ 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 }, { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+		{ 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 }, { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+		{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 }, { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 }, { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 }, { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+		{ 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 }, { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+		{ 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 }, { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 }, { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 }, { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+		{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 }, { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 }, { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 }, { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+		{ 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 }, { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+		{ 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 }, { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 }, { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+	};
+	// index of the pixel that stores one bit less for its subset (subset 0 always starts with pixel 0)
+	const unsigned char anchors2[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+	};
+	const unsigned char anchors3a[64] = {
+		3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+		3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+		8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+		3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3
+	};
+	const unsigned char anchors3b[64] = {
+		15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+		15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+		15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+		15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8
+	};
+	const int weights2[4] = { 0, 21, 43, 64 };
+	const int weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	const int weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static inline const int* getWeights(int bits)
+	{
+		return bits == 2 ? weights2 : (bits == 3 ? weights3 : weights4);
+	}
+	static inline int getSubset(int subsets, int partition, int pixel)
+	{
+		if (subsets == 2)
+			return partitions2[partition][pixel];
+		if (subsets == 3)
+			return partitions3[partition][pixel];
+		return 0;
+	}
+	static inline bool isAnchor(int subsets, int partition, int pixel)
+	{
+		if (pixel == 0)
+			return true;
+		if (subsets == 2)
+			return pixel == anchors2[partition];
+		if (subsets == 3)
+			return pixel == anchors3a[partition] || pixel == anchors3b[partition];
+		return false;
+	}
+
+	struct BC7Mode {
+		int Subsets, PartitionBits, RotationBits, IndexSelectionBits;
+		int ColorBits, AlphaBits, EndpointPBits, SharedPBits;
+		int IndexBits, SecondaryIndexBits;
+	};
+	const BC7Mode bc7Modes[8] = {
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+	};
+
+	static void decodeBC7(const unsigned char* block, unsigned char* out)
+	{
+		BlockBits bits(block);
+
+		int mode = 0;
+		while (mode < 8 && bits.Read(1) == 0)
+			mode++;
+
+		// reserved mode
+		if (mode == 8) {
+			memset(out, 0, 16 * 4);
+			return;
+		}
+
+		const BC7Mode& m = bc7Modes[mode];
+		int partition = bits.Read(m.PartitionBits);
+		int rotation = bits.Read(m.RotationBits);
+		int indexSelection = bits.Read(m.IndexSelectionBits);
+
+		// [subset * 2 + endpoint][channel]
+		int endpoints[6][4];
+		for (int c = 0; c < 3; c++)
+			for (int e = 0; e < m.Subsets * 2; e++)
+				endpoints[e][c] = bits.Read(m.ColorBits);
+		for (int e = 0; e < m.Subsets * 2; e++)
+			endpoints[e][3] = bits.Read(m.AlphaBits);
+
+		int colorBits = m.ColorBits, alphaBits = m.AlphaBits;
+		if (m.EndpointPBits || m.SharedPBits) {
+			int pbits[6];
+			if (m.EndpointPBits) {
+				for (int e = 0; e < m.Subsets * 2; e++)
+					pbits[e] = bits.Read(1);
+			} else {
+				for (int s = 0; s < m.Subsets; s++)
+					pbits[s * 2] = pbits[s * 2 + 1] = bits.Read(1);
+			}
+
+			for (int e = 0; e < m.Subsets * 2; e++)
+				for (int c = 0; c < 4; c++)
+					endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+			colorBits++;
+			if (alphaBits)
+				alphaBits++;
+		}
+
+		// expand to 8 bits
+		for (int e = 0; e < m.Subsets * 2; e++) {
+			for (int c = 0; c < 3; c++)
+				endpoints[e][c] = ((endpoints[e][c] << (8 - colorBits)) | (endpoints[e][c] >> (2 * colorBits - 8))) & 0xFF;
+			if (alphaBits)
+				endpoints[e][3] = ((endpoints[e][3] << (8 - alphaBits)) | (endpoints[e][3] >> (2 * alphaBits - 8))) & 0xFF;
+			else
+				endpoints[e][3] = 255;
+		}
+
+		int indices[16], secondaryIndices[16];
+		for (int i = 0; i < 16; i++)
+			indices[i] = bits.Read(m.IndexBits - isAnchor(m.Subsets, partition, i));
+		for (int i = 0; i < 16; i++)
+			secondaryIndices[i] = m.SecondaryIndexBits ? bits.Read(m.SecondaryIndexBits - (i == 0)) : indices[i];
+
+		const int* colorWeights = getWeights(m.IndexBits);
+		const int* alphaWeights = getWeights(m.SecondaryIndexBits ? m.SecondaryIndexBits : m.IndexBits);
+		const int* colorIndices = indices;
+		const int* alphaIndices = secondaryIndices;
+		if (indexSelection) {
+			std::swap(colorWeights, alphaWeights);
+			std::swap(colorIndices, alphaIndices);
+		}
+
+		for (int i = 0; i < 16; i++) {
+			int s = getSubset(m.Subsets, partition, i);
+			const int* e0 = endpoints[s * 2];
+			const int* e1 = endpoints[s * 2 + 1];
+			unsigned char* px = out + i * 4;
+
+			for (int c = 0; c < 3; c++)
+				px[c] = ((64 - colorWeights[colorIndices[i]]) * e0[c] + colorWeights[colorIndices[i]] * e1[c] + 32) >> 6;
+			px[3] = ((64 - alphaWeights[alphaIndices[i]]) * e0[3] + alphaWeights[alphaIndices[i]] * e1[3] + 32) >> 6;
+
+			if (rotation)
+				std::swap(px[3], px[rotation - 1]);
+		}
+	}
+
+	// BC6H: which bits of the endpoints are stored where - { endpoint * 3 + channel, first bit, bit count } in the order they are read
+	struct BC6HField {
+		unsigned char Value, Bit, Count;
+	};
+	struct BC6HMode {
+		int Regions;
+		bool Transformed;
+		int EndpointBits;
+		int DeltaBits[3];
+		BC6HField Fields[32];
+	};
+	enum {
+		RW, GW, BW,
+		RX, GX, BX,
+		RY, GY, BY,
+		RZ, GZ, BZ
+	};
+	const BC6HMode bc6hModes[14] = {
+		{ 2, true, 10, { 5, 5, 5 }, { { GY, 4, 1 }, { BY, 4, 1 }, { BZ, 4, 1 }, { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 7, { 6, 6, 6 }, { { GY, 5, 1 }, { GZ, 4, 1 }, { GZ, 5, 1 }, { RW, 0, 7 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 7 }, { BY, 5, 1 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 7 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 2, true, 11, { 5, 4, 4 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { RW, 10, 1 }, { GY, 0, 4 }, { GX, 0, 4 }, { GW, 10, 1 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 11, { 4, 5, 4 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { GW, 10, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 0, 1 }, { BZ, 2, 1 }, { RZ, 0, 4 }, { GY, 4, 1 }, { BZ, 3, 1 } } },
+		{ 2, true, 11, { 4, 4, 5 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { BY, 4, 1 }, { GY, 0, 4 }, { GX, 0, 4 }, { GW, 10, 1 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BW, 10, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 1, 1 }, { BZ, 2, 1 }, { RZ, 0, 4 }, { BZ, 4, 1 }, { BZ, 3, 1 } } },
+		{ 2, true, 9, { 5, 5, 5 }, { { RW, 0, 9 }, { BY, 4, 1 }, { GW, 0, 9 }, { GY, 4, 1 }, { BW, 0, 9 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 8, { 6, 5, 5 }, { { RW, 0, 8 }, { GZ, 4, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 3, 1 }, { BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 2, true, 8, { 5, 6, 5 }, { { RW, 0, 8 }, { BZ, 0, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { GY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { GZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 8, { 5, 5, 6 }, { { RW, 0, 8 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, false, 6, { 6, 6, 6 }, { { RW, 0, 6 }, { GZ, 4, 1 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 6 }, { GY, 5, 1 }, { BY, 5, 1 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 6 }, { GZ, 5, 1 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 1, false, 10, { 10, 10, 10 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 10 }, { GX, 0, 10 }, { BX, 0, 10 } } },
+		{ 1, true, 11, { 9, 9, 9 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 9 }, { RW, 10, 1 }, { GX, 0, 9 }, { GW, 10, 1 }, { BX, 0, 9 }, { BW, 10, 1 } } },
+		{ 1, true, 12, { 8, 8, 8 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 8 }, { RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 8 }, { GW, 11, 1 }, { GW, 10, 1 }, { BX, 0, 8 }, { BW, 11, 1 }, { BW, 10, 1 } } },
+		{ 1, true, 16, { 4, 4, 4 }, { { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 15, 1 }, { RW, 14, 1 }, { RW, 13, 1 }, { RW, 12, 1 }, { RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 4 }, { GW, 15, 1 }, { GW, 14, 1 }, { GW, 13, 1 }, { GW, 12, 1 }, { GW, 11, 1 }, { GW, 10, 1 }, { BX, 0, 4 }, { BW, 15, 1 }, { BW, 14, 1 }, { BW, 13, 1 }, { BW, 12, 1 }, { BW, 11, 1 }, { BW, 10, 1 } } }
+	};
+
+	static inline int signExtend(int value, int bits)
+	{
+		int shift = 32 - bits;
+		return (int)((unsigned int)value << shift) >> shift;
+	}
+	static int unquantizeBC6H(int value, int bits, bool isSigned)
+	{
+		if (!isSigned) {
+			if (bits >= 15)
+				return value;
+			if (value == 0)
+				return 0;
+			if (value == (1 << bits) - 1)
+				return 0xFFFF;
+			return ((value << 16) + 0x8000) >> bits;
+		}
+
+		if (bits >= 16)
+			return value;
+
+		bool negative = value < 0;
+		if (negative)
+			value = -value;
+
+		int ret = 0;
+		if (value == 0)
+			ret = 0;
+		else if (value >= (1 << (bits - 1)) - 1)
+			ret = 0x7FFF;
+		else
+			ret = ((value << 15) + 0x4000) >> (bits - 1);
+
+		return negative ? -ret : ret;
+	}
+	static float halfToFloat(uint16_t half)
+	{
+		uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+		uint32_t exponent = (half >> 10) & 0x1F;
+		uint32_t mantissa = half & 0x3FF;
+
+		uint32_t bits = 0;
+		if (exponent == 0) {
+			if (mantissa != 0) { // denormal
+				exponent = 127 - 15 + 1;
+				while ((mantissa & 0x400) == 0) {
+					mantissa <<= 1;
+					exponent--;
+				}
+				bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+			} else
+				bits = sign;
+		} else if (exponent == 31)
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		else
+			bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+		float ret;
+		memcpy(&ret, &bits, sizeof(float));
+		return ret;
+	}
+
+	static void decodeBC6H(const unsigned char* block, float* out, bool isSigned)
+	{
+		BlockBits bits(block);
+
+		int modeBits = bits.Read(2);
+		if (modeBits > 1)
+			modeBits |= bits.Read(3) << 2;
+
+		int mode = -1;
+		switch (modeBits) {
+		case 0x00: mode = 0; break;
+		case 0x01: mode = 1; break;
+		case 0x02: mode = 2; break;
+		case 0x06: mode = 3; break;
+		case 0x0A: mode = 4; break;
+		case 0x0E: mode = 5; break;
+		case 0x12: mode = 6; break;
+		case 0x16: mode = 7; break;
+		case 0x1A: mode = 8; break;
+		case 0x1E: mode = 9; break;
+		case 0x03: mode = 10; break;
+		case 0x07: mode = 11; break;
+		case 0x0B: mode = 12; break;
+		case 0x0F: mode = 13; break;
+		}
+
+		// reserved mode
+		if (mode == -1) {
+			for (int i = 0; i < 16; i++) {
+				out[i * 4 + 0] = out[i * 4 + 1] = out[i * 4 + 2] = 0.0f;
+				out[i * 4 + 3] = 1.0f;
+			}
+			return;
+		}
+
+		const BC6HMode& m = bc6hModes[mode];
+
+		// [endpoint][channel]
+		int endpoints[4][3] = { { 0 } };
+		for (int f = 0; f < 32 && m.Fields[f].Count != 0; f++) {
+			const BC6HField& field = m.Fields[f];
+			endpoints[field.Value / 3][field.Value % 3] |= bits.Read(field.Count) << field.Bit;
+		}
+
+		int partition = m.Regions == 2 ? bits.Read(5) : 0;
+		int endpointCount = m.Regions * 2;
+
+		for (int c = 0; c < 3; c++) {
+			if (isSigned)
+				endpoints[0][c] = signExtend(endpoints[0][c], m.EndpointBits);
+
+			for (int e = 1; e < endpointCount; e++) {
+				if (m.Transformed) {
+					// stored as the difference from the first endpoint
+					int delta = signExtend(endpoints[e][c], m.DeltaBits[c]);
+					endpoints[e][c] = (endpoints[0][c] + delta) & ((1 << m.EndpointBits) - 1);
+				}
+				if (isSigned)
+					endpoints[e][c] = signExtend(endpoints[e][c], m.EndpointBits);
+			}
+
+			for (int e = 0; e < endpointCount; e++)
+				endpoints[e][c] = unquantizeBC6H(endpoints[e][c], m.EndpointBits, isSigned);
+		}
+
+		int indexBits = m.Regions == 2 ? 3 : 4;
+		const int* weights = getWeights(indexBits);
+
+		for (int i = 0; i < 16; i++) {
+			int index = bits.Read(indexBits - isAnchor(m.Regions, partition, i));
+			int s = getSubset(m.Regions, partition, i);
+
+			for (int c = 0; c < 3; c++) {
+				int value = ((64 - weights[index]) * endpoints[s * 2][c] + weights[index] * endpoints[s * 2 + 1][c] + 32) >> 6;
+
+				uint16_t half = 0;
+				if (isSigned)
+					half = value < 0 ? (0x8000 | ((-value * 31) >> 5)) : ((value * 31) >> 5);
+				else
+					half = (value * 31) >> 6;
+
+				out[i * 4 + c] = halfToFloat(half);
+			}
+			out[i * 4 + 3] = 1.0f;
+		}
+	}
+
+	bool CompressedTexture::Load(const std::string& path, CompressedImage& img, std::string& error)
+	{
+		error = "";
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		size_t size = file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		// every container has at least 64 bytes of headers
+		std::vector<char> data(std::min<size_t>(size, 64));
+		if (!file.read(data.data(), data.size()))
+			return false;
+
+		bool isDDS = data.size() >= 4 && memcmp(data.data(), "DDS ", 4) == 0;
+		bool isKTX = data.size() >= 12 && memcmp(data.data() + 1, "KTX ", 4) == 0;
+		if (!isDDS && !isKTX)
+			return false;
+
+		data.resize(size);
+		if (size > 64 && !file.read(data.data() + 64, size - 64))
+			return false;
+
+		bool ret = false;
+		if (isDDS)
+			ret = loadDDS(data, img, error);
+		else if (data[5] == '1')
+			ret = loadKTX(data, img, error);
+		else
+			ret = loadKTX2(data, img, error);
+
+		// the KTX loaders accept any compressed format
+		if (ret && GetBlockSize(img.Format) == 0) {
+			error = "unsupported compressed format";
+			ret = false;
+		}
+
+		return ret;
+	}
+
+	bool CompressedTexture::IsCompressedFormat(GLenum format)
+	{
+		return GetBlockSize(format) != 0;
+	}
+	bool CompressedTexture::IsSupported(GLenum format, GLenum target)
+	{
+		switch (format) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			return target == GL_TEXTURE_2D && GLEW_EXT_texture_compression_s3tc;
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+			return target == GL_TEXTURE_2D && GLEW_EXT_texture_compression_s3tc && (GLEW_EXT_texture_sRGB || GLEW_VERSION_2_1);
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+			return target == GL_TEXTURE_2D && (GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc);
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc; // BPTC also works with 3D textures
+		}
+		return false;
+	}
+	int CompressedTexture::GetBlockSize(GLenum format)
+	{
+		switch (format) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+			return 8;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			return 16;
+		}
+		return 0;
+	}
+	bool CompressedTexture::IsDecodedFloat(GLenum format)
+	{
+		return format == GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT || format == GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT || format == GL_COMPRESSED_SIGNED_RED_RGTC1 || format == GL_COMPRESSED_SIGNED_RG_RGTC2;
+	}
+	GLenum CompressedTexture::GetDecodedFormat(GLenum format)
+	{
+		switch (format) {
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+			return GL_SRGB8_ALPHA8;
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			return GL_RGBA16F;
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+			return GL_RGBA32F;
+		}
+		return GL_RGBA8;
+	}
+
+	void CompressedTexture::Decode(const CompressedImage& img, int levelIndex, void* pixels)
+	{
+		const CompressedImage::Level& level = img.Levels[levelIndex];
+		const unsigned char* block = img.Data.data() + level.Offset;
+		int blockSize = GetBlockSize(img.Format);
+		int blocksX = (level.Width + 3) / 4, blocksY = (level.Height + 3) / 4;
+		bool isFloat = IsDecodedFloat(img.Format);
+
+		unsigned char decoded[16 * 4];
+		float decodedFloat[16 * 4];
+		float channel[16];
+
+		for (int z = 0; z < level.Depth; z++)
+			for (int by = 0; by < blocksY; by++)
+				for (int bx = 0; bx < blocksX; bx++, block += blockSize) {
+					switch (img.Format) {
+					case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+						decodeColorBlock(block, decoded, false, false);
+						break;
+					case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+						decodeColorBlock(block, decoded, true, false);
+						break;
+					case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+						decodeColorBlock(block + 8, decoded, false, true);
+						for (int i = 0; i < 16; i++)
+							decoded[i * 4 + 3] = ((block[i / 2] >> ((i % 2) * 4)) & 0xF) * 17;
+						break;
+					case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+						decodeColorBlock(block + 8, decoded, false, true);
+						decodeSingleChannel(block, channel, false);
+						for (int i = 0; i < 16; i++)
+							decoded[i * 4 + 3] = (unsigned char)channel[i];
+						break;
+					case GL_COMPRESSED_RED_RGTC1:
+					case GL_COMPRESSED_RG_RGTC2:
+						memset(decoded, 0, sizeof(decoded));
+						for (int c = 0; c < (img.Format == GL_COMPRESSED_RG_RGTC2 ? 2 : 1); c++) {
+							decodeSingleChannel(block + c * 8, channel, false);
+							for (int i = 0; i < 16; i++)
+								decoded[i * 4 + c] = (unsigned char)channel[i];
+						}
+						for (int i = 0; i < 16; i++)
+							decoded[i * 4 + 3] = 255;
+						break;
+					case GL_COMPRESSED_SIGNED_RED_RGTC1:
+					case GL_COMPRESSED_SIGNED_RG_RGTC2:
+						memset(decodedFloat, 0, sizeof(decodedFloat));
+						for (int c = 0; c < (img.Format == GL_COMPRESSED_SIGNED_RG_RGTC2 ? 2 : 1); c++) {
+							decodeSingleChannel(block + c * 8, channel, true);
+							for (int i = 0; i < 16; i++)
+								decodedFloat[i * 4 + c] = channel[i];
+						}
+						for (int i = 0; i < 16; i++)
+							decodedFloat[i * 4 + 3] = 1.0f;
+						break;
+					case GL_COMPRESSED_RGBA_BPTC_UNORM:
+					case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+						decodeBC7(block, decoded);
+						break;
+					case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+					case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+						decodeBC6H(block, decodedFloat, img.Format == GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT);
+						break;
+					}
+
+					// copy the pixels that are inside of the image
+					for (int y = 0; y < 4 && by * 4 + y < level.Height; y++)
+						for (int x = 0; x < 4 && bx * 4 + x < level.Width; x++) {
+							size_t dst = (((size_t)z * level.Height + by * 4 + y) * level.Width + bx * 4 + x) * 4;
+							if (isFloat)
+								memcpy((float*)pixels + dst, decodedFloat + (y * 4 + x) * 4, sizeof(float) * 4);
+							else
+								memcpy((unsigned char*)pixels + dst, decoded + (y * 4 + x) * 4, 4);
+						}
+				}
+	}
+}
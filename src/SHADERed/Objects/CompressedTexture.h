@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	// block compressed (BC1 - BC7) image with all of its mip levels, as stored in a .dds, .ktx or .ktx2 file
+	struct CompressedImage {
+		CompressedImage()
+		{
+			Format = 0;
+			Width = Height = Depth = 0;
+		}
+
+		struct Level {
+			int Width, Height, Depth;
+			size_t Offset, Size; // location of the level in Data
+		};
+
+		GLenum Format; // GL_COMPRESSED_* internal format
+		int Width, Height, Depth;
+		std::vector<Level> Levels;
+		std::vector<unsigned char> Data;
+	};
+
+	// loads block compressed textures so that they can be uploaded with glCompressedTexImage*() - it can also
+	// decode them on the CPU for the drivers that don't support the format (doesn't make any GL calls)
+	class CompressedTexture {
+	public:
+		// false if the file isn't a block compressed 2D/3D texture (error is empty if the file is valid but
+		// uncompressed, for example a RGBA .dds file)
+		static bool Load(const std::string& path, CompressedImage& img, std::string& error);
+
+		static bool IsCompressedFormat(GLenum format);
+		static bool IsSupported(GLenum format, GLenum target); // only reads the GLEW flags, can be called from any thread
+		static int GetBlockSize(GLenum format);				   // bytes per 4x4 block
+
+		// format of the decoded pixels: GL_RGBA + GL_UNSIGNED_BYTE, or GL_FLOAT for BC6H and signed BC4/BC5
+		static bool IsDecodedFloat(GLenum format);
+		static GLenum GetDecodedFormat(GLenum format); // internal format that should be used for the decoded pixels
+
+		// decode one mip level to RGBA (4 bytes or 4 floats per pixel, depth slices are stored one after another)
+		static void Decode(const CompressedImage& img, int level, void* pixels);
+	};
+}
@@ -1,6 +1,7 @@
 #include <SHADERed/Objects/DebugInformation.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
 #include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/SPIRVParser.h>
 
 #include <iomanip>
 
@@ -11,6 +12,9 @@
 #define GET_VALUE_WITH_CHECK_INT(val, c) (val == nullptr ? 0 : val->members[c].value.s)
 #define GET_VALUE2_WITH_CHECK_INT(val, c, r) (val == nullptr ? 0 : val->members[c].members[r].value.s)
 
+#define DEBUGGER_PROGRAM_CACHE_SIZE 16
+#define DEBUGGER_IMAGE_CACHE_SIZE (512 * 1024 * 1024) // bytes
+
 /* compute shader callbacks */
 void allocateWorkgroupMemory(struct spvm_state* state, spvm_word result_id, spvm_word type_id)
 {
@@ -347,6 +351,8 @@ namespace ed {
 		m_msgs = msgs;
 		m_workgroup = nullptr;
 		m_updatedGeometryOutput = false;
+		m_imageCacheSize = 0;
+		m_session = 0;
 
 		m_vmContext = spvm_context_initialize();
 		m_vmGLSL = spvm_build_glsl450_ext();
@@ -358,6 +364,7 @@ namespace ed {
 		ClearPixelList();
 
 		m_resetVM();
+		m_clearCache();
 
 		free(m_vmGLSL);
 		spvm_context_deinitialize(m_vmContext);
@@ -367,6 +374,10 @@ namespace ed {
 	{
 		ed::Logger::Get().Log("Resetting the debugger");
 
+		ClearPixelShaderWorkers();
+
+		m_session++;
+
 		for (spvm_image_t img : m_images) {
 			free(img->data);
 			free(img);
@@ -402,10 +413,7 @@ namespace ed {
 			spvm_state_delete(m_vm);
 			m_vm = nullptr;
 		}
-		if (m_shader) {
-			spvm_program_delete(m_shader);
-			m_shader = nullptr;
-		}
+		m_shader = nullptr; // owned by m_programCache
 
 		// delete old immediate program & state
 		if (m_vmImmediate) {
@@ -426,8 +434,8 @@ namespace ed {
 
 		m_spv = spv;
 		
-		// create program & state
-		m_shader = spvm_program_create(m_vmContext, (spvm_source)m_spv.data(), m_spv.size());
+		// get program & create state
+		m_shader = m_getProgram(m_spv);
 		m_shader->user_data = this;
 		m_shader->allocate_workgroup_memory = allocateWorkgroupMemory;
 		m_shader->write_workgroup_memory = writeWorkgroupMemory;
@@ -442,6 +450,129 @@ namespace ed {
 		// link GLSL.std.450
 		spvm_state_set_extension(m_vm, "GLSL.std.450", m_vmGLSL);
 	}
+	spvm_program_t DebugInformation::m_getProgram(const std::vector<unsigned int>& spv)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for (unsigned int word : spv) {
+			hash ^= word;
+			hash *= 1099511628211ULL;
+		}
+
+		for (CachedProgram& entry : m_programCache)
+			if (entry.Hash == hash && entry.SPIRV == spv) {
+				entry.LastUsed = m_session;
+				return entry.Program;
+			}
+
+		// remove the least recently used program
+		if (m_programCache.size() >= DEBUGGER_PROGRAM_CACHE_SIZE) {
+			int oldest = 0;
+			for (int i = 1; i < m_programCache.size(); i++)
+				if (m_programCache[i].LastUsed < m_programCache[oldest].LastUsed)
+					oldest = i;
+
+			spvm_program_delete(m_programCache[oldest].Program);
+			m_programCache.erase(m_programCache.begin() + oldest);
+		}
+
+		CachedProgram entry;
+		entry.Hash = hash;
+		entry.LastUsed = m_session;
+		entry.WritesStorage = -1;
+		m_programCache.push_back(entry);
+
+		CachedProgram& added = m_programCache.back();
+		added.SPIRV = spv;
+		added.Program = spvm_program_create(m_vmContext, (spvm_source)added.SPIRV.data(), added.SPIRV.size());
+
+		return added.Program;
+	}
+	bool DebugInformation::m_writesStorage()
+	{
+		for (CachedProgram& entry : m_programCache) {
+			if (entry.Program != m_shader)
+				continue;
+
+			if (entry.WritesStorage == -1) {
+				SPIRVParser parser;
+				parser.Parse(entry.SPIRV);
+
+				entry.WritesStorage = 0;
+				for (const auto& res : parser.StorageResources)
+					if (!res.ReadOnly)
+						entry.WritesStorage = 1;
+			}
+
+			return entry.WritesStorage == 1;
+		}
+
+		return true; // unknown program, play it safe
+	}
+	spvm_image_t DebugInformation::m_getCachedImage(GLuint tex, spvm_word dim, uint64_t generation)
+	{
+		for (CachedImage& entry : m_imageCache)
+			if (entry.Texture == tex && entry.Dimension == dim && entry.Generation == generation) {
+				entry.LastUsed = m_session;
+				return entry.Image;
+			}
+		return nullptr;
+	}
+	bool DebugInformation::m_cacheImage(GLuint tex, spvm_word dim, uint64_t generation, spvm_image_t img, size_t size)
+	{
+		if (size > DEBUGGER_IMAGE_CACHE_SIZE)
+			return false;
+
+		// remove outdated copies of this texture and the least recently used images - never the ones used by the current VM
+		for (int i = 0; i < m_imageCache.size(); i++) {
+			if (m_imageCache[i].Texture == tex && m_imageCache[i].Dimension == dim && m_imageCache[i].LastUsed != m_session) {
+				m_imageCacheSize -= m_imageCache[i].Size;
+				free(m_imageCache[i].Image->data);
+				free(m_imageCache[i].Image);
+				m_imageCache.erase(m_imageCache.begin() + i);
+				i--;
+			}
+		}
+		while (m_imageCacheSize + size > DEBUGGER_IMAGE_CACHE_SIZE) {
+			int oldest = -1;
+			for (int i = 0; i < m_imageCache.size(); i++)
+				if (m_imageCache[i].LastUsed != m_session && (oldest == -1 || m_imageCache[i].LastUsed < m_imageCache[oldest].LastUsed))
+					oldest = i;
+
+			if (oldest == -1)
+				return false;
+
+			m_imageCacheSize -= m_imageCache[oldest].Size;
+			free(m_imageCache[oldest].Image->data);
+			free(m_imageCache[oldest].Image);
+			m_imageCache.erase(m_imageCache.begin() + oldest);
+		}
+
+		CachedImage entry;
+		entry.Texture = tex;
+		entry.Dimension = dim;
+		entry.Generation = generation;
+		entry.Size = size;
+		entry.Image = img;
+		entry.LastUsed = m_session;
+		m_imageCache.push_back(entry);
+		m_imageCacheSize += size;
+
+		return true;
+	}
+	void DebugInformation::m_clearCache()
+	{
+		for (CachedProgram& entry : m_programCache)
+			spvm_program_delete(entry.Program);
+		m_programCache.clear();
+
+		for (CachedImage& entry : m_imageCache) {
+			free(entry.Image->data);
+			free(entry.Image);
+		}
+		m_imageCache.clear();
+		m_imageCacheSize = 0;
+	}
 	void DebugInformation::m_setupWorkgroup()
 	{
 		ed::Logger::Get().Log("Setting up the shader workgroup in the debugger");
@@ -477,6 +608,13 @@ namespace ed {
 			}
 		}
 
+		for (int j = 0; j < groupSize; j++)
+			if (m_workgroup[j])
+				m_shareUniforms(m_workgroup[j], m_originalValues);
+	}
+	void DebugInformation::m_shareUniforms(spvm_state_t state, std::vector<OriginalValue>& originalValues)
+	{
+		// textures and buffers point to the m_vm's memory, other uniforms are copied
 		for (int i = 0; i < m_shader->bound; i++) {
 			spvm_result_t slot = &m_vm->results[i];
 			
@@ -495,35 +633,46 @@ namespace ed {
 							break;
 						}
 
-					if (pointerInfo->storage_class == SpvStorageClassUniformConstant && !isBufferBlock) {
-						// textures
-						if (type_info->value_type == spvm_value_type_sampled_image || type_info->value_type == spvm_value_type_image) {
-
-							for (int j = 0; j < groupSize; j++)
-								if (m_workgroup[j]) {
-									m_originalValues.push_back(OriginalValue(m_workgroup[j], i, m_workgroup[j]->results[i].member_count, m_workgroup[j]->results[i].members));
-									m_workgroup[j]->results[i].member_count = slot->member_count;
-									m_workgroup[j]->results[i].members = slot->members;
-									wasCopied = true;
-								}
-						}
-					} else if (pointerInfo->storage_class == SpvStorageClassStorageBuffer || isBufferBlock) {
-						// buffers
-						for (int j = 0; j < groupSize; j++)
-							if (m_workgroup[j]) {
-								m_originalValues.push_back(OriginalValue(m_workgroup[j], i, m_workgroup[j]->results[i].member_count, m_workgroup[j]->results[i].members));
-								m_workgroup[j]->results[i].member_count = slot->member_count;
-								m_workgroup[j]->results[i].members = slot->members;
-								wasCopied = true;
-							}
+					bool isShared = false;
+					if (pointerInfo->storage_class == SpvStorageClassUniformConstant && !isBufferBlock)
+						isShared = type_info->value_type == spvm_value_type_sampled_image || type_info->value_type == spvm_value_type_image; // textures
+					else if (pointerInfo->storage_class == SpvStorageClassStorageBuffer || isBufferBlock)
+						isShared = true; // buffers
+
+					if (isShared) {
+						originalValues.push_back(OriginalValue(state, i, state->results[i].member_count, state->results[i].members));
+						state->results[i].member_count = slot->member_count;
+						state->results[i].members = slot->members;
+						wasCopied = true;
 					}
 				}
 				
-				if (!wasCopied && (pointerInfo->storage_class == SpvStorageClassUniformConstant || pointerInfo->storage_class == SpvStorageClassUniform)) {
-					for (int j = 0; j < groupSize; j++)
-						if (m_workgroup[j])
-							spvm_member_memcpy(m_workgroup[j]->results[i].members, slot->members, slot->member_count);
-				}
+				if (!wasCopied && slot->members != nullptr && (pointerInfo->storage_class == SpvStorageClassUniformConstant || pointerInfo->storage_class == SpvStorageClassUniform))
+					spvm_member_memcpy(state->results[i].members, slot->members, slot->member_count);
+			}
+		}
+	}
+	void DebugInformation::m_copyUniformsToDerivativeGroups(spvm_state_t state)
+	{
+		if (!state->derivative_used)
+			return;
+
+		for (spvm_word i = 0; i < state->owner->bound; i++) {
+			spvm_result_t slot = &state->results[i];
+
+			spvm_result_t ptrInfo = nullptr;
+			if (slot->pointer)
+				ptrInfo = &state->results[slot->pointer];
+
+			bool needsCopy = false;
+
+			if (ptrInfo)
+				needsCopy = (ptrInfo->storage_class == SpvStorageClassUniform || ptrInfo->storage_class == SpvStorageClassUniformConstant) && ptrInfo->value_type == spvm_value_type_pointer;
+
+			if (needsCopy && slot->members != nullptr) {
+				if (state->derivative_group_x) spvm_member_memcpy(state->derivative_group_x->results[i].members, slot->members, slot->member_count);
+				if (state->derivative_group_y) spvm_member_memcpy(state->derivative_group_y->results[i].members, slot->members, slot->member_count);
+				if (state->derivative_group_d) spvm_member_memcpy(state->derivative_group_d->results[i].members, slot->members, slot->member_count);
 			}
 		}
 	}
@@ -959,7 +1108,7 @@ namespace ed {
 						if (!wrongBind && textureID != 0) {
 							ObjectManagerItem* itemData = m_objs->GetByTextureID(textureID);
 							if (itemData) {
-								if (!(itemData->Type == ObjectType::Texture || itemData->Type == ObjectType::Texture3D || itemData->Type == ObjectType::RenderTexture || itemData->Type == ObjectType::Image || itemData->Type == ObjectType::Image3D || itemData->Type == ObjectType::KeyboardTexture)) {
+								if (!(itemData->Type == ObjectType::Texture || itemData->Type == ObjectType::CubeMap || itemData->Type == ObjectType::Texture3D || itemData->Type == ObjectType::RenderTexture || itemData->Type == ObjectType::Image || itemData->Type == ObjectType::Image3D || itemData->Type == ObjectType::KeyboardTexture)) {
 									wrongBind = true;
 									textureID = 0;
 								}
@@ -988,10 +1137,24 @@ namespace ed {
 							if (slot->members == nullptr) // if slot->members == nullptr it means that it's a pointer/function argument
 								continue;
 
-							spvm_image_t img = (spvm_image_t)malloc(sizeof(spvm_image));
-							
 							if (type_info->image_info == NULL)
 								type_info = &m_vm->results[type_info->pointer];
+
+							// sampled textures are read-only -> reuse the data from previous debug sessions if the texture hasn't changed
+							bool isCacheable = isSampled && !pluginUsesCustomTextures;
+							uint64_t texGeneration = 0;
+							if (isCacheable) {
+								texGeneration = m_objs->GetTextureGeneration(m_objs->GetByTextureID(textureID));
+
+								spvm_image_t cachedImg = m_getCachedImage(textureID, type_info->image_info->dim, texGeneration);
+								if (cachedImg != nullptr) {
+									slot->members[0].image_data = cachedImg;
+									sampler2Dloc++;
+									continue;
+								}
+							}
+
+							spvm_image_t img = (spvm_image_t)malloc(sizeof(spvm_image));
 							
 							glm::ivec3 imgSize(1, 1, 1);
 							float* imgData = nullptr;
@@ -1128,7 +1291,8 @@ namespace ed {
 								img->user_data = (void*)textureID;
 
 							slot->members[0].image_data = img;
-							m_images.push_back(img);
+							if (!isCacheable || !m_cacheImage(textureID, type_info->image_info->dim, texGeneration, img, sizeof(float) * imgSize.x * imgSize.y * imgSize.z * 4))
+								m_images.push_back(img);
 							sampler2Dloc++;
 						}
 					}
@@ -1769,86 +1933,67 @@ namespace ed {
 		m_copyUniforms(owner, item, px);
 
 		// dfdx/y
-		if (m_vm->derivative_used) {
-			for (spvm_word i = 0; i < m_vm->owner->bound; i++) {
-				spvm_result_t slot = &m_vm->results[i];
-
-				spvm_result_t ptrInfo = nullptr;
-				if (slot->pointer)
-					ptrInfo = &m_vm->results[slot->pointer];
-
-				bool needsCopy = false;
-
-				if (ptrInfo)
-					needsCopy = (ptrInfo->storage_class == SpvStorageClassUniform || ptrInfo->storage_class == SpvStorageClassUniformConstant) && ptrInfo->value_type == spvm_value_type_pointer;
-
-				if (needsCopy && slot->members != nullptr) {
-					if (m_vm->derivative_group_x) spvm_member_memcpy(m_vm->derivative_group_x->results[i].members, slot->members, slot->member_count);
-					if (m_vm->derivative_group_y) spvm_member_memcpy(m_vm->derivative_group_y->results[i].members, slot->members, slot->member_count);
-					if (m_vm->derivative_group_d) spvm_member_memcpy(m_vm->derivative_group_d->results[i].members, slot->members, slot->member_count);
-				}
-			}
-		}
+		m_copyUniformsToDerivativeGroups(m_vm);
 	}
 	float DebugInformation::SetPixelShaderInput(PixelInformation& pixel)
 	{
 		m_pixel = &pixel;
 		m_ubLastType = m_ubLastLine = m_ubCount = 0;
 
-		glm::vec3 weights = m_processWeight(glm::ivec2(0, 0));
-		m_interpolateValues(m_vm, weights);
+		return m_setPixelShaderInput(m_vm, pixel, pixel.Coordinate);
+	}
+	float DebugInformation::m_setPixelShaderInput(spvm_state_t state, const PixelInformation& pixel, const glm::ivec2& coord)
+	{
+		glm::vec3 weights = m_processWeight(pixel, coord);
+		m_interpolateValues(pixel, state, weights);
 
 		float depth = weights.x * pixel.FinalPosition[0].z + weights.y * pixel.FinalPosition[1].z + weights.z * pixel.FinalPosition[2].z;
 		
-		if (m_vm->derivative_used && !m_vm->_derivative_is_group_member) {
-			spvm_byte isOddX = ((int)pixel.Coordinate.x) % 2 != 0;
-			spvm_byte isOddY = ((int)pixel.Coordinate.y) % 2 != 0;
-			float modX = 1, modY = 1;
+		if (state->derivative_used && !state->_derivative_is_group_member) {
+			spvm_byte isOddX = coord.x % 2 != 0;
+			spvm_byte isOddY = coord.y % 2 != 0;
+			int modX = 1, modY = 1;
 
 			// setup frag_coord
 			if (isOddX) modX = -1;
 			if (isOddY) modY = -1;
 			
-			if (m_vm->derivative_group_x) {
-				weights = m_processWeight(glm::ivec2(modX, 0));
-				m_interpolateValues(m_vm->derivative_group_x, weights);
+			if (state->derivative_group_x) {
+				weights = m_processWeight(pixel, coord + glm::ivec2(modX, 0));
+				m_interpolateValues(pixel, state->derivative_group_x, weights);
 			}
-			if (m_vm->derivative_group_y) {
-				weights = m_processWeight(glm::ivec2(0, modY));
-				m_interpolateValues(m_vm->derivative_group_y, weights);
+			if (state->derivative_group_y) {
+				weights = m_processWeight(pixel, coord + glm::ivec2(0, modY));
+				m_interpolateValues(pixel, state->derivative_group_y, weights);
 			}
-			if (m_vm->derivative_group_d) {
-				weights = m_processWeight(glm::ivec2(modX, modY));
-				m_interpolateValues(m_vm->derivative_group_d, weights);
+			if (state->derivative_group_d) {
+				weights = m_processWeight(pixel, coord + glm::ivec2(modX, modY));
+				m_interpolateValues(pixel, state->derivative_group_d, weights);
 			}
 		}
 
 		return depth / (weights.x + weights.y + weights.z);
 	}
-	glm::vec3 DebugInformation::m_processWeight(glm::ivec2 offset)
+	glm::vec3 DebugInformation::m_processWeight(const PixelInformation& pixel, glm::ivec2 coord)
 	{
-		// !!! m_pixel must be set !!!
-
-		glm::vec2 pxPosition = glm::vec2(m_pixel->Coordinate + offset) / glm::vec2(m_pixel->RenderTextureSize - 1);
+		glm::vec2 pxPosition = glm::vec2(coord) / glm::vec2(pixel.RenderTextureSize - 1);
 
 		// weigths
-		glm::vec2 scrnPos1 = m_getScreenCoord(m_pixel->FinalPosition[0]);
-		glm::vec2 scrnPos2 = m_getScreenCoord(m_pixel->FinalPosition[1]);
-		glm::vec2 scrnPos3 = m_getScreenCoord(m_pixel->FinalPosition[2]);
+		glm::vec2 scrnPos1 = m_getScreenCoord(pixel.FinalPosition[0]);
+		glm::vec2 scrnPos2 = m_getScreenCoord(pixel.FinalPosition[1]);
+		glm::vec2 scrnPos3 = m_getScreenCoord(pixel.FinalPosition[2]);
 		glm::vec3 weights = m_getWeights(scrnPos1, scrnPos2, scrnPos3, pxPosition);
-		weights *= glm::vec3(m_pixel->FinalPosition[0].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[0].w), m_pixel->FinalPosition[1].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[1].w), m_pixel->FinalPosition[2].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[2].w));
+		weights *= glm::vec3(pixel.FinalPosition[0].w == 0.0f ? 0.0f : (1.0f / pixel.FinalPosition[0].w), pixel.FinalPosition[1].w == 0.0f ? 0.0f : (1.0f / pixel.FinalPosition[1].w), pixel.FinalPosition[2].w == 0.0f ? 0.0f : (1.0f / pixel.FinalPosition[2].w));
 	
 		return weights;
 	}
-	void DebugInformation::m_interpolateValues(spvm_state_t state, glm::vec3 weights)
+	void DebugInformation::m_interpolateValues(const PixelInformation& pixel, spvm_state_t state, glm::vec3 weights)
 	{
-		// !!! m_pixel must be set !!!
-
 		float weightSum = weights.x + weights.y + weights.z;
 
-		auto* mainStageOutput = &m_pixel->VertexShaderOutput[0];
-		if (m_pixel->GeometryShaderUsed && m_pixel->GeometrySelectedPrimitive != -1 && m_pixel->GeometrySelectedVertex != -1)
-			mainStageOutput = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
+		auto* mainStageOutput = &pixel.VertexShaderOutput[0];
+		if (pixel.GeometryShaderUsed && pixel.GeometrySelectedPrimitive != -1 && pixel.GeometrySelectedVertex != -1)
+			mainStageOutput = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex];
 
 		// match the ps input with vs output
 		for (int i = 0; i < state->owner->bound; i++) {
@@ -1888,23 +2033,23 @@ namespace ed {
 
 				// copy and interpolate values
 				if (outputIndex >= 0) {
-					auto* outputPtr0 = &m_pixel->VertexShaderOutput[0];
-					auto* outputPtr1 = &m_pixel->VertexShaderOutput[1];
-					auto* outputPtr2 = &m_pixel->VertexShaderOutput[2];
+					auto* outputPtr0 = &pixel.VertexShaderOutput[0];
+					auto* outputPtr1 = &pixel.VertexShaderOutput[1];
+					auto* outputPtr2 = &pixel.VertexShaderOutput[2];
 
-					if (m_pixel->GeometryShaderUsed && m_pixel->GeometrySelectedPrimitive != -1 && m_pixel->GeometrySelectedVertex != -1) {
-						if (m_pixel->GeometryOutputType == GeometryShaderOutput::Points) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
+					if (pixel.GeometryShaderUsed && pixel.GeometrySelectedPrimitive != -1 && pixel.GeometrySelectedVertex != -1) {
+						if (pixel.GeometryOutputType == GeometryShaderOutput::Points) {
+							outputPtr0 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex];
 							outputPtr1 = nullptr;
 							outputPtr2 = nullptr;
-						} else if (m_pixel->GeometryOutputType == GeometryShaderOutput::LineStrip) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 1];
-							outputPtr1 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
+						} else if (pixel.GeometryOutputType == GeometryShaderOutput::LineStrip) {
+							outputPtr0 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex - 1];
+							outputPtr1 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex];
 							outputPtr2 = nullptr;
-						} else if (m_pixel->GeometryOutputType == GeometryShaderOutput::TriangleStrip) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 2];
-							outputPtr1 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 1];
-							outputPtr2 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
+						} else if (pixel.GeometryOutputType == GeometryShaderOutput::TriangleStrip) {
+							outputPtr0 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex - 2];
+							outputPtr1 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex - 1];
+							outputPtr2 = &pixel.GeometryOutput[pixel.GeometrySelectedPrimitive].Output[pixel.GeometrySelectedVertex];
 						}
 					}
 
@@ -1952,34 +2097,37 @@ namespace ed {
 		if (m_vm == nullptr)
 			return glm::vec4(0.0f);
 
+		return m_executePixelShader(m_vm, x, y, loc);
+	}
+	glm::vec4 DebugInformation::m_executePixelShader(spvm_state_t state, int x, int y, int loc)
+	{
 		spvm_word fnMain = GetEntryPoint(m_stage);
 		if (fnMain == 0) {
-			fnMain = spvm_state_get_result_location(m_vm, "main");
+			fnMain = spvm_state_get_result_location(state, "main");
 			if (fnMain == 0)
 				return glm::vec4(0.0f);
 		}
 
-		spvm_state_prepare(m_vm, fnMain);
-		spvm_state_set_frag_coord(m_vm, x + 0.5f, y + 0.5f, 1.0f, 1.0f); // TODO: z and w components
-		spvm_state_call_function(m_vm);
+		spvm_state_prepare(state, fnMain);
+		spvm_state_set_frag_coord(state, x + 0.5f, y + 0.5f, 1.0f, 1.0f); // TODO: z and w components
+		spvm_state_call_function(state);
 
-		return GetPixelShaderOutput(loc);
+		return m_getPixelShaderOutput(state, loc);
 	}
 
 	glm::vec4 DebugInformation::GetPixelShaderOutput(int loc)
+	{
+		return m_getPixelShaderOutput(m_vm, loc);
+	}
+	glm::vec4 DebugInformation::m_getPixelShaderOutput(spvm_state_t state, int loc)
 	{
 		glm::vec4 ret(0.0f);
 
-		spvm_word mCount = 0;
-		spvm_member_t pointer = nullptr;
-
 		for (spvm_word i = 0; i < m_shader->bound; i++) {
-			spvm_result_t slot = &m_vm->results[i];
-			spvm_result_t type = nullptr, pointerType = nullptr;
-			if (slot->pointer) {
-				type = spvm_state_get_type_info(m_vm->results, &m_vm->results[slot->pointer]);
-				pointerType = &m_vm->results[slot->pointer];
-			}
+			spvm_result_t slot = &state->results[i];
+			spvm_result_t pointerType = nullptr;
+			if (slot->pointer)
+				pointerType = &state->results[slot->pointer];
 
 			if (slot->member_count == 0 || pointerType == nullptr || pointerType->storage_class != SpvStorageClassOutput)
 				continue;
@@ -2004,6 +2152,75 @@ namespace ed {
 		return glm::clamp(ret, 0.0f, 1.0f);
 	}
 
+	void DebugInformation::PreparePixelShaderWorkers(int count)
+	{
+		ClearPixelShaderWorkers();
+
+		if (m_vm == nullptr || m_stage != ShaderStage::Pixel)
+			return;
+
+		// the pixels would write to the same memory from multiple threads
+		if (m_writesStorage())
+			count = 1;
+
+		m_psWorkers.resize(std::max<int>(count, 1));
+		for (int i = 0; i < m_psWorkers.size(); i++) {
+			PixelShaderWorker& worker = m_psWorkers[i];
+			worker.UBLastType = worker.UBLastLine = worker.UBCount = 0;
+
+			if (i == 0) {
+				worker.VM = m_vm;
+				continue;
+			}
+
+			worker.VM = _spvm_state_create_base(m_shader, true, 0);
+			worker.VM->analyzer = m_vm->analyzer;
+			spvm_state_set_extension(worker.VM, "GLSL.std.450", m_vmGLSL);
+
+			m_shareUniforms(worker.VM, m_psWorkerOriginalValues);
+			m_copyUniformsToDerivativeGroups(worker.VM);
+		}
+	}
+	void DebugInformation::ClearPixelShaderWorkers()
+	{
+		for (const OriginalValue& originalData : m_psWorkerOriginalValues) {
+			originalData.State->results[originalData.Slot].members = originalData.Members;
+			originalData.State->results[originalData.Slot].member_count = originalData.MemberCount;
+		}
+		m_psWorkerOriginalValues.clear();
+
+		for (int i = 1; i < m_psWorkers.size(); i++)
+			spvm_state_delete(m_psWorkers[i].VM);
+		m_psWorkers.clear();
+	}
+	float DebugInformation::SetPixelShaderWorkerInput(int worker, const PixelInformation& pixel, const glm::ivec2& coord)
+	{
+		PixelShaderWorker& data = m_psWorkers[worker];
+		data.UBLastType = data.UBLastLine = data.UBCount = 0;
+
+		return m_setPixelShaderInput(data.VM, pixel, coord);
+	}
+	glm::vec4 DebugInformation::ExecutePixelShaderWorker(int worker, int x, int y, int loc)
+	{
+		spvm_state_t vm = m_psWorkers[worker].VM;
+
+		// don't let the values written by the previously shaded pixel leak into this one - the
+		// result must not depend on which worker (and in what order) executed the pixel
+		for (spvm_word i = 0; i < m_shader->bound; i++) {
+			spvm_result_t slot = &vm->results[i];
+			if (slot->pointer && slot->members != nullptr && vm->results[slot->pointer].storage_class == SpvStorageClassOutput)
+				for (spvm_word j = 0; j < slot->member_count; j++)
+					if (slot->members[j].member_count == 0)
+						memset(&slot->members[j].value, 0, sizeof(slot->members[j].value));
+		}
+
+		return m_executePixelShader(vm, x, y, loc);
+	}
+	glm::vec4 DebugInformation::GetPixelShaderWorkerOutput(int worker, int loc)
+	{
+		return m_getPixelShaderOutput(m_psWorkers[worker].VM, loc);
+	}
+
 	void DebugInformation::PrepareGeometryShader(PipelineItem* owner, PipelineItem* item, PixelInformation* px)
 	{
 		m_stage = ShaderStage::Geometry;
@@ -2820,6 +3037,16 @@ namespace ed {
 	}
 	void DebugInformation::OnUndefinedBehavior(spvm_state_t state, spvm_word ubID)
 	{
+		// workers keep track of their own UB so that they can run in parallel
+		for (PixelShaderWorker& worker : m_psWorkers) {
+			if (worker.VM == state) {
+				worker.UBLastType = ubID;
+				worker.UBLastLine = state->current_line;
+				worker.UBCount = std::min<spvm_word>(worker.UBCount + 1, 11);
+				return;
+			}
+		}
+
 		m_ubLastType = ubID;
 		m_ubLastLine = state->current_line;
 		m_ubCount = std::min<spvm_word>(m_ubCount + 1, 11);
@@ -48,6 +48,17 @@ namespace ed {
 		glm::vec4 ExecutePixelShader(int x, int y, int loc = 0);
 		glm::vec4 GetPixelShaderOutput(int loc = 0);
 
+		// pixel shader workers - copies of the pixel shader VM that can execute in parallel (used by the frame analyzer)
+		// worker 0 is always the main VM, call this after PreparePixelShader() - storage buffers & images are shared
+		// between the workers, so shaders that write to them only get one worker
+		void PreparePixelShaderWorkers(int count);
+		void ClearPixelShaderWorkers();
+		inline int GetPixelShaderWorkerCount() { return m_psWorkers.size(); }
+		inline spvm_state_t GetPixelShaderWorker(int worker) { return m_psWorkers[worker].VM; }
+		float SetPixelShaderWorkerInput(int worker, const PixelInformation& pixel, const glm::ivec2& coord);
+		glm::vec4 ExecutePixelShaderWorker(int worker, int x, int y, int loc = 0);
+		glm::vec4 GetPixelShaderWorkerOutput(int worker, int loc = 0);
+
 		void PrepareGeometryShader(PipelineItem* pass, PipelineItem* item, PixelInformation* px = nullptr);
 		void SetGeometryShaderInput(PixelInformation& pixel);
 		void ExecuteGeometryShader();
@@ -144,11 +155,16 @@ namespace ed {
 		{
 			if (m_vm != nullptr)
 				m_vm->analyzer = analyze ? &m_analyzer : nullptr;
+			for (auto& worker : m_psWorkers)
+				worker.VM->analyzer = analyze ? &m_analyzer : nullptr;
 		}
 		void OnUndefinedBehavior(spvm_state_t state, spvm_word ubID);
 		inline spvm_word GetLastUndefinedBehaviorType() { return m_ubLastType; }
 		inline spvm_word GetLastUndefinedBehaviorLine() { return m_ubLastLine; }
 		inline spvm_word GetUndefinedBehaviorCount() { return m_ubCount; }
+		inline spvm_word GetLastUndefinedBehaviorType(int worker) { return m_psWorkers[worker].UBLastType; }
+		inline spvm_word GetLastUndefinedBehaviorLine(int worker) { return m_psWorkers[worker].UBLastLine; }
+		inline spvm_word GetUndefinedBehaviorCount(int worker) { return m_psWorkers[worker].UBCount; }
 
 	private:
 		ObjectManager* m_objs;
@@ -166,10 +182,40 @@ namespace ed {
 		}
 		glm::vec3 m_getWeights(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 p);
 
-		glm::vec3 m_processWeight(glm::ivec2 offset);
-		void m_interpolateValues(spvm_state_t state, glm::vec3 weights);
-
-		std::vector<spvm_image_t> m_images; // TODO: clear these + smart cache
+		glm::vec3 m_processWeight(const PixelInformation& pixel, glm::ivec2 coord);
+		void m_interpolateValues(const PixelInformation& pixel, spvm_state_t state, glm::vec3 weights);
+		float m_setPixelShaderInput(spvm_state_t state, const PixelInformation& pixel, const glm::ivec2& coord);
+		glm::vec4 m_executePixelShader(spvm_state_t state, int x, int y, int loc);
+		glm::vec4 m_getPixelShaderOutput(spvm_state_t state, int loc);
+
+		std::vector<spvm_image_t> m_images; // images owned by the current VM
+
+		// parsed programs and texture data are reused between debug sessions
+		struct CachedProgram {
+			uint64_t Hash;
+			std::vector<unsigned int> SPIRV; // spvm_program_t points to this
+			spvm_program_t Program;
+			uint32_t LastUsed;
+			int WritesStorage; // -1 = not checked yet
+		};
+		std::vector<CachedProgram> m_programCache;
+		spvm_program_t m_getProgram(const std::vector<unsigned int>& spv);
+		bool m_writesStorage(); // does m_shader write to a storage buffer or image
+
+		struct CachedImage {
+			GLuint Texture;
+			spvm_word Dimension;
+			uint64_t Generation;
+			size_t Size;
+			spvm_image_t Image;
+			uint32_t LastUsed;
+		};
+		std::vector<CachedImage> m_imageCache;
+		size_t m_imageCacheSize;
+		spvm_image_t m_getCachedImage(GLuint tex, spvm_word dim, uint64_t generation);
+		bool m_cacheImage(GLuint tex, spvm_word dim, uint64_t generation, spvm_image_t img, size_t size);
+		void m_clearCache();
+		uint32_t m_session; // increased on each m_resetVM(), cached items used by the current VM can't be evicted
 
 		spvm_context_t m_vmContext;
 		spvm_ext_opcode_func* m_vmGLSL;
@@ -194,6 +240,15 @@ namespace ed {
 		int m_threadX, m_threadY, m_threadZ, m_numGroupsX, m_numGroupsY, m_numGroupsZ;
 		void m_setupWorkgroup();
 		std::vector<OriginalValue> m_originalValues;
+		void m_shareUniforms(spvm_state_t state, std::vector<OriginalValue>& originalValues);
+		void m_copyUniformsToDerivativeGroups(spvm_state_t state);
+
+		struct PixelShaderWorker {
+			spvm_state_t VM;
+			spvm_word UBLastType, UBLastLine, UBCount;
+		};
+		std::vector<PixelShaderWorker> m_psWorkers;
+		std::vector<OriginalValue> m_psWorkerOriginalValues;
 		void m_setThreadID(spvm_state_t state, int x, int y, int z, int numGroupsX, int numGroupsY, int numGroupsZ);
 		
 		void m_copyUniforms(PipelineItem* pass, PipelineItem* item, PixelInformation* px = nullptr);
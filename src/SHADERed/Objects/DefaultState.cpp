@@ -30,4 +30,24 @@ namespace ed {
 		// stencil
 		glDisable(GL_STENCIL_TEST);
 	}
+	void DefaultState::Bind(GLStateCache& state)
+	{
+		// render states
+		state.SetCapability(GL_DEPTH_CLAMP, false);
+		state.PolygonMode(GL_FILL);
+		state.SetCapability(GL_CULL_FACE, true);
+		state.CullFace(GL_BACK);
+		state.FrontFace(GL_CCW);
+
+		// disable blending
+		state.SetCapability(GL_BLEND, false);
+
+		// depth state
+		state.SetCapability(GL_DEPTH_TEST, true);
+		state.DepthMask(GL_TRUE);
+		state.DepthFunc(GL_LESS);
+
+		// stencil
+		state.SetCapability(GL_STENCIL_TEST, false);
+	}
 }
@@ -1,8 +1,10 @@
 #pragma once
+#include <SHADERed/Objects/GLStateCache.h>
 
 namespace ed {
 	class DefaultState {
 	public:
 		static void Bind();
+		static void Bind(GLStateCache& state);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,138 @@
+#include <SHADERed/Objects/DiskCache.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace ed {
+	DiskCache::DiskCache(const std::string& path, const std::string& name, uintmax_t maxSize)
+	{
+		m_path = path;
+		m_name = name;
+		m_maxSize = maxSize;
+
+		std::error_code ec;
+		std::filesystem::create_directories(m_path, ec);
+		m_enabled = !ec;
+
+		if (m_enabled)
+			Trim();
+		else
+			Logger::Get().Log("Failed to create the " + m_name + " cache directory " + m_path, true);
+	}
+
+	std::string DiskCache::GetFilename(uint64_t key, const char* ext)
+	{
+		std::stringstream ss;
+		ss << std::hex << key;
+		return m_path + ss.str() + "." + ext;
+	}
+	bool DiskCache::Write(const std::string& filename, const std::function<void(std::ofstream&)>& writer)
+	{
+		if (!m_enabled)
+			return false;
+
+		std::string tempName = GetTempFilename(filename);
+
+		std::ofstream file(tempName, std::ios::binary);
+		if (!file.is_open())
+			return false;
+		writer(file);
+		file.close();
+
+		bool failed = !file.good();
+
+		std::error_code ec;
+		if (!failed)
+			std::filesystem::rename(tempName, filename, ec);
+		if (failed || ec) {
+			std::filesystem::remove(tempName, ec);
+			return false;
+		}
+
+		return true;
+	}
+	void DiskCache::Touch(const std::string& filename)
+	{
+		std::error_code ec;
+		std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now(), ec);
+	}
+	void DiskCache::Trim()
+	{
+		struct CacheFile {
+			std::filesystem::path Path;
+			std::filesystem::file_time_type Time;
+			uintmax_t Size;
+		};
+
+		std::vector<CacheFile> files;
+		uintmax_t totalSize = 0;
+
+		auto now = std::filesystem::file_time_type::clock::now();
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(m_path, ec)) {
+			if (!entry.is_regular_file(ec))
+				continue;
+
+			std::filesystem::file_time_type time = entry.last_write_time(ec);
+			if (ec)
+				continue;
+
+			// leftovers from a crash - newer ones might still be written by another instance
+			if (entry.path().extension() == ".tmp") {
+				if (now - time > std::chrono::seconds(DISK_CACHE_TEMP_MAX_AGE))
+					std::filesystem::remove(entry.path(), ec);
+				continue;
+			}
+
+			CacheFile file;
+			file.Path = entry.path();
+			file.Time = time;
+			file.Size = entry.file_size(ec);
+			totalSize += file.Size;
+			files.push_back(file);
+		}
+
+		if (totalSize <= m_maxSize)
+			return;
+
+		// delete the least recently used entries
+		std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) {
+			return a.Time < b.Time;
+		});
+
+		size_t deleted = 0;
+		for (const auto& file : files) {
+			if (totalSize <= m_maxSize / 2)
+				break;
+
+			std::filesystem::remove(file.Path, ec);
+			totalSize -= file.Size;
+			deleted++;
+		}
+
+		Logger::Get().Log("Deleted " + std::to_string(deleted) + " old entries from the " + m_name + " cache");
+	}
+
+	std::string DiskCache::GetTempFilename(const std::string& filename)
+	{
+		// process ID + random suffix - thread IDs (or their hashes) repeat between processes
+		static thread_local std::mt19937_64 generator(std::random_device {}());
+
+		std::stringstream ss;
+		ss << filename << "." << getpid() << "-" << std::hex << generator() << ".tmp";
+		return ss.str();
+	}
+}
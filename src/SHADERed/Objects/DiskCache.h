@@ -0,0 +1,39 @@
+#pragma once
+#include <fstream>
+#include <functional>
+#include <string>
+#include <stdint.h>
+
+#define DISK_CACHE_TEMP_MAX_AGE 3600 // seconds - older .tmp files were left behind by a crash
+
+namespace ed {
+	// directory with one file per cache entry (named after the entry's key), shared by the shader, model & environment
+	// caches - entries are written to a temporary file and then renamed so that nobody can read a half written one,
+	// the least recently used entries are deleted once the directory is larger than maxSize
+	class DiskCache {
+	public:
+		DiskCache(const std::string& path, const std::string& name, uintmax_t maxSize);
+
+		inline bool IsEnabled() { return m_enabled; }
+
+		std::string GetFilename(uint64_t key, const char* ext);
+
+		// writer fills the temporary file - the entry is only replaced if all of the writes succeeded
+		bool Write(const std::string& filename, const std::function<void(std::ofstream&)>& writer);
+
+		// entries that are used often shouldn't be the first ones to get deleted
+		void Touch(const std::string& filename);
+
+		// delete the least recently used entries down to half of the max size
+		void Trim();
+
+		// unique between threads and instances of SHADERed that share the cache
+		static std::string GetTempFilename(const std::string& filename);
+
+	private:
+		std::string m_path;
+		std::string m_name;
+		uintmax_t m_maxSize;
+		bool m_enabled;
+	};
+}
@@ -0,0 +1,168 @@
+#include <SHADERed/Objects/EnvironmentCache.h>
+#include <SHADERed/Objects/ShaderCache.h>
+#include <SHADERed/Objects/Settings.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#define ENVIRONMENT_CACHE_MAGIC 0x45444553 // "SEDE"
+#define ENVIRONMENT_CACHE_FORMAT 1
+
+namespace ed {
+	struct EnvironmentCacheHeader {
+		uint32_t Magic;
+		uint32_t Format;
+		uint32_t Target;
+		uint32_t InternalFormat;
+		uint32_t PixelFormat;
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t Levels;
+	};
+
+	EnvironmentCache::EnvironmentCache()
+			: m_cache(Settings::Instance().ConvertPath(ENVIRONMENT_CACHE_DIRECTORY), "environment", ENVIRONMENT_CACHE_MAX_SIZE)
+	{
+	}
+
+	uint64_t EnvironmentCache::GetKey(uint64_t sourceHash, int environmentType)
+	{
+		uint64_t ret = ShaderCache::Hash(sourceHash, (uint64_t)ENVIRONMENT_CACHE_FORMAT);
+		ret = ShaderCache::Hash(environmentType, ret);
+		ret = ShaderCache::Hash(TextureHelper::kEnvMapSize, ret);
+		ret = ShaderCache::Hash(TextureHelper::kIrradianceMapSize, ret);
+		ret = ShaderCache::Hash(TextureHelper::kBRDF_LUT_Size, ret);
+		return ret;
+	}
+	uint64_t EnvironmentCache::HashFile(const std::string& path, uint64_t seed)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return seed;
+
+		std::vector<char> buffer(64 * 1024);
+		uint64_t ret = seed;
+		while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+			ret = ShaderCache::HashData(buffer.data(), file.gcount(), ret);
+
+		return ret;
+	}
+
+	bool EnvironmentCache::Load(uint64_t key, TextureHelper::TextureDesc& texture)
+	{
+		if (!m_cache.IsEnabled())
+			return false;
+
+		std::string filename = m_cache.GetFilename(key, "env");
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		size_t fileSize = file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		EnvironmentCacheHeader header;
+		if (fileSize < sizeof(header) || !file.read((char*)&header, sizeof(header)))
+			return false;
+		if (header.Magic != ENVIRONMENT_CACHE_MAGIC || header.Format != ENVIRONMENT_CACHE_FORMAT)
+			return false;
+		if (header.Target != GL_TEXTURE_2D && header.Target != GL_TEXTURE_CUBE_MAP)
+			return false;
+
+		int faceCount = header.Target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+		int channels = TextureHelper::TextureDesc::GetChannelCount(header.PixelFormat);
+
+		// check the size before creating anything
+		size_t dataSize = 0;
+		for (uint32_t level = 0; level < header.Levels; level++) {
+			size_t w = std::max<uint32_t>(1, header.Width >> level);
+			size_t h = std::max<uint32_t>(1, header.Height >> level);
+			dataSize += w * h * channels * sizeof(float) * faceCount;
+		}
+		if (header.Levels == 0 || sizeof(header) + dataSize != fileSize)
+			return false;
+
+		GLuint tex = 0;
+		glGenTextures(1, &tex);
+		glBindTexture(header.Target, tex);
+		glTexStorage2D(header.Target, header.Levels, header.InternalFormat, header.Width, header.Height);
+		glTexParameteri(header.Target, GL_TEXTURE_MIN_FILTER, header.Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(header.Target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		std::vector<float> pixels;
+		for (uint32_t level = 0; level < header.Levels; level++) {
+			int w = std::max<uint32_t>(1, header.Width >> level);
+			int h = std::max<uint32_t>(1, header.Height >> level);
+			pixels.resize(w * h * channels);
+
+			for (int face = 0; face < faceCount; face++) {
+				if (!file.read((char*)pixels.data(), pixels.size() * sizeof(float))) {
+					glBindTexture(header.Target, 0);
+					glDeleteTextures(1, &tex);
+					return false;
+				}
+
+				GLenum faceTarget = faceCount == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : header.Target;
+				glTexSubImage2D(faceTarget, level, 0, 0, w, h, header.PixelFormat, GL_FLOAT, pixels.data());
+			}
+		}
+		glBindTexture(header.Target, 0);
+		file.close();
+
+		texture.target = header.Target;
+		texture.id = tex;
+		texture.width = header.Width;
+		texture.height = header.Height;
+		texture.levels = header.Levels;
+		texture.format = header.PixelFormat;
+		texture.type = GL_FLOAT;
+		texture.internalFormat = header.InternalFormat;
+
+		m_cache.Touch(filename);
+
+		return true;
+	}
+	void EnvironmentCache::Save(uint64_t key, const TextureHelper::TextureDesc& texture)
+	{
+		if (!m_cache.IsEnabled() || !texture.Validate())
+			return;
+
+		EnvironmentCacheHeader header;
+		header.Magic = ENVIRONMENT_CACHE_MAGIC;
+		header.Format = ENVIRONMENT_CACHE_FORMAT;
+		header.Target = texture.target;
+		header.InternalFormat = texture.internalFormat;
+		header.PixelFormat = texture.format;
+		header.Width = texture.width;
+		header.Height = texture.height;
+		header.Levels = texture.levels;
+
+		int faceCount = texture.target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+		int channels = texture.GetChannelCount();
+
+		// the textures are usually written by compute shaders
+		glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+		// multiple instances of SHADERed might be writing the same entry
+		m_cache.Write(m_cache.GetFilename(key, "env"), [&](std::ofstream& file) {
+			file.write((const char*)&header, sizeof(header));
+
+			// always read back as 32bit floats - no conversion loses any precision
+			std::vector<float> pixels;
+			glBindTexture(texture.target, texture.id);
+			for (int level = 0; level < texture.levels; level++) {
+				int w = std::max(1, texture.width >> level);
+				int h = std::max(1, texture.height >> level);
+				pixels.resize(w * h * channels);
+
+				for (int face = 0; face < faceCount; face++) {
+					GLenum faceTarget = faceCount == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : texture.target;
+					glGetTexImage(faceTarget, level, texture.format, GL_FLOAT, pixels.data());
+					file.write((const char*)pixels.data(), pixels.size() * sizeof(float));
+				}
+			}
+			glBindTexture(texture.target, 0);
+		});
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <SHADERed/Objects/DiskCache.h>
+#include <SHADERed/Objects/TextureHelper.h>
+#include <string>
+#include <stdint.h>
+
+#define ENVIRONMENT_CACHE_DIRECTORY "cache/environment/"
+#define ENVIRONMENT_CACHE_MAX_SIZE (1024 * 1024 * 1024)
+
+namespace ed {
+	// persistent cache for the baked IBL textures (prefiltered specular cube with all of its mips, irradiance
+	// cube and the BRDF LUT) - each entry is a single file that stores every face & mip level as raw floats
+	// so that loading it gives back exactly what was baked and nothing has to be recomputed
+	class EnvironmentCache {
+	public:
+		EnvironmentCache();
+
+		static inline EnvironmentCache& Instance()
+		{
+			static EnvironmentCache ret;
+			return ret;
+		}
+
+		// sourceHash = hash of the input image(s), 0 for the scene independent BRDF LUT
+		static uint64_t GetKey(uint64_t sourceHash, int environmentType);
+		static uint64_t HashFile(const std::string& path, uint64_t seed = 14695981039346656037ULL);
+
+		bool Load(uint64_t key, TextureHelper::TextureDesc& texture); // creates a new GL texture
+		void Save(uint64_t key, const TextureHelper::TextureDesc& texture);
+
+	private:
+		DiskCache m_cache;
+	};
+}
@@ -0,0 +1,326 @@
+#include <SHADERed/Objects/Export/ExportImage.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
+#include <SHADERed/Objects/RenderEngine.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Options.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <math.h>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include <misc/stb_image_write.h>
+#include <misc/stb_image_resize.h>
+
+#define EXPORT_IMAGE_PBO_COUNT 3
+
+namespace ed {
+	// blocking queue with a fixed capacity - used to pass the frames between the GL thread and the encoders
+	class FrameQueue {
+	public:
+		struct Frame {
+			unsigned char* Pixels;
+			int Index;
+		};
+
+		FrameQueue(size_t capacity)
+		{
+			m_capacity = capacity;
+			m_closed = false;
+		}
+
+		void Push(const Frame& frame)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notFull.wait(lock, [&] { return m_frames.size() < m_capacity; });
+				m_frames.push_back(frame);
+			}
+			m_notEmpty.notify_one();
+		}
+		bool Pop(Frame& frame) // returns false once the queue is closed and empty
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notEmpty.wait(lock, [&] { return !m_frames.empty() || m_closed; });
+				if (m_frames.empty())
+					return false;
+				frame = m_frames.front();
+				m_frames.pop_front();
+			}
+			m_notFull.notify_one();
+			return true;
+		}
+		void Close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_closed = true;
+			}
+			m_notEmpty.notify_all();
+		}
+
+	private:
+		std::deque<Frame> m_frames;
+		size_t m_capacity;
+		bool m_closed;
+		std::mutex m_mutex;
+		std::condition_variable m_notEmpty, m_notFull;
+	};
+
+	void ExportImage::Export(RenderEngine* renderer, const ExportImageOptions& opts)
+	{
+		int sizeMulti = opts.Supersample;
+		int actualSizeX = opts.Size.x * sizeMulti;
+		int actualSizeY = opts.Size.y * sizeMulti;
+
+		SystemVariableManager::Instance().SetSavingToFile(true);
+
+		// normal render
+		if (!opts.Sequence) {
+			if (actualSizeX > 0 && actualSizeY > 0) {
+				SystemVariableManager::Instance().CopyState();
+
+				SystemVariableManager::Instance().SetTimeDelta(opts.TimeDelta);
+				SystemVariableManager::Instance().SetFrameIndex(opts.FrameIndex);
+				SystemVariableManager::Instance().SetKeysWASD(opts.WASD[0], opts.WASD[1], opts.WASD[2], opts.WASD[3]);
+				SystemVariableManager::Instance().SetMousePosition(opts.Mouse.x, opts.Mouse.y);
+				SystemVariableManager::Instance().SetMouse(opts.Mouse.x, opts.Mouse.y, opts.Mouse.z, opts.Mouse.w);
+
+				renderer->Render(actualSizeX, actualSizeY);
+
+				SystemVariableManager::Instance().AdvanceTimer(opts.CachedTime - opts.Time);
+			}
+
+			unsigned char* pixels = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
+			unsigned char* outPixels = nullptr;
+
+			if (sizeMulti != 1)
+				outPixels = (unsigned char*)malloc(opts.Size.x * opts.Size.y * 4);
+			else
+				outPixels = pixels;
+
+			GLuint tex = renderer->GetTexture();
+			glBindTexture(GL_TEXTURE_2D, tex);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			// resize image
+			if (sizeMulti != 1) {
+				stbir_resize_uint8(pixels, actualSizeX, actualSizeY, actualSizeX * 4,
+					outPixels, opts.Size.x, opts.Size.y, opts.Size.x * 4, 4);
+			}
+
+			std::string ext = opts.Path.substr(opts.Path.find_last_of('.') + 1);
+
+			if (ext == "jpg" || ext == "jpeg")
+				stbi_write_jpg(opts.Path.c_str(), opts.Size.x, opts.Size.y, 4, outPixels, 100);
+			else if (ext == "bmp")
+				stbi_write_bmp(opts.Path.c_str(), opts.Size.x, opts.Size.y, 4, outPixels);
+			else if (ext == "tga")
+				stbi_write_tga(opts.Path.c_str(), opts.Size.x, opts.Size.y, 4, outPixels);
+			else
+				stbi_write_png(opts.Path.c_str(), opts.Size.x, opts.Size.y, 4, outPixels, opts.Size.x * 4);
+
+			if (sizeMulti != 1) free(outPixels);
+			free(pixels);
+		} 
+		else { // sequence render
+			float seqDelta = 1.0f / opts.SequenceFPS;
+
+			if (actualSizeX > 0 && actualSizeY > 0) {
+				SystemVariableManager::Instance().SetKeysWASD(opts.WASD[0], opts.WASD[1], opts.WASD[2], opts.WASD[3]);
+				SystemVariableManager::Instance().SetMousePosition(opts.Mouse.x, opts.Mouse.y);
+				SystemVariableManager::Instance().SetMouse(opts.Mouse.x, opts.Mouse.y, opts.Mouse.z, opts.Mouse.w);
+
+				float curTime = 0.0f;
+
+				GLuint tex = renderer->GetTexture();
+
+				size_t lastDot = opts.Path.find_last_of('.');
+				std::string ext = lastDot == std::string::npos ? "png" : opts.Path.substr(lastDot + 1);
+				std::string filename = opts.Path;
+
+				// allow only one %??d
+				bool inFormat = false;
+				int lastFormatPos = -1;
+				int formatCount = 0;
+				for (int i = 0; i < filename.size(); i++) {
+					if (filename[i] == '%') {
+						inFormat = true;
+						lastFormatPos = i;
+						continue;
+					}
+
+					if (inFormat) {
+						if (isdigit(filename[i])) {
+						} else {
+							if (filename[i] != '%' && ((filename[i] == 'd' && formatCount > 0) || (filename[i] != 'd'))) {
+								filename.insert(lastFormatPos, 1, '%');
+							}
+
+							if (filename[i] == 'd')
+								formatCount++;
+							inFormat = false;
+						}
+					}
+				}
+
+				// no %d found? add one
+				if (formatCount == 0) {
+					int frameCountDigits = log10((int)(opts.SequenceDuration / seqDelta)) + 1;
+					filename.insert(lastDot == std::string::npos ? filename.size() : lastDot, "%0" + std::to_string(frameCountDigits) + "d"); // frame%d
+				}
+
+				SystemVariableManager::Instance().AdvanceTimer(opts.CachedTime - opts.TimeDelta);
+				SystemVariableManager::Instance().SetTimeDelta(seqDelta);
+
+				stbi_write_png_compression_level = 5; // set to lowest compression level
+
+				int tCount = std::thread::hardware_concurrency();
+				tCount = tCount == 0 ? 2 : tCount;
+
+				size_t frameSize = actualSizeX * actualSizeY * 4;
+
+				// frames waiting for an encoder hold one of these buffers - limits the memory usage and
+				// stops the GPU from running too far ahead of the encoders
+				int bufferCount = tCount + EXPORT_IMAGE_PBO_COUNT;
+				FrameQueue freeFrames(bufferCount), readyFrames(bufferCount);
+				std::vector<unsigned char*> buffers(bufferCount);
+				for (int i = 0; i < bufferCount; i++) {
+					buffers[i] = (unsigned char*)malloc(frameSize);
+					freeFrames.Push(FrameQueue::Frame { buffers[i], -1 });
+				}
+
+				std::vector<std::thread> threadPool;
+				for (int i = 0; i < tCount; i++) {
+					threadPool.push_back(std::thread([&, ext, filename](int w, int h) {
+						unsigned char* outPixels = nullptr;
+						if (sizeMulti != 1)
+							outPixels = (unsigned char*)malloc(w * h * 4);
+
+						char prevSavePath[SHADERED_MAX_PATH];
+						FrameQueue::Frame frame;
+						while (readyFrames.Pop(frame)) {
+							unsigned char* data = frame.Pixels;
+
+							// resize image
+							if (sizeMulti != 1) {
+								stbir_resize_uint8(frame.Pixels, actualSizeX, actualSizeY, actualSizeX * 4,
+									outPixels, w, h, w * 4, 4);
+								data = outPixels;
+							}
+
+							snprintf(prevSavePath, SHADERED_MAX_PATH, filename.c_str(), frame.Index);
+
+							if (ext == "jpg" || ext == "jpeg")
+								stbi_write_jpg(prevSavePath, w, h, 4, data, 100);
+							else if (ext == "bmp")
+								stbi_write_bmp(prevSavePath, w, h, 4, data);
+							else if (ext == "tga")
+								stbi_write_tga(prevSavePath, w, h, 4, data);
+							else
+								stbi_write_png(prevSavePath, w, h, 4, data, w * 4);
+
+							freeFrames.Push(frame);
+						}
+
+						if (outPixels != nullptr)
+							free(outPixels);
+					},
+						opts.Size.x, opts.Size.y));
+				}
+
+				// read the frames back asynchronously through a ring of PBOs - frame N is copied to the
+				// CPU while frames N+1 ... N+EXPORT_IMAGE_PBO_COUNT-1 are being rendered
+				GLuint pbos[EXPORT_IMAGE_PBO_COUNT];
+				GLsync fences[EXPORT_IMAGE_PBO_COUNT];
+				int pboFrame[EXPORT_IMAGE_PBO_COUNT];
+				glGenBuffers(EXPORT_IMAGE_PBO_COUNT, pbos);
+				for (int i = 0; i < EXPORT_IMAGE_PBO_COUNT; i++) {
+					glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+					glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, nullptr, GL_STREAM_READ);
+					fences[i] = 0;
+					pboFrame[i] = 0;
+				}
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+				auto readPBO = [&](int slot) {
+					while (glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) { }
+					glDeleteSync(fences[slot]);
+					fences[slot] = 0;
+
+					FrameQueue::Frame frame;
+					freeFrames.Pop(frame);
+					frame.Index = pboFrame[slot];
+
+					glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+					void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameSize, GL_MAP_READ_BIT);
+					if (mapped != nullptr) {
+						memcpy(frame.Pixels, mapped, frameSize);
+						glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+						readyFrames.Push(frame);
+					} else {
+						Logger::Get().Log("Failed to map the pixel buffer for frame " + std::to_string(frame.Index), true);
+						freeFrames.Push(frame);
+					}
+					glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+				};
+
+				auto timeStart = std::chrono::steady_clock::now();
+
+				int globalFrame = 0;
+				while (curTime < opts.SequenceDuration) {
+					int slot = globalFrame % EXPORT_IMAGE_PBO_COUNT;
+					if (fences[slot] != 0)
+						readPBO(slot);
+
+					SystemVariableManager::Instance().CopyState();
+					SystemVariableManager::Instance().SetFrameIndex(opts.FrameIndex + globalFrame);
+
+					renderer->Render(actualSizeX, actualSizeY);
+
+					glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+					glBindTexture(GL_TEXTURE_2D, tex);
+					glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+					glBindTexture(GL_TEXTURE_2D, 0);
+					glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+					fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+					pboFrame[slot] = globalFrame;
+
+					SystemVariableManager::Instance().AdvanceTimer(seqDelta);
+
+					curTime += seqDelta;
+					globalFrame++;
+				}
+
+				// frames that are still in the PBOs (oldest first)
+				for (int i = 0; i < EXPORT_IMAGE_PBO_COUNT; i++) {
+					int slot = (globalFrame + i) % EXPORT_IMAGE_PBO_COUNT;
+					if (fences[slot] != 0)
+						readPBO(slot);
+				}
+				glDeleteBuffers(EXPORT_IMAGE_PBO_COUNT, pbos);
+
+				readyFrames.Close();
+				for (std::thread& thread : threadPool)
+					thread.join();
+				for (unsigned char* buffer : buffers)
+					free(buffer);
+
+				float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - timeStart).count();
+				Logger::Get().Log("Saved " + std::to_string(globalFrame) + " frames in " + std::to_string(elapsed) + "s (" + std::to_string(elapsed > 0.0f ? globalFrame / elapsed : 0.0f) + " FPS)");
+
+				stbi_write_png_compression_level = 8; // set back to default compression level
+			}
+		}
+
+		SystemVariableManager::Instance().SetSavingToFile(false);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+
+namespace ed {
+	class RenderEngine;
+
+	struct ExportImageOptions {
+		ExportImageOptions()
+		{
+			Supersample = 1;
+			Time = CachedTime = TimeDelta = 0.0f;
+			FrameIndex = 0;
+			WASD[0] = WASD[1] = WASD[2] = WASD[3] = false;
+			Mouse = glm::vec4(0.0f);
+			Sequence = false;
+			SequenceDuration = 0.0f;
+			SequenceFPS = 30;
+		}
+
+		std::string Path;
+		glm::ivec2 Size;
+		int Supersample; // 1, 2, 4 or 8
+
+		float Time, CachedTime, TimeDelta;
+		int FrameIndex;
+		bool WASD[4];
+		glm::vec4 Mouse;
+
+		bool Sequence;
+		float SequenceDuration;
+		int SequenceFPS;
+	};
+
+	// renders the preview and writes it (or a sequence of frames) to the disk - doesn't depend on the UI
+	// so that it can also be used when rendering from the command line
+	class ExportImage {
+	public:
+		static void Export(RenderEngine* renderer, const ExportImageOptions& opts);
+	};
+}
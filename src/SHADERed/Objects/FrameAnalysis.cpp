@@ -3,6 +3,7 @@
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/Names.h>
 #include <SHADERed/Objects/BinaryVectorReader.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
 #include <SHADERed/Engine/GeometryFactory.h>
 
 #include <thread>
@@ -42,19 +43,48 @@ namespace ed {
 
 		return (color[id2] - color[id1]) * value + color[id1];
 	}
+	// FNV-1a
+	static uint64_t hashAnalysisInput(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+	template <typename T>
+	static uint64_t hashAnalysisInput(uint64_t hash, const T& value)
+	{
+		return hashAnalysisInput(hash, &value, sizeof(T));
+	}
+	const uint64_t ANALYSIS_HASH_SEED = 14695981039346656037ULL;
 
 	FrameAnalysis::FrameAnalysis(DebugInformation* dbgr, RenderEngine* renderer, PipelineManager* pipeline, ObjectManager* objects, MessageStack* msgs)
 	{
 		m_depth = nullptr;
 		m_color = nullptr;
+		m_base = nullptr;
 		m_instCount = nullptr;
 		m_ub = nullptr;
 		m_pass = nullptr;
 		m_bkpt = nullptr;
+		m_coverage = nullptr;
+		m_pixelStats = nullptr;
+		m_dirty = nullptr;
 
 		m_width = 0;
 		m_height = 0;
+		m_clearColor = 0;
 		m_hasBreakpoints = false;
+		m_breakpointHash = 0;
+		m_setupHash = 0;
+		m_resultsValid = false;
+		m_dirtyOnly = m_coverageOnly = false;
+		m_renderMask = ~0ULL;
+		m_itemIndex = -1;
+		m_itemBit = 0;
+		m_pixelsAnalyzed = 0;
 		m_isRegion = false;
 		m_instCountAvg = m_instCountAvgN = m_instCountMax = 0;
 		m_pixelCount = m_pixelsDiscarded = m_pixelsUB = m_pixelsFailedDepthTest = 0;
@@ -67,13 +97,76 @@ namespace ed {
 		m_msgs = msgs;
 
 		m_pixelHistoryLocation = glm::ivec2(-1, -1);
+
+		m_workerCount = std::max<int>(1, std::thread::hardware_concurrency());
+		m_workerGeneration = 0;
+		m_workersBusy = 0;
+		m_workersExit = false;
+		m_nextBlock = 0;
 	}
 	FrameAnalysis::~FrameAnalysis()
 	{
+		m_stopWorkers();
 		m_cleanBreakpoints();
 		m_clean();
 	}
 
+	void FrameAnalysis::m_startWorkers()
+	{
+		if (!m_workers.empty())
+			return;
+
+		m_workersExit = false;
+		for (int i = 1; i < m_workerCount; i++)
+			m_workers.push_back(std::thread(&FrameAnalysis::m_workerLoop, this, i, m_workerGeneration));
+	}
+	void FrameAnalysis::m_stopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_workerMutex);
+			m_workersExit = true;
+		}
+		m_workerStart.notify_all();
+
+		for (std::thread& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+	}
+	void FrameAnalysis::m_workerLoop(int worker, uint32_t generation)
+	{
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(m_workerMutex);
+				m_workerStart.wait(lock, [&] { return m_workersExit || m_workerGeneration != generation; });
+				if (m_workersExit)
+					return;
+				generation = m_workerGeneration;
+			}
+
+			m_shadeBlocks(worker);
+
+			{
+				std::lock_guard<std::mutex> lock(m_workerMutex);
+				m_workersBusy--;
+			}
+			m_workerDone.notify_one();
+		}
+	}
+	void FrameAnalysis::m_shadeBlocks(int worker)
+	{
+		// small triangles don't get a VM for every worker thread
+		if (worker >= m_debugger->GetPixelShaderWorkerCount())
+			return;
+
+		size_t index = 0;
+		while ((index = m_nextBlock++) < m_blocks.size()) {
+			if (m_hasBreakpoints)
+				m_renderBlock<true>(m_debugger, worker, m_blocks[index]);
+			else
+				m_renderBlock<false>(m_debugger, worker, m_blocks[index]);
+		}
+	}
+
 	std::vector<unsigned int>* FrameAnalysis::m_getPixelShaderSPV(const char* path)
 	{
 		for (auto& pass : m_pipeline->GetList()) {
@@ -88,14 +181,15 @@ namespace ed {
 		return nullptr;
 	}
 
-	void FrameAnalysis::m_cacheBreakpoint(int i)
+	void FrameAnalysis::m_cacheBreakpoint(int i, int worker)
 	{
 		ExpressionCompiler compiler;
 		compiler.SetSPIRV(*m_getPixelShaderSPV(m_breakpoint[i].PSPath));
 
+		spvm_state_t workerVM = m_debugger->GetPixelShaderWorker(worker);
 		std::string curFunction = "";
-		if (m_debugger->GetVM()->current_function != nullptr)
-			curFunction = m_debugger->GetVM()->current_function->name;
+		if (workerVM->current_function != nullptr)
+			curFunction = workerVM->current_function->name;
 		m_breakpoint[i].ResultID = compiler.Compile(m_breakpoint[i].Breakpoint->Condition, curFunction);
 
 		compiler.GetSPIRV(m_breakpoint[i].SPIRV);
@@ -107,19 +201,23 @@ namespace ed {
 
 		m_breakpoint[i].VariableList = compiler.GetVariableList();
 		m_breakpoint[i].Shader = spvm_program_create(m_debugger->GetVMContext(), (spvm_source)m_breakpoint[i].SPIRV.data(), m_breakpoint[i].SPIRV.size());
-		m_breakpoint[i].VM = _spvm_state_create_base(m_breakpoint[i].Shader, true, 0);
-
-		// can't use set_extenstion() function because for some reason two GLSL.std.450 instructions are generated with spvgentwo
-		for (int j = 0; j < m_breakpoint[i].Shader->bound; j++)
-			if (m_breakpoint[i].VM->results[j].name)
-				if (strcmp(m_breakpoint[i].VM->results[j].name, "GLSL.std.450") == 0)
-					m_breakpoint[i].VM->results[j].extension = m_debugger->GetGLSLExtension();
+		m_breakpoint[i].VM.resize(m_workerCount);
+		for (spvm_state_t& vm : m_breakpoint[i].VM) {
+			vm = _spvm_state_create_base(m_breakpoint[i].Shader, true, 0);
+
+			// can't use set_extenstion() function because for some reason two GLSL.std.450 instructions are generated with spvgentwo
+			for (int j = 0; j < m_breakpoint[i].Shader->bound; j++)
+				if (vm->results[j].name)
+					if (strcmp(vm->results[j].name, "GLSL.std.450") == 0)
+						vm->results[j].extension = m_debugger->GetGLSLExtension();
+		}
 
 		m_breakpoint[i].Cached = true;
 	}
-	spvm_result_t FrameAnalysis::m_executeBreakpoint(int index, spvm_result_t& returnType)
+	spvm_result_t FrameAnalysis::m_executeBreakpoint(int index, int worker, spvm_result_t& returnType)
 	{
-		spvm_state_t vm = m_breakpoint[index].VM;
+		spvm_state_t vm = m_breakpoint[index].VM[worker];
+		spvm_state_t workerVM = m_debugger->GetPixelShaderWorker(worker);
 		spvm_program_t program = m_breakpoint[index].Shader;
 		const std::vector<std::string>& varList = m_breakpoint[index].VariableList;
 
@@ -128,7 +226,7 @@ namespace ed {
 		for (int i = 0; i < varList.size(); i++) {
 			size_t varValueCount = 0;
 			spvm_result_t varType = nullptr;
-			spvm_member_t varValue = m_debugger->GetVariable(varList[i], varValueCount, varType);
+			spvm_member_t varValue = m_debugger->GetVariableFromState(workerVM, varList[i], varValueCount, varType);
 
 			if (varValue == nullptr)
 				continue;
@@ -151,15 +249,15 @@ namespace ed {
 
 					if (vm->derivative_used) {
 						if (vm->derivative_group_x) {
-							spvm_member_memcpy(vm->derivative_group_x->results[j].members, m_debugger->GetVariableFromState(m_debugger->GetVM()->derivative_group_x, varList[i], varValueCount), varValueCount);
+							spvm_member_memcpy(vm->derivative_group_x->results[j].members, m_debugger->GetVariableFromState(workerVM->derivative_group_x, varList[i], varValueCount), varValueCount);
 							pointerToVariable[1] = &vm->derivative_group_x->results[j];
 						}
 						if (vm->derivative_group_y) {
-							spvm_member_memcpy(vm->derivative_group_y->results[j].members, m_debugger->GetVariableFromState(m_debugger->GetVM()->derivative_group_y, varList[i], varValueCount), varValueCount);
+							spvm_member_memcpy(vm->derivative_group_y->results[j].members, m_debugger->GetVariableFromState(workerVM->derivative_group_y, varList[i], varValueCount), varValueCount);
 							pointerToVariable[2] = &vm->derivative_group_y->results[j];
 						}
 						if (vm->derivative_group_d) {
-							spvm_member_memcpy(vm->derivative_group_d->results[j].members, m_debugger->GetVariableFromState(m_debugger->GetVM()->derivative_group_d, varList[i], varValueCount), varValueCount);
+							spvm_member_memcpy(vm->derivative_group_d->results[j].members, m_debugger->GetVariableFromState(workerVM->derivative_group_d, varList[i], varValueCount), varValueCount);
 							pointerToVariable[3] = &vm->derivative_group_d->results[j];
 						}
 					}
@@ -203,7 +301,8 @@ namespace ed {
 	{
 		for (int i = 0; i < m_breakpoint.size(); i++) {
 			if (m_breakpoint[i].SPIRV.size() > 1) {
-				spvm_state_delete(m_breakpoint[i].VM);
+				for (spvm_state_t vm : m_breakpoint[i].VM)
+					spvm_state_delete(vm);
 				spvm_program_delete(m_breakpoint[i].Shader);
 			}
 		}
@@ -224,6 +323,11 @@ namespace ed {
 			m_color = nullptr;
 		}
 
+		if (m_base != nullptr) {
+			free(m_base);
+			m_base = nullptr;
+		}
+
 		if (m_instCount != nullptr) {
 			free(m_instCount);
 			m_instCount = nullptr;
@@ -238,6 +342,23 @@ namespace ed {
 			free(m_bkpt);
 			m_bkpt = nullptr;
 		}
+
+		if (m_coverage != nullptr) {
+			free(m_coverage);
+			m_coverage = nullptr;
+		}
+
+		if (m_pixelStats != nullptr) {
+			free(m_pixelStats);
+			m_pixelStats = nullptr;
+		}
+
+		if (m_dirty != nullptr) {
+			free(m_dirty);
+			m_dirty = nullptr;
+		}
+
+		m_resultsValid = false;
 	}
 	void FrameAnalysis::m_copyVBOData(eng::Model::Mesh::Vertex& vertex, GLfloat* vbo, int stride)
 	{
@@ -254,9 +375,9 @@ namespace ed {
 		}
 	}
 
-	glm::vec4 FrameAnalysis::m_executePixelShaderWithBreakpoints(int x, int y, uint8_t& res, int loc)
+	glm::vec4 FrameAnalysis::m_executePixelShaderWithBreakpoints(int worker, int x, int y, uint8_t& res, int loc)
 	{
-		spvm_state_t vm = m_debugger->GetVM();
+		spvm_state_t vm = m_debugger->GetPixelShaderWorker(worker);
 		if (vm == nullptr)
 			return glm::vec4(0.0f);
 
@@ -273,13 +394,18 @@ namespace ed {
 				for (uint8_t i = 0; i < m_breakpoint.size(); i++) {
 					if (m_breakpoint[i].Breakpoint->Line == vm->current_line) {
 						if (m_breakpoint[i].Breakpoint->IsConditional && (res & (1 << i)) == 0) { // only run conditional breakpoint if needed
-							if (!m_breakpoint[i].Cached) {
-								m_cacheBreakpoint(i);
-								m_breakpoint[i].Cached = true;
+							{
+								std::lock_guard<std::mutex> lock(m_breakpointMutex);
+								if (!m_breakpoint[i].Cached) {
+									m_cacheBreakpoint(i, worker);
+									m_breakpoint[i].Cached = true;
+								}
 							}
+							if (m_breakpoint[i].SPIRV.empty())
+								continue;
 							
 							spvm_result_t resultType = nullptr;
-							spvm_result_t result = m_executeBreakpoint(i, resultType);
+							spvm_result_t result = m_executeBreakpoint(i, worker, resultType);
 							if (result && resultType->value_type == spvm_value_type_bool && result->member_count == 1)
 								res |= (result->members[0].value.b << i);
 						} else
@@ -290,36 +416,40 @@ namespace ed {
 			}
 		}
 
-		return m_debugger->GetPixelShaderOutput(loc);
+		return m_debugger->GetPixelShaderWorkerOutput(worker, loc);
 	}
 
 	void FrameAnalysis::Init(size_t width, size_t height, const glm::vec4& clearColor)
 	{
-		m_clean();
-
-		m_depth = (float*)malloc(width * height * sizeof(float));
-		m_color = (uint32_t*)malloc(width * height * sizeof(uint32_t));
-		m_instCount = (uint32_t*)calloc(width * height, sizeof(uint32_t));
-		m_ub = (uint32_t*)calloc(width * height, sizeof(uint32_t));
+		// results of the previous analysis are kept so that Analyze() can reuse them
+		if (m_color == nullptr || width != m_width || height != m_height) {
+			m_clean();
+
+			m_depth = (float*)malloc(width * height * sizeof(float));
+			m_color = (uint32_t*)malloc(width * height * sizeof(uint32_t));
+			m_base = (uint32_t*)malloc(width * height * sizeof(uint32_t));
+			m_instCount = (uint32_t*)calloc(width * height, sizeof(uint32_t));
+			m_ub = (uint32_t*)calloc(width * height, sizeof(uint32_t));
+			m_coverage = (uint64_t*)calloc(width * height, sizeof(uint64_t));
+			m_pixelStats = (PixelStatistics*)calloc(width * height, sizeof(PixelStatistics));
+			m_dirty = (uint8_t*)calloc(width * height, sizeof(uint8_t));
+		}
 
-		if (m_hasBreakpoints)
+		if (m_hasBreakpoints && m_bkpt == nullptr)
 			m_bkpt = (uint8_t*)calloc(width * height, sizeof(uint8_t));
+		else if (!m_hasBreakpoints && m_bkpt != nullptr) {
+			free(m_bkpt);
+			m_bkpt = nullptr;
+		}
 
-		uint32_t clearColorU32 = m_encodeColor(clearColor);
+		m_clearColor = m_encodeColor(clearColor);
 
-		for (size_t x = 0; x < width; x++)
-			for (size_t y = 0; y < height; y++) {
-				m_color[y * width + x] = clearColorU32;
-				m_depth[y * width + x] = FLT_MAX;
-			}
+		for (size_t i = 0; i < width * height; i++)
+			m_base[i] = m_clearColor;
 
 		m_width = width;
 		m_height = height;
 
-		m_instCountAvg = m_instCountAvgN = m_instCountMax = 0;
-		m_pixelCount = m_pixelsDiscarded = m_pixelsUB = m_pixelsFailedDepthTest = 0;
-		m_triangleCount = m_trianglesDiscarded = 0;
-
 		m_isRegion = false;
 
 		// check if we need to collect pixel history
@@ -339,7 +469,7 @@ namespace ed {
 		for (size_t x = 0; x < width; x++)
 			for (size_t y = 0; y < height; y++) {
 				uint8_t* px = &pixels[(y * width + x) * 4];
-				m_color[y * width + x] = px[0] | px[1] << 8 | px[2] << 16 | 0x77000000;
+				m_base[y * width + x] = px[0] | px[1] << 8 | px[2] << 16 | 0x77000000;
 			}
 
 		free(pixels);
@@ -356,18 +486,306 @@ namespace ed {
 	{
 		m_cleanBreakpoints();
 
+		m_breakpointHash = ANALYSIS_HASH_SEED;
 		m_breakpoint.resize(breakpoints.size());
 		for (int i = 0; i < m_breakpoint.size(); i++) {
 			m_breakpoint[i].Breakpoint = breakpoints[i];
 			m_breakpoint[i].Color = bkptColors[i];
 			m_breakpoint[i].PSPath = bkptPaths[i];
 
-			m_breakpoint[i].VM = nullptr;
+			m_breakpoint[i].Cached = false;
 			m_breakpoint[i].Shader = nullptr;
+
+			m_breakpointHash = hashAnalysisInput(m_breakpointHash, breakpoints[i]->Line);
+			m_breakpointHash = hashAnalysisInput(m_breakpointHash, breakpoints[i]->IsConditional);
+			m_breakpointHash = hashAnalysisInput(m_breakpointHash, breakpoints[i]->Condition.c_str(), breakpoints[i]->Condition.size() + 1);
+			m_breakpointHash = hashAnalysisInput(m_breakpointHash, bkptColors[i]);
+			m_breakpointHash = hashAnalysisInput(m_breakpointHash, bkptPaths[i], strlen(bkptPaths[i]) + 1);
 		}
 		m_hasBreakpoints = m_breakpoint.size() > 0;
 	}
 
+	void FrameAnalysis::Analyze(const std::vector<PipelineItem*>& passes)
+	{
+		// items in the order in which RenderPass() renders them
+		std::vector<AnalyzedItem> items;
+		for (PipelineItem* pass : passes) {
+			if (pass->Type != PipelineItem::ItemType::ShaderPass)
+				continue;
+
+			for (PipelineItem* item : ((pipe::ShaderPass*)pass->Data)->Items) {
+				if (item->Type != PipelineItem::ItemType::Geometry && item->Type != PipelineItem::ItemType::Model && item->Type != PipelineItem::ItemType::VertexBuffer)
+					continue;
+
+				AnalyzedItem analyzed;
+				analyzed.Pass = pass;
+				analyzed.Item = item;
+				analyzed.Hash = m_hashItem(pass, item);
+				analyzed.Triangles = analyzed.TrianglesDiscarded = 0;
+				items.push_back(analyzed);
+			}
+		}
+
+		uint64_t setupHash = ANALYSIS_HASH_SEED;
+		setupHash = hashAnalysisInput(setupHash, m_clearColor);
+		setupHash = hashAnalysisInput(setupHash, m_isRegion);
+		if (m_isRegion) {
+			setupHash = hashAnalysisInput(setupHash, m_regionX);
+			setupHash = hashAnalysisInput(setupHash, m_regionY);
+			setupHash = hashAnalysisInput(setupHash, m_regionEndX);
+			setupHash = hashAnalysisInput(setupHash, m_regionEndY);
+		}
+		setupHash = hashAnalysisInput(setupHash, m_pixelHistoryLocation);
+		setupHash = hashAnalysisInput(setupHash, m_renderer->GetLastRenderSize());
+		setupHash = hashAnalysisInput(setupHash, m_hasBreakpoints ? m_breakpointHash : 0);
+
+		// find the items that changed since the last analysis
+		bool incremental = m_resultsValid && setupHash == m_setupHash && items.size() == m_items.size() && items.size() <= ANALYSIS_MAX_TRACKED_ITEMS;
+		uint64_t changed = 0;
+		for (int i = 0; incremental && i < items.size(); i++) {
+			if (items[i].Pass != m_items[i].Pass || items[i].Item != m_items[i].Item)
+				incremental = false;
+			else if (items[i].Hash != m_items[i].Hash)
+				changed |= 1ULL << i;
+			else {
+				items[i].Triangles = m_items[i].Triangles;
+				items[i].TrianglesDiscarded = m_items[i].TrianglesDiscarded;
+			}
+		}
+
+		// nothing to reuse if every item changed
+		uint64_t allItems = items.size() >= ANALYSIS_MAX_TRACKED_ITEMS ? ~0ULL : ((1ULL << items.size()) - 1);
+		if (incremental && changed == allItems)
+			incremental = false;
+
+		m_items = items;
+		m_setupHash = setupHash;
+		m_resultsValid = true;
+
+		if (!incremental)
+			m_analyzeAll(passes);
+		else {
+			// the debugger's pixel list is cleared before each analysis, so the history pixel is always shaded again
+			if (changed != 0 || m_pixelHistoryLocation.x >= 0)
+				m_analyzeChanged(passes, changed);
+			else
+				m_pixelsAnalyzed = 0;
+
+			// the copied texture might have changed too
+			for (size_t i = 0; i < m_width * m_height; i++)
+				if (m_pixelStats[i].Shaded == 0)
+					m_color[i] = m_base[i];
+		}
+
+		m_updateStatistics();
+	}
+	void FrameAnalysis::m_analyzeAll(const std::vector<PipelineItem*>& passes)
+	{
+		for (size_t i = 0; i < m_width * m_height; i++)
+			m_resetPixel(i);
+		memset(m_coverage, 0, m_width * m_height * sizeof(uint64_t));
+
+		m_renderMask = ~0ULL;
+		m_itemIndex = -1;
+		for (PipelineItem* pass : passes)
+			RenderPass(pass);
+
+		m_pixelsAnalyzed = m_width * m_height;
+	}
+	void FrameAnalysis::m_analyzeChanged(const std::vector<PipelineItem*>& passes, uint64_t changed)
+	{
+		// pixels that the changed items covered in the previous analysis
+		for (size_t i = 0; i < m_width * m_height; i++) {
+			m_dirty[i] = (m_coverage[i] & changed) != 0;
+			m_coverage[i] &= ~changed;
+		}
+
+		// ... and the pixels that they cover now
+		for (int i = 0; i < m_items.size(); i++) {
+			if (changed & (1ULL << i))
+				m_items[i].Triangles = m_items[i].TrianglesDiscarded = 0;
+		}
+		m_coverageOnly = true;
+		m_renderMask = changed;
+		m_itemIndex = -1;
+		for (PipelineItem* pass : passes)
+			RenderPass(pass);
+		m_coverageOnly = false;
+
+		if (m_pixelHistoryLocation.x >= 0 && m_pixelHistoryLocation.x < m_width && m_pixelHistoryLocation.y >= 0 && m_pixelHistoryLocation.y < m_height)
+			m_dirty[m_pixelHistoryLocation.y * m_width + m_pixelHistoryLocation.x] = 1;
+
+		// every item that covers a dirty pixel is rendered again (in the same order) to get the same depth test results
+		int blocksX = (m_width + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+		int blocksY = (m_height + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+		m_dirtyBlocks.assign(blocksX * blocksY, 0);
+
+		uint64_t rerender = 0;
+		m_pixelsAnalyzed = 0;
+		for (int y = 0; y < m_height; y++) {
+			for (int x = 0; x < m_width; x++) {
+				size_t index = y * m_width + x;
+				if (!m_dirty[index])
+					continue;
+
+				rerender |= m_coverage[index];
+				m_resetPixel(index);
+				m_dirtyBlocks[(y / RASTER_BLOCK_SIZE) * blocksX + x / RASTER_BLOCK_SIZE] = 1;
+				m_pixelsAnalyzed++;
+			}
+		}
+
+		m_dirtyOnly = true;
+		m_renderMask = rerender;
+		m_itemIndex = -1;
+		for (PipelineItem* pass : passes)
+			RenderPass(pass);
+		m_dirtyOnly = false;
+	}
+	void FrameAnalysis::m_resetPixel(size_t index)
+	{
+		m_color[index] = m_base[index];
+		m_depth[index] = FLT_MAX;
+		m_instCount[index] = 0;
+		m_ub[index] = 0;
+		memset(&m_pixelStats[index], 0, sizeof(PixelStatistics));
+		if (m_bkpt != nullptr)
+			m_bkpt[index] = 0;
+	}
+	bool FrameAnalysis::m_beginItem(PipelineItem* item)
+	{
+		if (item->Type != PipelineItem::ItemType::Geometry && item->Type != PipelineItem::ItemType::Model && item->Type != PipelineItem::ItemType::VertexBuffer)
+			return false;
+
+		m_itemIndex++;
+		m_itemBit = m_itemIndex < ANALYSIS_MAX_TRACKED_ITEMS ? (1ULL << m_itemIndex) : 0;
+
+		// items that aren't tracked are always rendered (only happens when everything is analyzed)
+		return m_itemBit == 0 || (m_renderMask & m_itemBit) != 0;
+	}
+	uint64_t FrameAnalysis::m_hashItem(PipelineItem* pass, PipelineItem* item)
+	{
+		pipe::ShaderPass* data = (pipe::ShaderPass*)pass->Data;
+		uint64_t hash = ANALYSIS_HASH_SEED;
+
+		// shaders
+		hash = hashAnalysisInput(hash, data->VSSPV.data(), data->VSSPV.size() * sizeof(unsigned int));
+		hash = hashAnalysisInput(hash, data->PSSPV.data(), data->PSSPV.size() * sizeof(unsigned int));
+		hash = hashAnalysisInput(hash, data->GSUsed);
+		if (data->GSUsed)
+			hash = hashAnalysisInput(hash, data->GSSPV.data(), data->GSSPV.size() * sizeof(unsigned int));
+		for (const InputLayoutItem& layItem : data->InputLayout)
+			hash = hashAnalysisInput(hash, layItem.Value);
+
+		// variables, with the values that the debugger will use for this item
+		SystemVariableManager::Instance().SetViewportSize(m_renderer->GetLastRenderSize().x, m_renderer->GetLastRenderSize().y);
+		const auto& itemVars = m_renderer->GetItemVariableValues();
+		for (ShaderVariable* var : data->Variables.GetVariables()) {
+			// depend only on the item's properties which are hashed below
+			if (var->System == SystemShaderVariable::GeometryTransform || var->System == SystemShaderVariable::IsPicked)
+				continue;
+
+			SystemVariableManager::Instance().Update(var, item);
+
+			ShaderVariable* actualVar = var;
+			for (const auto& iVar : itemVars)
+				if (iVar.Item == item && iVar.Variable == var) {
+					actualVar = iVar.NewValue;
+					break;
+				}
+
+			hash = hashAnalysisInput(hash, actualVar->Data, ShaderVariable::GetSize(actualVar->GetType()));
+		}
+
+		// textures & buffers - dynamic ones (render textures, buffers, ...) change every frame
+		for (GLuint tex : m_objects->GetBindList(pass)) {
+			hash = hashAnalysisInput(hash, tex);
+			hash = hashAnalysisInput(hash, m_objects->GetTextureGeneration(m_objects->GetByTextureID(tex)));
+		}
+		for (GLuint buf : m_objects->GetUniformBindList(pass)) {
+			hash = hashAnalysisInput(hash, buf);
+			hash = hashAnalysisInput(hash, m_objects->GetTextureGeneration(m_objects->GetByBufferID(buf)));
+		}
+
+		// geometry
+		hash = hashAnalysisInput(hash, item->Type);
+		hash = hashAnalysisInput(hash, m_renderer->IsPicked(item));
+		if (item->Type == PipelineItem::ItemType::Geometry) {
+			pipe::GeometryItem* geom = (pipe::GeometryItem*)item->Data;
+			hash = hashAnalysisInput(hash, geom->Type);
+			hash = hashAnalysisInput(hash, geom->Topology);
+			hash = hashAnalysisInput(hash, geom->VBO);
+			hash = hashAnalysisInput(hash, geom->Position);
+			hash = hashAnalysisInput(hash, geom->Rotation);
+			hash = hashAnalysisInput(hash, geom->Scale);
+			hash = hashAnalysisInput(hash, geom->Size);
+		} else if (item->Type == PipelineItem::ItemType::Model) {
+			pipe::Model* mdl = (pipe::Model*)item->Data;
+			hash = hashAnalysisInput(hash, mdl->Data);
+			hash = hashAnalysisInput(hash, mdl->Position);
+			hash = hashAnalysisInput(hash, mdl->Rotation);
+			hash = hashAnalysisInput(hash, mdl->Scale);
+		} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
+			pipe::VertexBuffer* vBuffer = (pipe::VertexBuffer*)item->Data;
+			ed::BufferObject* bufData = (ed::BufferObject*)vBuffer->Buffer;
+			hash = hashAnalysisInput(hash, vBuffer->Topology);
+			hash = hashAnalysisInput(hash, vBuffer->Position);
+			hash = hashAnalysisInput(hash, vBuffer->Rotation);
+			hash = hashAnalysisInput(hash, vBuffer->Scale);
+			hash = hashAnalysisInput(hash, bufData->ViewFormat, strlen(bufData->ViewFormat));
+
+			// contents of the buffer
+			uint8_t* bufPtr = (uint8_t*)malloc(bufData->Size);
+			glBindBuffer(GL_ARRAY_BUFFER, bufData->ID);
+			glGetBufferSubData(GL_ARRAY_BUFFER, 0, bufData->Size, bufPtr);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			hash = hashAnalysisInput(hash, bufPtr, bufData->Size);
+			free(bufPtr);
+		}
+
+		return hash;
+	}
+	void FrameAnalysis::m_coverBlock(const RasterBlock& block)
+	{
+		const EdgeEquation& e1 = *m_edges[0];
+		const EdgeEquation& e2 = *m_edges[1];
+		const EdgeEquation& e3 = *m_edges[2];
+
+		for (int x = block.X; x < std::min<int>(m_width, block.X + RASTER_BLOCK_SIZE); x++) {
+			for (int y = block.Y; y < std::min<int>(m_height, block.Y + RASTER_BLOCK_SIZE); y++) {
+				if (block.SkipChecks || (e1.Test(x, y) && e2.Test(x, y) && e3.Test(x, y))) {
+					size_t index = y * m_width + x;
+					m_coverage[index] |= m_itemBit;
+					m_dirty[index] = 1;
+				}
+			}
+		}
+	}
+	void FrameAnalysis::m_updateStatistics()
+	{
+		m_pixelCount = m_pixelsDiscarded = m_pixelsUB = m_pixelsFailedDepthTest = 0;
+		m_instCountMax = 0;
+
+		uint64_t instSum = 0;
+		for (size_t i = 0; i < m_width * m_height; i++) {
+			const PixelStatistics& stats = m_pixelStats[i];
+			m_pixelCount += stats.Shaded;
+			m_pixelsDiscarded += stats.Discarded;
+			m_pixelsUB += stats.UndefinedBehavior;
+			m_pixelsFailedDepthTest += stats.FailedDepthTest;
+			m_instCountMax = std::max<int>(m_instCountMax, stats.InstructionMax);
+			instSum += stats.InstructionSum;
+		}
+		m_instCountAvgN = m_pixelCount;
+		m_instCountAvg = m_pixelCount == 0 ? 0 : instSum / m_pixelCount;
+
+		m_triangleCount = m_trianglesDiscarded = 0;
+		for (const AnalyzedItem& item : m_items) {
+			m_triangleCount += item.Triangles;
+			m_trianglesDiscarded += item.TrianglesDiscarded;
+		}
+	}
+
 	void FrameAnalysis::RenderPass(PipelineItem* pass)
 	{
 		m_pass = pass;
@@ -379,6 +797,9 @@ namespace ed {
 			m_pixel.TessellationShaderUsed = data->TSUsed;
 
 			for (PipelineItem* item : data->Items) {
+				if (!m_beginItem(item))
+					continue;
+
 				// built-in geometry
 				if (item->Type == PipelineItem::ItemType::Geometry) {
 					pipe::GeometryItem* geom = (pipe::GeometryItem*)item->Data;
@@ -549,10 +970,13 @@ namespace ed {
 		EdgeEquation edge2(vert[1], vert[2]);
 		EdgeEquation edge3(vert[2], vert[0]);
 
-		// check if backfacing
-		m_triangleCount++;
+		// check if backfacing - triangles of the items that didn't change are only counted when everything is analyzed
+		bool countTriangles = !m_dirtyOnly && m_itemIndex >= 0 && m_itemIndex < m_items.size();
+		if (countTriangles)
+			m_items[m_itemIndex].Triangles++;
 		if (edge1.c + edge2.c + edge3.c < 0.0f) {
-			m_trianglesDiscarded++;
+			if (countTriangles)
+				m_items[m_itemIndex].TrianglesDiscarded++;
 			return;
 		}
 
@@ -570,12 +994,14 @@ namespace ed {
 		minY &= ~(RASTER_BLOCK_SIZE - 1);
 		maxY &= ~(RASTER_BLOCK_SIZE - 1);
 
-		// init the renderer
-		// TODO: tested with threads, it was 3-4 times faster though there were some artifacts which appeared only *sometimes*... it's really slow rn :(
-		m_debugger->PreparePixelShader(m_pass, item, &m_pixel);
-		m_debugger->ToggleAnalyzer(true); // turn on the analyzer
+		// split the bounding box into blocks
+		int blocksX = (m_width + RASTER_BLOCK_SIZE - 1) / RASTER_BLOCK_SIZE;
+		m_blocks.clear();
 		for (int x = minX; x <= maxX; x += RASTER_BLOCK_SIZE) {
 			for (int y = minY; y <= maxY; y += RASTER_BLOCK_SIZE) {
+				if (m_dirtyOnly && !m_dirtyBlocks[(y / RASTER_BLOCK_SIZE) * blocksX + x / RASTER_BLOCK_SIZE])
+					continue;
+
 				// check if block is inside the triangle
 				// inspired by github.com/trenki2/SoftwareRenderer
 				bool btmLeft1 = edge1.Test(x, y), btmLeft2 = edge2.Test(x, y), btmLeft3 = edge3.Test(x, y), btmLeft = btmLeft1 && btmLeft2 && btmLeft3;
@@ -586,13 +1012,55 @@ namespace ed {
 				int result = btmLeft + btmRight + topLeft + topRight;
 
 				// TODO: check if triangle and and rectangle don't intersect - skip the m_renderBlock
-				if (m_hasBreakpoints)
-					m_renderBlock<true>(m_debugger, x, y, result == 4, edge1, edge2, edge3);
-				else
-					m_renderBlock<false>(m_debugger, x, y, result == 4, edge1, edge2, edge3);
+				RasterBlock block;
+				block.X = x;
+				block.Y = y;
+				block.SkipChecks = result == 4;
+				m_blocks.push_back(block);
+			}
+		}
+		m_edges[0] = &edge1;
+		m_edges[1] = &edge2;
+		m_edges[2] = &edge3;
+
+		if (m_blocks.empty())
+			return;
+
+		// changed items only mark the pixels that have to be analyzed again
+		if (m_coverageOnly) {
+			for (const RasterBlock& block : m_blocks)
+				m_coverBlock(block);
+			return;
+		}
+
+		// init the renderer
+		m_debugger->PreparePixelShader(m_pass, item, &m_pixel);
+		m_debugger->PreparePixelShaderWorkers(std::min<int>(m_workerCount, m_blocks.size()));
+		m_debugger->ToggleAnalyzer(true); // turn on the analyzer
+
+		// shade the blocks - each worker has its own VM and takes the next free block (only one worker is
+		// prepared if the shader writes to a storage buffer or image)
+		m_nextBlock = 0;
+		int workerCount = m_debugger->GetPixelShaderWorkerCount();
+		if (workerCount <= 1)
+			m_shadeBlocks(0);
+		else {
+			m_startWorkers();
+			{
+				std::lock_guard<std::mutex> lock(m_workerMutex);
+				m_workersBusy = m_workers.size();
+				m_workerGeneration++;
 			}
+			m_workerStart.notify_all();
+
+			m_shadeBlocks(0);
+
+			std::unique_lock<std::mutex> lock(m_workerMutex);
+			m_workerDone.wait(lock, [&] { return m_workersBusy == 0; });
 		}
+
 		m_debugger->ToggleAnalyzer(false); // turn off the analyzer
+		m_debugger->ClearPixelShaderWorkers();
 	}
 
 	float* FrameAnalysis::AllocateHeatmap()
@@ -819,6 +1287,7 @@ namespace ed {
 		
 		// input the new shader
 		m_renderer->RecompileFromSource(pass->Name, "", newGLSL);
+		m_renderer->FinishShaderCompilation();
 		m_renderer->Render();
 
 		GLuint rendTex = m_renderer->GetTexture();
@@ -829,6 +1298,7 @@ namespace ed {
 
 		// return old shader
 		m_renderer->Recompile(pass->Name);
+		m_renderer->FinishShaderCompilation();
 		m_renderer->Render();
 
 		return returnData;
@@ -2,8 +2,14 @@
 #include <SHADERed/Objects/PipelineItem.h>
 #include <SHADERed/Objects/DebugInformation.h>
 
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
 #define RASTER_BLOCK_SIZE 8
 #define RASTER_BLOCK_STEP RASTER_BLOCK_SIZE - 1
+#define ANALYSIS_MAX_TRACKED_ITEMS 64 // items that can be re-analyzed on their own (one bit per item in each pixel)
 
 namespace ed {
 	class FrameAnalysis {
@@ -17,6 +23,11 @@ namespace ed {
 
 		void SetBreakpoints(const std::vector<const dbg::Breakpoint*>& breakpoints, const std::vector<glm::vec3>& bkptColors, const std::vector<const char*>& bkptPaths);
 
+		// renders the passes - if the output & the items are the same as in the previous call, only the
+		// pixels covered by the items whose shaders, variables or geometry changed are analyzed again
+		void Analyze(const std::vector<PipelineItem*>& passes);
+		inline uint32_t GetPixelsAnalyzed() { return m_pixelsAnalyzed; } // by the last Analyze() call
+
 		void RenderPass(PipelineItem* pass);
 		void RenderPrimitive(PipelineItem* item, unsigned int vertexStart, uint8_t vertexCount, unsigned int topology);
 		void RenderTriangle(PipelineItem* item);
@@ -57,15 +68,15 @@ namespace ed {
 
 			EdgeEquation(const glm::ivec2& v0, const glm::ivec2& v1);
 			
-			inline bool Test(int x, int y) {
+			inline bool Test(int x, int y) const {
 				return m_test(m_evaluate(x, y));
 			}
 
 		private:
-			inline float m_evaluate(int x, int y) {
+			inline float m_evaluate(int x, int y) const {
 				return a * x + b * y + c;
 			}
-			inline bool m_test(float v) {
+			inline bool m_test(float v) const {
 				return (v > 0 || v == 0 && tie);
 			}
 		};
@@ -81,7 +92,9 @@ namespace ed {
 
 		float* m_depth;
 		uint32_t* m_color;
+		uint32_t* m_base; // color of the pixels that nothing is rendered to (clear color or the copied texture)
 		int m_width, m_height;
+		uint32_t m_clearColor;
 
 		glm::ivec2 m_pixelHistoryLocation;
 
@@ -93,7 +106,40 @@ namespace ed {
 
 		uint32_t* m_ub;
 
+		// incremental analysis - each pixel remembers which items covered it and what happened to its fragments
+		struct AnalyzedItem {
+			PipelineItem* Pass;
+			PipelineItem* Item;
+			uint64_t Hash; // shaders, variables, textures & geometry used to render the item
+			uint32_t Triangles, TrianglesDiscarded;
+		};
+		struct PixelStatistics {
+			uint16_t Shaded, Discarded, UndefinedBehavior, FailedDepthTest;
+			uint32_t InstructionSum, InstructionMax;
+		};
+		std::vector<AnalyzedItem> m_items;
+		uint64_t m_setupHash; // region, breakpoints, ... - everything has to be analyzed again if it changes
+		bool m_resultsValid;
+		uint64_t* m_coverage; // bit i -> m_items[i] covers the pixel
+		PixelStatistics* m_pixelStats;
+		uint8_t* m_dirty;					// pixels that are analyzed again
+		std::vector<uint8_t> m_dirtyBlocks; // RASTER_BLOCK_SIZE blocks that contain a dirty pixel
+		bool m_dirtyOnly;					// shade only the dirty pixels
+		bool m_coverageOnly;				// only find the pixels that the items cover, don't shade them
+		uint64_t m_renderMask;				// items that RenderPass() renders
+		int m_itemIndex;
+		uint64_t m_itemBit;
+		uint32_t m_pixelsAnalyzed;
+
+		uint64_t m_hashItem(PipelineItem* pass, PipelineItem* item);
+		bool m_beginItem(PipelineItem* item);
+		void m_resetPixel(size_t index);
+		void m_analyzeAll(const std::vector<PipelineItem*>& passes);
+		void m_analyzeChanged(const std::vector<PipelineItem*>& passes, uint64_t changed);
+		void m_updateStatistics();
+
 		bool m_hasBreakpoints;
+		uint64_t m_breakpointHash;
 		struct BreakpointData {
 			const dbg::Breakpoint* Breakpoint;
 			glm::vec3 Color;
@@ -106,16 +152,42 @@ namespace ed {
 			std::vector<unsigned int> SPIRV;
 
 			spvm_program_t Shader;
-			spvm_state_t VM;
+			std::vector<spvm_state_t> VM; // one state per worker
 		};
 		std::vector<BreakpointData> m_breakpoint;
+		std::mutex m_breakpointMutex;
 		uint8_t* m_bkpt;
 
 		std::vector<unsigned int>* m_getPixelShaderSPV(const char* path);
-		void m_cacheBreakpoint(int index);
-		spvm_result_t m_executeBreakpoint(int index, spvm_result_t& retType);
+		void m_cacheBreakpoint(int index, int worker);
+		spvm_result_t m_executeBreakpoint(int index, int worker, spvm_result_t& retType);
 		void m_cleanBreakpoints();
 
+		// RASTER_BLOCK_SIZE blocks of the triangle that's currently being rendered - blocks
+		// don't overlap so workers can shade them in parallel. Statistics are stored per pixel.
+		struct RasterBlock {
+			int X, Y;
+			bool SkipChecks;
+		};
+		std::vector<RasterBlock> m_blocks;
+		const EdgeEquation* m_edges[3];
+		std::mutex m_historyMutex;
+
+		// worker threads, the thread that calls RenderTriangle() is worker 0
+		int m_workerCount;
+		std::vector<std::thread> m_workers;
+		std::mutex m_workerMutex;
+		std::condition_variable m_workerStart, m_workerDone;
+		uint32_t m_workerGeneration;
+		int m_workersBusy;
+		bool m_workersExit;
+		std::atomic<size_t> m_nextBlock;
+		void m_startWorkers();
+		void m_stopWorkers();
+		void m_workerLoop(int worker, uint32_t generation);
+		void m_shadeBlocks(int worker);
+		void m_coverBlock(const RasterBlock& block);
+
 		PipelineItem* m_pass;
 		PixelInformation m_pixel;
 
@@ -129,52 +201,65 @@ namespace ed {
 				(uint32_t)(color.b * 255) << 16 | (uint32_t)(color.a * 255) << 24;
 		}
 
-		glm::vec4 m_executePixelShaderWithBreakpoints(int x, int y, uint8_t& res, int loc = 0);
+		glm::vec4 m_executePixelShaderWithBreakpoints(int worker, int x, int y, uint8_t& res, int loc = 0);
 
+		// m_pixel is shared between the workers and must only be read in here
 		template <bool hasBreakpoints>
-		void m_renderBlock(DebugInformation* renderer, size_t startX, size_t startY, bool skipChecks, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3)
+		void m_renderBlock(DebugInformation* renderer, int worker, RasterBlock& block)
 		{
-			for (size_t x = startX; x < std::min<size_t>(m_width, startX + RASTER_BLOCK_SIZE); x++) {
-				for (size_t y = startY; y < std::min<size_t>(m_height, startY + RASTER_BLOCK_SIZE); y++) {
-					if (skipChecks || (e1.Test(x, y) && e2.Test(x, y) && e3.Test(x, y))) {
-						m_pixel.Coordinate = glm::ivec2(x, y);
-						m_pixel.RelativeCoordinate = glm::vec2(x, y) / glm::vec2(m_pixel.RenderTextureSize);
+			const EdgeEquation& e1 = *m_edges[0];
+			const EdgeEquation& e2 = *m_edges[1];
+			const EdgeEquation& e3 = *m_edges[2];
+			spvm_state_t vm = renderer->GetPixelShaderWorker(worker);
+
+			for (size_t x = block.X; x < std::min<size_t>(m_width, block.X + RASTER_BLOCK_SIZE); x++) {
+				for (size_t y = block.Y; y < std::min<size_t>(m_height, block.Y + RASTER_BLOCK_SIZE); y++) {
+					if (block.SkipChecks || (e1.Test(x, y) && e2.Test(x, y) && e3.Test(x, y))) {
+						size_t index = y * m_width + x;
+						if (m_dirtyOnly && !m_dirty[index])
+							continue;
+						m_coverage[index] |= m_itemBit;
+
+						glm::ivec2 coord(x, y);
 
 						// prepare inputs & calculate
-						float depth = renderer->SetPixelShaderInput(m_pixel);
+						float depth = renderer->SetPixelShaderWorkerInput(worker, m_pixel, coord);
 
-						if (depth <= m_depth[y * m_width + x]) { // TODO: OpExecutionMode DepthReplacing -> execute pixel shader, then go through depth test
+						if (depth <= m_depth[index]) { // TODO: OpExecutionMode DepthReplacing -> execute pixel shader, then go through depth test
+							glm::vec4 color;
 							if constexpr (!hasBreakpoints)
-								m_pixel.DebuggerColor = renderer->ExecutePixelShader(x, y, m_pixel.RenderTextureIndex);
+								color = renderer->ExecutePixelShaderWorker(worker, x, y, m_pixel.RenderTextureIndex);
 							else
-								m_pixel.DebuggerColor = m_executePixelShaderWithBreakpoints(x, y, m_bkpt[y * m_width + x], m_pixel.RenderTextureIndex);
+								color = m_executePixelShaderWithBreakpoints(worker, x, y, m_bkpt[index], m_pixel.RenderTextureIndex);
 
-							if (renderer->GetVM()->discarded) {
-								m_pixelsDiscarded++;
+							PixelStatistics& stats = m_pixelStats[index];
+							if (vm->discarded) {
+								stats.Discarded++;
 								continue;
 							}
 
 							// actual color and depth
-							m_color[y * m_width + x] = m_encodeColor(m_pixel.DebuggerColor);
-							m_depth[y * m_width + x] = depth;
-							m_pixelCount++;
+							m_color[index] = m_encodeColor(color);
+							m_depth[index] = depth;
+							stats.Shaded++;
 
 							// instruction count / heatmap stuff
-							int instCount = renderer->GetVM()->instruction_count;
-							m_instCount[y * m_width + x] = instCount;
-							m_instCountMax = std::max<int>(m_instCountMax, instCount);
-							m_instCountAvgN++;
-							m_instCountAvg = m_instCountAvg + (instCount - m_instCountAvg) / m_instCountAvgN;
+							uint32_t instCount = vm->instruction_count;
+							m_instCount[index] = instCount;
+							stats.InstructionSum += instCount;
+							stats.InstructionMax = std::max<uint32_t>(stats.InstructionMax, instCount);
 
 							// undefined behavior
-							spvm_word ubType = renderer->GetLastUndefinedBehaviorType();
-							spvm_word ubLine = renderer->GetLastUndefinedBehaviorLine();
-							spvm_word ubCount = renderer->GetUndefinedBehaviorCount();
-							m_ub[y * m_width + x] = (ubType & 0x000000FF) | ((ubCount << 8) & 0x00000F00) | ((ubLine << 12) & 0xFFFFF000);
-							m_pixelsUB += (ubType > 0);
+							spvm_word ubType = renderer->GetLastUndefinedBehaviorType(worker);
+							spvm_word ubLine = renderer->GetLastUndefinedBehaviorLine(worker);
+							spvm_word ubCount = renderer->GetUndefinedBehaviorCount(worker);
+							m_ub[index] = (ubType & 0x000000FF) | ((ubCount << 8) & 0x00000F00) | ((ubLine << 12) & 0xFFFFF000);
+							stats.UndefinedBehavior += (ubType > 0);
 
 							// pixel history
-							if (m_pixelHistoryLocation == m_pixel.Coordinate) {
+							if (m_pixelHistoryLocation == coord) {
+								std::lock_guard<std::mutex> lock(m_historyMutex);
+
 								bool exists = false;
 								for (const auto& pixel : m_debugger->GetPixelList())
 									if (pixel.Object == m_pixel.Object && pixel.VertexID == m_pixel.VertexID) {
@@ -183,14 +268,17 @@ namespace ed {
 									}
 
 								if (!exists) {
-									m_pixel.Color = m_pixel.DebuggerColor;
-									m_pixel.History = true;
-									m_debugger->AddPixel(m_pixel);
+									PixelInformation historyPixel = m_pixel;
+									historyPixel.Coordinate = coord;
+									historyPixel.RelativeCoordinate = glm::vec2(coord) / glm::vec2(m_pixel.RenderTextureSize);
+									historyPixel.DebuggerColor = historyPixel.Color = color;
+									historyPixel.History = true;
+									m_debugger->AddPixel(historyPixel);
 								}
 							}
 
 						} else
-							m_pixelsFailedDepthTest++;
+							m_pixelStats[index].FailedDepthTest++;
 					}
 				}
 			}
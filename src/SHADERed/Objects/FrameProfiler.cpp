@@ -0,0 +1,300 @@
+#include <SHADERed/Objects/FrameProfiler.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace ed {
+	FrameProfiler::FrameProfiler()
+	{
+		m_next = 0;
+		m_current = -1;
+		m_openPass = m_openDraw = -1;
+		m_frameIndex = 0;
+		m_version = 0;
+		m_statsVersion = -1;
+		m_epoch = std::chrono::high_resolution_clock::now();
+	}
+	FrameProfiler::~FrameProfiler()
+	{
+		for (int i = 0; i < FRAME_PROFILER_LATENCY; i++)
+			if (!m_frames[i].Queries.empty())
+				glDeleteQueries(m_frames[i].Queries.size(), m_frames[i].Queries.data());
+	}
+
+	void FrameProfiler::BeginFrame()
+	{
+		m_collect();
+
+		PendingFrame& frame = m_frames[m_next];
+
+		// the GPU is too far behind - don't record this frame instead of waiting for it
+		if (frame.Pending) {
+			m_current = -1;
+			return;
+		}
+
+		m_current = m_next;
+		m_next = (m_next + 1) % FRAME_PROFILER_LATENCY;
+		m_openPass = m_openDraw = -1;
+
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+
+		frame.Data.Index = m_frameIndex++;
+		frame.Data.CPUStart = m_now();
+		frame.Data.Events.clear();
+		frame.LastQuery = -1;
+		frame.GPUOffset = (int64_t)frame.Data.CPUStart - (int64_t)gpuNow;
+	}
+	void FrameProfiler::EndFrame()
+	{
+		if (m_current == -1)
+			return;
+
+		m_endEvent(m_openDraw);
+		m_endEvent(m_openPass);
+
+		PendingFrame& frame = m_frames[m_current];
+		frame.Data.CPUEnd = m_now();
+		frame.Pending = true;
+
+		m_current = -1;
+	}
+
+	void FrameProfiler::BeginPass(const char* name)
+	{
+		if (m_current == -1)
+			return;
+
+		m_endEvent(m_openDraw);
+		m_endEvent(m_openPass);
+
+		m_beginEvent(name, "");
+		m_openPass = m_frames[m_current].Data.Events.size() - 1;
+	}
+	void FrameProfiler::BeginDraw(const char* name)
+	{
+		if (m_current == -1 || m_openPass == -1)
+			return;
+
+		m_endEvent(m_openDraw);
+
+		m_beginEvent(name, m_frames[m_current].Data.Events[m_openPass].Name);
+		m_openDraw = m_frames[m_current].Data.Events.size() - 1;
+	}
+	void FrameProfiler::EndDraw()
+	{
+		if (m_current == -1)
+			return;
+
+		m_endEvent(m_openDraw);
+	}
+
+	void FrameProfiler::Clear()
+	{
+		// results of the frames that are still waiting would belong to the old pipeline
+		for (int i = 0; i < FRAME_PROFILER_LATENCY; i++)
+			m_frames[i].Pending = false;
+		m_current = -1;
+
+		m_history.clear();
+		m_stats.clear();
+		m_version++;
+	}
+
+	const std::vector<FrameProfiler::Statistics>& FrameProfiler::GetStatistics()
+	{
+		// sorting all the samples on each UI frame would be too much for big pipelines
+		if (m_statsVersion == m_version || (m_statsTimer.GetElapsedTime() < 0.25f && !m_stats.empty()))
+			return m_stats;
+
+		m_statsVersion = m_version;
+		m_statsTimer.Restart();
+		m_stats.clear();
+
+		std::unordered_map<std::string, int> ids;
+		std::vector<std::vector<uint64_t>> cpuTimes, gpuTimes;
+
+		// newest frame first so that the statistics are in the current pipeline order
+		for (auto frame = m_history.rbegin(); frame != m_history.rend(); frame++) {
+			for (const Event& ev : frame->Events) {
+				std::string key = std::string(ev.Parent) + "/" + ev.Name;
+
+				auto id = ids.find(key);
+				if (id == ids.end()) {
+					id = ids.insert(std::make_pair(key, (int)m_stats.size())).first;
+
+					Statistics stat;
+					stat.Name = ev.Name;
+					stat.Parent = ev.Parent;
+					m_stats.push_back(stat);
+					cpuTimes.push_back(std::vector<uint64_t>());
+					gpuTimes.push_back(std::vector<uint64_t>());
+				}
+
+				cpuTimes[id->second].push_back(ev.CPUEnd - ev.CPUStart);
+				gpuTimes[id->second].push_back(ev.GPUEnd > ev.GPUStart ? ev.GPUEnd - ev.GPUStart : 0);
+			}
+		}
+
+		auto calculate = [](std::vector<uint64_t>& times, uint64_t& minTime, uint64_t& avgTime, uint64_t& p99Time) {
+			std::sort(times.begin(), times.end());
+
+			uint64_t sum = 0;
+			for (uint64_t time : times)
+				sum += time;
+
+			minTime = times.front();
+			avgTime = sum / times.size();
+			p99Time = times[(times.size() - 1) * 99 / 100];
+		};
+		for (int i = 0; i < m_stats.size(); i++) {
+			m_stats[i].Samples = cpuTimes[i].size();
+			calculate(cpuTimes[i], m_stats[i].CPUMin, m_stats[i].CPUAvg, m_stats[i].CPUP99);
+			calculate(gpuTimes[i], m_stats[i].GPUMin, m_stats[i].GPUAvg, m_stats[i].GPUP99);
+		}
+
+		return m_stats;
+	}
+
+	std::string FrameProfiler::EscapeJSON(const std::string& str)
+	{
+		std::string ret;
+		for (char c : str) {
+			if (c == '"' || c == '\\') {
+				ret += '\\';
+				ret += c;
+			} else if ((unsigned char)c < 0x20)
+				ret += ' ';
+			else
+				ret += c;
+		}
+		return ret;
+	}
+	bool FrameProfiler::ExportTrace(const std::string& filename)
+	{
+		std::ofstream file(filename);
+		if (!file.is_open()) {
+			Logger::Get().Log("Failed to open " + filename + " for writing the profiler trace", true);
+			return false;
+		}
+
+		// timestamps are in microseconds, relative to the first frame
+		uint64_t start = m_history.empty() ? 0 : m_history.front().CPUStart;
+		auto writeEvent = [&](const std::string& name, const char* category, int thread, uint64_t begin, uint64_t end) {
+			begin = std::max(begin, start);
+			end = std::max(end, begin);
+			file << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+				 << ",\"ts\":" << (begin - start) / 1000.0 << ",\"dur\":" << (end - begin) / 1000.0 << "}";
+		};
+
+		file.setf(std::ios::fixed);
+		file.precision(3);
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SHADERed\"}},\n";
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+		for (const Frame& frame : m_history) {
+			std::string frameName = "Frame " + std::to_string(frame.Index);
+			writeEvent(frameName, "frame", 1, frame.CPUStart, frame.CPUEnd);
+			if (!frame.Events.empty())
+				writeEvent(frameName, "frame", 2, frame.GPUStart, frame.GPUEnd);
+
+			for (const Event& ev : frame.Events) {
+				const char* category = ev.Parent[0] == 0 ? "item" : "draw";
+				std::string name = EscapeJSON(ev.Name);
+				writeEvent(name, category, 1, ev.CPUStart, ev.CPUEnd);
+				writeEvent(name, category, 2, ev.GPUStart, ev.GPUEnd);
+			}
+		}
+
+		file << "\n]}\n";
+
+		return file.good();
+	}
+
+	uint64_t FrameProfiler::m_now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - m_epoch).count();
+	}
+	void FrameProfiler::m_timestamp(PendingFrame& frame, int index)
+	{
+		if (index >= frame.Queries.size()) {
+			size_t oldSize = frame.Queries.size();
+			frame.Queries.resize(std::max<size_t>(std::max<size_t>(index + 1, oldSize * 2), 64));
+			glGenQueries(frame.Queries.size() - oldSize, &frame.Queries[oldSize]);
+		}
+
+		glQueryCounter(frame.Queries[index], GL_TIMESTAMP);
+		frame.LastQuery = index;
+	}
+	void FrameProfiler::m_beginEvent(const char* name, const char* parent)
+	{
+		PendingFrame& frame = m_frames[m_current];
+
+		Event ev;
+		strncpy(ev.Name, name, PIPELINE_ITEM_NAME_LENGTH - 1);
+		ev.Name[PIPELINE_ITEM_NAME_LENGTH - 1] = 0;
+		strncpy(ev.Parent, parent, PIPELINE_ITEM_NAME_LENGTH - 1);
+		ev.Parent[PIPELINE_ITEM_NAME_LENGTH - 1] = 0;
+		ev.CPUStart = ev.CPUEnd = m_now();
+		ev.GPUStart = ev.GPUEnd = 0;
+
+		frame.Data.Events.push_back(ev);
+		m_timestamp(frame, (frame.Data.Events.size() - 1) * 2);
+	}
+	void FrameProfiler::m_endEvent(int& ev)
+	{
+		if (ev == -1)
+			return;
+
+		PendingFrame& frame = m_frames[m_current];
+		frame.Data.Events[ev].CPUEnd = m_now();
+		m_timestamp(frame, ev * 2 + 1);
+
+		ev = -1;
+	}
+	void FrameProfiler::m_collect()
+	{
+		// oldest frame first - the results arrive in order so we can stop at the first unfinished frame
+		for (int i = 0; i < FRAME_PROFILER_LATENCY; i++) {
+			PendingFrame& frame = m_frames[(m_next + i) % FRAME_PROFILER_LATENCY];
+			if (!frame.Pending)
+				continue;
+
+			std::vector<Event>& events = frame.Data.Events;
+			if (!events.empty()) {
+				GLint available = 0;
+				glGetQueryObjectiv(frame.Queries[frame.LastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+				if (!available)
+					break;
+			}
+
+			frame.Data.GPUStart = frame.Data.GPUEnd = 0;
+			for (int j = 0; j < events.size(); j++) {
+				GLuint64 start = 0, end = 0;
+				glGetQueryObjectui64v(frame.Queries[j * 2], GL_QUERY_RESULT, &start);
+				glGetQueryObjectui64v(frame.Queries[j * 2 + 1], GL_QUERY_RESULT, &end);
+
+				events[j].GPUStart = start + frame.GPUOffset;
+				events[j].GPUEnd = end + frame.GPUOffset;
+
+				if (j == 0)
+					frame.Data.GPUStart = events[j].GPUStart;
+				frame.Data.GPUEnd = std::max(frame.Data.GPUEnd, events[j].GPUEnd);
+			}
+
+			m_history.push_back(frame.Data);
+			if (m_history.size() > FRAME_PROFILER_HISTORY)
+				m_history.pop_front();
+			m_version++;
+
+			frame.Pending = false;
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <SHADERed/Engine/Timer.h>
+#include <SHADERed/Objects/PipelineItem.h>
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#define FRAME_PROFILER_HISTORY 300 // number of frames used for the statistics & the trace
+#define FRAME_PROFILER_LATENCY 4   // number of frames that can wait for their GPU results at once
+
+namespace ed {
+	// records the CPU & GPU (GL_TIMESTAMP queries) begin/end times of every pipeline item and every draw call over
+	// the last FRAME_PROFILER_HISTORY frames. GPU results are read a few frames later so that the CPU never waits.
+	class FrameProfiler {
+	public:
+		FrameProfiler();
+		~FrameProfiler();
+
+		struct Event {
+			char Name[PIPELINE_ITEM_NAME_LENGTH];
+			char Parent[PIPELINE_ITEM_NAME_LENGTH]; // shader pass of a draw call, empty for pipeline items
+			uint64_t CPUStart, CPUEnd;				// ns since the profiler was created
+			uint64_t GPUStart, GPUEnd;				// ns, converted to the same clock as the CPU times
+		};
+		struct Frame {
+			int Index;
+			uint64_t CPUStart, CPUEnd;
+			uint64_t GPUStart, GPUEnd;
+			std::vector<Event> Events;
+		};
+		struct Statistics {
+			std::string Name;
+			std::string Parent;
+			int Samples;
+			uint64_t CPUMin, CPUAvg, CPUP99;
+			uint64_t GPUMin, GPUAvg, GPUP99;
+		};
+
+		void BeginFrame();
+		void EndFrame();
+
+		// an event ends when the next one on the same level (or the frame) begins
+		void BeginPass(const char* name);
+		void BeginDraw(const char* name);
+		void EndDraw();
+
+		void Clear();
+
+		inline const std::deque<Frame>& GetHistory() { return m_history; }
+		inline int GetVersion() { return m_version; } // changes every time a frame is added to the history
+
+		// min/avg/p99 of every pipeline item & draw call in the history, in the order of the latest frame
+		const std::vector<Statistics>& GetStatistics();
+
+		// Chrome's trace event format (chrome://tracing, Perfetto, ...)
+		bool ExportTrace(const std::string& filename);
+
+		// contents of a JSON string (also used for the --benchmark results)
+		static std::string EscapeJSON(const std::string& str);
+
+	private:
+		struct PendingFrame {
+			PendingFrame()
+			{
+				Pending = false;
+				GPUOffset = 0;
+				LastQuery = -1;
+			}
+			Frame Data;
+			std::vector<GLuint> Queries; // start & end timestamp of each event, reused between frames
+			int LastQuery;				 // the last one that was issued
+			int64_t GPUOffset;			 // CPU clock - GPU clock
+			bool Pending;				 // waiting for the GPU results
+		};
+		PendingFrame m_frames[FRAME_PROFILER_LATENCY];
+		int m_next;	   // slot for the next frame
+		int m_current; // -1 if the current frame isn't being recorded
+		int m_openPass, m_openDraw;
+		int m_frameIndex;
+
+		std::chrono::high_resolution_clock::time_point m_epoch;
+		uint64_t m_now();
+
+		void m_timestamp(PendingFrame& frame, int index);
+		void m_beginEvent(const char* name, const char* parent);
+		void m_endEvent(int& ev);
+		void m_collect();
+
+		std::deque<Frame> m_history;
+		int m_version;
+
+		std::vector<Statistics> m_stats;
+		int m_statsVersion;
+		eng::Timer m_statsTimer;
+	};
+}
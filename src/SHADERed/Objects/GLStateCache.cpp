@@ -0,0 +1,153 @@
+#include <SHADERed/Objects/GLStateCache.h>
+
+// not a valid object name nor enum value
+#define GL_STATE_UNKNOWN 0xFFFFFFFF
+
+namespace ed {
+	GLStateCache::GLStateCache()
+	{
+		Invalidate();
+	}
+	void GLStateCache::Invalidate()
+	{
+		m_program = GL_STATE_UNKNOWN;
+		m_vao = GL_STATE_UNKNOWN;
+		m_drawFBO = m_readFBO = GL_STATE_UNKNOWN;
+		m_activeUnit = GL_STATE_UNKNOWN;
+
+		for (int i = 0; i < GL_STATE_CACHE_TEXTURE_UNITS; i++)
+			for (int j = 0; j < Target_Count; j++)
+				m_textures[i][j] = GL_STATE_UNKNOWN;
+		for (int i = 0; i < GL_STATE_CACHE_BUFFER_BINDINGS; i++)
+			m_storageBuffers[i] = GL_STATE_UNKNOWN;
+
+		for (int i = 0; i < Cap_Count; i++)
+			m_caps[i] = -1;
+		m_polygonMode = m_cullFace = m_frontFace = m_depthFunc = GL_STATE_UNKNOWN;
+		m_depthMask = -1;
+	}
+
+	void GLStateCache::UseProgram(GLuint program)
+	{
+		if (m_program != program) {
+			glUseProgram(program);
+			m_program = program;
+		}
+	}
+	void GLStateCache::BindVertexArray(GLuint vao)
+	{
+		if (m_vao != vao) {
+			glBindVertexArray(vao);
+			m_vao = vao;
+		}
+	}
+	void GLStateCache::BindFramebuffer(GLenum target, GLuint fbo)
+	{
+		bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+		bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+
+		if ((!draw || m_drawFBO == fbo) && (!read || m_readFBO == fbo))
+			return;
+
+		glBindFramebuffer(target, fbo);
+		if (draw) m_drawFBO = fbo;
+		if (read) m_readFBO = fbo;
+	}
+	void GLStateCache::ActiveTexture(GLuint unit)
+	{
+		if (m_activeUnit != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			m_activeUnit = unit;
+		}
+	}
+	void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		int targetIndex = -1;
+		if (target == GL_TEXTURE_2D)
+			targetIndex = Target_2D;
+		else if (target == GL_TEXTURE_3D)
+			targetIndex = Target_3D;
+		else if (target == GL_TEXTURE_CUBE_MAP)
+			targetIndex = Target_CubeMap;
+
+		if (targetIndex != -1 && unit < GL_STATE_CACHE_TEXTURE_UNITS) {
+			if (m_textures[unit][targetIndex] == texture)
+				return;
+			m_textures[unit][targetIndex] = texture;
+		}
+
+		ActiveTexture(unit);
+		glBindTexture(target, texture);
+	}
+	void GLStateCache::BindStorageBuffer(GLuint index, GLuint buffer)
+	{
+		if (index < GL_STATE_CACHE_BUFFER_BINDINGS) {
+			if (m_storageBuffers[index] == buffer)
+				return;
+			m_storageBuffers[index] = buffer;
+		}
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+	}
+
+	void GLStateCache::SetCapability(GLenum cap, bool enabled)
+	{
+		int capIndex = -1;
+		if (cap == GL_DEPTH_CLAMP)
+			capIndex = Cap_DepthClamp;
+		else if (cap == GL_CULL_FACE)
+			capIndex = Cap_CullFace;
+		else if (cap == GL_BLEND)
+			capIndex = Cap_Blend;
+		else if (cap == GL_DEPTH_TEST)
+			capIndex = Cap_DepthTest;
+		else if (cap == GL_STENCIL_TEST)
+			capIndex = Cap_StencilTest;
+
+		if (capIndex != -1) {
+			if (m_caps[capIndex] == (char)enabled)
+				return;
+			m_caps[capIndex] = enabled;
+		}
+
+		if (enabled)
+			glEnable(cap);
+		else
+			glDisable(cap);
+	}
+	void GLStateCache::PolygonMode(GLenum mode)
+	{
+		if (m_polygonMode != mode) {
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
+			m_polygonMode = mode;
+		}
+	}
+	void GLStateCache::CullFace(GLenum mode)
+	{
+		if (m_cullFace != mode) {
+			glCullFace(mode);
+			m_cullFace = mode;
+		}
+	}
+	void GLStateCache::FrontFace(GLenum mode)
+	{
+		if (m_frontFace != mode) {
+			glFrontFace(mode);
+			m_frontFace = mode;
+		}
+	}
+	void GLStateCache::DepthMask(GLboolean mask)
+	{
+		if (m_depthMask != mask) {
+			glDepthMask(mask);
+			m_depthMask = mask;
+		}
+	}
+	void GLStateCache::DepthFunc(GLenum func)
+	{
+		if (m_depthFunc != func) {
+			glDepthFunc(func);
+			m_depthFunc = func;
+		}
+	}
+}
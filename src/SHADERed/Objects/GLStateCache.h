@@ -0,0 +1,67 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#define GL_STATE_CACHE_TEXTURE_UNITS 32
+#define GL_STATE_CACHE_BUFFER_BINDINGS 32
+
+namespace ed {
+	// shadow copy of the GL state that RenderEngine changes the most - calls that wouldn't change anything are
+	// skipped. Code that changes the state directly (plugins, FBO updates, ...) has to be followed by Invalidate()
+	class GLStateCache {
+	public:
+		GLStateCache();
+
+		// forget everything - the next call of each function will reach the driver
+		void Invalidate();
+
+		void UseProgram(GLuint program);
+		void BindVertexArray(GLuint vao);
+		void BindFramebuffer(GLenum target, GLuint fbo);
+		void ActiveTexture(GLuint unit);
+		void BindTexture(GLuint unit, GLenum target, GLuint texture);
+		void BindStorageBuffer(GLuint index, GLuint buffer);
+
+		// only capabilities used by the render states are cached, others are passed through
+		void SetCapability(GLenum cap, bool enabled);
+		void PolygonMode(GLenum mode);
+		void CullFace(GLenum mode);
+		void FrontFace(GLenum mode);
+		void DepthMask(GLboolean mask);
+		void DepthFunc(GLenum func);
+
+	private:
+		enum Capability {
+			Cap_DepthClamp,
+			Cap_CullFace,
+			Cap_Blend,
+			Cap_DepthTest,
+			Cap_StencilTest,
+			Cap_Count
+		};
+		enum TextureTarget {
+			Target_2D,
+			Target_3D,
+			Target_CubeMap,
+			Target_Count
+		};
+
+		GLuint m_program;
+		GLuint m_vao;
+		GLuint m_drawFBO, m_readFBO;
+		GLuint m_activeUnit;
+		GLuint m_textures[GL_STATE_CACHE_TEXTURE_UNITS][Target_Count];
+		GLuint m_storageBuffers[GL_STATE_CACHE_BUFFER_BINDINGS];
+
+		char m_caps[Cap_Count]; // -1 -> unknown
+		GLenum m_polygonMode, m_cullFace, m_frontFace, m_depthFunc;
+		GLint m_depthMask; // -1 -> unknown
+	};
+}
@@ -0,0 +1,117 @@
+#include <SHADERed/Objects/HeadlessContext.h>
+#include <SHADERed/Objects/Logger.h>
+
+#ifdef SHADERED_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <string.h>
+#endif
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace ed {
+	HeadlessContext::HeadlessContext()
+	{
+		m_display = nullptr;
+		m_context = nullptr;
+	}
+	HeadlessContext::~HeadlessContext()
+	{
+		Destroy();
+	}
+
+	bool HeadlessContext::Create(int major, int minor)
+	{
+#ifdef SHADERED_EGL
+		EGLDisplay display = EGL_NO_DISPLAY;
+
+		// prefer the surfaceless platform (works under llvmpipe in containers), fall back to the default display
+		const char* clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+		if (clientExts != nullptr && strstr(clientExts, "EGL_MESA_platform_surfaceless") != nullptr) {
+			PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay)
+				display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+		if (display == EGL_NO_DISPLAY)
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		EGLint eglMajor = 0, eglMinor = 0;
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajor, &eglMinor)) {
+			Logger::Get().Log("Failed to initialize the EGL display", true);
+			return false;
+		}
+		m_display = display;
+
+		if (!eglBindAPI(EGL_OPENGL_API)) {
+			Logger::Get().Log("EGL implementation doesn't support desktop OpenGL", true);
+			Destroy();
+			return false;
+		}
+
+		EGLint configAttribs[] = {
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_ALPHA_SIZE, 8,
+			EGL_DEPTH_SIZE, 24,
+			EGL_STENCIL_SIZE, 8,
+			EGL_NONE
+		};
+
+		// surfaceless displays might not have any pbuffer configs - we never create a surface anyway
+		EGLConfig config = nullptr;
+		EGLint configCount = 0;
+		if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+			configAttribs[1] = EGL_DONT_CARE;
+			if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+				Logger::Get().Log("Failed to find a suitable EGL config", true);
+				Destroy();
+				return false;
+			}
+		}
+
+		EGLint contextAttribs[] = {
+			EGL_CONTEXT_MAJOR_VERSION, major,
+			EGL_CONTEXT_MINOR_VERSION, minor,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+		if (context == EGL_NO_CONTEXT) {
+			Logger::Get().Log("Failed to create the EGL context", true);
+			Destroy();
+			return false;
+		}
+		m_context = context;
+
+		if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+			Logger::Get().Log("Failed to make the EGL context current", true);
+			Destroy();
+			return false;
+		}
+
+		Logger::Get().Log("Created a headless EGL " + std::to_string(eglMajor) + "." + std::to_string(eglMinor) + " context");
+
+		return true;
+#else
+		return false;
+#endif
+	}
+	void HeadlessContext::Destroy()
+	{
+#ifdef SHADERED_EGL
+		if (m_display != nullptr) {
+			eglMakeCurrent((EGLDisplay)m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (m_context != nullptr)
+				eglDestroyContext((EGLDisplay)m_display, (EGLContext)m_context);
+			eglTerminate((EGLDisplay)m_display);
+		}
+#endif
+		m_display = nullptr;
+		m_context = nullptr;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace ed {
+	// OpenGL context without a window (surfaceless EGL) - used when rendering from the command line
+	// so that no display server is needed. Only available when SHADERed is built with SHADERED_EGL
+	class HeadlessContext {
+	public:
+		HeadlessContext();
+		~HeadlessContext();
+
+		bool Create(int major = 3, int minor = 3);
+		void Destroy();
+
+		inline bool IsCreated() { return m_context != nullptr; }
+
+	private:
+		void* m_display;
+		void* m_context;
+	};
+}
@@ -33,4 +33,24 @@ namespace ed {
 		}
 		return 0;
 	}
+
+	size_t VertexFormat::GetStride() const
+	{
+		return GetOffset(InputLayoutValue::Color) + (Colors ? (ByteColors ? 4 : 16) : 0);
+	}
+	size_t VertexFormat::GetOffset(InputLayoutValue val) const
+	{
+		size_t normalSize = PackedNormals ? 4 : 12;
+		size_t texcoordSize = HalfTexcoords ? 4 : 8;
+
+		switch (val) {
+		case InputLayoutValue::Position: return 0;
+		case InputLayoutValue::Normal: return 12;
+		case InputLayoutValue::Texcoord: return 12 + normalSize;
+		case InputLayoutValue::Tangent: return 12 + normalSize + texcoordSize;
+		case InputLayoutValue::Binormal: return 12 + normalSize * 2 + texcoordSize;
+		case InputLayoutValue::Color: return 12 + normalSize * 3 + texcoordSize;
+		}
+		return 0;
+	}
 }
\ No newline at end of file
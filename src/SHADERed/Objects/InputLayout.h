@@ -28,4 +28,28 @@ namespace ed {
 		static size_t GetValueSize(InputLayoutValue val);
 		static size_t GetValueOffset(InputLayoutValue val);
 	};
+
+	// how the standard attributes (Position - Color) are stored in a VBO - the default
+	// is 18 floats per vertex, the compact types are decoded by the vertex fetch
+	class VertexFormat {
+	public:
+		VertexFormat()
+				: HalfTexcoords(false)
+				, PackedNormals(false)
+				, ByteColors(false)
+				, Colors(true)
+		{
+		}
+
+		bool HalfTexcoords; // 2x GL_HALF_FLOAT
+		bool PackedNormals; // normal, tangent and binormal as normalized GL_INT_2_10_10_10_REV
+		bool ByteColors;	// 4x normalized GL_UNSIGNED_BYTE
+		bool Colors;		// false -> not stored, Color is always (1, 1, 1, 1)
+
+		inline bool IsDefault() const { return !HalfTexcoords && !PackedNormals && !ByteColors && Colors; }
+
+		// in bytes
+		size_t GetStride() const;
+		size_t GetOffset(InputLayoutValue val) const;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+#include <SHADERed/Objects/Logger.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ed {
+	enum class JobStatus {
+		Queued,
+		Running,
+		Finished
+	};
+
+	// pool of worker threads (started on the first Submit()) that process jobs in the order they were submitted - shared
+	// by the shader compiler and the texture loader. Job needs a JobStatus Status and an Item pointer.
+	template <typename Job>
+	class JobQueue {
+	public:
+		// threadCount <= 0: one thread per core, except the one for the UI thread, but at most maxThreads
+		// inOrder: GetFinishedJobs() only returns a job once every job that was submitted before it has finished too
+		JobQueue(const std::string& name, int threadCount, int maxThreads, bool inOrder, const std::function<void(Job*)>& process)
+		{
+			m_name = name;
+			m_inOrder = inOrder;
+			m_process = process;
+			m_exit = false;
+
+			m_threadCount = threadCount;
+			if (m_threadCount <= 0)
+				m_threadCount = std::min<int>(maxThreads, std::max<int>(1, (int)std::thread::hardware_concurrency() - 1));
+		}
+		~JobQueue()
+		{
+			m_stopThreads();
+
+			for (Job* job : m_jobs)
+				delete job;
+			m_jobs.clear();
+		}
+
+		// queue the job (queue takes the ownership) - replaceQueued: drop the jobs for the same item that haven't started yet
+		void Submit(Job* job, bool replaceQueued = false)
+		{
+			m_startThreads();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				if (replaceQueued)
+					for (int i = 0; i < m_jobs.size(); i++)
+						if (m_jobs[i]->Item == job->Item && m_jobs[i]->Status == JobStatus::Queued) {
+							delete m_jobs[i];
+							m_jobs.erase(m_jobs.begin() + i);
+							i--;
+						}
+
+				job->Status = JobStatus::Queued;
+				m_jobs.push_back(job);
+			}
+
+			m_jobQueued.notify_one();
+		}
+
+		// caller takes the ownership of the returned jobs
+		std::vector<Job*> GetFinishedJobs()
+		{
+			std::vector<Job*> ret;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (int i = 0; i < m_jobs.size(); i++) {
+				if (m_jobs[i]->Status == JobStatus::Finished) {
+					ret.push_back(m_jobs[i]);
+					m_jobs.erase(m_jobs.begin() + i);
+					i--;
+				} else if (m_inOrder)
+					break;
+			}
+
+			return ret;
+		}
+		bool IsBusy()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return !m_allFinished();
+		}
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobFinished.wait(lock, [&] { return m_allFinished(); });
+		}
+		void Clear()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// drop the queued jobs first so that the threads don't start them while the running ones are waited for
+			for (int i = 0; i < m_jobs.size(); i++)
+				if (m_jobs[i]->Status == JobStatus::Queued) {
+					delete m_jobs[i];
+					m_jobs.erase(m_jobs.begin() + i);
+					i--;
+				}
+
+			// running jobs can't be stopped
+			m_jobFinished.wait(lock, [&] {
+				for (Job* job : m_jobs)
+					if (job->Status == JobStatus::Running)
+						return false;
+				return true;
+			});
+
+			for (Job* job : m_jobs)
+				delete job;
+			m_jobs.clear();
+		}
+
+	protected:
+		// has to be called by the derived class' destructor if the process function uses its members
+		void m_stopThreads()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_exit = true;
+			}
+			m_jobQueued.notify_all();
+
+			for (std::thread& thread : m_threads)
+				thread.join();
+			m_threads.clear();
+		}
+
+	private:
+		std::string m_name;
+		bool m_inOrder;
+		std::function<void(Job*)> m_process;
+
+		int m_threadCount;
+		std::vector<std::thread> m_threads;
+		std::deque<Job*> m_jobs; // in the order they were submitted
+		std::mutex m_mutex;
+		std::condition_variable m_jobQueued, m_jobFinished;
+		bool m_exit;
+
+		// m_mutex has to be locked
+		bool m_allFinished()
+		{
+			for (Job* job : m_jobs)
+				if (job->Status != JobStatus::Finished)
+					return false;
+			return true;
+		}
+		Job* m_getQueued()
+		{
+			for (Job* job : m_jobs)
+				if (job->Status == JobStatus::Queued)
+					return job;
+			return nullptr;
+		}
+
+		void m_startThreads()
+		{
+			if (!m_threads.empty())
+				return;
+
+			Logger::Get().Log("Starting " + std::to_string(m_threadCount) + " " + m_name + " thread(s)");
+
+			for (int i = 0; i < m_threadCount; i++)
+				m_threads.push_back(std::thread(&JobQueue::m_threadLoop, this));
+		}
+		void m_threadLoop()
+		{
+			while (true) {
+				Job* job = nullptr;
+
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_jobQueued.wait(lock, [&] { return m_exit || m_getQueued() != nullptr; });
+
+					if (m_exit)
+						return;
+
+					job = m_getQueued();
+					job->Status = JobStatus::Running;
+				}
+
+				m_process(job);
+
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					job->Status = JobStatus::Finished;
+				}
+				m_jobFinished.notify_all();
+			}
+		}
+	};
+}
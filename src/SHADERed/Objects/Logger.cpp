@@ -12,6 +12,8 @@ namespace ed {
 		if (!Settings::Instance().General.Log)
 			return;
 
+		std::lock_guard<std::mutex> lock(m_mutex);
+
 		time_t now = time(0);
 		tm* ltm = localtime(&now);
 
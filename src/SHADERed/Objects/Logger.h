@@ -1,6 +1,7 @@
 #pragma once
 #include <SHADERed/Objects/MessageStack.h>
 #include <string>
+#include <mutex>
 
 namespace ed {
 	class Logger {
@@ -23,5 +24,6 @@ namespace ed {
 
 	private:
 		std::vector<std::string> m_msgs;
+		std::mutex m_mutex; // shader compiler threads also log
 	};
 }
\ No newline at end of file
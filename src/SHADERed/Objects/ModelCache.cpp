@@ -0,0 +1,160 @@
+#include <SHADERed/Objects/ModelCache.h>
+#include <SHADERed/Objects/ShaderCache.h>
+#include <SHADERed/Objects/Settings.h>
+
+#include <filesystem>
+#include <fstream>
+
+#define MODEL_CACHE_MAGIC 0x4D444553 // "SEDM"
+#define MODEL_CACHE_FORMAT 2
+
+namespace ed {
+	struct ModelCacheHeader {
+		uint32_t Magic;
+		uint32_t Format;
+		uint32_t VertexSize;
+		uint32_t MeshCount;
+	};
+	// followed by the name, vertices, indices, LODs and LOD indices of the mesh
+	struct ModelCacheMesh {
+		uint32_t NameLength;
+		uint32_t LODCount;
+		uint64_t VertexCount;
+		uint64_t IndexCount;
+		uint64_t LODIndexCount;
+	};
+
+	ModelCache::ModelCache()
+			: m_cache(Settings::Instance().ConvertPath(MODEL_CACHE_DIRECTORY), "model", MODEL_CACHE_MAX_SIZE)
+	{
+	}
+
+	uint64_t ModelCache::GetKey(const std::string& path, int importFlags, bool optimized, bool lods)
+	{
+		// hashing the contents of a large model would take as long as a part of the import
+		std::error_code ec;
+		std::filesystem::path absPath = std::filesystem::absolute(path, ec);
+		uintmax_t size = std::filesystem::file_size(path, ec);
+		if (ec)
+			return 0;
+		int64_t time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+		if (ec)
+			return 0;
+
+		uint64_t ret = ShaderCache::Hash(absPath.u8string());
+		ret = ShaderCache::Hash((uint64_t)size, ret);
+		ret = ShaderCache::Hash(time, ret);
+		ret = ShaderCache::Hash(importFlags, ret);
+		ret = ShaderCache::Hash(optimized, ret);
+		ret = ShaderCache::Hash(lods, ret);
+		ret = ShaderCache::Hash((uint64_t)MODEL_CACHE_FORMAT, ret);
+		return ret;
+	}
+
+	bool ModelCache::Load(uint64_t key, std::vector<eng::Model::Mesh>& meshes, bool compactVertices)
+	{
+		if (!m_cache.IsEnabled() || key == 0)
+			return false;
+
+		std::string filename = m_cache.GetFilename(key, "mdl");
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		size_t fileSize = file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		ModelCacheHeader header;
+		if (fileSize < sizeof(header) || !file.read((char*)&header, sizeof(header)))
+			return false;
+		if (header.Magic != MODEL_CACHE_MAGIC || header.Format != MODEL_CACHE_FORMAT || header.VertexSize != sizeof(eng::Model::Mesh::Vertex))
+			return false;
+
+		struct MeshData {
+			std::string Name;
+			std::vector<eng::Model::Mesh::Vertex> Vertices;
+			std::vector<unsigned int> Indices;
+			std::vector<eng::Model::Mesh::LOD> LODs;
+			std::vector<unsigned int> LODIndices;
+		};
+
+		size_t remaining = fileSize - sizeof(header);
+
+		// check the count before allocating anything
+		auto readArray = [&](auto& arr, uint64_t count) -> bool {
+			size_t elementSize = sizeof(arr[0]);
+			if (count > remaining / elementSize)
+				return false;
+			arr.resize(count);
+			remaining -= count * elementSize;
+			return count == 0 || file.read((char*)&arr[0], count * elementSize);
+		};
+
+		// read everything before creating any GL objects
+		std::vector<MeshData> data(header.MeshCount);
+		for (MeshData& mesh : data) {
+			ModelCacheMesh meshHeader;
+			if (remaining < sizeof(meshHeader) || !file.read((char*)&meshHeader, sizeof(meshHeader)))
+				return false;
+			remaining -= sizeof(meshHeader);
+
+			if (!readArray(mesh.Name, meshHeader.NameLength)
+				|| !readArray(mesh.Vertices, meshHeader.VertexCount)
+				|| !readArray(mesh.Indices, meshHeader.IndexCount)
+				|| !readArray(mesh.LODs, meshHeader.LODCount)
+				|| !readArray(mesh.LODIndices, meshHeader.LODIndexCount))
+				return false;
+
+			for (const auto& lod : mesh.LODs)
+				if ((uint64_t)lod.IndexOffset + lod.IndexCount > mesh.LODIndices.size())
+					return false;
+		}
+		file.close();
+
+		if (remaining != 0)
+			return false;
+
+		meshes.reserve(meshes.size() + data.size());
+		for (MeshData& mesh : data) {
+			meshes.push_back(eng::Model::Mesh(mesh.Name, std::move(mesh.Vertices), std::move(mesh.Indices), std::vector<eng::Model::Mesh::Texture>(), compactVertices));
+			if (!mesh.LODs.empty())
+				meshes.back().SetLODs(std::move(mesh.LODIndices), std::move(mesh.LODs));
+		}
+
+		m_cache.Touch(filename);
+
+		return true;
+	}
+	void ModelCache::Save(uint64_t key, const std::vector<eng::Model::Mesh>& meshes)
+	{
+		if (!m_cache.IsEnabled() || key == 0)
+			return;
+
+		ModelCacheHeader header;
+		header.Magic = MODEL_CACHE_MAGIC;
+		header.Format = MODEL_CACHE_FORMAT;
+		header.VertexSize = sizeof(eng::Model::Mesh::Vertex);
+		header.MeshCount = meshes.size();
+
+		// multiple instances of SHADERed might be writing the same entry
+		m_cache.Write(m_cache.GetFilename(key, "mdl"), [&](std::ofstream& file) {
+			file.write((const char*)&header, sizeof(header));
+
+			for (const eng::Model::Mesh& mesh : meshes) {
+				ModelCacheMesh meshHeader;
+				meshHeader.NameLength = mesh.Name.size();
+				meshHeader.LODCount = mesh.LODs.size();
+				meshHeader.VertexCount = mesh.Vertices.size();
+				meshHeader.IndexCount = mesh.Indices.size();
+				meshHeader.LODIndexCount = mesh.LODIndices.size();
+
+				file.write((const char*)&meshHeader, sizeof(meshHeader));
+				file.write(mesh.Name.data(), mesh.Name.size());
+				file.write((const char*)mesh.Vertices.data(), mesh.Vertices.size() * sizeof(eng::Model::Mesh::Vertex));
+				file.write((const char*)mesh.Indices.data(), mesh.Indices.size() * sizeof(unsigned int));
+				file.write((const char*)mesh.LODs.data(), mesh.LODs.size() * sizeof(eng::Model::Mesh::LOD));
+				file.write((const char*)mesh.LODIndices.data(), mesh.LODIndices.size() * sizeof(unsigned int));
+			}
+		});
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <SHADERed/Engine/Model.h>
+#include <SHADERed/Objects/DiskCache.h>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define MODEL_CACHE_DIRECTORY "cache/models/"
+#define MODEL_CACHE_MAX_SIZE (1024 * 1024 * 1024)
+
+namespace ed {
+	// persistent cache for the processed assimp output (vertices, indices, LODs and the name of every mesh) -
+	// each array is stored exactly as it is laid out in memory so that loading an entry is just a few
+	// large reads instead of running the importer again
+	class ModelCache {
+	public:
+		ModelCache();
+
+		static inline ModelCache& Instance()
+		{
+			static ModelCache ret;
+			return ret;
+		}
+
+		// based on the file's path, size & modification time and the import options - 0 if the file doesn't exist
+		static uint64_t GetKey(const std::string& path, int importFlags, bool optimized, bool lods);
+
+		bool Load(uint64_t key, std::vector<eng::Model::Mesh>& meshes, bool compactVertices); // creates the GL buffers
+		void Save(uint64_t key, const std::vector<eng::Model::Mesh>& meshes);
+
+	private:
+		DiskCache m_cache;
+	};
+}
@@ -0,0 +1,68 @@
+#include <SHADERed/Objects/ObjectLookup.h>
+
+namespace ed {
+	template <typename K>
+	static ObjectManagerItem* findItem(const std::unordered_map<K, ObjectManagerItem*>& table, const K& key)
+	{
+		auto it = table.find(key);
+		return it == table.end() ? nullptr : it->second;
+	}
+	template <typename K>
+	static void eraseItem(std::unordered_map<K, ObjectManagerItem*>& table, const K& key, ObjectManagerItem* item)
+	{
+		// cached cube maps can share their texture with another item - keep the entry if it isn't ours
+		auto it = table.find(key);
+		if (it != table.end() && it->second == item)
+			table.erase(it);
+	}
+
+	void ObjectLookup::Clear()
+	{
+		m_names.clear();
+		m_textures.clear();
+		m_buffers.clear();
+	}
+
+	void ObjectLookup::Add(ObjectManagerItem* item, const std::string& name, unsigned int texture, unsigned int buffer)
+	{
+		m_names[name] = item;
+		if (texture != 0)
+			m_textures.insert({ texture, item }); // the first item with this texture is returned
+		if (buffer != 0)
+			m_buffers[buffer] = item;
+	}
+	void ObjectLookup::Remove(ObjectManagerItem* item, const std::string& name, unsigned int texture, unsigned int buffer)
+	{
+		eraseItem(m_names, name, item);
+		if (texture != 0)
+			eraseItem(m_textures, texture, item);
+		if (buffer != 0)
+			eraseItem(m_buffers, buffer, item);
+	}
+
+	void ObjectLookup::Rename(ObjectManagerItem* item, const std::string& oldName, const std::string& newName)
+	{
+		eraseItem(m_names, oldName, item);
+		m_names[newName] = item;
+	}
+	void ObjectLookup::ChangeTexture(ObjectManagerItem* item, unsigned int oldTexture, unsigned int newTexture)
+	{
+		if (oldTexture != 0)
+			eraseItem(m_textures, oldTexture, item);
+		if (newTexture != 0)
+			m_textures[newTexture] = item;
+	}
+
+	ObjectManagerItem* ObjectLookup::GetByName(const std::string& name) const
+	{
+		return findItem(m_names, name);
+	}
+	ObjectManagerItem* ObjectLookup::GetByTexture(unsigned int texture) const
+	{
+		return findItem(m_textures, texture);
+	}
+	ObjectManagerItem* ObjectLookup::GetByBuffer(unsigned int buffer) const
+	{
+		return findItem(m_buffers, buffer);
+	}
+}
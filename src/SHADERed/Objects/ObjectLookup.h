@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+namespace ed {
+	class ObjectManagerItem;
+
+	// name, texture ID and buffer ID -> item tables used by ObjectManager::Get*() - ObjectManager updates them
+	// whenever an item is created, renamed, gets a new texture or is removed (0 = item has no texture/buffer)
+	class ObjectLookup {
+	public:
+		void Clear();
+
+		void Add(ObjectManagerItem* item, const std::string& name, unsigned int texture, unsigned int buffer);
+		void Remove(ObjectManagerItem* item, const std::string& name, unsigned int texture, unsigned int buffer);
+
+		void Rename(ObjectManagerItem* item, const std::string& oldName, const std::string& newName);
+		void ChangeTexture(ObjectManagerItem* item, unsigned int oldTexture, unsigned int newTexture);
+
+		ObjectManagerItem* GetByName(const std::string& name) const;
+		ObjectManagerItem* GetByTexture(unsigned int texture) const;
+		ObjectManagerItem* GetByBuffer(unsigned int buffer) const;
+
+	private:
+		std::unordered_map<std::string, ObjectManagerItem*> m_names;
+		std::unordered_map<unsigned int, ObjectManagerItem*> m_textures, m_buffers;
+	};
+}
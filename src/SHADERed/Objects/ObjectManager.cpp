@@ -1,4 +1,6 @@
 #include <SHADERed/Engine/GLUtils.h>
+#include <SHADERed/Objects/CompressedTexture.h>
+#include <SHADERed/Objects/EnvironmentCache.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/ObjectManager.h>
 #include <SHADERed/Objects/RenderEngine.h>
@@ -6,8 +8,10 @@
 #include <SHADERed/Objects/TextureHelper.h>
 #include <SHADERed/Engine/Model.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <fstream>
+#include <string.h>
 
 #include <misc/stb_image.h>
 #include <misc/stb_image_write.h>
@@ -17,9 +21,13 @@ extern "C" {
 }
 
 namespace ed {
-	ObjectManager::ObjectManager(ProjectParser* parser, RenderEngine* rnd)
+	ObjectManager::ObjectManager(ProjectParser* parser, RenderEngine* rnd, MessageStack* msgs)
 			: m_parser(parser)
 			, m_renderer(rnd)
+			, m_msgs(msgs)
+			, m_assetGeneration(0)
+			, m_frameGeneration(0)
+			, m_textureJobCounter(0)
 	{
 		m_binds.clear();
 		memset(m_kbTexture, 0, sizeof(unsigned char) * 256 * 3);
@@ -134,71 +142,121 @@ namespace ed {
 		Clear();
 	}
 
-	bool loadCubemapFace(GLuint face, const std::string& path, int& w, int& h, TextureHelper::TextureDesc* outputDetail)
+	static uint64_t hashCubemapFaces(ProjectParser* parser, const std::string (&faces)[6])
 	{
-		stbi_set_flip_vertically_on_load(0);
-
-		std::filesystem::path pathObject(path);
-		if (!std::filesystem::exists(pathObject)) {
-			Logger::Get().Log("Error when loadCubemapFace, file not exist: " + path);
-			return false;
-		}
-		bool isDDS = (pathObject.extension().u8string() == ".dds");
-
-		unsigned char* data = nullptr;
-		dds_image_t ddsImage = nullptr;
-		int nrChannels = 0;
-		bool isFloat = false;
-
-		//Always create 4 channel texture, but some channel may be trivial
-		if (!isDDS) {
-			if (stbi_is_hdr(path.c_str())) {
-				data = (unsigned char*)stbi_loadf(path.c_str(), &w, &h, &nrChannels, STBI_rgb_alpha); //force 4 channel
-				isFloat = true;
-			} else {
-				data = stbi_load(path.c_str(), &w, &h, &nrChannels, STBI_rgb_alpha);
-			}
-		} else {
-			ddsImage = dds_load_from_file(path.c_str());
-
-			data = ddsImage->pixels;
-			w = ddsImage->header.width;
-			h = ddsImage->header.height;
-			nrChannels = 4;
+		uint64_t ret = 14695981039346656037ULL;
+		for (int i = 0; i < 6; i++)
+			ret = EnvironmentCache::HashFile(parser->GetProjectPath(faces[i]), ret);
+		return ret;
+	}
+	// 1x1 texture that is shown until the pixels are loaded
+	static void setPlaceholderTexture(GLenum target)
+	{
+		static const unsigned char pixel[4] = { 0, 0, 0, 255 };
+		if (target == GL_TEXTURE_CUBE_MAP) {
+			for (int i = 0; i < 6; i++)
+				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+		} else
+			glTexImage2D(target, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	}
+	// upside down copy of the texture's first level (done on the GPU), used for the flipped variant of a 2D texture
+	static void copyTextureFlipped(GLuint src, GLuint dst, int width, int height, GLenum internalFormat, GLenum format, GLenum type)
+	{
+		// GetFlippedTexture() can be called by plugins in the middle of a render - keep their bindings
+		GLint oldReadFBO = 0, oldDrawFBO = 0, oldTexture = 0;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &oldReadFBO);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &oldDrawFBO);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTexture);
+
+		// block compressed textures can't be attached to a framebuffer - flip the decompressed pixels on the CPU
+		if (CompressedTexture::IsCompressedFormat(internalFormat)) {
+			size_t rowSize = (size_t)width * 4 * (type == GL_FLOAT ? sizeof(float) : 1);
+			std::vector<unsigned char> pixels(rowSize * height);
+
+			glBindTexture(GL_TEXTURE_2D, src);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, type, pixels.data());
+
+			for (int y = 0; y < height / 2; y++)
+				std::swap_ranges(pixels.begin() + y * rowSize, pixels.begin() + (y + 1) * rowSize, pixels.begin() + (height - y - 1) * rowSize);
+
+			glBindTexture(GL_TEXTURE_2D, dst);
+			glTexImage2D(GL_TEXTURE_2D, 0, CompressedTexture::GetDecodedFormat(internalFormat), width, height, 0, GL_RGBA, type, pixels.data());
+			glGenerateMipmap(GL_TEXTURE_2D);
+			glBindTexture(GL_TEXTURE_2D, oldTexture);
+			return;
 		}
 
-		GLuint format = GL_RGBA;
-		GLenum type = isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE;
-		GLenum internalFormat = isFloat ? GL_RGBA32F : GL_RGBA8;
-
-		if (outputDetail != nullptr) {
-			TextureHelper::TextureDesc& texture = *outputDetail;
-			texture.target = GL_TEXTURE_2D;
-			texture.width = w;
-			texture.height = h;
-			texture.levels = TextureHelper::Utility::numMipmapLevels(w, h);
-			texture.format = format;
-			texture.type = type;
-			texture.internalFormat = internalFormat;
-			//assert(texture.Validate()); //It's not valid right not
+		glBindTexture(GL_TEXTURE_2D, dst);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+		glBindTexture(GL_TEXTURE_2D, oldTexture);
+
+		GLuint fbos[2];
+		glGenFramebuffers(2, fbos);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, fbos[0]);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, src, 0);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbos[1]);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dst, 0);
+
+		// blit is affected by the scissor test
+		GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+		glDisable(GL_SCISSOR_TEST);
+		glBlitFramebuffer(0, 0, width, height, 0, height, width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		if (scissor)
+			glEnable(GL_SCISSOR_TEST);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, oldReadFBO);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldDrawFBO);
+		glDeleteFramebuffers(2, fbos);
+
+		glBindTexture(GL_TEXTURE_2D, dst);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, oldTexture);
+	}
+	// upload the mip levels stored in a .dds/.ktx/.ktx2 file to the bound texture - returns the number of levels
+	static int uploadCompressedLevels(GLenum target, const TextureLoadImage& img, GLuint& internalFormat, GLenum& type)
+	{
+		const CompressedImage& compressed = *img.Compressed;
+		bool isDecoded = !img.Decoded.empty();
+
+		internalFormat = isDecoded ? CompressedTexture::GetDecodedFormat(compressed.Format) : compressed.Format;
+		type = img.IsFloat ? GL_FLOAT : GL_UNSIGNED_BYTE;
+
+		for (int i = 0; i < compressed.Levels.size(); i++) {
+			const CompressedImage::Level& level = compressed.Levels[i];
+			if (isDecoded)
+				glTexImage2D(target, i, internalFormat, level.Width, level.Height, 0, GL_RGBA, type, img.Decoded[i].data());
+			else // 2D texture loaded from a volume texture file only uses the first slice
+				glCompressedTexImage2D(target, i, internalFormat, level.Width, level.Height, 0, level.Size / level.Depth, compressed.Data.data() + level.Offset);
 		}
 
-		glTexImage2D(
-			face,
-			0, internalFormat, w, h, 0, format, type, data);
+		// the file's mip chain doesn't have to be complete, compressed formats can't use glGenerateMipmap
+		glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, compressed.Levels.size() - 1);
 
-		if (!isDDS)
-			stbi_image_free(data);
-		else
-			dds_image_free(ddsImage);
-
-		return true;
+		return compressed.Levels.size();
+	}
+	static void setPlaceholderDesc(ObjectManagerItem* item)
+	{
+		item->TextureDetail.reset(new TextureHelper::TextureDesc());
+		TextureHelper::TextureDesc& texture = *item->TextureDetail;
+		texture.id = item->Texture;
+		texture.target = GL_TEXTURE_2D;
+		texture.width = 1;
+		texture.height = 1;
+		texture.levels = 1;
+		texture.format = GL_RGBA;
+		texture.type = GL_UNSIGNED_BYTE;
+		texture.internalFormat = GL_RGBA8;
 	}
 
 	void ObjectManager::Clear()
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Clearing ObjectManager contents...");
 
+		m_textureLoader.Clear();
+		m_textureJobIDs.clear();
+
 		for (int i = 0; i < m_items.size(); i++) {
 			if (m_items[i]->Plugin != nullptr) {
 				PluginObject* pobj = m_items[i]->Plugin;
@@ -211,9 +269,13 @@ namespace ed {
 		m_binds.clear();
 		m_uniformBinds.clear();
 		m_items.clear();
+		m_lookup.Clear();
+		m_bufferGeometry.clear();
 	}
 	bool ObjectManager::CreateRenderTexture(const std::string& name)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a render texture " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -224,7 +286,6 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::RenderTexture);
-		m_items.push_back(item);
 
 		ed::RenderTextureObject* rtObj = item->RT = new ed::RenderTextureObject();
 		glm::ivec2 size = m_renderer->GetLastRenderSize();
@@ -251,21 +312,16 @@ namespace ed {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glBindTexture(GL_TEXTURE_2D, 0);
 
-		// color texture ms
-		glGenTextures(1, &rtObj->BufferMS);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, rtObj->BufferMS);
-		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, rtObj->Format, size.x, size.y, true);
+		// multisampled copies are handed out by RenderEngine when needed
 
-		// depth texture ms
-		glGenTextures(1, &rtObj->DepthStencilBufferMS);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, rtObj->DepthStencilBufferMS);
-		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, GL_DEPTH24_STENCIL8, size.x, size.y, true);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+		m_addItem(item);
 
 		return true;
 	}
 	bool ObjectManager::CreateTexture(const std::string& file)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a texture " + file + " ...");
 
 		if (Exists(file)) {
@@ -273,7 +329,6 @@ namespace ed {
 			return false;
 		}
 
-		bool isDDS = (std::filesystem::path(file).extension().u8string() == ".dds");
 		std::string path = m_parser->GetProjectPath(file);
 
 		std::filesystem::path pathObject(path);
@@ -282,42 +337,10 @@ namespace ed {
 			return false;
 		}
 
-		int width = 0, height = 0;
-		unsigned char* data = nullptr;
-		bool isFloat = false;
-		dds_image_t ddsImage = nullptr;
-
-		if (isDDS) {
-			ddsImage = dds_load_from_file(path.c_str());
-
-			data = ddsImage->pixels;
-			width = ddsImage->header.width;
-			height = ddsImage->header.height;
-		} else {
-			int nrChannels = 0;
-			stbi_set_flip_vertically_on_load(1);
-			if (stbi_is_hdr(path.c_str())) {
-				data = (unsigned char*)stbi_loadf(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-				isFloat = true;
-			} else {
-				data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-			}
-			
-		}
-
-		if (data == nullptr || width == 0 || height == 0 || (isDDS && ddsImage == nullptr)) {
-			Logger::Get().Log("Failed to load a texture " + file + " from file", true);
-			return false;
-		}
-
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(file, ObjectType::Texture);
 
-		GLuint internalFormat = isFloat ? GL_RGBA32F : GL_RGBA8; //It used to be GL_RGBA, but since type is always GL_UNSIGNED_BYTE, not SHORT4444 alike, GL_RGBA8 is more precise
-		GLenum format = GL_RGBA;
-		GLenum type = isFloat? GL_FLOAT : GL_UNSIGNED_BYTE;
-
 		// normal texture
 		glGenTextures(1, &item->Texture);
 		glBindTexture(GL_TEXTURE_2D, item->Texture);
@@ -325,57 +348,27 @@ namespace ed {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		setPlaceholderTexture(GL_TEXTURE_2D);
 		glBindTexture(GL_TEXTURE_2D, 0);
 
-		// flipped texture
-		
-		int pixelSize = (isFloat ? 4 * 4 : 4);
-			
-		unsigned char* flippedData = (unsigned char*)malloc(width * height * pixelSize);
-		memcpy(flippedData, data, width * height * pixelSize);
-		stbi_vertical_flip(flippedData, width, height, pixelSize); //No need to do it on our own, it can handle different pixel size
-		
+		// flipped texture is created by GetFlippedTexture() once something needs it
 
-		glGenTextures(1, &item->FlippedTexture);
-		glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, flippedData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		item->TextureSize = glm::ivec2(1, 1);
+		setPlaceholderDesc(item);
 
-		item->TextureSize = glm::ivec2(width, height);
+		// pixels are uploaded by UpdateTextureLoading() once the image is decoded
+		TextureLoadJob* job = new TextureLoadJob();
+		job->Paths.push_back(path);
+		job->Flip = true;
+		m_submitTextureJob(item, job);
 
-		{
-			item->TextureDetail.reset(new TextureHelper::TextureDesc);
-			TextureHelper::TextureDesc& texture = *item->TextureDetail;
-			texture.id = item->Texture;
-			texture.target = GL_TEXTURE_2D;
-			texture.width = width;
-			texture.height = height;
-			texture.levels = TextureHelper::Utility::numMipmapLevels(width, height);
-			texture.format = format;
-			texture.type = type;
-			texture.internalFormat = internalFormat;
-			assert(texture.Validate()); //Make sure the format is valid
-		}
-
-		free(flippedData);
-
-		if (isDDS)
-			dds_image_free(ddsImage);
-		else
-			stbi_image_free(data);
-
-		m_items.push_back(item);
+		m_addItem(item);
 		return true;
 	}
 	bool ObjectManager::CreateTexture3D(const std::string& file)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a 3D texture " + file + " ...");
 
 		if (Exists(file)) {
@@ -390,21 +383,36 @@ namespace ed {
 			return false;
 		}
 
-		dds_image_t ddsImage = dds_load_from_file(path.c_str());
-
-		if (ddsImage == nullptr) {
-			Logger::Get().Log("Failed to load a texture " + file + " from file", true);
+		// block compressed volume textures keep their mip levels
+		CompressedImage compressed;
+		std::string compressedError;
+		bool isCompressed = CompressedTexture::Load(path, compressed, compressedError);
+		if (!compressedError.empty()) {
+			Logger::Get().Log("Failed to load a texture " + file + ": " + compressedError, true);
 			return false;
 		}
 
+		dds_image_t ddsImage = nullptr;
+		if (!isCompressed) {
+			ddsImage = dds_load_from_file(path.c_str());
+
+			if (ddsImage == nullptr) {
+				Logger::Get().Log("Failed to load a texture " + file + " from file", true);
+				return false;
+			}
+		}
+
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(file, ObjectType::Texture3D);
-		m_items.push_back(item);
 
 		GLuint internalFormat = GL_RGBA;
 		GLenum format = GL_RGBA;
 		GLenum type = GL_UNSIGNED_BYTE;
+		int width = isCompressed ? compressed.Width : ddsImage->header.width;
+		int height = isCompressed ? compressed.Height : ddsImage->header.height;
+		int depth = isCompressed ? compressed.Depth : ddsImage->header.depth;
+		int levels = TextureHelper::Utility::numMipmapLevels(width, height);
 
 		glGenTextures(1, &item->Texture);
 		glBindTexture(GL_TEXTURE_3D, item->Texture);
@@ -413,9 +421,29 @@ namespace ed {
 		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
 		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
 		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, item->Texture_WrapR);
-		glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, ddsImage->header.width, ddsImage->header.height, 
-			ddsImage->header.depth, 0, format, type, ddsImage->pixels);
-		glGenerateMipmap(GL_TEXTURE_3D);
+		if (isCompressed) {
+			// only BPTC can be used with 3D textures, everything else is decoded
+			bool isSupported = CompressedTexture::IsSupported(compressed.Format, GL_TEXTURE_3D);
+			internalFormat = isSupported ? compressed.Format : CompressedTexture::GetDecodedFormat(compressed.Format);
+			type = CompressedTexture::IsDecodedFloat(compressed.Format) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+			levels = compressed.Levels.size();
+
+			std::vector<unsigned char> pixels;
+			for (int i = 0; i < levels; i++) {
+				const CompressedImage::Level& level = compressed.Levels[i];
+				if (isSupported)
+					glCompressedTexImage3D(GL_TEXTURE_3D, i, internalFormat, level.Width, level.Height, level.Depth, 0, level.Size, compressed.Data.data() + level.Offset);
+				else {
+					pixels.resize((size_t)level.Width * level.Height * level.Depth * 4 * (type == GL_FLOAT ? sizeof(float) : 1));
+					CompressedTexture::Decode(compressed, i, pixels.data());
+					glTexImage3D(GL_TEXTURE_3D, i, internalFormat, level.Width, level.Height, level.Depth, 0, format, type, pixels.data());
+				}
+			}
+			glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		} else {
+			glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, width, height, depth, 0, format, type, ddsImage->pixels);
+			glGenerateMipmap(GL_TEXTURE_3D);
+		}
 		glBindTexture(GL_TEXTURE_3D, 0);
 
 		{
@@ -423,19 +451,22 @@ namespace ed {
 			TextureHelper::TextureDesc& texture = *item->TextureDetail;
 			texture.id = item->Texture;
 			texture.target = GL_TEXTURE_2D;
-			texture.width = ddsImage->header.width;
-			texture.height = ddsImage->header.height;
-			texture.levels = TextureHelper::Utility::numMipmapLevels(texture.width, texture.height);
+			texture.width = width;
+			texture.height = height;
+			texture.levels = levels;
 			texture.format = format;
 			texture.type = type;
 			texture.internalFormat = internalFormat;
 			assert(texture.Validate()); //Make sure the format is valid
 		}
 
-		item->TextureSize = glm::ivec2(ddsImage->header.width, ddsImage->header.height);
-		item->Depth = ddsImage->header.depth;
+		item->TextureSize = glm::ivec2(width, height);
+		item->Depth = depth;
 
-		dds_image_free(ddsImage);
+		if (ddsImage != nullptr)
+			dds_image_free(ddsImage);
+
+		m_addItem(item);
 
 		return true;
 	}
@@ -449,6 +480,8 @@ namespace ed {
 		const std::string& left, const std::string& top, const std::string& front, 
 		const std::string& bottom, const std::string& right, const std::string& back, EnvironmentType environmentType)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a cubemap " + name + " ...");
 		ObjectManagerItem* item = nullptr;
 		{
@@ -461,100 +494,71 @@ namespace ed {
 
 			item = new ObjectManagerItem(name, ObjectType::CubeMap);
 
-			glGenTextures(1, &item->Texture);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
+			std::string faces[6] = { left, top, front, bottom, right, back };
 
-			// properties
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, item->Texture_WrapR);
-
-			auto firstExtension = std::filesystem::path(left).extension().string();
-
-			bool isFloat = false;
-			if (stbi_is_hdr(m_parser->GetProjectPath(left).c_str()))
-				isFloat = true;
+			// baked IBL cubes are loaded together with their mip chain from the cache - nothing has to be filtered again
+			uint64_t envKey = 0;
+			if (environmentType == EnvironmentType_Specular || environmentType == EnvironmentType_Iradiance) {
+				envKey = EnvironmentCache::GetKey(hashCubemapFaces(m_parser, faces), environmentType);
 
-			int width = 0, height = 0;
-			int width2 = 0, height2 = 0;
+				TextureHelper::TextureDesc cached;
+				if (EnvironmentCache::Instance().Load(envKey, cached)) {
+					item->Texture = cached.id;
+					item->TextureDetail.reset(new TextureHelper::TextureDesc(cached));
+					item->CubemapPaths = std::vector<std::string>(faces, faces + 6);
+					item->EnvironmentTypeValue = environmentType;
+					item->TextureSize = glm::ivec2(cached.width, cached.height);
+					if (environmentType == EnvironmentType_Specular)
+						item->Texture_MinFilter = GL_LINEAR_MIPMAP_LINEAR;
+					this->UpdateTextureParameters(item);
 
-			item->TextureDetail.reset(new TextureHelper::TextureDesc());
-			// left face
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, m_parser->GetProjectPath(left), width, height, item->TextureDetail.get()))
-				goto Exit0;
-			item->CubemapPaths.push_back(left);
-
-			// top
-			if (firstExtension != std::filesystem::path(top).extension().string()) {
-				Logger::Get().Log("Cannot create a cubemap because: " + top + ", extension is not identical to the left one", true);
-				goto Exit0;
-			}
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, m_parser->GetProjectPath(top), width2, height2, nullptr))
-				goto Exit0;
-			item->CubemapPaths.push_back(top);
-			//Should it check width2 == width ??
+					m_addItem(item);
 
-			// front
-			if (firstExtension != std::filesystem::path(front).extension().string()) {
-				Logger::Get().Log("Cannot create a cubemap because: " + front + ", extension is not identical to the left one", true);
-				goto Exit0;
+					return true;
+				}
 			}
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, m_parser->GetProjectPath(front), width2, height2, nullptr))
-				goto Exit0;
-			item->CubemapPaths.push_back(front);
 
-			// bottom
-			if (firstExtension != std::filesystem::path(bottom).extension().string()) {
-				Logger::Get().Log("Cannot create a cubemap because: " + bottom + ", extension is not identical to the left one", true);
-				goto Exit0;
-			}
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, m_parser->GetProjectPath(bottom), width2, height2, nullptr))
-				goto Exit0;
-			item->CubemapPaths.push_back(bottom);
+			// faces are decoded on the background threads - only check if they can be loaded
+			auto firstExtension = std::filesystem::path(left).extension().string();
+			std::vector<std::string> paths;
+			for (int i = 0; i < 6; i++) {
+				if (firstExtension != std::filesystem::path(faces[i]).extension().string()) {
+					Logger::Get().Log("Cannot create a cubemap because: " + faces[i] + ", extension is not identical to the left one", true);
+					goto Exit0;
+				}
 
-			// right
-			if (firstExtension != std::filesystem::path(right).extension().string()) {
-				Logger::Get().Log("Cannot create a cubemap because: " + right + ", extension is not identical to the left one", true);
-				goto Exit0;
+				paths.push_back(m_parser->GetProjectPath(faces[i]));
+				if (!std::filesystem::exists(paths.back())) {
+					Logger::Get().Log("Cannot create a cubemap because: " + paths.back() + " doesn't exist", true);
+					goto Exit0;
+				}
 			}
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X, m_parser->GetProjectPath(right), width2, height2, nullptr))
-				goto Exit0;
-			item->CubemapPaths.push_back(right);
 
-			// back
-			if (firstExtension != std::filesystem::path(back).extension().string()) {
-				Logger::Get().Log("Cannot create a cubemap because: " + back + ", extension is not identical to the left one", true);
-				goto Exit0;
-			}
-			if (!loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, m_parser->GetProjectPath(back), width2, height2, nullptr))
-				goto Exit0;
-			item->CubemapPaths.push_back(back);
+			glGenTextures(1, &item->Texture);
+			glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
 
-			item->TextureDetail->id = item->Texture; //Final set the id to make it valid
-			assert(item->TextureDetail->Validate());
-			item->EnvironmentTypeValue = environmentType;
+			// properties
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, item->Texture_WrapR);
+			setPlaceholderTexture(GL_TEXTURE_CUBE_MAP);
 
 			// clean up
 			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-			item->TextureSize = glm::ivec2(width, height);
 
-			if (environmentType == EnvironmentType_Specular) {
-				auto oldId = item->TextureDetail->id;
-				*(item->TextureDetail) = TextureHelper::PostProcessCubemap_PrefilteredSpecular(*item->TextureDetail);
-				auto newId = item->TextureDetail->id;
-				assert(oldId != newId);
-				assert(item->TextureDetail->Validate());
-				item->Texture = item->TextureDetail->id; //Texture was recreated
+			item->CubemapPaths = std::vector<std::string>(faces, faces + 6);
+			item->EnvironmentTypeValue = environmentType;
+			item->TextureSize = glm::ivec2(1, 1);
+			setPlaceholderDesc(item);
 
-				// specular map needs linear filter
-				item->Texture_MinFilter = GL_LINEAR_MIPMAP_LINEAR;
-				this->UpdateTextureParameters(item);
-			}
+			TextureLoadJob* job = new TextureLoadJob();
+			job->Paths = paths;
+			job->CacheKey = envKey;
+			m_submitTextureJob(item, job);
 
-			assert(item->TextureDetail->width == width);
-			m_items.push_back(item);
+			m_addItem(item);
 
 			return true;
 		}
@@ -566,6 +570,8 @@ namespace ed {
 	}
 	bool ObjectManager::CreateTextureEnvironment(const std::string& file)
 	{
+		m_assetGeneration++;
+
 		//This function is used to convert a lat-long hdr to reflection cubemap, ir cubemap, and ibl lut table map
 		//It used to be 
 		constexpr char ItermediateTextureExtensionNoFloat[] = ".tga";//tga is better for review
@@ -615,6 +621,11 @@ namespace ed {
 				return false;
 			}
 
+			// store the lossless bake under the saved faces - CreateCubemap() (and every later project open) will
+			// then load it instead of the RGBE quantized faces and won't filter the specular cube again
+			EnvironmentCache::Instance().Save(EnvironmentCache::GetKey(hashCubemapFaces(m_parser, envTextureResult.SavedPath), EnvironmentType_Specular), et.m_envTexture);
+			EnvironmentCache::Instance().Save(EnvironmentCache::GetKey(hashCubemapFaces(m_parser, irTextureResult.SavedPath), EnvironmentType_Iradiance), et.m_irmapTexture);
+
 			TextureHelper::SavedTexturePathResult spBRDF_LUTResult;
 			if (!SaveTextureToFile(et.m_spBRDF_LUT,
 					saveFileNameBase + ".lut" + ItermediateTextureExtensionNoFloat, flipYBeforeSave, &spBRDF_LUTResult)) {
@@ -668,6 +679,8 @@ namespace ed {
 	}
 	bool ObjectManager::CreateAudio(const std::string& file)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating audio object from file " + file + " ...");
 
 		if (Exists(file)) {
@@ -686,7 +699,6 @@ namespace ed {
 		}
 
 		m_parser->ModifyProject();
-		m_items.push_back(item);
 
 		glGenTextures(1, &item->Texture);
 		glBindTexture(GL_TEXTURE_2D, item->Texture);
@@ -700,10 +712,14 @@ namespace ed {
 		item->Sound->Start();
 		item->SoundMuted = false;
 
+		m_addItem(item);
+
 		return true;
 	}
 	bool ObjectManager::CreateBuffer(const std::string& name)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a buffer " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -714,7 +730,6 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::Buffer);
-		m_items.push_back(item);
 
 		ed::BufferObject* bObj = item->Buffer = new ed::BufferObject();
 		glm::ivec2 size = m_renderer->GetLastRenderSize();
@@ -722,6 +737,7 @@ namespace ed {
 		bObj->PreviewPaused = false;
 		bObj->Size = 0;
 		bObj->Data = nullptr;
+		bObj->Version = 0;
 		strcpy(bObj->ViewFormat, "float");
 
 		glGenBuffers(1, &bObj->ID);
@@ -729,10 +745,14 @@ namespace ed {
 		glBufferData(GL_UNIFORM_BUFFER, 0, NULL, GL_STATIC_DRAW); // allocate 0 bytes of memory
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
+		m_addItem(item);
+
 		return true;
 	}
 	bool ObjectManager::CreateImage(const std::string& name, glm::ivec2 size)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating an image " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -743,7 +763,6 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::Image);
-		m_items.push_back(item);
 
 		ed::ImageObject* iObj = item->Image = new ImageObject();
 
@@ -758,10 +777,14 @@ namespace ed {
 		iObj->Size = size;
 		iObj->Format = GL_RGBA32F;
 
+		m_addItem(item);
+
 		return true;
 	}
 	bool ObjectManager::CreateImage3D(const std::string& name, glm::ivec3 size)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating an image " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -772,7 +795,6 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::Image3D);
-		m_items.push_back(item);
 
 		ed::Image3DObject* iObj = item->Image3D = new Image3DObject();
 		iObj->Size = size;
@@ -785,10 +807,14 @@ namespace ed {
 		glTexImage3D(GL_TEXTURE_3D, 0, iObj->Format, size.x, size.y, size.z, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 		glBindTexture(GL_TEXTURE_3D, 0);
 
+		m_addItem(item);
+
 		return true;
 	}
 	bool ObjectManager::CreatePluginItem(const std::string& name, const std::string& objtype, void* data, GLuint id, IPlugin1* owner)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a plugin object " + name + " of type " + objtype + "...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -799,7 +825,7 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::PluginObject);
-		m_items.push_back(item);
+		m_addItem(item);
 
 		PluginObject* pObj = item->Plugin = new PluginObject();
 		strcpy(pObj->Type, objtype.c_str());
@@ -811,6 +837,8 @@ namespace ed {
 	}
 	bool ObjectManager::CreateKeyboardTexture(const std::string& name)
 	{
+		m_assetGeneration++;
+
 		Logger::Get().Log("Creating a keyboard texture " + name + " ...");
 
 		if (name.size() == 0 || Exists(name)) {
@@ -821,7 +849,6 @@ namespace ed {
 		m_parser->ModifyProject();
 
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::KeyboardTexture);
-		m_items.push_back(item);
 
 		GLenum fmt = GL_RED;
 		int width = 256, height = 3;
@@ -839,6 +866,8 @@ namespace ed {
 
 		item->TextureSize = glm::ivec2(width, height);
 
+		m_addItem(item);
+
 		return true;
 	}
 		
@@ -953,6 +982,8 @@ namespace ed {
 				stbi_image_free(data);
 			else
 				dds_image_free(ddsImage);
+
+			buf->Version++;
 			
 			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
@@ -988,6 +1019,8 @@ namespace ed {
 					index += 4;
 				}
 
+			buf->Version++;
+
 			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
 			glBindBuffer(GL_UNIFORM_BUFFER, 0);
@@ -1012,6 +1045,7 @@ namespace ed {
 			bufRead.read(data, bufSize);
 			memcpy(buf->Data, data, bufSize);
 			free(data);
+			buf->Version++;
 
 			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
@@ -1025,6 +1059,8 @@ namespace ed {
 
 	bool ObjectManager::ReloadTexture(ObjectManagerItem* item, const std::string& newPath, bool forcely/* = false*/)
 	{
+		m_assetGeneration++;
+
 		if (item->Type != ObjectType::Texture) {
 			Logger::Get().Log("Cant reload non-texture: " + item->Name);
 			return false;
@@ -1032,115 +1068,191 @@ namespace ed {
 
 		Logger::Get().Log("Reloading a texture " + newPath + " ...");
 
-		GLuint oldID = item->Texture;
-
-		stbi_set_flip_vertically_on_load(1);
-
 		for (int i = 0; i < m_items.size(); i++) {
 			if (m_items[i] == item) {
 				std::string path = m_parser->GetProjectPath(newPath);
-				int width = 0, height = 0, depth = 0;
-				unsigned char* data = nullptr;
-				bool isFloat = false;
-				dds_image_t ddsImage = nullptr;
-
-				bool isDDS = (std::filesystem::path(path).extension().u8string() == ".dds");
-				
-				if (isDDS) {
-					ddsImage = dds_load_from_file(path.c_str());
-
-					data = ddsImage->pixels;
-					width = ddsImage->header.width;
-					height = ddsImage->header.height;
-					depth = ddsImage->header.depth;
-				} else {
-					int nrChannels = 0;
-					if (stbi_is_hdr(path.c_str())) {
-						data = (unsigned char*)stbi_loadf(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-						isFloat = true;
-					} else {
-						data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-					}
-				}
-		
-				if (data == nullptr || width == 0 || height == 0 ||(isDDS && ddsImage == nullptr) || (item->Type == ObjectType::Texture3D && depth == 0)){ 
+				if (!std::filesystem::exists(path)) {
 					Logger::Get().Log("Failed to load a texture " + newPath + " from file", true);
 					return false;
 				}
 
 				if (forcely) {
 					m_parser->ModifyProject();
-				}else {
+				} else {
 					if (m_items[i]->Name != newPath) {
+						m_lookup.Rename(item, item->Name, newPath);
+						m_msgs->RenameGroup(item->Name, newPath);
 						m_items[i]->Name = newPath;
 						m_parser->ModifyProject();
 					}
 				}
 
-				if (item->Type == ObjectType::Texture3D) {
-					// normal texture
-					glBindTexture(GL_TEXTURE_3D, item->Texture);
-					glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA, width, height, depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-					glGenerateMipmap(GL_TEXTURE_3D);
-					glBindTexture(GL_TEXTURE_3D, 0);
-				} else {
+				// the old pixels are kept until the new image is decoded (the previous job for this item is replaced)
+				TextureLoadJob* job = new TextureLoadJob();
+				job->Paths.push_back(path);
+				job->Flip = true;
+				m_submitTextureJob(item, job);
 
-					GLuint internalFormat = isFloat ? GL_RGBA32F : GL_RGBA8; //It used to be GL_RGBA, but since type is always GL_UNSIGNED_BYTE, not SHORT4444 alike, GL_RGBA8 is more precise
-					GLenum format = GL_RGBA;
-					GLenum type = isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE;
+				return true;
+			}
+		}
 
-					// normal texture
-					glBindTexture(GL_TEXTURE_2D, item->Texture);
-					glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
-					glGenerateMipmap(GL_TEXTURE_2D);
-					glBindTexture(GL_TEXTURE_2D, 0);
+		return false;
+	}
 
-					// flipped texture
+	bool ObjectManager::UpdateTextureLoading()
+	{
+		bool applied = false;
+
+		std::vector<TextureLoadJob*> jobs = m_textureLoader.GetFinishedJobs();
+		for (TextureLoadJob* job : jobs) {
+			// skip the job if the item was removed or reloaded in the meantime
+			if (m_textureJobIDs.count(job->Item) && m_textureJobIDs[job->Item] == job->ID) {
+				m_textureJobIDs.erase(job->Item);
+				m_applyTextureJob(job);
+				applied = true;
+			}
 
-					int pixelSize = (isFloat ? 4 * 4 : 4);
+			delete job;
+		}
 
-					unsigned char* flippedData = (unsigned char*)malloc(width * height * pixelSize);
-					memcpy(flippedData, data, width * height * pixelSize);
-					stbi_vertical_flip(flippedData, width, height, pixelSize); //No need to do it on our own, it can handle different pixel size
+		return applied;
+	}
+	void ObjectManager::FinishTextureLoading()
+	{
+		m_textureLoader.Wait();
+		UpdateTextureLoading();
+	}
+	void ObjectManager::m_submitTextureJob(ObjectManagerItem* item, TextureLoadJob* job)
+	{
+		job->Item = item;
+		job->ID = ++m_textureJobCounter;
+		m_textureJobIDs[item] = job->ID;
 
-					glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-					glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, flippedData);
-					glGenerateMipmap(GL_TEXTURE_2D);
-					glBindTexture(GL_TEXTURE_2D, 0);
+		m_textureLoader.Submit(job);
+	}
+	void ObjectManager::m_applyTextureJob(TextureLoadJob* job)
+	{
+		ObjectManagerItem* item = job->Item;
+
+		// the item stays in the project (with its placeholder or previous image) so that it can be reloaded
+		if (!job->Succeeded) {
+			Logger::Get().Log(job->Error, true);
+			item->LoadError = job->Error;
+			m_msgs->ClearGroup(item->Name);
+			m_msgs->Add(MessageStack::Type::Warning, item->Name, job->Error);
+			return;
+		}
+		if (!item->LoadError.empty()) {
+			item->LoadError.clear();
+			m_msgs->ClearGroup(item->Name);
+		}
 
-					free(flippedData);
-				}
+		m_assetGeneration++;
 
-				item->TextureSize = glm::ivec2(width, height);
-				item->Depth = depth;
+		const TextureLoadImage& first = job->Images[0];
+		GLuint internalFormat = first.IsFloat ? GL_RGBA32F : GL_RGBA8; //It used to be GL_RGBA, but since type is always GL_UNSIGNED_BYTE, not SHORT4444 alike, GL_RGBA8 is more precise
+		GLenum format = GL_RGBA;
+		GLenum type = first.IsFloat ? GL_FLOAT : GL_UNSIGNED_BYTE;
 
-				if (!isDDS)
-					stbi_image_free(data);
-				else
-					dds_image_free(ddsImage);
+		if (item->Type == ObjectType::Texture) {
+			// the texture objects could've been swapped by FlipTexture() while the image was loading
+			GLuint tex = item->Texture_VFlipped ? item->FlippedTexture : item->Texture;
+			GLuint flippedTex = item->Texture_VFlipped ? item->Texture : item->FlippedTexture;
 
-				if (item->Texture_VFlipped) {
-					std::swap(item->Texture, item->FlippedTexture);
-				}
+			// normal texture
+			int levels = 0;
+			glBindTexture(GL_TEXTURE_2D, tex);
+			if (first.Compressed != nullptr)
+				levels = uploadCompressedLevels(GL_TEXTURE_2D, first, internalFormat, type);
+			else {
+				glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, first.Width, first.Height, 0, format, type, first.Data);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000); // could've been limited by a compressed file
+				glGenerateMipmap(GL_TEXTURE_2D);
+				levels = TextureHelper::Utility::numMipmapLevels(first.Width, first.Height);
+			}
+			glBindTexture(GL_TEXTURE_2D, 0);
 
-				//Rebind texture
-				int newID = item->Texture;
-				for (auto& pipeline_bindvector : m_binds)
-				{
-					std::vector<GLuint>& bindVector = pipeline_bindvector.second;
-					for (size_t i = 0; i < bindVector.size(); ++i)
-					{
-						if (bindVector[i] == oldID) {
-							bindVector[i] = newID;
-						}
-					}
-				}
+			// flipped texture - only if it was requested while the image was loading
+			if (flippedTex != 0)
+				copyTextureFlipped(tex, flippedTex, first.Width, first.Height, internalFormat, format, type);
 
-				return true;
+			item->TextureSize = glm::ivec2(first.Width, first.Height);
+
+			item->TextureDetail.reset(new TextureHelper::TextureDesc);
+			TextureHelper::TextureDesc& texture = *item->TextureDetail;
+			texture.id = tex;
+			texture.target = GL_TEXTURE_2D;
+			texture.width = first.Width;
+			texture.height = first.Height;
+			texture.levels = levels;
+			texture.format = format;
+			texture.type = type;
+			texture.internalFormat = internalFormat;
+			assert(texture.Validate()); //Make sure the format is valid
+		} else if (item->Type == ObjectType::CubeMap) {
+			// same order as the job's paths: left, top, front, bottom, right, back
+			static const GLenum faces[6] = {
+				GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
+				GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Z
+			};
+
+			glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
+			for (int i = 0; i < 6; i++) {
+				const TextureLoadImage& img = job->Images[i];
+				glTexImage2D(faces[i], 0, img.IsFloat ? GL_RGBA32F : GL_RGBA8, img.Width, img.Height, 0, format, img.IsFloat ? GL_FLOAT : GL_UNSIGNED_BYTE, img.Data);
 			}
-		}
+			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
-		return false;
+			item->TextureSize = glm::ivec2(first.Width, first.Height);
+
+			item->TextureDetail.reset(new TextureHelper::TextureDesc);
+			TextureHelper::TextureDesc& texture = *item->TextureDetail;
+			texture.id = item->Texture;
+			texture.target = GL_TEXTURE_2D;
+			texture.width = first.Width;
+			texture.height = first.Height;
+			texture.levels = TextureHelper::Utility::numMipmapLevels(first.Width, first.Height);
+			texture.format = format;
+			texture.type = type;
+			texture.internalFormat = internalFormat;
+			assert(texture.Validate());
+
+			if (item->EnvironmentTypeValue == EnvironmentType_Specular) {
+				GLuint oldID = item->Texture;
+				*(item->TextureDetail) = TextureHelper::PostProcessCubemap_PrefilteredSpecular(*item->TextureDetail);
+				assert(item->TextureDetail->Validate());
+				item->Texture = item->TextureDetail->id; //Texture was recreated
+				m_lookup.ChangeTexture(item, oldID, item->Texture);
+
+				// the passes might already use the unfiltered cube map
+				m_rebindTexture(oldID, item->Texture);
+				glDeleteTextures(1, &oldID);
+
+				// specular map needs linear filter
+				item->Texture_MinFilter = GL_LINEAR_MIPMAP_LINEAR;
+				this->UpdateTextureParameters(item);
+			}
+
+			if (job->CacheKey != 0) {
+				// only the specular cube has the whole mip chain
+				TextureHelper::TextureDesc cacheDesc = *item->TextureDetail;
+				if (item->EnvironmentTypeValue != EnvironmentType_Specular)
+					cacheDesc.levels = 1;
+				EnvironmentCache::Instance().Save(job->CacheKey, cacheDesc);
+			}
+		}
+	}
+	void ObjectManager::m_rebindTexture(GLuint oldID, GLuint newID)
+	{
+		for (auto& key : m_binds)
+			for (int i = 0; i < key.second.size(); i++)
+				if (key.second[i] == oldID)
+					key.second[i] = newID;
+		for (auto& key : m_uniformBinds)
+			for (int i = 0; i < key.second.size(); i++)
+				if (key.second[i] == oldID)
+					key.second[i] = newID;
 	}
 
 	void ObjectManager::Pause(bool pause)
@@ -1233,6 +1345,8 @@ namespace ed {
 	}
 	void ObjectManager::Update(float delta)
 	{
+		m_frameGeneration++; // audio & keyboard textures are updated every frame
+
 		for (auto& it : m_items) {
 			// update audio items
 			if (it->Type == ed::ObjectType::Audio && it->Sound != nullptr) {
@@ -1264,6 +1378,8 @@ namespace ed {
 	}
 	void ObjectManager::Remove(const std::string& file)
 	{
+		m_assetGeneration++;
+
 		m_parser->ModifyProject();
 
 		ed::ObjectManagerItem* item = Get(file);
@@ -1296,6 +1412,13 @@ namespace ed {
 			pobj->Owner->Object_Remove(file.c_str(), pobj->Type, pobj->Data, pobj->ID);
 		}
 
+		m_lookup.Remove(item, item->Name, item->Texture, item->Buffer != nullptr ? item->Buffer->ID : 0);
+		if (item->Buffer != nullptr)
+			m_bufferGeometry.erase(item->Buffer);
+		m_textureJobIDs.erase(item); // the job's result will be ignored
+		if (!item->LoadError.empty())
+			m_msgs->ClearGroup(item->Name);
+
 		delete item;
 		m_items.erase(m_items.begin() + index);
 	}
@@ -1401,14 +1524,13 @@ namespace ed {
 	}
 	bool ObjectManager::Exists(const std::string& name)
 	{
-		for (int i = 0; i < m_items.size(); i++)
-			if (m_items[i]->Name == name)
-				return true;
-		return false;
+		return Get(name) != nullptr;
 	}
 
 	void ObjectManager::UploadDataToImage(ImageObject* img, GLuint tex, glm::ivec2 texSize)
 	{
+		m_assetGeneration++;
+
 		GLuint imgTex = 0;
 		for (auto& obj : m_items)
 			if (obj->Image == img) {
@@ -1505,46 +1627,110 @@ namespace ed {
 
 	ObjectManagerItem* ObjectManager::GetByTextureID(GLuint tex)
 	{
-		for (int i = 0; i < m_items.size(); i++)
-			if (m_items[i]->Texture == tex)
-				return m_items[i];
-		return nullptr;
+		return m_lookup.GetByTexture(tex);
+	}
+	uint64_t ObjectManager::GetTextureGeneration(ObjectManagerItem* item)
+	{
+		if (item != nullptr && (item->Type == ObjectType::Texture || item->Type == ObjectType::CubeMap || item->Type == ObjectType::Texture3D))
+			return m_assetGeneration;
+
+		return m_assetGeneration + m_frameGeneration;
 	}
 	ObjectManagerItem* ObjectManager::GetByBufferID(GLuint tex)
 	{
-		for (int i = 0; i < m_items.size(); i++)
-			if (m_items[i]->Buffer && m_items[i]->Buffer->ID == tex)
-				return m_items[i];
-		return nullptr;
+		return m_lookup.GetByBuffer(tex);
 	}
 	ObjectManagerItem* ObjectManager::Get(const std::string& name)
 	{
-		for (int i = 0; i < m_items.size(); i++)
-			if (m_items[i]->Name == name)
-				return m_items[i];
-		return nullptr;
+		return m_lookup.GetByName(name);
+	}
+	ObjectManager::BufferGeometry& ObjectManager::GetBufferGeometry(BufferObject* buf)
+	{
+		BufferGeometry& geo = m_bufferGeometry[buf];
+
+		// the editor keeps a copy of every buffer's data - no need to read it back from the GPU
+		const char* data = (const char*)buf->Data;
+		size_t size = data == nullptr ? 0 : buf->Size;
+		if (geo.Valid && geo.Version == buf->Version && geo.Format == buf->ViewFormat)
+			return geo;
+
+		geo.Valid = true;
+		geo.Version = buf->Version;
+		geo.Format = buf->ViewFormat;
+		geo.Positions.clear();
+		geo.BVH.Clear();
+		geo.MinBound = geo.MaxBound = glm::vec3(0.0f);
+
+		std::vector<ShaderVariable::ValueType> tData = ParseBufferFormat(buf->ViewFormat);
+
+		int stride = 0;
+		for (const auto& dataEl : tData)
+			stride += ShaderVariable::GetSize(dataEl, true);
+
+		if (tData.size() == 0 || stride == 0)
+			return geo;
+
+		// first element is the position
+		int elCount = std::min(3, ShaderVariable::GetSize(tData[0]) / 4);
+		int rows = size / stride;
+
+		geo.Positions.resize(rows, glm::vec3(0.0f));
+		for (int r = 0; r < rows; r++) {
+			const float* curPtr = (const float*)(data + r * stride);
+			for (int c = 0; c < elCount; c++) {
+				geo.Positions[r][c] = curPtr[c];
+				geo.MinBound[c] = glm::min(geo.MinBound[c], curPtr[c]);
+				geo.MaxBound[c] = glm::max(geo.MaxBound[c], curPtr[c]);
+			}
+		}
+
+		return geo;
+	}
+	void ObjectManager::m_addItem(ObjectManagerItem* item)
+	{
+		m_items.push_back(item);
+		m_lookup.Add(item, item->Name, item->Texture, item->Buffer != nullptr ? item->Buffer->ID : 0);
 	}
 
 	void ObjectManager::FlipTexture(const std::string& name)
 	{
+		m_assetGeneration++;
+
 		ObjectManagerItem* item = Get(name);
 
 		if (item != nullptr) {
+			if (GetFlippedTexture(item) == 0)
+				return;
+
 			GLuint tex = item->Texture;
-			for (auto& key : m_binds)
-				for (int i = 0; i < key.second.size(); i++)
-					if (key.second[i] == tex)
-						key.second[i] = item->FlippedTexture;
-			for (auto& key : m_uniformBinds)
-				for (int i = 0; i < key.second.size(); i++)
-					if (key.second[i] == tex)
-						key.second[i] = item->FlippedTexture;
+			m_rebindTexture(tex, item->FlippedTexture);
+			m_lookup.ChangeTexture(item, tex, item->FlippedTexture);
 
 			item->Texture = item->FlippedTexture;
 			item->FlippedTexture = tex;
 			item->Texture_VFlipped = !item->Texture_VFlipped;
 		}
 	}
+	GLuint ObjectManager::GetFlippedTexture(ObjectManagerItem* item)
+	{
+		if (item->Type != ObjectType::Texture || item->FlippedTexture != 0)
+			return item->FlippedTexture;
+
+		// Texture is always the normal variant until the flipped one exists
+		const TextureHelper::TextureDesc& desc = *item->TextureDetail;
+
+		glGenTextures(1, &item->FlippedTexture);
+		glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		copyTextureFlipped(item->Texture, item->FlippedTexture, item->TextureSize.x, item->TextureSize.y, desc.internalFormat, desc.format, desc.type);
+
+		return item->FlippedTexture;
+	}
 	void ObjectManager::UpdateTextureParameters(const std::string& name)
 	{
 		ObjectManagerItem* item = Get(name);
@@ -1562,11 +1748,13 @@ namespace ed {
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
 
-				glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+				if (item->FlippedTexture != 0) {
+					glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+				}
 
 				glBindTexture(GL_TEXTURE_2D, 0);
 			}
@@ -1614,6 +1802,8 @@ namespace ed {
 
 	void ObjectManager::ResizeRenderTexture(ObjectManagerItem* item, glm::ivec2 size)
 	{
+		m_assetGeneration++;
+
 		RenderTextureObject* rtObj = item->RT;
 
 		if (rtObj == nullptr)
@@ -1628,16 +1818,11 @@ namespace ed {
 		glBindTexture(GL_TEXTURE_2D, rtObj->DepthStencilBuffer);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, size.x, size.y, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
 		glBindTexture(GL_TEXTURE_2D, 0);
-
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, rtObj->BufferMS);
-		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, rtObj->Format, size.x, size.y, true);
-
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, rtObj->DepthStencilBufferMS);
-		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, GL_DEPTH24_STENCIL8, size.x, size.y, true);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
 	}
 	void ObjectManager::ResizeImage(ObjectManagerItem* item, glm::ivec2 size)
 	{
+		m_assetGeneration++;
+
 		ImageObject* iobj = item->Image;
 
 		m_parser->ModifyProject();
@@ -1650,6 +1835,8 @@ namespace ed {
 	}
 	void ObjectManager::ResizeImage3D(ObjectManagerItem* item, glm::ivec3 size)
 	{
+		m_assetGeneration++;
+
 		Image3DObject* iobj = item->Image3D;
 
 		m_parser->ModifyProject();
@@ -5,17 +5,20 @@
 #include <utility>
 #include <vector>
 
+#include <SHADERed/Engine/BVH.h>
 #include <SHADERed/Objects/AudioAnalyzer.h>
 #include <SHADERed/Objects/PipelineItem.h>
 #include <SHADERed/Objects/ProjectParser.h>
+#include <SHADERed/Objects/ObjectLookup.h>
 #include <SHADERed/Objects/ObjectManagerItem.h>
+#include <SHADERed/Objects/TextureLoadService.h>
 
 namespace ed {
 	class RenderEngine;
 
 	class ObjectManager {
 	public:
-		ObjectManager(ProjectParser* parser, RenderEngine* rnd);
+		ObjectManager(ProjectParser* parser, RenderEngine* rnd, MessageStack* msgs);
 		~ObjectManager();
 
 		bool CreateRenderTexture(const std::string& name);
@@ -54,6 +57,14 @@ namespace ed {
 
 		bool ReloadTexture(ObjectManagerItem* item, const std::string& newPath, bool forcely=false);
 
+		// textures and cube maps are decoded on background threads - until their pixels are uploaded
+		// they contain a 1x1 placeholder (the GL texture object doesn't change once the upload is done). If a file can't
+		// be decoded, the item keeps its placeholder (or its previous image), its LoadError is set and a warning is added
+		bool UpdateTextureLoading(); // call this every frame - returns true if any texture was uploaded
+		void FinishTextureLoading(); // wait for all textures to load and upload them
+		inline bool IsLoadingTextures() { return !m_textureJobIDs.empty(); }
+		inline bool IsLoading(ObjectManagerItem* item) { return m_textureJobIDs.count(item) > 0; }
+
 		void Clear();
 
 		inline std::vector<ObjectManagerItem*>& GetObjects() { return m_items; }
@@ -70,6 +81,7 @@ namespace ed {
 		std::vector<ed::ShaderVariable::ValueType> ParseBufferFormat(const std::string& str);
 
 		void FlipTexture(const std::string& name);
+		GLuint GetFlippedTexture(ObjectManagerItem* item); // creates the vertically flipped variant of a 2D texture on the first call
 		void UpdateTextureParameters(const std::string& name);
 		void UpdateTextureParameters(ObjectManagerItem* item);
 
@@ -93,12 +105,53 @@ namespace ed {
 
 		bool Exists(const std::string& name);
 
+		// texture generation - changes whenever the contents of a texture might have changed (used to cache texture data)
+		// textures loaded from files only change when objects are (re)created while render textures, images, etc... change every frame
+		inline void InvalidateDynamicTextures() { m_frameGeneration++; }
+		uint64_t GetTextureGeneration(ObjectManagerItem* item);
+
+		// vertex positions stored in a buffer (read from its CPU copy and parsed with its ViewFormat) - only
+		// parsed again when the buffer's Version or format changes. BVH is built by the user on the first pick
+		struct BufferGeometry {
+			BufferGeometry()
+					: Valid(false)
+					, Version(0)
+					, MinBound(0.0f)
+					, MaxBound(0.0f)
+			{
+			}
+
+			bool Valid;
+			uint64_t Version; // BufferObject::Version that the geometry was parsed from
+			std::string Format;
+			std::vector<glm::vec3> Positions;
+			glm::vec3 MinBound, MaxBound;
+			eng::BVH BVH;
+		};
+		BufferGeometry& GetBufferGeometry(BufferObject* buf);
+
 	private:
 		RenderEngine* m_renderer;
 		ProjectParser* m_parser;
+		MessageStack* m_msgs;
 
 		std::vector<ObjectManagerItem*> m_items;
 
+		// Get*() tables - updated whenever an item is added, renamed, removed or gets a new texture
+		ObjectLookup m_lookup;
+		void m_addItem(ObjectManagerItem* item); // call once the item's texture/buffer exists
+
+		std::unordered_map<BufferObject*, BufferGeometry> m_bufferGeometry;
+
+		TextureLoadService m_textureLoader;
+		uint64_t m_textureJobCounter;
+		std::unordered_map<ObjectManagerItem*, uint64_t> m_textureJobIDs; // ID of the job that loads the item's pixels
+		void m_submitTextureJob(ObjectManagerItem* item, TextureLoadJob* job);
+		void m_applyTextureJob(TextureLoadJob* job);
+		void m_rebindTexture(GLuint oldID, GLuint newID);
+
+		uint64_t m_assetGeneration, m_frameGeneration;
+
 		std::unordered_map<SDL_Keycode, int> m_keyIDs;
 
 		inline GLuint m_getGLObject(ObjectManagerItem* item)
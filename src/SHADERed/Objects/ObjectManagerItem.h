@@ -33,7 +33,7 @@ namespace ed {
 
 	/* object information */
 	struct RenderTextureObject {
-		GLuint DepthStencilBuffer, DepthStencilBufferMS, BufferMS; // ColorBuffer is stored in ObjectManager
+		GLuint DepthStencilBuffer; // ColorBuffer is stored in ObjectManager, multisampled copies in RenderEngine
 		glm::ivec2 FixedSize;
 		glm::vec2 RatioSize;
 		glm::vec4 ClearColor;
@@ -66,6 +66,7 @@ namespace ed {
 		char ViewFormat[256]; // vec3;vec3;vec2
 		bool PreviewPaused;
 		GLuint ID;
+		uint64_t Version; // incremented whenever Data is written - caches built from the data compare it
 	};
 	struct ImageObject {
 		glm::ivec2 Size;
@@ -105,9 +106,10 @@ namespace ed {
 
 		glm::ivec2 TextureSize;
 		int Depth;
-		std::unique_ptr<TextureHelper::TextureDesc> TextureDetail; //Save more detail
-		GLuint Texture, FlippedTexture;
+		std::unique_ptr<TextureHelper::TextureDesc> TextureDetail; //Save more detail (of the normal variant)
+		GLuint Texture, FlippedTexture; // FlippedTexture is 0 until ObjectManager::GetFlippedTexture() creates it (swapped with Texture while Texture_VFlipped is set)
 		std::vector<std::string> CubemapPaths;
+		std::string LoadError; // set if the texture/cube map file(s) couldn't be loaded
 		
 		EnvironmentType EnvironmentTypeValue;
 
@@ -5,18 +5,13 @@ namespace ed {
 	class PerformanceTimer {
 	public:
 		PerformanceTimer(PipelineItem* pass) {
-			IsDone = true;
-			IsCreated = false;
-			Object = 0;
 			LastTime = 0;
+			LastCPUTime = 0;
 			Pass = pass;
 		}
 
-		bool IsCreated;
-		bool IsDone;
-		uint64_t LastTime; // Last timer results
+		uint64_t LastTime;	  // Last timer results (GPU)
+		uint64_t LastCPUTime; // time spent submitting the item's commands
 		PipelineItem* Pass;
-
-		unsigned int Object; // OpenGL Query
 	};
 }
\ No newline at end of file
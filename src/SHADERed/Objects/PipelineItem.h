@@ -297,6 +297,8 @@ namespace ed {
 			void* InstanceBuffer;
 
 			int TheModelImportFlags = 0;
+
+			int LOD = -1; // < 0 -> picked based on the size on the screen
 		};
 
 		std::vector<ShaderVariable*>& GetShaderVariables(PipelineItem* pipelineItem);
@@ -1,3 +1,4 @@
+#include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
@@ -226,7 +227,7 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							eng::GeometryFactory::Release(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pdata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pdata->Type, pdata->PluginData);
@@ -247,7 +248,7 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							eng::GeometryFactory::Release(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pldata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pldata->Type, pldata->PluginData);
@@ -277,7 +278,7 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								eng::GeometryFactory::Release(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
@@ -304,7 +305,7 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								eng::GeometryFactory::Release(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
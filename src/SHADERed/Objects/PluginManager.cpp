@@ -399,7 +399,7 @@ namespace ed {
 
 			if (pitem != nullptr && pitem->Type == PipelineItem::ItemType::ShaderPass) {
 				pipe::ShaderPass* pass = (pipe::ShaderPass*)pitem->Data;
-				pass->Variables.Bind(item);
+				pass->Variables.Bind(item, false); // plugin might have its own program bound
 			}
 		};
 		plugin->GetViewMatrix = [](float* out) {
@@ -482,7 +482,7 @@ namespace ed {
 		};
 		plugin->GetFlippedTexture = [](void* objects, const char* name) -> unsigned int {
 			ObjectManager* obj = (ObjectManager*)objects;
-			return obj->Get(name)->FlippedTexture;
+			return obj->GetFlippedTexture(obj->Get(name));
 		};
 		plugin->GetTextureSize = [](void* objects, const char* name, int& w, int& h) {
 			ObjectManager* obj = (ObjectManager*)objects;
@@ -626,6 +626,7 @@ namespace ed {
 			/* PROJECT */
 			if (lwr == "fpcamera") return seti.Project.FPCamera;
 			if (lwr == "usealphachannel") return seti.Project.UseAlphaChannel;
+			if (lwr == "halfprecisionwindow") return seti.Project.HalfPrecisionWindow;
 
 			return false;
 		};
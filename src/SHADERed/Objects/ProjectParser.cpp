@@ -16,6 +16,7 @@
 
 #include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Engine/GeometryFactory.h>
+#include <SHADERed/Engine/Timer.h>
 #include <SHADERed/UI/CodeEditorUI.h>
 #include <SHADERed/UI/PinnedUI.h>
 #include <SHADERed/UI/PipelineUI.h>
@@ -70,11 +71,12 @@ namespace ed {
 	{
 		ResetProjectDirectory();
 		m_ui = gui;
+		m_modelLoadTime = 0.0f;
 	}
 	ProjectParser::~ProjectParser()
 	{
 	}
-	void ProjectParser::Open(const std::string& file)
+	bool ProjectParser::Open(const std::string& file)
 	{
 		Logger::Get().Log("Opening a project file " + file);
 
@@ -82,7 +84,7 @@ namespace ed {
 		pugi::xml_parse_result result = doc.load_file(file.c_str());
 		if (!result) {
 			Logger::Get().Log("Failed to parse a project file", true);
-			return;
+			return false;
 		}
 
 		// check if user has all required plugins
@@ -107,6 +109,11 @@ namespace ed {
 
 				std::string msg = "The project you are trying to open requires plugin \"" + pname + "\".";
 
+				if (m_ui == nullptr) {
+					Logger::Get().Log(msg, true);
+					break;
+				}
+
 				const SDL_MessageBoxButtonData buttons[] = {
 					{ SDL_MESSAGEBOX_BUTTON_RETURNKEY_DEFAULT, 0, "OK" },
 				};
@@ -133,6 +140,11 @@ namespace ed {
 
 						std::string msg = "The project you are trying to open requires plugin " + pname + " version " + std::to_string(pver) + " while you have version " + std::to_string(instPVer) + " installed.\n";
 
+						if (m_ui == nullptr) {
+							Logger::Get().Log(msg, true);
+							break;
+						}
+
 						const SDL_MessageBoxButtonData buttons[] = {
 							{ /* .flags, .buttonid, .text */ 0, 1, "NO" },
 							{ SDL_MESSAGEBOX_BUTTON_RETURNKEY_DEFAULT, 0, "YES" },
@@ -161,7 +173,7 @@ namespace ed {
 
 		if (!pluginTest) {
 			Logger::Get().Log("Missing plugin - project not loaded", true);
-			return;
+			return false;
 		}
 
 		CameraSnapshots::Clear();
@@ -180,6 +192,7 @@ namespace ed {
 			mdl.second = nullptr;
 		}
 		m_models.clear();
+		m_modelLoadTime = 0.0f;
 
 		m_pipe->Clear();
 		m_objects->Clear();
@@ -187,6 +200,7 @@ namespace ed {
 		Settings::Instance().Project.FPCamera = false;
 		Settings::Instance().Project.ClearColor = glm::vec4(0, 0, 0, 0);
 		Settings::Instance().Project.UseAlphaChannel = false;
+		Settings::Instance().Project.HalfPrecisionWindow = false;
 
 		pugi::xml_node projectNode = doc.child("project");
 		int projectVersion = 1; // if no project version is specified == using first project file
@@ -215,6 +229,8 @@ namespace ed {
 			m_plugins->GetPlugin(pname)->Project_EndLoad();
 
 		Logger::Get().Log("Finished with parsing a project file");
+
+		return true;
 	}
 	void ProjectParser::OpenTemplate()
 	{
@@ -876,6 +892,13 @@ namespace ed {
 				alphaNode.append_attribute("val").set_value(settings.Project.UseAlphaChannel);
 			}
 
+			// halfprecision
+			if (settings.Project.HalfPrecisionWindow) {
+				pugi::xml_node precisionNode = settingsNode.append_child("entry");
+				precisionNode.append_attribute("type").set_value("halfprecision");
+				precisionNode.append_attribute("val").set_value(settings.Project.HalfPrecisionWindow);
+			}
+
 			// include paths
 			if (settings.Project.IncludePaths.size() > 0) {
 				pugi::xml_node pathsNode = settingsNode.append_child("entry");
@@ -1001,7 +1024,9 @@ namespace ed {
 
 		// load the model
 		std::string path = GetProjectPath(file);
-		bool loaded = m_models[m_models.size() - 1].second->LoadFromFile(path, modelImportFlag);
+		eng::Timer loadTimer;
+		bool loaded = m_models[m_models.size() - 1].second->LoadFromFile(path, modelImportFlag, Settings::Instance().Preview.OptimizeModels, Settings::Instance().Preview.CompactModelVertices, Settings::Instance().Preview.GenerateModelLODs);
+		m_modelLoadTime += loadTimer.GetElapsedTime();
 		if (!loaded) {
 			m_models.erase(m_models.begin() + (m_models.size() - 1));
 			return nullptr;
@@ -1418,6 +1443,9 @@ namespace ed {
 
 				itemNode.append_child("modelImportFlags").text().set(data->TheModelImportFlags);
 
+				if (data->LOD >= 0)
+					itemNode.append_child("lod").text().set(data->LOD);
+
 			} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 				itemNode.append_attribute("type").set_value("vertexbuffer");
 
@@ -1630,6 +1658,7 @@ namespace ed {
 				mdata->Instanced = false;
 				mdata->InstanceCount = 0;
 				mdata->TheModelImportFlags = 0;
+				mdata->LOD = -1;
 
 				modelUBOs[mdata] = std::make_pair("", data);
 
@@ -1666,6 +1695,8 @@ namespace ed {
 						modelUBOs[mdata] = std::make_pair(attrNode.text().as_string(), data);
 					else if (strcmp(attrNode.name(), "modelImportFlags") == 0)
 						mdata->TheModelImportFlags = attrNode.text().as_int();
+					else if (strcmp(attrNode.name(), "lod") == 0)
+						mdata->LOD = attrNode.text().as_int();
 				}
 
 				if (strlen(mdata->Filename) > 0)
@@ -1802,7 +1833,7 @@ namespace ed {
 			// check if it should be collapsed
 			if (!passNode.attribute("collapsed").empty()) {
 				bool cs = passNode.attribute("collapsed").as_bool();
-				if (cs)
+				if (cs && m_ui != nullptr)
 					((PipelineUI*)m_ui->Get(ViewID::Pipeline))->Collapse(data);
 			}
 
@@ -2285,13 +2316,13 @@ namespace ed {
 		for (pugi::xml_node settingItem : projectNode.child("settings").children("entry")) {
 			if (!settingItem.attribute("type").empty()) {
 				std::string type = settingItem.attribute("type").as_string();
-				if (type == "property") {
+				if (type == "property" && m_ui != nullptr) {
 					PropertyUI* props = ((PropertyUI*)m_ui->Get(ViewID::Properties));
 					if (!settingItem.attribute("name").empty()) {
 						PipelineItem* item = m_pipe->Get(settingItem.attribute("name").as_string());
 						props->Open(item);
 					}
-				} else if (type == "file" && Settings::Instance().General.ReopenShaders) {
+				} else if (type == "file" && Settings::Instance().General.ReopenShaders && m_ui != nullptr) {
 					CodeEditorUI* editor = ((CodeEditorUI*)m_ui->Get(ViewID::Code));
 					if (!settingItem.attribute("name").empty()) {
 						PipelineItem* item = m_pipe->Get(settingItem.attribute("name").as_string());
@@ -2319,7 +2350,7 @@ namespace ed {
 						else if (strcmp(shaderType, "tes") == 0 && FileExists(path))
 							editor->Open(item, ShaderStage::TessellationEvaluation);
 					}
-				} else if (type == "pinned") {
+				} else if (type == "pinned" && m_ui != nullptr) {
 					PinnedUI* pinned = ((PinnedUI*)m_ui->Get(ViewID::Pinned));
 					if (!settingItem.attribute("name").empty()) {
 						const pugi::char_t* item = settingItem.attribute("name").as_string();
@@ -2429,7 +2460,7 @@ namespace ed {
 				// check if it should be collapsed
 				if (!passNode.attribute("collapsed").empty()) {
 					bool cs = passNode.attribute("collapsed").as_bool();
-					if (cs)
+					if (cs && m_ui != nullptr)
 						((PipelineUI*)m_ui->Get(ViewID::Pipeline))->Collapse(data);
 				}
 
@@ -3233,6 +3264,7 @@ namespace ed {
 				if (bufRead.is_open())
 					bufRead.read((char*)buf->Data, buf->Size);
 				bufRead.close();
+				buf->Version++;
 
 				glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 				glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
@@ -3307,10 +3339,10 @@ namespace ed {
 				mdl.first->InstanceBuffer = bobj;
 
 				for (auto& mesh : mdl.first->Data->Meshes)
-					gl::CreateVAO(mesh.VAO, mesh.VBO, mdl.second.second->InputLayout, mesh.EBO, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
+					gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, mdl.second.second->InputLayout, mesh.EBO, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
 			} else { // recreate vao anyway
 				for (auto& mesh : mdl.first->Data->Meshes)
-					gl::CreateVAO(mesh.VAO, mesh.VBO, mdl.second.second->InputLayout, mesh.EBO);
+					gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, mdl.second.second->InputLayout, mesh.EBO);
 			}
 		}
 		for (auto& vb : vbUBOs) {
@@ -3347,7 +3379,7 @@ namespace ed {
 		for (pugi::xml_node settingItem : projectNode.child("settings").children("entry")) {
 			if (!settingItem.attribute("type").empty()) {
 				std::string type = settingItem.attribute("type").as_string();
-				if (type == "property") {
+				if (type == "property" && m_ui != nullptr) {
 					PropertyUI* props = ((PropertyUI*)m_ui->Get(ViewID::Properties));
 					if (!settingItem.attribute("name").empty()) {
 						int type = 0; // pipeline item
@@ -3368,7 +3400,7 @@ namespace ed {
 							props->Open(item);
 						}
 					}
-				} else if (type == "file" && Settings::Instance().General.ReopenShaders) {
+				} else if (type == "file" && Settings::Instance().General.ReopenShaders && m_ui != nullptr) {
 					CodeEditorUI* editor = ((CodeEditorUI*)m_ui->Get(ViewID::Code));
 					if (!settingItem.attribute("name").empty()) {
 						PipelineItem* item = m_pipe->Get(settingItem.attribute("name").as_string());
@@ -3406,7 +3438,7 @@ namespace ed {
 							editor->Open(item, ShaderStage::Pixel);
 						}
 					}
-				} else if (type == "pinned") {
+				} else if (type == "pinned" && m_ui != nullptr) {
 					PinnedUI* pinned = ((PinnedUI*)m_ui->Get(ViewID::Pinned));
 					if (!settingItem.attribute("name").empty()) {
 						const pugi::char_t* item = settingItem.attribute("name").as_string();
@@ -3470,6 +3502,8 @@ namespace ed {
 						Settings::Instance().Project.UseAlphaChannel = settingItem.attribute("val").as_bool();
 					else
 						Settings::Instance().Project.UseAlphaChannel = false;
+				} else if (type == "halfprecision") {
+					Settings::Instance().Project.HalfPrecisionWindow = settingItem.attribute("val").as_bool();
 				} else if (type == "ipaths") {
 					Settings::Instance().Project.IncludePaths.clear();
 					for (pugi::xml_node pathNode : settingItem.children("path"))
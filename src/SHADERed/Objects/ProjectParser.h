@@ -36,7 +36,7 @@ namespace ed {
 		ProjectParser(PipelineManager* pipeline, ObjectManager* objects, RenderEngine* renderer, PluginManager* plugins, MessageStack* msgs, DebugInformation* debugger, GUIManager* gui);
 		~ProjectParser();
 
-		void Open(const std::string& file);
+		bool Open(const std::string& file); // false if the project wasn't loaded (parse error, missing plugin, ...)
 		void OpenTemplate();
 		inline void SetTemplate(const std::string& str) { m_template = str; }
 
@@ -47,6 +47,7 @@ namespace ed {
 		std::string LoadFile(const std::string& file);
 		char* LoadProjectFile(const std::string& file, size_t& len);
 		eng::Model* LoadModel(const std::string& file, int modelImportFlag);
+		inline float GetModelLoadTime() { return m_modelLoadTime; } // seconds spent loading models in the last Open()
 
 		void SaveProjectFile(const std::string& file, const std::string& data);
 
@@ -107,5 +108,6 @@ namespace ed {
 		void m_addPlugin(const std::string& name);
 
 		std::vector<std::pair<std::string, eng::Model*>> m_models;
+		float m_modelLoadTime;
 	};
 }
\ No newline at end of file
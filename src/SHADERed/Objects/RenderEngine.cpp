@@ -9,11 +9,15 @@
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
+#include <SHADERed/Objects/SPIRVParser.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
 
 #include <algorithm>
 #include <glm/gtx/intersect.hpp>
 
+#define MODEL_LOD_PIXEL_ERROR 1.0f // largest error of a model's LOD level on the screen
+#define GEOMETRY_BATCH_BLOCK "SHADERedGeometryBatch" // shader storage block that enables geometry batching
+
 static const GLenum fboBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5, GL_COLOR_ATTACHMENT6, GL_COLOR_ATTACHMENT7, GL_COLOR_ATTACHMENT8, GL_COLOR_ATTACHMENT9, GL_COLOR_ATTACHMENT10, GL_COLOR_ATTACHMENT11, GL_COLOR_ATTACHMENT12, GL_COLOR_ATTACHMENT13, GL_COLOR_ATTACHMENT14, GL_COLOR_ATTACHMENT15 };
 static const char* GeneralDebugShaderCode = R"(
 #version 330
@@ -29,6 +33,36 @@ void main()
 
 
 namespace ed {
+	static GLenum getShaderType(ShaderStage stage)
+	{
+		switch (stage) {
+		case ShaderStage::Pixel: return GL_FRAGMENT_SHADER;
+		case ShaderStage::Geometry: return GL_GEOMETRY_SHADER;
+		case ShaderStage::Compute: return GL_COMPUTE_SHADER;
+		case ShaderStage::TessellationControl: return GL_TESS_CONTROL_SHADER;
+		case ShaderStage::TessellationEvaluation: return GL_TESS_EVALUATION_SHADER;
+		default: return GL_VERTEX_SHADER;
+		}
+	}
+	static GLenum getWindowTextureFormat()
+	{
+		const Settings& settings = Settings::Instance();
+		if (settings.Project.HalfPrecisionWindow)
+			return settings.Project.UseAlphaChannel ? GL_RGBA16F : GL_RGB16F;
+		return settings.Project.UseAlphaChannel ? GL_RGBA32F : GL_RGB32F;
+	}
+	static void setGeometryItemTransform(PipelineItem* item, const glm::vec2& rtSize)
+	{
+		pipe::GeometryItem* geoData = reinterpret_cast<pipe::GeometryItem*>(item->Data);
+
+		if (geoData->Type == pipe::GeometryItem::Rectangle) {
+			// TODO: don't multiply with m_renderer->GetLastRenderSize() but rather with actual RT size
+			glm::vec3 scaleRect(geoData->Scale.x * rtSize.x, geoData->Scale.y * rtSize.y, 1.0f);
+			glm::vec3 posRect((geoData->Position.x + 0.5f) * rtSize.x, (geoData->Position.y + 0.5f) * rtSize.y, -1000.0f);
+			SystemVariableManager::Instance().SetGeometryTransform(item, scaleRect, geoData->Rotation, posRect);
+		} else
+			SystemVariableManager::Instance().SetGeometryTransform(item, geoData->Scale, geoData->Rotation, geoData->Position);
+	}
 	void DebugDrawPrimitives(int& vertexStart, int vertexCount, int maxVertexCount, int vertexStrip, GLuint topology, GLuint varLoc, bool instanced, int instanceCount, bool useIndices = false, int vbase = 0)
 	{
 		int actualVertexCount = vertexCount;
@@ -80,6 +114,7 @@ namespace ed {
 			, m_debug(debugger)
 			, m_lastSize(0, 0)
 			, m_pickAwaiting(false)
+			, m_pickVersion(0)
 			, m_rtColor(0)
 			, m_rtDepth(0)
 			, m_fbosNeedUpdate(false)
@@ -87,6 +122,12 @@ namespace ed {
 			, m_tessellationSupported(true)
 			, m_tessMaxPatchVertices(0)
 			, m_wasMultiPick(false)
+			, m_compiler(project)
+			, m_compileJobCounter(0)
+			, m_totalPerfTime(0)
+			, m_itemValuesVersion(0)
+			, m_batchBuffer(0)
+			, m_unsyncedUnknown(false)
 	{
 		m_paused = false;
 
@@ -108,6 +149,7 @@ namespace ed {
 		glDeleteTextures(1, &m_rtColorMS);
 		glDeleteTextures(1, &m_rtDepthMS);
 		glDeleteShader(m_generalDebugShader);
+		glDeleteBuffers(1, &m_batchBuffer);
 		FlushCache();
 	}
 	void RenderEngine::Render(int width, int height, bool isDebug, PipelineItem* breakItem)
@@ -117,6 +159,9 @@ namespace ed {
 		if (isMSAA)
 			glEnable(GL_MULTISAMPLE);
 
+		// render textures, images, etc... are about to be modified
+		m_objects->InvalidateDynamicTextures();
+
 		if (Settings::Instance().Preview.EnableCubemapSeamleass)
 			glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 			
@@ -125,7 +170,7 @@ namespace ed {
 			m_lastSize = glm::vec2(width, height);
 
 			glBindTexture(GL_TEXTURE_2D, m_rtColor);
-			glTexImage2D(GL_TEXTURE_2D, 0, Settings::Instance().Project.UseAlphaChannel ? GL_RGBA32F : GL_RGB32F, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glTexImage2D(GL_TEXTURE_2D, 0, getWindowTextureFormat(), width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 			glBindTexture(GL_TEXTURE_2D, 0);
@@ -136,12 +181,21 @@ namespace ed {
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 			glBindTexture(GL_TEXTURE_2D, 0);
 
-			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_rtColorMS);
-			glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, Settings::Instance().Project.UseAlphaChannel ? GL_RGBA : GL_RGB, width, height, true);
+			// recreate the multisampled textures so that their storage is freed when MSAA is turned off
+			glDeleteTextures(1, &m_rtColorMS);
+			glDeleteTextures(1, &m_rtDepthMS);
+			glGenTextures(1, &m_rtColorMS);
+			glGenTextures(1, &m_rtDepthMS);
+			m_msAttached.clear();
 
-			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_rtDepthMS);
-			glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, GL_DEPTH24_STENCIL8, width, height, true);
-			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+			if (Settings::Instance().Preview.MSAA != 1) {
+				glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_rtColorMS);
+				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, Settings::Instance().Project.UseAlphaChannel ? GL_RGBA : GL_RGB, width, height, true);
+
+				glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_rtDepthMS);
+				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Settings::Instance().Preview.MSAA, GL_DEPTH24_STENCIL8, width, height, true);
+				glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+			}
 
 			// update
 			std::vector<ObjectManagerItem*>& objs = m_objects->GetObjects();
@@ -157,6 +211,14 @@ namespace ed {
 		// cache elements
 		m_cache();
 
+		// decide which multisampled textures each pass renders to
+		if (isMSAA)
+			m_planMSTargets(width, height);
+		else if (Settings::Instance().Preview.MSAA == 1 && m_msTargetPool.GetTextureCount() > 0) {
+			m_msTargetPool.Clear();
+			m_msAttached.clear();
+		}
+
 		auto& systemVM = SystemVariableManager::Instance();
 
 		auto& itemVarValues = GetItemVariableValues();
@@ -167,41 +229,29 @@ namespace ed {
 
 		m_plugins->BeginRender();
 
-		// check if we need to perform performance measurement
-		bool performPerfMeasure = Settings::Instance().General.Profiler && m_lastPerfMeasure.GetElapsedTime() > 0.4f;
-		if (performPerfMeasure) {
-			bool isAllDone = true;
-			unsigned long long totalTime = 0;
-
-			for (int i = 0; i < m_perfTimers.size(); i++) {
-				if (!m_perfTimers[i].IsDone) {
-					isAllDone = false;
-
-					int queryDone = 0;
-					glGetQueryObjectiv(m_perfTimers[i].Object, GL_QUERY_RESULT_AVAILABLE, &queryDone);
+		// the state could've been changed by anything since the last frame
+		m_glState.Invalidate();
 
-					if (queryDone) {
-						glGetQueryObjectui64v(m_perfTimers[i].Object, GL_QUERY_RESULT, &m_perfTimers[i].LastTime);
-						m_perfTimers[i].IsDone = true;
-					}
-				}
-				totalTime += m_perfTimers[i].LastTime;
-			}
-			
-			m_totalPerfTime = totalTime;
-			performPerfMeasure &= isAllDone;
+		// record the CPU & GPU time of every item and draw call
+		bool profile = Settings::Instance().General.Profiler && !isDebug;
+		if (profile) {
+			m_profiler.BeginFrame();
 
-			if (performPerfMeasure)
+			// the per item view only shows a new frame every 0.4s
+			if (m_lastPerfMeasure.GetElapsedTime() > 0.4f && !m_profiler.GetHistory().empty()) {
+				m_updatePerfTimers(m_profiler.GetHistory().back());
 				m_lastPerfMeasure.Restart();
+			}
 		}
 
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* it = m_items[i];
 
-			if (performPerfMeasure) {
-				glBeginQuery(GL_TIME_ELAPSED, m_perfTimers[i].Object);
-				m_perfTimers[i].IsDone = false;
-			}
+			if (profile)
+				m_profiler.BeginPass(it->Name);
+
+			// make the results of earlier compute passes visible to this item
+			m_syncComputeWrites(it);
 
 			if (it->Type == PipelineItem::ItemType::ShaderPass) {
 				pipe::ShaderPass* data = (pipe::ShaderPass*)it->Data;
@@ -218,11 +268,16 @@ namespace ed {
 				if (m_shaders[i] == 0)
 					continue;
 
+				if (isMSAA)
+					m_attachMSTargets(data);
+
+				DrawList& drawList = m_getDrawList(data);
+
 				if (data->TSUsed && m_tessellationSupported) 
 					glPatchParameteri(GL_PATCH_VERTICES, data->TSPatchVertices);
 
 				// bind fbo and buffers
-				glBindFramebuffer(GL_FRAMEBUFFER, isMSAA ? m_fboMS[data] : data->FBO);
+				m_glState.BindFramebuffer(GL_FRAMEBUFFER, isMSAA ? m_fboMS[data] : data->FBO);
 				glDrawBuffers(data->RTCount, fboBuffers);
 
 				// clear depth texture
@@ -277,43 +332,60 @@ namespace ed {
 				// bind shaders
 				if (isDebug) {
 					data->Variables.UpdateUniformInfo(m_debugShaders[i]);
-					glUseProgram(m_debugShaders[i]);
+					m_glState.UseProgram(m_debugShaders[i]);
 				} else
-					glUseProgram(m_shaders[i]);
+					m_glState.UseProgram(m_shaders[i]);
 
 				// bind shader resource views
+				bool isGLSL = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath) == ShaderLanguage::GLSL; // TODO: or should this be for vulkan glsl too?
 				for (int j = 0; j < srvs.size(); j++) {
 					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
 
-					glActiveTexture(GL_TEXTURE0 + j);
 					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_CUBE_MAP, srvs[j]);
 					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_3D, srvs[j]);
 					else if (srvData->Type == ObjectType::PluginObject) {
 						PluginObject* pobj = srvData->Plugin;
+						m_glState.ActiveTexture(j);
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+						m_glState.Invalidate();
 					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_2D, srvs[j]);
 
-					
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
+					if (isGLSL)
 						data->Variables.UpdateTexture(m_shaders[i], j);
 				}
 
 				for (int j = 0; j < ubos.size(); j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+					m_glState.BindStorageBuffer(j, ubos[j]);
+
+				// find out if the shader supports geometry batching (the block is bound after the pass' buffers)
+				bool canBatch = false;
+				if (!isDebug && m_computeSupported) {
+					if (drawList.BatchProgram != m_shaders[i]) {
+						drawList.BatchProgram = m_shaders[i];
+						drawList.BatchBlock = glGetProgramResourceIndex(m_shaders[i], GL_SHADER_STORAGE_BLOCK, GEOMETRY_BATCH_BLOCK);
+						drawList.BatchBinding = GL_INVALID_INDEX;
+					}
+					if (drawList.BatchBlock != GL_INVALID_INDEX && drawList.BatchBinding != ubos.size()) {
+						drawList.BatchBinding = ubos.size();
+						glShaderStorageBlockBinding(m_shaders[i], drawList.BatchBlock, drawList.BatchBinding);
+					}
+					canBatch = drawList.BatchBlock != GL_INVALID_INDEX;
+				}
 
 				// clear messages
 				//if (m_msgs->GetGroupWarningMsgCount(it->Name) > 0)
 				//	m_msgs->ClearGroup(it->Name, (int)ed::MessageStack::Type::Warning);
 
 				// bind default states for each shader pass
-				DefaultState::Bind();
+				DefaultState::Bind(m_glState);
 
 				// render pipeline items
 				for (int j = 0; j < data->Items.size(); j++) {
 					PipelineItem* item = data->Items[j];
+					DrawCommand& cmd = drawList.Commands[j];
 
 					systemVM.SetPicked(false);
 
@@ -321,12 +393,21 @@ namespace ed {
 					if (!item->Active)
 						continue;
 
+					if (profile) {
+						if (item->Type == PipelineItem::ItemType::RenderState)
+							m_profiler.EndDraw();
+						else
+							m_profiler.BeginDraw(item->Name);
+					}
+
 					// update the value for this element and check if we picked it
 					if (item->Type == PipelineItem::ItemType::Geometry || item->Type == PipelineItem::ItemType::Model || item->Type == PipelineItem::ItemType::VertexBuffer || item->Type == PipelineItem::ItemType::PluginItem) {
-						if (m_pickAwaiting) m_pickItem(item, m_wasMultiPick);
-						for (int k = 0; k < itemVarValues.size(); k++)
-							if (itemVarValues[k].Item == item)
-								itemVarValues[k].Variable->Data = itemVarValues[k].NewValue->Data;
+						if (m_pickAwaiting) {
+							m_pickItem(item, m_wasMultiPick);
+							cmd.Picked = IsPicked(item);
+						}
+						for (int k : cmd.ItemValues)
+							itemVarValues[k].Variable->Data = itemVarValues[k].NewValue->Data;
 
 						if (isDebug) {
 							float r = (debugID & 0x000000FF) / 255.0f;
@@ -341,20 +422,48 @@ namespace ed {
 					if (item->Type == PipelineItem::ItemType::Geometry) {
 						pipe::GeometryItem* geoData = reinterpret_cast<pipe::GeometryItem*>(item->Data);
 
-						if (geoData->Type == pipe::GeometryItem::Rectangle) {
-							// TODO: don't multiply with m_renderer->GetLastRenderSize() but rather with actual RT size
-							glm::vec3 scaleRect(geoData->Scale.x * rtSize.x, geoData->Scale.y * rtSize.y, 1.0f);
-							glm::vec3 posRect((geoData->Position.x + 0.5f) * rtSize.x, (geoData->Position.y + 0.5f) * rtSize.y, -1000.0f);
-							systemVM.SetGeometryTransform(item, scaleRect, geoData->Rotation, posRect);
-						} else
-							systemVM.SetGeometryTransform(item, geoData->Scale, geoData->Rotation, geoData->Position);
+						setGeometryItemTransform(item, rtSize);
+						systemVM.SetPicked(cmd.Picked);
+
+						int batchLength = canBatch ? m_getGeometryBatchLength(data, drawList, j) : 1;
+						if (batchLength > 1) {
+							m_batchData.resize(batchLength);
+							for (int k = 0; k < batchLength; k++) {
+								PipelineItem* batchItem = data->Items[j + k];
+								DrawCommand& batchCmd = drawList.Commands[j + k];
+
+								if (k != 0) {
+									if (m_pickAwaiting) {
+										m_pickItem(batchItem, m_wasMultiPick);
+										batchCmd.Picked = IsPicked(batchItem);
+									}
+									setGeometryItemTransform(batchItem, rtSize);
+								}
 
-						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+								m_batchData[k].Transform = systemVM.GetGeometryTransform(batchItem);
+								m_batchData[k].IsPicked = batchCmd.Picked;
+							}
+
+							m_bindGeometryBatch(drawList.BatchBinding);
+
+							// the variables are the same for all of the items
+							data->Variables.Bind(item);
+
+							m_glState.BindVertexArray(geoData->VAO);
+							glDrawArraysInstanced(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type], batchLength);
+
+							j += batchLength - 1;
+							continue;
+						}
+
+						// the shader reads the transform from the batch block even if the item is drawn on its own
+						if (canBatch)
+							m_bindSingleGeometryBatch(item, cmd.Picked, drawList.BatchBinding, geoData->Instanced ? geoData->InstanceCount : 1);
 
 						// bind variables
 						data->Variables.Bind(item);
 
-						glBindVertexArray(geoData->VAO);
+						m_glState.BindVertexArray(geoData->VAO);
 						if (geoData->Instanced)
 							glDrawArraysInstanced(geoData->Topology, 0, eng::GeometryFactory::VertexCount[geoData->Type], geoData->InstanceCount);
 						else
@@ -362,34 +471,55 @@ namespace ed {
 					} else if (item->Type == PipelineItem::ItemType::Model) {
 						pipe::Model* objData = reinterpret_cast<pipe::Model*>(item->Data);
 
-						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+						systemVM.SetPicked(cmd.Picked);
 						systemVM.SetGeometryTransform(item, objData->Scale, objData->Rotation, objData->Position);
 
+						if (canBatch)
+							m_bindSingleGeometryBatch(item, cmd.Picked, drawList.BatchBinding, objData->Instanced ? objData->InstanceCount : 1);
+
 						// bind variables
 						data->Variables.Bind(item);
 
-						objData->Data->Draw(objData->Instanced, objData->InstanceCount);
+						// the debugger reads the triangles of the full mesh & instances can be anywhere
+						int lod = objData->LOD;
+						if (isDebug || (lod < 0 && objData->Instanced))
+							lod = 0;
+
+						float maxError = lod < 0 ? m_getModelLODError(item, objData) : 0.0f;
+						for (auto& mesh : objData->Data->Meshes) {
+							m_glState.BindVertexArray(mesh.VAO);
+							mesh.Draw(objData->Instanced, objData->InstanceCount, lod < 0 ? mesh.GetLOD(maxError) : lod);
+						}
 					} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 						pipe::VertexBuffer* vbData = reinterpret_cast<pipe::VertexBuffer*>(item->Data);
 						ed::BufferObject* bobj = (ed::BufferObject*)vbData->Buffer;
 
 						if (bobj != 0) {
-							auto bobjFmt = m_objects->ParseBufferFormat(bobj->ViewFormat);
-							int stride = 0;
-							for (const auto& f : bobjFmt)
-								stride += ShaderVariable::GetSize(f, true);
+							// the format only has to be parsed again when it changes
+							if (cmd.Buffer != bobj || cmd.BufferFormat != bobj->ViewFormat) {
+								auto bobjFmt = m_objects->ParseBufferFormat(bobj->ViewFormat);
+								cmd.BufferStride = 0;
+								for (const auto& f : bobjFmt)
+									cmd.BufferStride += ShaderVariable::GetSize(f, true);
+
+								cmd.Buffer = bobj;
+								cmd.BufferFormat = bobj->ViewFormat;
+							}
 
+							int stride = cmd.BufferStride;
 							if (stride != 0) {
 								int vertCount = bobj->Size / stride;
 
 								systemVM.SetGeometryTransform(item, vbData->Scale, vbData->Rotation, vbData->Position);
-								systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+								systemVM.SetPicked(cmd.Picked);
+
+								if (canBatch)
+									m_bindSingleGeometryBatch(item, cmd.Picked, drawList.BatchBinding, vbData->Instanced ? vbData->InstanceCount : 1);
 
 								// bind variables
 								data->Variables.Bind(item);
 
-								
-								glBindVertexArray(vbData->VAO);
+								m_glState.BindVertexArray(vbData->VAO);
 								if (vbData->Instanced)
 									glDrawArraysInstanced(vbData->Topology, 0, vertCount, vbData->InstanceCount);
 								else
@@ -400,78 +530,73 @@ namespace ed {
 						pipe::RenderState* state = reinterpret_cast<pipe::RenderState*>(item->Data);
 
 						// depth clamp
-						if (state->DepthClamp)
-							glEnable(GL_DEPTH_CLAMP);
-						else
-							glDisable(GL_DEPTH_CLAMP);
+						m_glState.SetCapability(GL_DEPTH_CLAMP, state->DepthClamp);
 
 						// fill mode
-						glPolygonMode(GL_FRONT_AND_BACK, state->PolygonMode);
+						m_glState.PolygonMode(state->PolygonMode);
 
 						// culling and front face
-						if (state->CullFace)
-							glEnable(GL_CULL_FACE);
-						else
-							glDisable(GL_CULL_FACE);
-						glCullFace(state->CullFaceType);
-						glFrontFace(state->FrontFace);
+						m_glState.SetCapability(GL_CULL_FACE, state->CullFace);
+						m_glState.CullFace(state->CullFaceType);
+						m_glState.FrontFace(state->FrontFace);
 
 						// disable blending
 						if (state->Blend && !isDebug) {
-							glEnable(GL_BLEND);
+							m_glState.SetCapability(GL_BLEND, true);
 							glBlendEquationSeparate(state->BlendFunctionColor, state->BlendFunctionAlpha);
 							glBlendFuncSeparate(state->BlendSourceFactorRGB, state->BlendDestinationFactorRGB, state->BlendSourceFactorAlpha, state->BlendDestinationFactorAlpha);
 							glBlendColor(state->BlendFactor.r, state->BlendFactor.g, state->BlendFactor.a, state->BlendFactor.a);
 							glSampleCoverage(state->AlphaToCoverage, GL_FALSE);
 						} else
-							glDisable(GL_BLEND);
+							m_glState.SetCapability(GL_BLEND, false);
 
 						// depth state
-						if (state->DepthTest)
-							glEnable(GL_DEPTH_TEST);
-						else
-							glDisable(GL_DEPTH_TEST);
-						glDepthMask(state->DepthMask);
-						glDepthFunc(state->DepthFunction);
+						m_glState.SetCapability(GL_DEPTH_TEST, state->DepthTest);
+						m_glState.DepthMask(state->DepthMask);
+						m_glState.DepthFunc(state->DepthFunction);
 						glPolygonOffset(0.0f, state->DepthBias);
 
 						// stencil
 						if (state->StencilTest) {
-							glEnable(GL_STENCIL_TEST);
+							m_glState.SetCapability(GL_STENCIL_TEST, true);
 							glStencilFuncSeparate(GL_FRONT, state->StencilFrontFaceFunction, 1, state->StencilReference);
 							glStencilFuncSeparate(GL_BACK, state->StencilBackFaceFunction, 1, state->StencilReference);
 							glStencilMask(state->StencilMask);
 							glStencilOpSeparate(GL_FRONT, state->StencilFrontFaceOpStencilFail, state->StencilFrontFaceOpDepthFail, state->StencilFrontFaceOpPass);
 							glStencilOpSeparate(GL_BACK, state->StencilBackFaceOpStencilFail, state->StencilBackFaceOpDepthFail, state->StencilBackFaceOpPass);
 						} else
-							glDisable(GL_STENCIL_TEST);
+							m_glState.SetCapability(GL_STENCIL_TEST, false);
 					} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 						pipe::PluginItemData* pldata = reinterpret_cast<pipe::PluginItemData*>(item->Data);
 
-						if (m_pickAwaiting && pldata->Owner->PipelineItem_IsPickable(pldata->Type, pldata->PluginData))
+						if (m_pickAwaiting && pldata->Owner->PipelineItem_IsPickable(pldata->Type, pldata->PluginData)) {
 							m_pickItem(item, m_wasMultiPick);
+							cmd.Picked = IsPicked(item);
+						}
 
 						if (pldata->Owner->PipelineItem_IsPickable(pldata->Type, pldata->PluginData))
-							systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+							systemVM.SetPicked(cmd.Picked);
 						else
 							systemVM.SetPicked(false);
 
 						pldata->Owner->PipelineItem_Execute(data, plugin::PipelineItemType::ShaderPass, pldata->Type, pldata->PluginData);
+						m_glState.Invalidate();
 					}
 
 					// set the old value back
-					if (item->Type == PipelineItem::ItemType::Geometry || item->Type == PipelineItem::ItemType::Model || item->Type == PipelineItem::ItemType::VertexBuffer || item->Type == PipelineItem::ItemType::PluginItem)
-						for (int k = 0; k < itemVarValues.size(); k++)
-							if (itemVarValues[k].Item == item)
-								itemVarValues[k].Variable->Data = itemVarValues[k].OldValue;
+					for (int k : cmd.ItemValues)
+						itemVarValues[k].Variable->Data = itemVarValues[k].OldValue;
 				}
 
+				if (profile)
+					m_profiler.EndDraw();
+
 				if (isDebug)
 					data->Variables.UpdateUniformInfo(m_shaders[i]); // return old variable data
 
 				if (isMSAA) {
-					glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fboMS[data]);
-					glBindFramebuffer(GL_DRAW_FRAMEBUFFER, data->FBO);
+					m_glState.BindFramebuffer(GL_READ_FRAMEBUFFER, m_fboMS[data]);
+					m_glState.BindFramebuffer(GL_DRAW_FRAMEBUFFER, data->FBO);
 					glDrawBuffer(GL_BACK);
 					for (unsigned int i = 0; i < data->RTCount; i++) {
 						glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
@@ -493,31 +618,33 @@ namespace ed {
 					continue;
 
 				// bind shaders
-				glUseProgram(m_shaders[i]);
+				m_glState.UseProgram(m_shaders[i]);
 				
 				// bind shader resource views
+				bool isGLSL = ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL;
 				for (int j = 0; j < srvs.size(); j++) {
 					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
 
-					glActiveTexture(GL_TEXTURE0 + j);
 					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_CUBE_MAP, srvs[j]);
 					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_3D, srvs[j]);
 					else if (srvData->Type == ObjectType::PluginObject) {
 						PluginObject* pobj = srvData->Plugin;
+						m_glState.ActiveTexture(j);
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+						m_glState.Invalidate();
 					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_2D, srvs[j]);
 
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
+					if (isGLSL)
 						data->Variables.UpdateTexture(m_shaders[i], j);
 				}
 
 				// bind buffers
 				int cMax = (m_uboMax[data] = std::max<int>(ubos.size(), m_uboMax[data]));
 				for (int j = ubos.size(); j < cMax; j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, 0);
+					m_glState.BindStorageBuffer(j, 0);
 
 				for (int j = 0; j < ubos.size(); j++) {
 					ObjectManagerItem* uboData = m_objects->GetByTextureID(ubos[j]);
@@ -533,8 +660,9 @@ namespace ed {
 					} else if (uboData->Type == ObjectType::PluginObject) {
 						PluginObject* pobj = uboData->Plugin;
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+						m_glState.Invalidate();
 					} else
-						glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+						m_glState.BindStorageBuffer(j, ubos[j]);
 				}
 
 				// bind variables
@@ -543,9 +671,8 @@ namespace ed {
 				// call compute shader
 				glDispatchCompute(data->WorkX, data->WorkY, data->WorkZ);
 
-				// wait until it finishes
-				glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-				// or maybe until i implement these as options glMemoryBarrier(GL_ALL_BARRIER_BITS);
+				// barriers are issued later, only before the items that read the written objects
+				m_addComputeWrites(data, ubos);
 			}
 			else if (it->Type == PipelineItem::ItemType::AudioPass && !isDebug) {
 				pipe::AudioPass* data = (pipe::AudioPass*)it->Data;
@@ -557,16 +684,17 @@ namespace ed {
 				for (int j = 0; j < srvs.size(); j++) {
 					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
 
-					glActiveTexture(GL_TEXTURE0 + j);
 					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_CUBE_MAP, srvs[j]);
 					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_3D, srvs[j]);
 					else if (srvData->Type == ObjectType::PluginObject) {
 						PluginObject* pobj = srvData->Plugin;
+						m_glState.ActiveTexture(j);
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+						m_glState.Invalidate();
 					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
+						m_glState.BindTexture(j, GL_TEXTURE_2D, srvs[j]);
 
 					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
 						data->Variables.UpdateTexture(m_shaders[i], j);
@@ -574,12 +702,13 @@ namespace ed {
 
 				// bind buffers
 				for (int j = 0; j < ubos.size(); j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+					m_glState.BindStorageBuffer(j, ubos[j]);
 
 				// bind variables
 				data->Variables.Bind();
 
 				data->Stream.RenderAudio();
+				m_glState.Invalidate();
 			}
 			else if (it->Type == PipelineItem::ItemType::PluginItem) {
 				pipe::PluginItemData* pldata = reinterpret_cast<pipe::PluginItemData*>(it->Data);
@@ -588,17 +717,22 @@ namespace ed {
 					pldata->Owner->PipelineItem_Execute(pldata->Type, pldata->PluginData, pldata->Items.data(), pldata->Items.size());
 				else if (pldata->Owner->PipelineItem_IsDebuggable(pldata->Type, pldata->PluginData))
 					pldata->Owner->PipelineItem_DebugExecute(pldata->Type, pldata->PluginData, pldata->Items.data(), pldata->Items.size(), &debugID);
-			}
 
-			if (performPerfMeasure)
-				glEndQuery(GL_TIME_ELAPSED);
+				m_glState.Invalidate();
+			}
 
 			if (it == breakItem && breakItem != nullptr)
 				break;
 		}
 
+		if (profile)
+			m_profiler.EndFrame();
+
 		m_plugins->EndRender();
 
+		// UI, previews & the next frame can read the written objects in any way
+		m_syncAllComputeWrites();
+
 		// update frame index
 		if (!m_paused) {
 			systemVM.CopyState();
@@ -609,8 +743,10 @@ namespace ed {
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		if (m_pickAwaiting) {
-			if (m_pickDist == std::numeric_limits<float>::infinity())
+			if (m_pickDist == std::numeric_limits<float>::infinity()) {
 				m_pick.clear();
+				m_pickVersion++;
+			}
 			if (m_pickHandle != nullptr)
 				m_pickHandle(m_pick.size() == 0 ? nullptr : m_pick[m_pick.size() - 1]);
 			m_pickAwaiting = false;
@@ -1122,281 +1258,13 @@ namespace ed {
 
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemCompiled, (void*)name, nullptr);
 
-		GLchar shaderMessage[1024] = { 0 };
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* item = m_items[i];
 			if (strcmp(item->Name, name) == 0) {
-				if (item->Type == PipelineItem::ItemType::ShaderPass) {
-					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
-
-					SPIRVQueue.push_back(item);
-
-					m_msgs->ClearGroup(name);
-
-					glDeleteShader(m_shaderSources[i].VS);
-					glDeleteShader(m_shaderSources[i].PS);
-					glDeleteShader(m_shaderSources[i].GS);
-					glDeleteShader(m_shaderSources[i].TCS);
-					glDeleteShader(m_shaderSources[i].TES);
-
-					std::string psContent = "", vsContent = "",
-								vsEntry = shader->VSEntry,
-								psEntry = shader->PSEntry;
-					int lineBias = 0;
-					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->PSPath);
-					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->VSPath);
-					ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->GSPath);
-					ShaderLanguage tcsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TCSPath);
-					ShaderLanguage tesLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TESPath);
-
-					// pixel shader
-					bool psCompiled = false;
-
-					if (psLang == ShaderLanguage::Plugin)
-						psCompiled = m_pluginCompileToSpirv(item, shader->PSSPV, shader->PSPath, psEntry, plugin::ShaderStage::Pixel, shader->Macros.data(), shader->Macros.size());
-					else
-						psCompiled = ShaderCompiler::CompileToSPIRV(shader->PSSPV, psLang, shader->PSPath, ShaderStage::Pixel, psEntry, shader->Macros, m_msgs, m_project);
-
-					if (psLang == ShaderLanguage::GLSL) { // GLSL
-						psContent = m_project->LoadProjectFile(shader->PSPath);
-						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(psContent, shader);
-					} else { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(shader->PSSPV, psLang, ShaderStage::Pixel, shader->TSUsed, shader->GSUsed, m_msgs);
-						psEntry = "main";
-
-						if (psLang == ShaderLanguage::Plugin)
-							psContent = m_pluginProcessGLSL(shader->PSPath, psContent.c_str());		
-					}
-
-					shader->Variables.UpdateTextureList(psContent);
-					GLuint ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps, shaderMessage);
-
-					// vertex shader
-					lineBias = 0;
-					bool vsCompiled = false;
-
-					if (vsLang == ShaderLanguage::Plugin)
-						vsCompiled = m_pluginCompileToSpirv(item, shader->VSSPV, shader->VSPath, vsEntry, plugin::ShaderStage::Vertex, shader->Macros.data(), shader->Macros.size());
-					else
-						vsCompiled = ShaderCompiler::CompileToSPIRV(shader->VSSPV, vsLang, shader->VSPath, ShaderStage::Vertex, vsEntry, shader->Macros, m_msgs, m_project);
-					
-					// generate glsl
-					if (vsLang == ShaderLanguage::GLSL) { // GLSL
-						vsContent = m_project->LoadProjectFile(shader->VSPath);
-						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(vsContent, shader);
-					} else { // HLSL / VK
-						vsContent = ShaderCompiler::ConvertToGLSL(shader->VSSPV, vsLang, ShaderStage::Vertex, shader->TSUsed, shader->GSUsed, m_msgs);
-						vsEntry = "main";
-
-						if (vsLang == ShaderLanguage::Plugin)
-							vsContent = m_pluginProcessGLSL(shader->VSPath, vsContent.c_str());
-					}
-
-					GLuint vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs, shaderMessage);
-
-					// geometry shader
-					bool gsCompiled = true;
-					GLuint gs = 0;
-					if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0) {
-						std::string gsContent = "",
-									gsEntry = shader->GSEntry;
-
-						lineBias = 0;
-						
-						if (gsLang == ShaderLanguage::Plugin)
-							gsCompiled = m_pluginCompileToSpirv(item, shader->GSSPV, shader->GSPath, gsEntry, plugin::ShaderStage::Geometry, shader->Macros.data(), shader->Macros.size());
-						else
-							gsCompiled = ShaderCompiler::CompileToSPIRV(shader->GSSPV, gsLang, shader->GSPath, ShaderStage::Geometry, gsEntry, shader->Macros, m_msgs, m_project);
-						
-						if (gsLang == ShaderLanguage::GLSL) { // GLSL
-							gsContent = m_project->LoadProjectFile(shader->GSPath);
-							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(gsContent, shader);
-						} else { // HLSL / VK
-							gsContent = ShaderCompiler::ConvertToGLSL(shader->GSSPV, gsLang, ShaderStage::Geometry, shader->TSUsed, shader->GSUsed, m_msgs);
-							gsEntry = "main";
-
-							if (gsLang == ShaderLanguage::Plugin)
-								gsContent = m_pluginProcessGLSL(shader->GSPath, gsContent.c_str());
-						}
-
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs, shaderMessage);
-
-						if (gsContent.empty())
-							gsCompiled = false;
-					}
-
-					// tessellation shader
-					bool tsCompiled = ((shader->TSUsed && m_tessellationSupported) || !shader->TSUsed);
-					GLuint tcs = 0, tes = 0;
-					if (shader->TSUsed && m_tessellationSupported) {
-						// tess control
-						if (strlen(shader->TCSPath) > 0 && strlen(shader->TCSEntry) > 0) {
-							std::string tcsContent = "",
-										tcsEntry = shader->TCSEntry;
-
-							lineBias = 0;
-
-							if (gsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(item, shader->TCSSPV, shader->TCSPath, tcsEntry, plugin::ShaderStage::TessellationControl, shader->Macros.data(), shader->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(shader->TCSSPV, tcsLang, shader->TCSPath, ShaderStage::TessellationControl, tcsEntry, shader->Macros, m_msgs, m_project);
-
-							if (tcsLang == ShaderLanguage::GLSL) { // GLSL
-								tcsContent = m_project->LoadProjectFile(shader->TCSPath);
-								m_includeCheck(tcsContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tcsContent, shader);
-							} else { // HLSL / VK
-								tcsContent = ShaderCompiler::ConvertToGLSL(shader->TCSSPV, gsLang, ShaderStage::TessellationControl, shader->TSUsed, shader->GSUsed, m_msgs);
-								tcsEntry = "main";
-
-								if (tcsLang == ShaderLanguage::Plugin)
-									tcsContent = m_pluginProcessGLSL(shader->TCSPath, tcsContent.c_str());
-							}
-
-							tcs = gl::CompileShader(GL_TESS_CONTROL_SHADER, tcsContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tcs, shaderMessage);
-
-							if (tcsContent.empty())
-								tsCompiled = false;
-						}
-						
-						// tess evaluation
-						if (strlen(shader->TESPath) > 0 && strlen(shader->TESEntry) > 0) {
-							std::string tesContent = "",
-										tesEntry = shader->TESEntry;
-
-							lineBias = 0;
-
-							if (gsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(item, shader->TESSPV, shader->TESPath, tesEntry, plugin::ShaderStage::TessellationEvaluation, shader->Macros.data(), shader->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(shader->TESSPV, tcsLang, shader->TESPath, ShaderStage::TessellationEvaluation, tesEntry, shader->Macros, m_msgs, m_project);
-
-							if (tesLang == ShaderLanguage::GLSL) { // GLSL
-								tesContent = m_project->LoadProjectFile(shader->TESPath);
-								m_includeCheck(tesContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tesContent, shader);
-							} else { // HLSL / VK
-								tesContent = ShaderCompiler::ConvertToGLSL(shader->TESSPV, gsLang, ShaderStage::TessellationEvaluation, shader->TSUsed, shader->GSUsed, m_msgs);
-								tesEntry = "main";
-
-								if (tesLang == ShaderLanguage::Plugin)
-									tesContent = m_pluginProcessGLSL(shader->TESPath, tesContent.c_str());
-							}
-
-							tes = gl::CompileShader(GL_TESS_EVALUATION_SHADER, tesContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tes, shaderMessage);
-
-							if (tesContent.empty())
-								tsCompiled = false;
-						}
-					}
-
-
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled || vsContent.empty() || psContent.empty()) {
-						Logger::Get().Log("Shaders not compiled", true);
-						if (vsContent.empty() || psContent.empty())
-							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
-						else {
-							if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-								m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
-							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
-						}
-
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], tcs);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], tes);
-						if (shader->GSUsed) glAttachShader(m_shaders[i], gs);
-						glAttachShader(m_shaders[i], ps);
-						glLinkProgram(m_shaders[i]);
-					}
-
-					if (m_shaders[i] != 0)
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
-
-					m_shaderSources[i].VS = vs;
-					m_shaderSources[i].PS = ps;
-					m_shaderSources[i].GS = gs;
-					m_shaderSources[i].TCS = tcs;
-					m_shaderSources[i].TES = tes;
-				} 
-				else if (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) {
-					pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
-
-					SPIRVQueue.push_back(item);
-
-					m_msgs->ClearGroup(name);
-
-					std::string content = "", entry = shader->Entry;
-					int lineBias = 0;
-					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(shader->Path);
-
-					// compute shader
-					bool compiled = false;
-						
-					if (lang == ShaderLanguage::Plugin)
-						compiled = m_pluginCompileToSpirv(item, shader->SPV, shader->Path, entry, plugin::ShaderStage::Compute, shader->Macros.data(), shader->Macros.size());
-					else
-						compiled = ShaderCompiler::CompileToSPIRV(shader->SPV, lang, shader->Path, ShaderStage::Compute, entry, shader->Macros, m_msgs, m_project);
-					
-					if (lang == ShaderLanguage::GLSL) { // GLSL
-						content = m_project->LoadProjectFile(shader->Path);
-						m_includeCheck(content, std::vector<std::string>(), lineBias);
-						m_applyMacros(content, shader);
-					} else { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(shader->SPV, lang, ShaderStage::Compute, false, false, m_msgs);
-						entry = "main";
-
-						if (lang == ShaderLanguage::Plugin)
-							content = m_pluginProcessGLSL(shader->Path, content.c_str());		
-					}
-
-					// compute shader supported == version 4.3 == not needed: shader->Variables.UpdateTextureList(content);
-					GLuint cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs, shaderMessage);
-
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!compiled || content.empty()) {
-						Logger::Get().Log("Compute shader was not compiled", true);
-						if (content.empty())
-							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
-						else {
-							if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-								m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
-							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
-						}
-
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the compute shader.");
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
-					}
-
-					glDeleteShader(cs);
-
-					if (m_shaders[i] != 0)
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
+				if (item->Type == PipelineItem::ItemType::ShaderPass || (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported)) {
+					ShaderCompileJob* job = m_createCompileJob(item);
+					job->UserRequested = true;
+					m_submitCompileJob(job);
 				} 
 				else if (item->Type == PipelineItem::ItemType::AudioPass) {
 					pipe::AudioPass* shader = (pipe::AudioPass*)item->Data;
@@ -1407,7 +1275,7 @@ namespace ed {
 
 					// audio shader
 					if (ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::GLSL)
-						m_applyMacros(content, shader);
+						ShaderCompileService::ApplyMacros(content, shader->Macros);
 
 					shader->Stream.CompileFromShaderSource(m_project, m_msgs, content, shader->Macros, ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::HLSL);
 					shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
@@ -1448,269 +1316,302 @@ namespace ed {
 
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemCompiled, (void*)name, nullptr);
 
-		GLchar shaderMessage[1024] = { 0 };
+		const std::string sources[5] = { vssrc, pssrc, gssrc, tcssrc, tessrc };
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* item = m_items[i];
 			if (strcmp(item->Name, name) == 0) {
-				if (item->Type == PipelineItem::ItemType::ShaderPass) {
-					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
-
+				if (item->Type == PipelineItem::ItemType::ShaderPass || (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported)) {
+					ShaderCompileJob* job = m_createCompileJob(item, sources);
+					job->UserRequested = true;
+					m_submitCompileJob(job);
+				} 
+				else if (item->Type == PipelineItem::ItemType::AudioPass) {
+					pipe::AudioPass* shader = (pipe::AudioPass*)item->Data;
 					m_msgs->ClearGroup(name);
 
-					SPIRVQueue.push_back(item);
-
-					bool vsCompiled = true, psCompiled = true, gsCompiled = true;
-					bool tsCompiled = ((shader->TSUsed && m_tessellationSupported) || !shader->TSUsed);
-					int lineBias = 0;
-
-					// pixel shader
-					if (pssrc.size() > 0) {
-						ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->PSPath);
-						if (psLang == ShaderLanguage::Plugin)
-							psCompiled = m_pluginCompileToSpirv(item, shader->PSSPV, shader->PSPath, shader->PSEntry, plugin::ShaderStage::Pixel, shader->Macros.data(), shader->Macros.size(), pssrc);
-						else
-							psCompiled = ShaderCompiler::CompileSourceToSPIRV(shader->PSSPV, psLang, shader->PSPath, pssrc, ShaderStage::Pixel, shader->PSEntry, shader->Macros, m_msgs, m_project);
-
-						std::string psContent = pssrc;
-						if (psLang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(psContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(psContent, shader);
-						} else { // HLSL / VK
-							psContent = ShaderCompiler::ConvertToGLSL(shader->PSSPV, psLang, ShaderStage::Pixel, shader->TSUsed, shader->GSUsed, m_msgs);
-							
-							if (psLang == ShaderLanguage::Plugin)
-								psContent = m_pluginProcessGLSL(shader->PSPath, psContent.c_str());
-						}
-
-
-
-						shader->Variables.UpdateTextureList(psContent);
-						GLuint ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-						psCompiled &= gl::CheckShaderCompilationStatus(ps, shaderMessage);
-
-						glDeleteShader(m_shaderSources[i].PS);
-						m_shaderSources[i].PS = ps;
-					}
-
-					// vertex shader
-					if (vssrc.size() > 0) {
-						lineBias = 0;
-						
-						ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->VSPath);
-						if (vsLang == ShaderLanguage::Plugin)
-							vsCompiled = m_pluginCompileToSpirv(item, shader->VSSPV, shader->VSPath, shader->VSEntry, plugin::ShaderStage::Vertex, shader->Macros.data(), shader->Macros.size(), vssrc);
-						else
-							vsCompiled = ShaderCompiler::CompileSourceToSPIRV(shader->VSSPV, vsLang, shader->VSPath, vssrc, ShaderStage::Vertex, shader->VSEntry, shader->Macros, m_msgs, m_project);
-
-						std::string vsContent = vssrc;
-						if (vsLang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(vsContent, shader);
-						} else { // HLSL / VK
-							vsContent = ShaderCompiler::ConvertToGLSL(shader->VSSPV, vsLang, ShaderStage::Vertex, shader->TSUsed, shader->GSUsed, m_msgs);
-
-							if (vsLang == ShaderLanguage::Plugin)
-								vsContent = m_pluginProcessGLSL(shader->VSPath, vsContent.c_str());
-						}
-
-
-						GLuint vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-						vsCompiled &= gl::CheckShaderCompilationStatus(vs, shaderMessage);
-
-						glDeleteShader(m_shaderSources[i].VS);
-						m_shaderSources[i].VS = vs;
-					}
-
-					// geometry shader
-					if (gssrc.size() > 0) {
-						lineBias = 0;
-
-						ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->GSPath);
-						if (gsLang == ShaderLanguage::Plugin)
-							gsCompiled = m_pluginCompileToSpirv(item, shader->GSSPV, shader->GSPath, shader->GSEntry, plugin::ShaderStage::Geometry, shader->Macros.data(), shader->Macros.size(), gssrc);
-						else
-							gsCompiled = ShaderCompiler::CompileSourceToSPIRV(shader->GSSPV, gsLang, shader->GSPath, gssrc, ShaderStage::Geometry, shader->GSEntry, shader->Macros, m_msgs, m_project);
-
-						std::string gsContent = gssrc;
-						if (gsLang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(gsContent, shader);
-						} else { // HLSL / VK
-							gsContent = ShaderCompiler::ConvertToGLSL(shader->GSSPV, gsLang, ShaderStage::Geometry, shader->TSUsed, shader->GSUsed, m_msgs);
-
-							if (gsLang == ShaderLanguage::Plugin)
-								gsContent = m_pluginProcessGLSL(shader->GSPath, gsContent.c_str());
-						}
-
-
-						GLuint gs = 0;
-						glDeleteShader(m_shaderSources[i].GS);
-						if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0) {
-							gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-							gsCompiled &= gl::CheckShaderCompilationStatus(gs, shaderMessage);
-
-							m_shaderSources[i].GS = gs;
-						}
-					}
-
-					// tessellation control shader
-					if (tcssrc.size() > 0 && m_tessellationSupported) {
-						lineBias = 0;
-
-						ShaderLanguage tcsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TCSPath);
-						if (tcsLang == ShaderLanguage::Plugin)
-							tsCompiled &= m_pluginCompileToSpirv(item, shader->TCSSPV, shader->TCSPath, shader->TCSEntry, plugin::ShaderStage::TessellationControl, shader->Macros.data(), shader->Macros.size(), tcssrc);
-						else
-							tsCompiled &= ShaderCompiler::CompileSourceToSPIRV(shader->TCSSPV, tcsLang, shader->TCSPath, tcssrc, ShaderStage::TessellationControl, shader->TCSEntry, shader->Macros, m_msgs, m_project);
-
-						std::string tcsContent = tcssrc;
-						if (tcsLang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(tcsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(tcsContent, shader);
-						} else { // HLSL / VK
-							tcsContent = ShaderCompiler::ConvertToGLSL(shader->TCSSPV, tcsLang, ShaderStage::TessellationControl, shader->TSUsed, shader->GSUsed, m_msgs);
-
-							if (tcsLang == ShaderLanguage::Plugin)
-								tcsContent = m_pluginProcessGLSL(shader->TCSPath, tcsContent.c_str());
-						}
-
-						GLuint tcs = 0;
-						glDeleteShader(m_shaderSources[i].TCS);
-						if (shader->TSUsed && strlen(shader->TCSPath) > 0 && strlen(shader->TCSEntry) > 0) {
-							tcs = gl::CompileShader(GL_TESS_CONTROL_SHADER, tcsContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tcs, shaderMessage);
-
-							m_shaderSources[i].TCS = tcs;
-						}
-					}
-
-					// tessellation control shader
-					if (tessrc.size() > 0 && m_tessellationSupported) {
-						lineBias = 0;
-
-						ShaderLanguage tesLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TESPath);
-						if (tesLang == ShaderLanguage::Plugin)
-							tsCompiled &= m_pluginCompileToSpirv(item, shader->TESSPV, shader->TESPath, shader->TESEntry, plugin::ShaderStage::TessellationEvaluation, shader->Macros.data(), shader->Macros.size(), tessrc);
-						else
-							tsCompiled &= ShaderCompiler::CompileSourceToSPIRV(shader->TESSPV, tesLang, shader->TESPath, tessrc, ShaderStage::TessellationEvaluation, shader->TESEntry, shader->Macros, m_msgs, m_project);
-
-						std::string tesContent = tessrc;
-						if (tesLang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(tesContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(tesContent, shader);
-						} else { // HLSL / VK
-							tesContent = ShaderCompiler::ConvertToGLSL(shader->TESSPV, tesLang, ShaderStage::TessellationEvaluation, shader->TSUsed, shader->GSUsed, m_msgs);
-
-							if (tesLang == ShaderLanguage::Plugin)
-								tesContent = m_pluginProcessGLSL(shader->TESPath, tesContent.c_str());
-						}
+					// audio shader
+					if (vssrc.size() > 0)
+						shader->Stream.CompileFromShaderSource(m_project, m_msgs, vssrc, shader->Macros, true);
+					shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
+				}
+			}
+		}
 
-						GLuint tes = 0;
-						glDeleteShader(m_shaderSources[i].TES);
-						if (shader->TSUsed && strlen(shader->TESPath) > 0 && strlen(shader->TESEntry) > 0) {
-							tes = gl::CompileShader(GL_TESS_EVALUATION_SHADER, tesContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tes, shaderMessage);
+		Render();
+	}
+	void RenderEngine::UpdateShaderCompilation()
+	{
+		// the preview isn't rendered every frame while paused
+		if (m_applyCompileJobs() && m_paused)
+			Render();
+	}
+	void RenderEngine::FinishShaderCompilation()
+	{
+		m_compiler.Wait();
+		m_applyCompileJobs();
+	}
+	ShaderCompileJob* RenderEngine::m_createCompileJob(PipelineItem* item, const std::string* sources)
+	{
+		ShaderCompileJob* job = new ShaderCompileJob();
+		job->Item = item;
+		job->ID = ++m_compileJobCounter;
+		job->Name = item->Name;
+		job->Partial = (sources != nullptr);
+		job->IncludePaths = Settings::Instance().Project.IncludePaths;
+		job->Messages.CurrentItem = item->Name;
+
+		// sources[] = { VS, PS, GS, TCS, TES } - empty source means that the stage shouldn't be recompiled
+		auto addStage = [&](ShaderStage stage, const char* path, const char* entry, int sourceIndex) {
+			if (sources != nullptr && sources[sourceIndex].empty())
+				return;
 
-							m_shaderSources[i].TES = tes;
-						}
-					}
+			ShaderCompileStage compileStage;
+			compileStage.Stage = stage;
+			compileStage.Language = ShaderCompiler::GetShaderLanguageFromExtension(path);
+			compileStage.Path = path;
+			compileStage.Entry = entry;
+			if (sources != nullptr) {
+				compileStage.Source = sources[sourceIndex];
+				compileStage.HasSource = true;
+			}
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled) {
-						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-							m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
-						m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], m_shaderSources[i].VS);
-						glAttachShader(m_shaders[i], m_shaderSources[i].PS);
-						if (shader->GSUsed) glAttachShader(m_shaders[i], m_shaderSources[i].GS);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], m_shaderSources[i].TCS);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], m_shaderSources[i].TES);
-						glLinkProgram(m_shaders[i]);
-					}
+			job->Stages.push_back(compileStage);
+		};
+
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
+			job->TSUsed = shader->TSUsed;
+			job->GSUsed = shader->GSUsed;
+			job->Macros = shader->Macros;
+
+			addStage(ShaderStage::Vertex, shader->VSPath, shader->VSEntry, 0);
+			addStage(ShaderStage::Pixel, shader->PSPath, shader->PSEntry, 1);
+			if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0)
+				addStage(ShaderStage::Geometry, shader->GSPath, shader->GSEntry, 2);
+			if (shader->TSUsed && m_tessellationSupported) {
+				if (strlen(shader->TCSPath) > 0 && strlen(shader->TCSEntry) > 0)
+					addStage(ShaderStage::TessellationControl, shader->TCSPath, shader->TCSEntry, 3);
+				if (strlen(shader->TESPath) > 0 && strlen(shader->TESEntry) > 0)
+					addStage(ShaderStage::TessellationEvaluation, shader->TESPath, shader->TESEntry, 4);
+			}
+		} else if (item->Type == PipelineItem::ItemType::ComputePass) {
+			pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
+			job->Macros = shader->Macros;
 
-					if (m_shaders[i] != 0)
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
-				} 
-				else if (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) {
-					pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
+			addStage(ShaderStage::Compute, shader->Path, shader->Entry, 0);
+		}
 
-					m_msgs->ClearGroup(name);
+		return job;
+	}
+	void RenderEngine::m_submitCompileJob(ShaderCompileJob* job)
+	{
+		m_compileJobIDs[job->Item] = job->ID;
 
-					SPIRVQueue.push_back(item);
+		// plugins aren't guaranteed to be thread safe
+		for (ShaderCompileStage& stage : job->Stages) {
+			if (stage.Language != ShaderLanguage::Plugin)
+				continue;
 
-					bool compiled = false;
-					GLuint cs = 0;
+			stage.Compiled = m_pluginCompileToSpirv(job->Item, stage.SPV, stage.Path, stage.Entry, (plugin::ShaderStage)stage.Stage, job->Macros.data(), job->Macros.size(), stage.Source);
+			if (stage.Compiled) {
+				stage.GLSL = ShaderCompiler::ConvertToGLSL(stage.SPV, stage.Language, stage.Stage, job->TSUsed, job->GSUsed, &job->Messages);
+				stage.GLSL = m_pluginProcessGLSL(stage.Path.c_str(), stage.GLSL.c_str());
+			}
+			stage.Processed = true;
+		}
 
-					// compute shader
-					if (vssrc.size() > 0) {
-						int lineBias = 0;
+		// the result of an older job for the same item would be thrown away anyway
+		m_compiler.Submit(job, true);
+	}
+	bool RenderEngine::m_applyCompileJobs()
+	{
+		bool applied = false;
+
+		std::vector<ShaderCompileJob*> jobs = m_compiler.GetFinishedJobs();
+		for (ShaderCompileJob* job : jobs) {
+			// skip the job if a newer one was submitted or if the item was removed
+			if (m_compileJobIDs.count(job->Item) && m_compileJobIDs[job->Item] == job->ID) {
+				m_applyCompileJob(job);
+				applied = true;
+			}
 
-						ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(shader->Path);
-						if (lang == ShaderLanguage::Plugin)
-							compiled = m_pluginCompileToSpirv(item, shader->SPV, shader->Path, shader->Entry, plugin::ShaderStage::Compute, shader->Macros.data(), shader->Macros.size(), vssrc);
-						else
-							compiled = ShaderCompiler::CompileSourceToSPIRV(shader->SPV, lang, shader->Path, vssrc, ShaderStage::Compute, shader->Entry, shader->Macros, m_msgs, m_project);
+			delete job;
+		}
 
-						std::string content = vssrc;
-						if (lang == ShaderLanguage::GLSL) { // GLSL
-							m_includeCheck(content, std::vector<std::string>(), lineBias);
-							m_applyMacros(content, shader);
-						} else { // HLSL / VK
-							content = ShaderCompiler::ConvertToGLSL(shader->SPV, lang, ShaderStage::Compute, false, false, m_msgs);
+		return applied;
+	}
+	void RenderEngine::m_applyCompileJob(ShaderCompileJob* job)
+	{
+		int index = std::find(m_items.begin(), m_items.end(), job->Item) - m_items.begin();
+		if (index >= m_items.size())
+			return;
 
-							if (lang == ShaderLanguage::Plugin)
-								content = m_pluginProcessGLSL(shader->Path, content.c_str());
-						}
+		PipelineItem* item = m_items[index];
+		const char* name = item->Name;
 
+		Logger::Get().Log("Applying compiled shaders to " + std::string(name));
 
-						cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-						compiled &= gl::CheckShaderCompilationStatus(cs);
-					}
+		// item could have been renamed in the meantime
+		job->Messages.RenameGroup(job->Name, name);
+		bool hasStageMessages = job->Messages.GetGroupErrorAndWarningMsgCount(name) > 0;
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
+		m_msgs->ClearGroup(name);
+		m_msgs->Add(job->Messages.GetMessages());
+		if (job->UserRequested)
+			m_msgs->BuildOccured = true;
 
-					if (m_shaders[i] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
+		GLchar shaderMessage[1024] = { 0 };
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
+
+			// stages that aren't part of a partial job keep their shader objects
+			ShaderPack sources;
+			if (job->Partial)
+				sources = m_shaderSources[index];
+
+			bool compiled = true, sourceEmpty = false;
+			for (ShaderCompileStage& stage : job->Stages) {
+				GLuint glShader = gl::CompileShader(getShaderType(stage.Stage), stage.GLSL.c_str());
+				compiled &= stage.Compiled;
+				compiled &= gl::CheckShaderCompilationStatus(glShader, shaderMessage);
+				sourceEmpty |= stage.GLSL.empty();
+
+				if (stage.Stage == ShaderStage::Pixel)
+					shader->Variables.UpdateTextureList(stage.GLSL);
+
+				if (stage.Stage == ShaderStage::Vertex) {
+					sources.VS = glShader;
+					shader->VSSPV = std::move(stage.SPV);
+				} else if (stage.Stage == ShaderStage::Pixel) {
+					sources.PS = glShader;
+					shader->PSSPV = std::move(stage.SPV);
+				} else if (stage.Stage == ShaderStage::Geometry) {
+					sources.GS = glShader;
+					shader->GSSPV = std::move(stage.SPV);
+				} else if (stage.Stage == ShaderStage::TessellationControl) {
+					sources.TCS = glShader;
+					shader->TCSSPV = std::move(stage.SPV);
+				} else if (stage.Stage == ShaderStage::TessellationEvaluation) {
+					sources.TES = glShader;
+					shader->TESSPV = std::move(stage.SPV);
+				}
+			}
 
-					if (!compiled) {
-						m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the compute shader.");
+			// delete replaced shader objects
+			const ShaderPack& oldSources = m_shaderSources[index];
+			if (oldSources.VS != sources.VS) glDeleteShader(oldSources.VS);
+			if (oldSources.PS != sources.PS) glDeleteShader(oldSources.PS);
+			if (oldSources.GS != sources.GS) glDeleteShader(oldSources.GS);
+			if (oldSources.TCS != sources.TCS) glDeleteShader(oldSources.TCS);
+			if (oldSources.TES != sources.TES) glDeleteShader(oldSources.TES);
+			m_shaderSources[index] = sources;
+
+			// the old program was used until now
+			if (m_shaders[index] != 0)
+				glDeleteProgram(m_shaders[index]);
+			if (m_debugShaders[index] != 0)
+				glDeleteProgram(m_debugShaders[index]);
+			m_shaders[index] = m_debugShaders[index] = 0;
+
+			// the new program can get the same name, so the batch block binding has to be set up again
+			m_drawLists.erase(shader);
+
+			if (!compiled || sourceEmpty) {
+				Logger::Get().Log("Shaders not compiled", true);
+				if (sourceEmpty)
+					m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
+				else {
+					if (shaderMessage[0] != 0 && !hasStageMessages)
+						m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
+					m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
+				}
+			} else {
+				if (job->UserRequested)
+					m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
+
+				m_shaders[index] = glCreateProgram();
+				glAttachShader(m_shaders[index], sources.VS);
+				glAttachShader(m_shaders[index], sources.PS);
+				if (shader->GSUsed) glAttachShader(m_shaders[index], sources.GS);
+				if (shader->TSUsed) glAttachShader(m_shaders[index], sources.TCS);
+				if (shader->TSUsed) glAttachShader(m_shaders[index], sources.TES);
+				glLinkProgram(m_shaders[index]);
+				// XXX TODO check link status
+
+				m_debugShaders[index] = glCreateProgram();
+				glAttachShader(m_debugShaders[index], m_generalDebugShader);
+				glAttachShader(m_debugShaders[index], sources.VS);
+				if (shader->GSUsed) glAttachShader(m_debugShaders[index], sources.GS);
+				if (shader->TSUsed) glAttachShader(m_debugShaders[index], sources.TCS);
+				if (shader->TSUsed) glAttachShader(m_debugShaders[index], sources.TES);
+				glLinkProgram(m_debugShaders[index]);
+
+				shader->Variables.UpdateUniformInfo(m_shaders[index]);
+			}
+		} 
+		else if (item->Type == PipelineItem::ItemType::ComputePass) {
+			pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
+
+			bool compiled = !job->Stages.empty(), sourceEmpty = false;
+			GLuint cs = 0;
+			if (!job->Stages.empty()) {
+				ShaderCompileStage& stage = job->Stages[0];
+
+				// compute shader supported == version 4.3 == not needed: shader->Variables.UpdateTextureList(content);
+				cs = gl::CompileShader(GL_COMPUTE_SHADER, stage.GLSL.c_str());
+				compiled &= stage.Compiled;
+				compiled &= gl::CheckShaderCompilationStatus(cs, shaderMessage);
+				sourceEmpty = stage.GLSL.empty();
+
+				shader->SPV = std::move(stage.SPV);
+			}
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
+			// find out which bindings the shader writes to - only GLSL keeps the bindings we use in Render()
+			ComputeBindings& bindings = m_computeBindings[shader];
+			bindings = ComputeBindings();
+			if (!shader->SPV.empty() && ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::GLSL) {
+				SPIRVParser parser;
+				parser.Parse(shader->SPV);
+
+				bindings.Reflected = true;
+				for (const auto& res : parser.StorageResources) {
+					if (res.Binding < 0) {
+						bindings.Reflected = false;
+						break;
 					}
+					if (!res.ReadOnly)
+						(res.IsImage ? bindings.WrittenImages : bindings.WrittenBuffers).push_back(res.Binding);
+				}
+			}
 
-					glDeleteShader(cs);
-				} 
-				else if (item->Type == PipelineItem::ItemType::AudioPass) {
-					pipe::AudioPass* shader = (pipe::AudioPass*)item->Data;
-					m_msgs->ClearGroup(name);
+			if (m_shaders[index] != 0)
+				glDeleteProgram(m_shaders[index]);
+			m_shaders[index] = 0;
+
+			if (!compiled || sourceEmpty) {
+				Logger::Get().Log("Compute shader was not compiled", true);
+				if (sourceEmpty)
+					m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
+				else {
+					if (shaderMessage[0] != 0 && !hasStageMessages)
+						m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
+					m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
+				}
+			} else {
+				if (job->UserRequested)
+					m_msgs->Add(MessageStack::Type::Message, name, "Compiled the compute shader.");
 
-					bool compiled = false;
-					GLuint ss = 0;
+				m_shaders[index] = glCreateProgram();
+				glAttachShader(m_shaders[index], cs);
+				glLinkProgram(m_shaders[index]);
 
-					// audio shader
-					if (vssrc.size() > 0)
-						shader->Stream.CompileFromShaderSource(m_project, m_msgs, vssrc, shader->Macros, true);
-					shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
-				}
+				shader->Variables.UpdateUniformInfo(m_shaders[index]);
 			}
+
+			glDeleteShader(cs);
 		}
 
-		Render();
+		SPIRVQueue.push_back(item);
 	}
 	void RenderEngine::Pick(float sx, float sy, bool multiPick, std::function<void(PipelineItem*)> func)
 	{
@@ -1734,6 +1635,8 @@ namespace ed {
 	}
 	void RenderEngine::Pick(PipelineItem* item, bool add)
 	{
+		m_pickVersion++;
+
 		// check if it already exists
 		bool skipAdd = false;
 		for (int i = 0; i < m_pick.size(); i++)
@@ -1757,6 +1660,235 @@ namespace ed {
 			}
 		}
 	}
+	RenderEngine::DrawList& RenderEngine::m_getDrawList(pipe::ShaderPass* pass)
+	{
+		DrawList& list = m_drawLists[pass];
+
+		// items were added, removed or moved
+		bool rebuild = list.Items != pass->Items;
+		if (rebuild) {
+			list.Items = pass->Items;
+			list.Commands.clear();
+			list.Commands.resize(pass->Items.size());
+		}
+
+		if (rebuild || list.PickVersion != m_pickVersion) {
+			for (int i = 0; i < list.Items.size(); i++)
+				list.Commands[i].Picked = IsPicked(list.Items[i]);
+			list.PickVersion = m_pickVersion;
+		}
+
+		if (rebuild || list.ItemValuesVersion != m_itemValuesVersion || list.ItemValuesSize != m_itemValues.size()) {
+			for (int i = 0; i < list.Items.size(); i++) {
+				PipelineItem* item = list.Items[i];
+				DrawCommand& cmd = list.Commands[i];
+
+				cmd.ItemValues.clear();
+				if (item->Type != PipelineItem::ItemType::Geometry && item->Type != PipelineItem::ItemType::Model && item->Type != PipelineItem::ItemType::VertexBuffer && item->Type != PipelineItem::ItemType::PluginItem)
+					continue;
+
+				for (int k = 0; k < m_itemValues.size(); k++)
+					if (m_itemValues[k].Item == item)
+						cmd.ItemValues.push_back(k);
+			}
+
+			list.ItemValuesVersion = m_itemValuesVersion;
+			list.ItemValuesSize = m_itemValues.size();
+		}
+
+		return list;
+	}
+	void RenderEngine::m_bindGeometryBatch(GLuint binding)
+	{
+		// orphan the old data instead of waiting for the previous batch to finish
+		if (m_batchBuffer == 0)
+			glGenBuffers(1, &m_batchBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_batchBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_batchData.size() * sizeof(GeometryBatchItem), m_batchData.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		m_glState.BindStorageBuffer(binding, m_batchBuffer);
+	}
+	void RenderEngine::m_bindSingleGeometryBatch(PipelineItem* item, bool picked, GLuint binding, int instanceCount)
+	{
+		// every instance gets the item's transform
+		m_batchData.resize(std::max(1, instanceCount));
+		for (GeometryBatchItem& batchItem : m_batchData) {
+			batchItem.Transform = SystemVariableManager::Instance().GetGeometryTransform(item);
+			batchItem.IsPicked = picked;
+		}
+
+		m_bindGeometryBatch(binding);
+	}
+	int RenderEngine::m_getGeometryBatchLength(pipe::ShaderPass* pass, DrawList& list, int start)
+	{
+		pipe::GeometryItem* first = (pipe::GeometryItem*)pass->Items[start]->Data;
+		if (first->Instanced || !list.Commands[start].ItemValues.empty())
+			return 1;
+
+		// items can only share a draw call if they have the same vertices & nothing but the
+		// transform and the picked state differs between them
+		int end = start + 1;
+		for (; end < pass->Items.size(); end++) {
+			PipelineItem* item = pass->Items[end];
+			if (item->Type != PipelineItem::ItemType::Geometry || !item->Active || !list.Commands[end].ItemValues.empty())
+				break;
+
+			pipe::GeometryItem* geo = (pipe::GeometryItem*)item->Data;
+			if (geo->Instanced || geo->Type != first->Type || geo->Topology != first->Topology || geo->Size != first->Size)
+				break;
+		}
+
+		return end - start;
+	}
+	void RenderEngine::m_updatePerfTimers(const FrameProfiler::Frame& frame)
+	{
+		m_totalPerfTime = 0;
+		for (auto& timer : m_perfTimers) {
+			timer.LastTime = timer.LastCPUTime = 0;
+
+			for (const auto& ev : frame.Events) {
+				if (ev.Parent[0] == 0 && strcmp(ev.Name, timer.Pass->Name) == 0) {
+					timer.LastTime = ev.GPUEnd > ev.GPUStart ? ev.GPUEnd - ev.GPUStart : 0;
+					timer.LastCPUTime = ev.CPUEnd - ev.CPUStart;
+					break;
+				}
+			}
+
+			m_totalPerfTime += timer.LastTime;
+		}
+	}
+	void RenderEngine::m_addComputeWrites(pipe::ComputePass* pass, const std::vector<GLuint>& ubos)
+	{
+		const ComputeBindings& bindings = m_computeBindings[pass];
+
+		for (int j = 0; j < ubos.size(); j++) {
+			ObjectManagerItem* uboData = m_objects->GetByTextureID(ubos[j]);
+			if (uboData == nullptr)
+				uboData = m_objects->GetByBufferID(ubos[j]);
+			if (uboData == nullptr)
+				continue;
+
+			if (uboData->Type == ObjectType::Image || uboData->Type == ObjectType::Image3D) {
+				if (!bindings.Reflected || std::count(bindings.WrittenImages.begin(), bindings.WrittenImages.end(), j))
+					m_unsyncedTextures[ubos[j]] = 0;
+			} else if (uboData->Type == ObjectType::PluginObject)
+				m_unsyncedUnknown = true;
+			else if (!bindings.Reflected || std::count(bindings.WrittenBuffers.begin(), bindings.WrittenBuffers.end(), j))
+				m_unsyncedBuffers[ubos[j]] = 0;
+		}
+	}
+	void RenderEngine::m_syncComputeWrites(PipelineItem* item)
+	{
+		if (m_unsyncedBuffers.empty() && m_unsyncedTextures.empty() && !m_unsyncedUnknown)
+			return;
+
+		// we don't know what plugins read
+		bool syncAll = m_unsyncedUnknown || item->Type == PipelineItem::ItemType::PluginItem;
+
+		GLbitfield barriers = 0;
+		auto needBuffer = [&](GLuint buffer, GLbitfield bit) {
+			auto it = m_unsyncedBuffers.find(buffer);
+			if (it != m_unsyncedBuffers.end() && (it->second & bit) == 0)
+				barriers |= bit;
+		};
+		auto needTexture = [&](GLuint tex, GLbitfield bit) {
+			auto it = m_unsyncedTextures.find(tex);
+			if (it != m_unsyncedTextures.end() && (it->second & bit) == 0)
+				barriers |= bit;
+		};
+		auto needVertexBuffer = [&](void* buffer) {
+			if (buffer != nullptr)
+				needBuffer(((BufferObject*)buffer)->ID, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+		};
+
+		if (!syncAll) {
+			const std::vector<GLuint>& srvs = m_objects->GetBindList(item);
+			const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(item);
+
+			for (GLuint srv : srvs)
+				needTexture(srv, GL_TEXTURE_FETCH_BARRIER_BIT);
+
+			if (item->Type == PipelineItem::ItemType::ComputePass) {
+				// written images and buffers are also bound here, so this covers write-after-write too
+				for (GLuint ubo : ubos) {
+					ObjectManagerItem* uboData = m_objects->GetByTextureID(ubo);
+					if (uboData == nullptr)
+						uboData = m_objects->GetByBufferID(ubo);
+
+					if (uboData != nullptr && uboData->Type == ObjectType::PluginObject)
+						syncAll = true;
+					else if (uboData != nullptr && (uboData->Type == ObjectType::Image || uboData->Type == ObjectType::Image3D))
+						needTexture(ubo, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+					else
+						needBuffer(ubo, GL_SHADER_STORAGE_BARRIER_BIT);
+				}
+			} else {
+				for (GLuint ubo : ubos)
+					needBuffer(ubo, GL_SHADER_STORAGE_BARRIER_BIT);
+			}
+
+			if (item->Type == PipelineItem::ItemType::ShaderPass) {
+				pipe::ShaderPass* pass = (pipe::ShaderPass*)item->Data;
+				for (PipelineItem* child : pass->Items) {
+					if (child->Type == PipelineItem::ItemType::Geometry)
+						needVertexBuffer(((pipe::GeometryItem*)child->Data)->InstanceBuffer);
+					else if (child->Type == PipelineItem::ItemType::Model)
+						needVertexBuffer(((pipe::Model*)child->Data)->InstanceBuffer);
+					else if (child->Type == PipelineItem::ItemType::VertexBuffer) {
+						needVertexBuffer(((pipe::VertexBuffer*)child->Data)->Buffer);
+						needVertexBuffer(((pipe::VertexBuffer*)child->Data)->InstanceBuffer);
+					} else if (child->Type == PipelineItem::ItemType::PluginItem)
+						syncAll = true;
+				}
+			}
+		}
+
+		if (syncAll) {
+			m_syncAllComputeWrites();
+			return;
+		}
+
+		if (barriers == 0)
+			return;
+
+		glMemoryBarrier(barriers);
+
+		for (auto& buffer : m_unsyncedBuffers)
+			buffer.second |= barriers;
+		for (auto& tex : m_unsyncedTextures)
+			tex.second |= barriers;
+	}
+	void RenderEngine::m_syncAllComputeWrites()
+	{
+		if (m_unsyncedBuffers.empty() && m_unsyncedTextures.empty() && !m_unsyncedUnknown)
+			return;
+
+		glMemoryBarrier(GL_ALL_BARRIER_BITS);
+
+		m_unsyncedBuffers.clear();
+		m_unsyncedTextures.clear();
+		m_unsyncedUnknown = false;
+	}
+	float RenderEngine::m_getModelLODError(PipelineItem* item, pipe::Model* model)
+	{
+		SystemVariableManager& systemVM = SystemVariableManager::Instance();
+		const glm::mat4& world = systemVM.GetGeometryTransform(item);
+
+		// bounding sphere in world space
+		glm::vec3 minBound = model->Data->GetMinBound(), maxBound = model->Data->GetMaxBound();
+		glm::vec3 center = glm::vec3(world * glm::vec4((minBound + maxBound) * 0.5f, 1.0f));
+		float scale = std::max(std::max(glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1]))), glm::length(glm::vec3(world[2])));
+		float radius = glm::length(maxBound - minBound) * 0.5f * scale;
+
+		float distance = glm::length(center - glm::vec3(systemVM.GetCamera()->GetPosition())) - radius;
+		if (distance <= 0.0f)
+			return 0.0f;
+
+		// size of one model space unit on the screen (SHADERed's camera)
+		float pixelsPerUnit = systemVM.GetProjectionMatrix()[1][1] * systemVM.GetViewportSize().y * 0.5f * scale / distance;
+
+		return MODEL_LOD_PIXEL_ERROR / pixelsPerUnit;
+	}
 	void RenderEngine::m_pickItem(PipelineItem* item, bool multiPick)
 	{
 		glm::mat4 world(1);
@@ -1836,42 +1968,36 @@ namespace ed {
 			glm::vec3 minb = obj->Data->GetMinBound();
 			glm::vec3 maxb = obj->Data->GetMaxBound();
 
-			float triDist = std::numeric_limits<float>::infinity();
-			if (ray::IntersectBox(vec3Origin, vec3Dir, minb, maxb, triDist)) {
-				bool donetris = false;
+			float boxDist = std::numeric_limits<float>::infinity();
+			if (ray::IntersectBox(vec3Origin, vec3Dir, minb, maxb, boxDist)) {
 				for (auto& mesh : obj->Data->Meshes) {
-					for (int i = 0; i + 2 < mesh.Vertices.size(); i += 3) {
-						glm::vec3 v0 = mesh.Vertices[i + 0].Position;
-						glm::vec3 v1 = mesh.Vertices[i + 1].Position;
-						glm::vec3 v2 = mesh.Vertices[i + 2].Position;
-
-						if (ray::IntersectTriangle(vec3Origin, vec3Dir, v0, v1, v2, triDist))
-							if (triDist < myDist) {
-								myDist = triDist;
-
-								if (triDist < m_pickDist) {
-									donetris = true;
-									break;
-								}
-							}
-					}
-
-					if (donetris)
-						break;
+					float triDist = std::numeric_limits<float>::infinity();
+					if (mesh.GetBVH().Intersect(vec3Origin, vec3Dir, triDist) && triDist < myDist)
+						myDist = triDist;
 				}
 			}
 		} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 			pipe::VertexBuffer* obj = (pipe::VertexBuffer*)item->Data;
 
-			glm::vec3 b1(0.0f);
-			glm::vec3 b2(0.0f);
-			gl::GetVertexBufferBounds(m_objects, obj, b1, b2);
+			BufferObject* buffer = (BufferObject*)obj->Buffer;
 
-			// TODO: use ray-triangle intersection for more precision
+			if (buffer != nullptr) {
+				ObjectManager::BufferGeometry& geo = m_objects->GetBufferGeometry(buffer);
 
-			float distHit;
-			if (ray::IntersectBox(vec3Origin, vec3Dir, b1, b2, distHit))
-				myDist = distHit;
+				float distHit;
+				if (ray::IntersectBox(vec3Origin, vec3Dir, geo.MinBound, geo.MaxBound, distHit)) {
+					// other topologies don't have any triangles to test against
+					if (obj->Topology == GL_TRIANGLES) {
+						if (!geo.BVH.IsBuilt())
+							geo.BVH.Build(geo.Positions.data(), sizeof(glm::vec3), geo.Positions.size(), nullptr, 0);
+
+						float triDist;
+						if (geo.BVH.Intersect(vec3Origin, vec3Dir, triDist))
+							myDist = triDist;
+					} else
+						myDist = distHit;
+				}
+			}
 		} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 			pipe::PluginItemData* obj = (pipe::PluginItemData*)item->Data;
 
@@ -1890,6 +2016,8 @@ namespace ed {
 	}
 	void RenderEngine::AddPickedItem(PipelineItem* pipe, bool multiPick)
 	{
+		m_pickVersion++;
+
 		// check if it already exists
 		bool skipAdd = false;
 		for (int i = 0; i < m_pick.size(); i++)
@@ -1954,6 +2082,9 @@ namespace ed {
 	}
 	void RenderEngine::FlushCache()
 	{
+		m_compiler.Clear();
+		m_compileJobIDs.clear();
+
 		for (int i = 0; i < m_shaders.size(); i++) {
 			glDeleteShader(m_shaderSources[i].VS);
 			glDeleteShader(m_shaderSources[i].PS);
@@ -1961,7 +2092,6 @@ namespace ed {
 			glDeleteShader(m_shaderSources[i].TCS);
 			glDeleteShader(m_shaderSources[i].TES);
 			glDeleteProgram(m_shaders[i]);
-			glDeleteQueries(1, &m_perfTimers[i].Object);
 		}
 
 		m_fbos.clear();
@@ -1969,13 +2099,19 @@ namespace ed {
 		m_items.clear();
 		m_shaders.clear();
 		m_perfTimers.clear();
+		m_profiler.Clear();
 		m_shaderSources.clear();
 		m_uboMax.clear();
+		m_drawLists.clear();
+		m_msTargets.clear();
+		m_msAttached.clear();
+		m_computeBindings.clear();
+		m_syncAllComputeWrites();
 		m_fbosNeedUpdate = true;
 
 		// clear textures
 		glBindTexture(GL_TEXTURE_2D, m_rtColor);
-		glTexImage2D(GL_TEXTURE_2D, 0, Settings::Instance().Project.UseAlphaChannel ? GL_RGBA32F : GL_RGB32F, m_lastSize.x, m_lastSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexImage2D(GL_TEXTURE_2D, 0, getWindowTextureFormat(), m_lastSize.x, m_lastSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 		glBindTexture(GL_TEXTURE_2D, m_rtDepth);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_lastSize.x, m_lastSize.y, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
 		glBindTexture(GL_TEXTURE_2D, 0);
@@ -1996,7 +2132,7 @@ namespace ed {
 		}
 
 		// check if some item was added
-		GLchar shaderMessage[1024] = { 0 };
+		bool hasNewShaders = false;
 		for (int i = 0; i < items.size(); i++) {
 			bool found = false;
 			for (int j = 0; j < m_items.size(); j++)
@@ -2010,239 +2146,39 @@ namespace ed {
 
 				if (items[i]->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* data = reinterpret_cast<ed::pipe::ShaderPass*>(items[i]->Data);
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name);
 
 					m_items.insert(m_items.begin() + i, items[i]);
 					m_shaders.insert(m_shaders.begin() + i, 0);
 					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
 					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
 					
-					SPIRVQueue.push_back(items[i]);
-
 					// cache performance timer
 					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
 
 					if (strlen(data->VSPath) == 0 || strlen(data->PSPath) == 0) {
 						Logger::Get().Log("No shader paths are set", true);
 						continue;
 					}
 
-					glDeleteShader(m_shaderSources[i].VS);
-					glDeleteShader(m_shaderSources[i].PS);
-					glDeleteShader(m_shaderSources[i].GS);
-					glDeleteShader(m_shaderSources[i].TCS);
-					glDeleteShader(m_shaderSources[i].TES);
-
 					/*
 						ITEM CACHING
 					*/
 
 					m_fbos[data].resize(MAX_RENDER_TEXTURES);
 
-					GLuint ps = 0, vs = 0, gs = 0, tcs = 0, tes = 0;
-
-					m_msgs->CurrentItem = items[i]->Name;
-
-					int lineBias = 0;
-					std::string psContent = "", vsContent = "",
-								vsEntry = data->VSEntry,
-								psEntry = data->PSEntry;
-					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->VSPath);
-					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath);
-
-					// vertex shader
-					bool vsCompiled = false;
-
-					if (vsLang == ShaderLanguage::Plugin)
-						vsCompiled = m_pluginCompileToSpirv(items[i], data->VSSPV, data->VSPath, vsEntry, plugin::ShaderStage::Vertex, data->Macros.data(), data->Macros.size());
-					else
-						vsCompiled = ShaderCompiler::CompileToSPIRV(data->VSSPV, vsLang, data->VSPath, ShaderStage::Vertex, vsEntry, data->Macros, m_msgs, m_project);
-					
-					// generate glsl
-					if (vsLang == ShaderLanguage::GLSL) { // GLSL
-						vsContent = m_project->LoadProjectFile(data->VSPath);
-						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(vsContent, data);
-					} else if (vsCompiled) {
-						vsContent = ShaderCompiler::ConvertToGLSL(data->VSSPV, vsLang, ShaderStage::Vertex, data->TSUsed, data->GSUsed, m_msgs);
-						vsEntry = "main";
-
-						if (vsLang == ShaderLanguage::Plugin)
-							vsContent = std::string(m_pluginProcessGLSL(data->VSPath, vsContent.c_str()));
-					}
-
-					vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs, shaderMessage);
-					
-					// pixel shader
-					lineBias = 0;
-					bool psCompiled = false;
-
-					if (psLang == ShaderLanguage::Plugin)
-						psCompiled = m_pluginCompileToSpirv(items[i], data->PSSPV, data->PSPath, psEntry, plugin::ShaderStage::Pixel, data->Macros.data(), data->Macros.size());
-					else
-						psCompiled = ShaderCompiler::CompileToSPIRV(data->PSSPV, psLang, data->PSPath, ShaderStage::Pixel, psEntry, data->Macros, m_msgs, m_project);
-					
-					if (psLang == ShaderLanguage::GLSL) { // GLSL
-						psContent = m_project->LoadProjectFile(data->PSPath);
-						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(psContent, data);
-					} else if (psCompiled) { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(data->PSSPV, psLang, ShaderStage::Pixel, data->TSUsed, data->GSUsed, m_msgs);
-						psEntry = "main";
-
-						if (psLang == ShaderLanguage::Plugin)
-							psContent = m_pluginProcessGLSL(data->PSPath, psContent.c_str());
-					}
-
-					data->Variables.UpdateTextureList(psContent);
-					ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps, shaderMessage);
-
-					// geometry shader
-					lineBias = 0;
-					bool gsCompiled = true;
-					if (data->GSUsed && strlen(data->GSEntry) > 0 && strlen(data->GSPath) > 0) {
-						std::string gsContent = "", gsEntry = data->GSEntry;
-						ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->GSPath);
-						
-						if (gsLang == ShaderLanguage::Plugin)
-							gsCompiled = m_pluginCompileToSpirv(items[i], data->GSSPV, data->GSPath, gsEntry, plugin::ShaderStage::Geometry, data->Macros.data(), data->Macros.size());
-						else
-							gsCompiled = ShaderCompiler::CompileToSPIRV(data->GSSPV, gsLang, data->GSPath, ShaderStage::Geometry, gsEntry, data->Macros, m_msgs, m_project);
-						
-						if (gsLang == ShaderLanguage::GLSL) { // GLSL
-							gsContent = m_project->LoadProjectFile(data->GSPath);
-							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(gsContent, data);
-						} else if (gsCompiled) { // HLSL
-							gsContent = ShaderCompiler::ConvertToGLSL(data->GSSPV, gsLang, ShaderStage::Geometry, data->TSUsed, data->GSUsed, m_msgs);
-							gsEntry = "main";
-
-							if (gsLang == ShaderLanguage::Plugin)
-								gsContent = m_pluginProcessGLSL(data->GSPath, gsContent.c_str());
-						}
-
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs, shaderMessage);
-					}
-
-					// tessellation shader
-					lineBias = 0;
-					bool tsCompiled = ((data->TSUsed && m_tessellationSupported) || !data->TSUsed);
-					if (data->TSUsed && m_tessellationSupported) {
-						// tessellation control shader
-						if (strlen(data->TCSEntry) > 0 && strlen(data->TCSPath) > 0) {
-							std::string tcsContent = "", tcsEntry = data->TCSEntry;
-							ShaderLanguage tcsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->TCSPath);
-
-							if (tcsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(items[i], data->TCSSPV, data->TCSPath, tcsEntry, plugin::ShaderStage::TessellationControl, data->Macros.data(), data->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(data->TCSSPV, tcsLang, data->TCSPath, ShaderStage::TessellationControl, tcsEntry, data->Macros, m_msgs, m_project);
-
-							if (tcsLang == ShaderLanguage::GLSL) { // GLSL
-								tcsContent = m_project->LoadProjectFile(data->TCSPath);
-								m_includeCheck(tcsContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tcsContent, data);
-							} else if (gsCompiled) { // HLSL
-								tcsContent = ShaderCompiler::ConvertToGLSL(data->TCSSPV, tcsLang, ShaderStage::TessellationControl, data->TSUsed, data->GSUsed, m_msgs);
-								tcsEntry = "main";
-
-								if (tcsLang == ShaderLanguage::Plugin)
-									tcsContent = m_pluginProcessGLSL(data->TCSPath, tcsContent.c_str());
-							}
-
-							tcs = gl::CompileShader(GL_TESS_CONTROL_SHADER, tcsContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tcs, shaderMessage);
-						}
-
-						// tessellation evauluation shader
-						if (strlen(data->TESEntry) > 0 && strlen(data->TESPath) > 0) {
-							std::string tesContent = "", tesEntry = data->TESEntry;
-							ShaderLanguage tesLang = ShaderCompiler::GetShaderLanguageFromExtension(data->TESPath);
-
-							if (tesLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(items[i], data->TESSPV, data->TESPath, tesEntry, plugin::ShaderStage::TessellationEvaluation, data->Macros.data(), data->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(data->TESSPV, tesLang, data->TESPath, ShaderStage::TessellationEvaluation, tesEntry, data->Macros, m_msgs, m_project);
-
-							if (tesLang == ShaderLanguage::GLSL) { // GLSL
-								tesContent = m_project->LoadProjectFile(data->TESPath);
-								m_includeCheck(tesContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tesContent, data);
-							} else if (gsCompiled) { // HLSL
-								tesContent = ShaderCompiler::ConvertToGLSL(data->TESSPV, tesLang, ShaderStage::TessellationEvaluation, data->TSUsed, data->GSUsed, m_msgs);
-								tesEntry = "main";
-
-								if (tesLang == ShaderLanguage::Plugin)
-									tesContent = m_pluginProcessGLSL(data->TESPath, tesContent.c_str());
-							}
-
-							tes = gl::CompileShader(GL_TESS_EVALUATION_SHADER, tesContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tes, shaderMessage);
-						}
-					}
-
-
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (m_debugShaders[i] != 0)
-						glDeleteProgram(m_debugShaders[i]);
-
-					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled) {
-						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name))
-							m_msgs->Add(MessageStack::Type::Error, items[i]->Name, shaderMessage);
-						m_msgs->Add(MessageStack::Type::Error, items[i]->Name, "Failed to compile the shader");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->ClearGroup(items[i]->Name);
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						glAttachShader(m_shaders[i], ps);
-						if (data->GSUsed) glAttachShader(m_shaders[i], gs);
-						if (data->TSUsed) glAttachShader(m_shaders[i], tcs);
-						if (data->TSUsed) glAttachShader(m_shaders[i], tes);
-						glLinkProgram(m_shaders[i]);
-						// XXX TODO check link status
-
-						m_debugShaders[i] = glCreateProgram();
-						glAttachShader(m_debugShaders[i], m_generalDebugShader);
-						glAttachShader(m_debugShaders[i], vs);
-						if (data->GSUsed) glAttachShader(m_debugShaders[i], gs);
-						if (data->TSUsed) glAttachShader(m_debugShaders[i], tcs);
-						if (data->TSUsed) glAttachShader(m_debugShaders[i], tes);
-						glLinkProgram(m_debugShaders[i]);
-					}
-
-					if (m_shaders[i] != 0)
-						data->Variables.UpdateUniformInfo(m_shaders[i]);
-
-					m_shaderSources[i].VS = vs;
-					m_shaderSources[i].PS = ps;
-					m_shaderSources[i].GS = gs;
-					m_shaderSources[i].TCS = tcs;
-					m_shaderSources[i].TES = tes;
+					m_submitCompileJob(m_createCompileJob(items[i]));
+					hasNewShaders = true;
 				}
 				else if (items[i]->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) {
 					pipe::ComputePass* data = reinterpret_cast<ed::pipe::ComputePass*>(items[i]->Data);
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name);
 
 					m_items.insert(m_items.begin() + i, items[i]);
 					m_shaders.insert(m_shaders.begin() + i, 0);
 					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
 					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
 
-					SPIRVQueue.push_back(items[i]);
-
 					// cache performance timer
 					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
 
 					if (strlen(data->Path) == 0) {
 						Logger::Get().Log("No shader paths are set", true);
@@ -2253,61 +2189,8 @@ namespace ed {
 						ITEM CACHING
 					*/
 
-					GLuint cs = 0;
-
-					m_msgs->CurrentItem = items[i]->Name;
-
-					std::string content = "", entry = data->Entry;
-					int lineBias = 0;
-					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(data->Path);
-
-					// compute shader
-					bool compiled = false;
-
-					if (lang == ShaderLanguage::Plugin)
-						compiled = m_pluginCompileToSpirv(items[i], data->SPV, data->Path, entry, plugin::ShaderStage::Compute, data->Macros.data(), data->Macros.size());
-					else
-						compiled = ShaderCompiler::CompileToSPIRV(data->SPV, lang, data->Path, ShaderStage::Compute, entry, data->Macros, m_msgs, m_project);
-					
-					if (lang == ShaderLanguage::GLSL) { // GLSL
-						content = m_project->LoadProjectFile(data->Path);
-						m_includeCheck(content, std::vector<std::string>(), lineBias);
-						m_applyMacros(content, data);
-					} else if (compiled) { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(data->SPV, lang, ShaderStage::Compute, false, false, m_msgs);
-						entry = "main";
-
-						if (lang == ShaderLanguage::Plugin)
-							content = m_pluginProcessGLSL(data->Path, content.c_str());
-					}
-
-					cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs, shaderMessage);
-
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!compiled) {
-						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name))
-							m_msgs->Add(MessageStack::Type::Error, items[i]->Name, shaderMessage);
-						m_msgs->Add(MessageStack::Type::Error, items[i]->Name, "Failed to compile the compute shader");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->ClearGroup(items[i]->Name);
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
-					}
-
-					if (m_shaders[i] != 0)
-						data->Variables.UpdateUniformInfo(m_shaders[i]);
-
-					m_shaderSources[i].VS = 0;
-					m_shaderSources[i].PS = 0;
-					m_shaderSources[i].GS = 0;
-					m_shaderSources[i].TCS = 0;
-					m_shaderSources[i].TES = 0;
+					m_submitCompileJob(m_createCompileJob(items[i]));
+					hasNewShaders = true;
 				} 
 				else if (items[i]->Type == PipelineItem::ItemType::AudioPass) {
 					pipe::AudioPass* data = reinterpret_cast<ed::pipe::AudioPass*>(items[i]->Data);
@@ -2319,8 +2202,6 @@ namespace ed {
 
 					// cache performance timer
 					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
 
 					/*
 						ITEM CACHING
@@ -2331,7 +2212,7 @@ namespace ed {
 
 					// vertex shader
 					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
-						m_applyMacros(content, data);
+						ShaderCompileService::ApplyMacros(content, data->Macros);
 					data->Stream.CompileFromShaderSource(m_project, m_msgs, content, data->Macros, ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::HLSL);
 
 					data->Variables.UpdateUniformInfo(data->Stream.GetShader());
@@ -2346,8 +2227,6 @@ namespace ed {
 
 					// cache performance timer
 					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
 				}
 			}
 		}
@@ -2364,12 +2243,18 @@ namespace ed {
 			if (!found) {
 				glDeleteProgram(m_shaders[i]);
 				glDeleteProgram(m_debugShaders[i]);
-				glDeleteQueries(1, &m_perfTimers[i].Object);
 
 				Logger::Get().Log("Removing an item from cache");
 
-				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass)
+				m_compileJobIDs.erase(m_items[i]);
+
+				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass) {
 					m_fbos.erase((pipe::ShaderPass*)m_items[i]->Data);
+					m_drawLists.erase((pipe::ShaderPass*)m_items[i]->Data);
+					m_msTargets.erase((pipe::ShaderPass*)m_items[i]->Data);
+					m_msAttached.erase((pipe::ShaderPass*)m_items[i]->Data);
+				} else if (m_items[i]->Type == PipelineItem::ItemType::ComputePass)
+					m_computeBindings.erase((pipe::ComputePass*)m_items[i]->Data);
 
 				m_items.erase(m_items.begin() + i);
 				m_shaders.erase(m_shaders.begin() + i);
@@ -2413,78 +2298,11 @@ namespace ed {
 				}
 			}
 		}
-	}
-	void RenderEngine::m_applyMacros(std::string& src, pipe::ShaderPass* pass)
-	{
-		size_t verLoc = src.find_first_of("#version");
-		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
-		std::string strMacro = "";
-
-#ifdef SHADERED_WEB
-		strMacro += "#define SHADERED_WEB\n";
-#else
-		strMacro += "#define SHADERED_DESKTOP\n";
-#endif
-		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
-
-		for (auto& macro : pass->Macros) {
-			if (!macro.Active)
-				continue;
-
-			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
-		}
-
-		if (strMacro.size() > 0)
-			src.insert(lineLoc, strMacro);
-	}
-	void RenderEngine::m_applyMacros(std::string& src, pipe::ComputePass* pass)
-	{
-		size_t verLoc = src.find_first_of("#version");
-		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
-		std::string strMacro = "";
-
-#ifdef SHADERED_WEB
-		strMacro += "#define SHADERED_WEB\n";
-#else
-		strMacro += "#define SHADERED_DESKTOP\n";
-#endif
-		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
-
-		for (auto& macro : pass->Macros) {
-			if (!macro.Active)
-				continue;
-
-			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
-		}
-
-		if (strMacro.size() > 0)
-			src.insert(lineLoc, strMacro);
-	}
-	void RenderEngine::m_applyMacros(std::string& src, pipe::AudioPass* pass)
-	{
-		size_t verLoc = src.find_first_of("#version");
-		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
-		std::string strMacro = "";
-
-#ifdef SHADERED_WEB
-		strMacro += "#define SHADERED_WEB\n";
-#else
-		strMacro += "#define SHADERED_DESKTOP\n";
-#endif
-		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
-
-		for (auto& macro : pass->Macros) {
-			if (!macro.Active)
-				continue;
-
-			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
-		}
 
-		if (strMacro.size() > 0)
-			src.insert(lineLoc, strMacro);
+		// new items are compiled in parallel, but they have to be ready once m_cache() returns
+		if (hasNewShaders)
+			FinishShaderCompilation();
 	}
-	
-	
 	const char* RenderEngine::m_pluginProcessGLSL(const char* path, const char* src)
 	{
 		Logger::Get().Log("Plugin is processing GLSL");
@@ -2526,59 +2344,6 @@ namespace ed {
 		
 		return ret;
 	}
-	void RenderEngine::m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias)
-	{
-		size_t incLoc = src.find("#include");
-		Settings& settings = Settings::Instance();
-
-		std::vector<std::string> paths = settings.Project.IncludePaths;
-		paths.push_back(".");
-
-		while (incLoc != std::string::npos) {
-			bool isAfterNewline = true;
-			if (incLoc != 0)
-				if (src[incLoc - 1] != '\n')
-					isAfterNewline = false;
-
-			if (!isAfterNewline) {
-				incLoc = src.find("#include", incLoc + 1);
-				continue;
-			}
-
-			size_t quotePos = src.find_first_of("\"<", incLoc);
-			size_t quoteEnd = src.find_first_of("\">", quotePos + 1);
-			std::string fileName = src.substr(quotePos + 1, quoteEnd - quotePos - 1);
-
-			for (int i = 0; i < paths.size(); i++) {
-				std::string ipath = paths[i];
-				char last = ipath[ipath.size() - 1];
-				if (last != '\\' && last != '/')
-					ipath += "/";
-
-				ipath += fileName;
-
-				src.erase(incLoc, src.find_first_of('\n', incLoc) - incLoc);
-
-				if (std::count(includeStack.begin(), includeStack.end(), ipath) > 0)
-					m_msgs->Add(ed::MessageStack::Type::Error, m_msgs->CurrentItem, "Recursive #include detected");
-
-				if (m_project->FileExists(ipath) && std::count(includeStack.begin(), includeStack.end(), ipath) == 0) {
-					includeStack.push_back(ipath);
-
-					std::string incFileSrc = m_project->LoadProjectFile(ipath);
-					lineBias = std::count(incFileSrc.begin(), incFileSrc.end(), '\n');
-
-					m_includeCheck(incFileSrc, includeStack, lineBias);
-
-					src.insert(incLoc, incFileSrc);
-
-					break;
-				}
-			}
-
-			incLoc = src.find("#include", incLoc + 1);
-		}
-	}
 	void RenderEngine::m_updatePassFBO(ed::pipe::ShaderPass* pass)
 	{
 		bool changed = false;
@@ -2601,7 +2366,6 @@ namespace ed {
 		ObjectManagerItem* lastData = m_objects->GetByTextureID(lastID);
 
 		GLuint depthID = lastID == m_rtColor ? m_rtDepth : lastData->RT->DepthStencilBuffer;
-		GLuint depthMSID = lastID == m_rtColor ? m_rtDepthMS : lastData->RT->DepthStencilBufferMS;
 
 		pass->DepthTexture = depthID;
 
@@ -2625,26 +2389,99 @@ namespace ed {
 		GLenum retval = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-		// MSAA fbo
+		// MSAA fbo - textures are attached in m_attachMSTargets()
 		glGenFramebuffers(1, &m_fboMS[pass]);
-		glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_fboMS[pass]);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, depthMSID, 0);
-		for (int i = 0; i < pass->RTCount; i++) {
-			GLuint texID = pass->RenderTextures[i];
+		m_msAttached.erase(pass);
 
-			if (texID == 0) continue;
+		// the old FBO names might get reused
+		m_glState.Invalidate();
 
-			if (texID == m_rtColor)
-				texID = m_rtColorMS;
-			else
-				texID = m_objects->GetByTextureID(texID)->RT->BufferMS;
+		m_fbosNeedUpdate = false;
+	}
+	void RenderEngine::m_planMSTargets(int width, int height)
+	{
+		int samples = Settings::Instance().Preview.MSAA;
 
-			// attach
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D_MULTISAMPLE, texID, 0);
+		// follows the clearing logic in Render(): a render texture's contents only have to survive while it stays
+		// in previousTexture and a depth buffer's contents while it's used by consecutive passes - after that
+		// they get cleared anyway, so the multisampled texture can be given to someone else
+		GLuint previousTexture[MAX_RENDER_TEXTURES] = { 0 };
+		GLuint previousDepth = 0, previousDepthMS = 0;
+		std::unordered_map<GLuint, GLuint> colorMS; // render texture -> multisampled texture
+
+		m_msTargetPool.Begin();
+
+		for (int i = 0; i < m_items.size(); i++) {
+			if (m_items[i]->Type != PipelineItem::ItemType::ShaderPass)
+				continue;
+
+			pipe::ShaderPass* data = (pipe::ShaderPass*)m_items[i]->Data;
+			if (!data->Active || data->Items.size() <= 0 || data->RTCount == 0 || m_shaders[i] == 0)
+				continue;
+
+			for (int j = 0; j < data->RTCount; j++)
+				previousTexture[j] = data->RenderTextures[j];
+
+			for (auto it = colorMS.begin(); it != colorMS.end();) {
+				bool inUse = std::count(previousTexture, previousTexture + MAX_RENDER_TEXTURES, it->first) > 0;
+				if (!inUse && m_objects->GetByTextureID(it->first)->RT->Clear) {
+					m_msTargetPool.Release(it->second);
+					it = colorMS.erase(it);
+				} else
+					++it;
+			}
+
+			std::vector<GLuint>& targets = m_msTargets[data];
+			targets.resize(data->RTCount + 1);
+
+			// color
+			glm::ivec2 lastSize(width, height);
+			for (int j = 0; j < data->RTCount; j++) {
+				GLuint rt = data->RenderTextures[j];
+				if (rt == m_rtColor) {
+					targets[j] = m_rtColorMS;
+					lastSize = glm::ivec2(width, height);
+					continue;
+				}
+
+				RenderTextureObject* rtObj = m_objects->GetByTextureID(rt)->RT;
+				lastSize = rtObj->CalculateSize(width, height);
+
+				// render textures that are never cleared need their own texture
+				if (colorMS.count(rt) == 0)
+					colorMS[rt] = m_msTargetPool.Acquire(lastSize, rtObj->Format, samples, rtObj->Clear ? 0 : rt);
+				targets[j] = colorMS[rt];
+			}
+
+			// depth & stencil
+			GLuint lastID = data->RenderTextures[data->RTCount - 1];
+			GLuint depth = lastID == m_rtColor ? m_rtDepth : m_objects->GetByTextureID(lastID)->RT->DepthStencilBuffer;
+			if (depth != previousDepth) {
+				if (previousDepthMS != 0 && previousDepthMS != m_rtDepthMS)
+					m_msTargetPool.Release(previousDepthMS);
+
+				previousDepthMS = depth == m_rtDepth ? m_rtDepthMS : m_msTargetPool.Acquire(lastSize, GL_DEPTH24_STENCIL8, samples);
+				previousDepth = depth;
+			}
+			targets[data->RTCount] = previousDepthMS;
 		}
-		retval = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-		m_fbosNeedUpdate = false;
+		// textures of the passes that were removed or are inactive might have been deleted
+		if (m_msTargetPool.End())
+			m_msAttached.clear();
+	}
+	void RenderEngine::m_attachMSTargets(pipe::ShaderPass* pass)
+	{
+		const std::vector<GLuint>& targets = m_msTargets[pass];
+		std::vector<GLuint>& attached = m_msAttached[pass];
+		if (attached == targets)
+			return;
+
+		m_glState.BindFramebuffer(GL_FRAMEBUFFER, m_fboMS[pass]);
+		for (int i = 0; i < pass->RTCount; i++)
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D_MULTISAMPLE, targets[i], 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, targets[pass->RTCount], 0);
+
+		attached = targets;
 	}
 }
\ No newline at end of file
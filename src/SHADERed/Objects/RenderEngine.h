@@ -1,11 +1,15 @@
 #pragma once
 #include <SHADERed/Engine/Timer.h>
 #include <SHADERed/Objects/DebugInformation.h>
+#include <SHADERed/Objects/FrameProfiler.h>
+#include <SHADERed/Objects/GLStateCache.h>
 #include <SHADERed/Objects/MessageStack.h>
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/PluginManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
+#include <SHADERed/Objects/RenderTargetPool.h>
 #include <SHADERed/Objects/PerformanceTimer.h>
+#include <SHADERed/Objects/ShaderCompileService.h>
 
 #include <functional>
 #include <unordered_map>
@@ -39,6 +43,12 @@ namespace ed {
 		void Recompile(const char* name);
 		void RecompileFile(const char* fname);
 		void RecompileFromSource(const char* name, const std::string& vs = "", const std::string& ps = "", const std::string& gs = "", const std::string& tcs = "", const std::string& tes = "");
+
+		// shaders are compiled on worker threads - the previous program is used until the new one is applied
+		void UpdateShaderCompilation(); // call this every frame
+		void FinishShaderCompilation(); // wait for all shaders to compile and apply them
+		inline void Cache() { m_cache(); } // pick up the pipeline changes (and compile the new items) without rendering
+		inline bool IsCompilingShaders() { return m_compiler.IsBusy(); }
 		void Pick(float sx, float sy, bool multiPick, std::function<void(PipelineItem*)> func = nullptr);
 		void Pick(PipelineItem* item, bool add = false);
 		inline bool IsPicked(PipelineItem* item) { return std::count(m_pick.begin(), m_pick.end(), item); }
@@ -62,6 +72,7 @@ namespace ed {
 
 		inline const std::vector<PerformanceTimer>& GetPerformanceTimers() { return m_perfTimers; }
 		inline unsigned long long GetGPUTime() { return m_totalPerfTime; }
+		inline FrameProfiler& GetProfiler() { return m_profiler; }
 
 		inline bool IsPaused() { return m_paused; }
 		void Pause(bool pause);
@@ -86,12 +97,17 @@ namespace ed {
 		};
 
 		inline std::vector<ItemVariableValue>& GetItemVariableValues() { return m_itemValues; }
-		inline void AddItemVariableValue(const ItemVariableValue& item) { m_itemValues.push_back(item); }
+		inline void AddItemVariableValue(const ItemVariableValue& item)
+		{
+			m_itemValues.push_back(item);
+			m_itemValuesVersion++;
+		}
 		inline void RemoveItemVariableValue(PipelineItem* item, ShaderVariable* var)
 		{
 			for (int i = 0; i < m_itemValues.size(); i++)
 				if (m_itemValues[i].Item == item && m_itemValues[i].Variable == var) {
 					m_itemValues.erase(m_itemValues.begin() + i);
+					m_itemValuesVersion++;
 					return;
 				}
 		}
@@ -100,6 +116,7 @@ namespace ed {
 			for (int i = 0; i < m_itemValues.size(); i++)
 				if (m_itemValues[i].Item == item) {
 					m_itemValues.erase(m_itemValues.begin() + i);
+					m_itemValuesVersion++;
 					i--;
 				}
 		}
@@ -127,13 +144,14 @@ namespace ed {
 		GLuint m_rtColor, m_rtDepth, m_rtColorMS, m_rtDepthMS;
 		bool m_fbosNeedUpdate;
 
-		// check for the #include's & change the source code accordingly (includeStack == prevent recursion)
-		void m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias);
-
-		// apply macros to GLSL source code
-		void m_applyMacros(std::string& source, pipe::ShaderPass* pass);
-		void m_applyMacros(std::string& source, pipe::ComputePass* pass);
-		void m_applyMacros(std::string& source, pipe::AudioPass* pass); // TODO: merge this function with the ones above
+		// shader compilation
+		ShaderCompileService m_compiler;
+		uint64_t m_compileJobCounter;
+		std::unordered_map<PipelineItem*, uint64_t> m_compileJobIDs; // ID of the latest job submitted for an item
+		ShaderCompileJob* m_createCompileJob(PipelineItem* item, const std::string* sources = nullptr);
+		void m_submitCompileJob(ShaderCompileJob* job);
+		bool m_applyCompileJobs();
+		void m_applyCompileJob(ShaderCompileJob* job);
 
 		// compile to spirv - plugin edition
 		bool m_pluginCompileToSpirv(PipelineItem* owner, std::vector<GLuint>& spv, const std::string& path, const std::string& entry, plugin::ShaderStage stage, ed::ShaderMacro* macros, size_t macroCount, const std::string& actualSrc = "");
@@ -146,9 +164,13 @@ namespace ed {
 		glm::vec3 m_pickOrigin; // view space
 		glm::vec3 m_pickDir;
 		std::vector<PipelineItem*> m_pick;
+		int m_pickVersion; // incremented each time m_pick changes
 		bool m_wasMultiPick;
 		void m_pickItem(PipelineItem* item, bool multiPick);
 
+		// LOD
+		float m_getModelLODError(PipelineItem* item, pipe::Model* model);
+
 		// cache
 		std::vector<PipelineItem*> m_items;
 		std::vector<GLuint> m_shaders;
@@ -166,12 +188,87 @@ namespace ed {
 		std::vector<PerformanceTimer> m_perfTimers;
 		unsigned long long m_totalPerfTime;
 		eng::Timer m_lastPerfMeasure;
+		FrameProfiler m_profiler;
+		void m_updatePerfTimers(const FrameProfiler::Frame& frame);
 
 		GLuint m_generalDebugShader;
 
 		void m_updatePassFBO(ed::pipe::ShaderPass* pass);
 
+		// multisampled copies of the render targets - render targets that aren't in use at the same time share them
+		RenderTargetPool m_msTargetPool;
+		std::unordered_map<pipe::ShaderPass*, std::vector<GLuint>> m_msTargets;	 // color attachments + depth & stencil
+		std::unordered_map<pipe::ShaderPass*, std::vector<GLuint>> m_msAttached; // what's currently attached to m_fboMS
+		void m_planMSTargets(int width, int height);
+		void m_attachMSTargets(pipe::ShaderPass* pass);
+
 		std::vector<ItemVariableValue> m_itemValues; // list of all values to apply once we start rendering
+		int m_itemValuesVersion;
+
+		// everything a shader pass needs to draw its items that would otherwise be recalculated on each draw call
+		struct DrawCommand {
+			DrawCommand()
+			{
+				Picked = false;
+				Buffer = nullptr;
+				BufferStride = 0;
+			}
+			bool Picked;
+			std::vector<int> ItemValues; // indices in m_itemValues
+			BufferObject* Buffer; // vertex buffer's buffer & format when the stride was calculated
+			std::string BufferFormat;
+			int BufferStride;
+		};
+		struct DrawList {
+			DrawList()
+			{
+				PickVersion = ItemValuesVersion = -1;
+				ItemValuesSize = 0;
+				BatchProgram = 0;
+				BatchBlock = BatchBinding = GL_INVALID_INDEX;
+			}
+			std::vector<PipelineItem*> Items; // pass' items when the list was built
+			std::vector<DrawCommand> Commands;
+			int PickVersion;
+			int ItemValuesVersion;
+			size_t ItemValuesSize; // m_itemValues can also be modified through GetItemVariableValues()
+			GLuint BatchProgram, BatchBlock, BatchBinding; // geometry batch storage block of the pass' program
+		};
+		std::unordered_map<pipe::ShaderPass*, DrawList> m_drawLists;
+		DrawList& m_getDrawList(pipe::ShaderPass* pass);
+
+		// filters out redundant state changes in Render()
+		GLStateCache m_glState;
+
+		// consecutive geometry items are drawn with a single instanced draw call if the shader declares the
+		// SHADERedGeometryBatch storage block - an array of these (std430), indexed with the instance ID
+		struct GeometryBatchItem {
+			glm::mat4 Transform;
+			GLuint IsPicked;
+			GLuint Padding[3];
+		};
+		GLuint m_batchBuffer;
+		std::vector<GeometryBatchItem> m_batchData;
+		int m_getGeometryBatchLength(pipe::ShaderPass* pass, DrawList& list, int start);
+		void m_bindGeometryBatch(GLuint binding); // uploads m_batchData
+		void m_bindSingleGeometryBatch(PipelineItem* item, bool picked, GLuint binding, int instanceCount);
+
+		// storage buffer & image bindings that a compute pass writes to, reflected from its SPIR-V
+		struct ComputeBindings {
+			ComputeBindings() { Reflected = false; }
+			bool Reflected; // if false, the pass is assumed to write to all of its bound buffers and images
+			std::vector<int> WrittenBuffers;
+			std::vector<int> WrittenImages;
+		};
+		std::unordered_map<pipe::ComputePass*, ComputeBindings> m_computeBindings;
+
+		// objects written by compute passes that weren't made visible to every kind of access yet -> barrier bits issued since the write
+		std::unordered_map<GLuint, GLbitfield> m_unsyncedBuffers;
+		std::unordered_map<GLuint, GLbitfield> m_unsyncedTextures;
+		bool m_unsyncedUnknown; // a plugin object was written to
+		void m_addComputeWrites(pipe::ComputePass* pass, const std::vector<GLuint>& ubos);
+		void m_syncComputeWrites(PipelineItem* item); // issues only the barriers that the item needs
+		void m_syncAllComputeWrites();
 
 		eng::Timer m_cacheTimer;
 		void m_cache();
@@ -0,0 +1,85 @@
+#include <SHADERed/Objects/RenderTargetPool.h>
+
+namespace ed {
+	RenderTargetPool::RenderTargetPool()
+	{
+	}
+	RenderTargetPool::~RenderTargetPool()
+	{
+		Clear();
+	}
+
+	void RenderTargetPool::Begin()
+	{
+		for (auto& tex : m_textures)
+			tex.Acquired = tex.Used = false;
+	}
+	bool RenderTargetPool::End()
+	{
+		bool deleted = false;
+		for (int i = 0; i < m_textures.size(); i++) {
+			if (!m_textures[i].Used) {
+				glDeleteTextures(1, &m_textures[i].ID);
+				m_textures.erase(m_textures.begin() + i);
+				deleted = true;
+				i--;
+			}
+		}
+		return deleted;
+	}
+
+	GLuint RenderTargetPool::Acquire(const glm::ivec2& size, GLenum format, int samples, GLuint owner)
+	{
+		for (auto& tex : m_textures) {
+			if (!tex.Acquired && tex.Owner == owner && tex.Size == size && tex.Format == format && tex.Samples == samples) {
+				tex.Acquired = tex.Used = true;
+				return tex.ID;
+			}
+		}
+
+		bool isDepth = format == GL_DEPTH24_STENCIL8;
+
+		Texture tex;
+		tex.Size = size;
+		tex.Format = format;
+		tex.Samples = samples;
+		tex.Owner = owner;
+		tex.Acquired = tex.Used = true;
+
+		glGenTextures(1, &tex.ID);
+		if (samples > 1) {
+			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, tex.ID);
+			glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, format, size.x, size.y, true);
+			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+		} else {
+			glBindTexture(GL_TEXTURE_2D, tex.ID);
+			if (isDepth)
+				glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+			else
+				glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+
+		m_textures.push_back(tex);
+
+		return tex.ID;
+	}
+	void RenderTargetPool::Release(GLuint tex)
+	{
+		for (auto& t : m_textures) {
+			if (t.ID == tex) {
+				t.Acquired = t.Owner != 0;
+				break;
+			}
+		}
+	}
+
+	void RenderTargetPool::Clear()
+	{
+		for (auto& tex : m_textures)
+			glDeleteTextures(1, &tex.ID);
+		m_textures.clear();
+	}
+}
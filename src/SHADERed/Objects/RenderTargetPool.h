@@ -0,0 +1,50 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	// textures that are only used as intermediate render targets (nothing samples them and their contents don't
+	// have to outlive the passes that render to them). Users whose lifetimes don't overlap get the same texture.
+	// Allocation happens in rounds: Begin() makes every texture available, Acquire()/Release() hand them out
+	// and End() deletes the textures that nobody acquired in that round.
+	class RenderTargetPool {
+	public:
+		RenderTargetPool();
+		~RenderTargetPool();
+
+		void Begin();
+		bool End(); // returns true if any texture was deleted
+
+		// returns an available texture with matching size, format & sample count or creates one. Textures with an
+		// owner are never given to anyone else, so their contents are kept between rounds - for everything else
+		// the same sequence of calls returns the same textures but the contents might be overwritten by other users
+		GLuint Acquire(const glm::ivec2& size, GLenum format, int samples, GLuint owner = 0);
+		void Release(GLuint tex);
+
+		void Clear();
+
+		inline size_t GetTextureCount() { return m_textures.size(); }
+
+	private:
+		struct Texture {
+			GLuint ID;
+			glm::ivec2 Size;
+			GLenum Format;
+			int Samples;
+			GLuint Owner;
+			bool Acquired; // currently in use
+			bool Used;	   // acquired at least once in this round
+		};
+		std::vector<Texture> m_textures;
+	};
+}
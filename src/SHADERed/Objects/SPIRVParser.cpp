@@ -1,5 +1,6 @@
 #include <SHADERed/Objects/SPIRVParser.h>
 #include <spvgentwo/Spv.h>
+#include <algorithm>
 #include <unordered_map>
 #include <functional>
 
@@ -33,6 +34,7 @@ namespace ed {
 		UserTypes.clear();
 		Uniforms.clear();
 		Globals.clear();
+		StorageResources.clear();
 
 		ArithmeticInstCount = 0;
 		BitInstCount = 0;
@@ -53,6 +55,19 @@ namespace ed {
 		std::unordered_map<spv_word, spv_word> pointers;
 		std::unordered_map<spv_word, std::pair<ValueType, int>> types;
 
+		// used to find the storage resources
+		std::unordered_map<spv_word, int> bindings;
+		std::unordered_map<spv_word, int> nonWritableMembers;
+		std::unordered_map<spv_word, int> memberCounts;
+		std::unordered_map<spv_word, spv_word> arrayTypes; // array type -> element type
+		std::unordered_map<spv_word, spv_word> imageSampled; // image type -> sampled operand (2 == storage image)
+		std::vector<spv_word> nonWritable, bufferBlocks;
+		struct GlobalVariable {
+			spv_word ID, Type;
+			spvgentwo::spv::StorageClass Storage;
+		};
+		std::vector<GlobalVariable> globalVariables;
+
 		std::function<void(Variable&, spv_word)> fetchType = [&](Variable& var, spv_word type) {
 			spv_word actualType = type;
 			if (pointers.count(type))
@@ -90,10 +105,39 @@ namespace ed {
 				if (!curFunc.empty() && Functions[curFunc].LineStart == -1)
 					Functions[curFunc].LineStart = lastOpLine;
 			} break;
+			case spvgentwo::spv::Op::OpDecorate: {
+				spv_word target = ir[++i];
+				spvgentwo::spv::Decoration decoration = (spvgentwo::spv::Decoration)ir[++i];
+
+				if (decoration == spvgentwo::spv::Decoration::Binding)
+					bindings[target] = ir[++i];
+				else if (decoration == spvgentwo::spv::Decoration::NonWritable)
+					nonWritable.push_back(target);
+				else if (decoration == spvgentwo::spv::Decoration::BufferBlock)
+					bufferBlocks.push_back(target);
+			} break;
+			case spvgentwo::spv::Op::OpMemberDecorate: {
+				spv_word owner = ir[++i];
+				++i; // skip member index
+				spvgentwo::spv::Decoration decoration = (spvgentwo::spv::Decoration)ir[++i];
+
+				if (decoration == spvgentwo::spv::Decoration::NonWritable)
+					nonWritableMembers[owner]++;
+			} break;
+			case spvgentwo::spv::Op::OpTypeImage: {
+				spv_word loc = ir[++i];
+				imageSampled[loc] = ir[i + 6];
+			} break;
+			case spvgentwo::spv::Op::OpTypeArray:
+			case spvgentwo::spv::Op::OpTypeRuntimeArray: {
+				spv_word loc = ir[++i];
+				arrayTypes[loc] = ir[++i];
+			} break;
 			case spvgentwo::spv::Op::OpTypeStruct: {
 				spv_word loc = ir[++i];
 
 				spv_word memCount = wordCount - 1;
+				memberCounts[loc] = memCount;
 				if (UserTypes.count(names[loc]) == 0) {
 					std::vector<Variable> mems(memCount);
 					for (spv_word j = 0; j < memCount; j++) {
@@ -155,6 +199,7 @@ namespace ed {
 
 				if (curFunc.empty()) {
 					spvgentwo::spv::StorageClass sType = (spvgentwo::spv::StorageClass)ir[++i];
+					globalVariables.push_back({ loc, type, sType });
 					if (sType == spvgentwo::spv::StorageClass::Uniform || sType == spvgentwo::spv::StorageClass::UniformConstant) {
 						Variable uni;
 						uni.Name = varName;
@@ -347,5 +392,35 @@ namespace ed {
 
 			i = iStart + wordCount + 1;
 		}
+
+		auto isNonWritable = [&](spv_word id) -> bool {
+			return std::count(nonWritable.begin(), nonWritable.end(), id) > 0;
+		};
+		auto isBufferBlock = [&](spv_word id) -> bool {
+			return std::count(bufferBlocks.begin(), bufferBlocks.end(), id) > 0;
+		};
+
+		for (const auto& global : globalVariables) {
+			// pointer -> (array ->) block / image type
+			spv_word type = global.Type;
+			if (pointers.count(type))
+				type = pointers[type];
+			while (arrayTypes.count(type))
+				type = arrayTypes[type];
+
+			StorageResource res;
+			res.Binding = bindings.count(global.ID) ? bindings[global.ID] : -1;
+
+			if (global.Storage == spvgentwo::spv::StorageClass::StorageBuffer || (global.Storage == spvgentwo::spv::StorageClass::Uniform && isBufferBlock(type))) {
+				res.IsImage = false;
+				res.ReadOnly = isNonWritable(global.ID) || (memberCounts.count(type) && nonWritableMembers[type] >= memberCounts[type]);
+			} else if (global.Storage == spvgentwo::spv::StorageClass::UniformConstant && imageSampled.count(type) && imageSampled[type] == 2) {
+				res.IsImage = true;
+				res.ReadOnly = isNonWritable(global.ID);
+			} else
+				continue;
+
+			StorageResources.push_back(res);
+		}
 	}
 }
\ No newline at end of file
@@ -40,6 +40,14 @@ namespace ed {
 		std::vector<Variable> Uniforms;
 		std::vector<Variable> Globals;
 
+		// shader storage buffers and storage images
+		struct StorageResource {
+			int Binding; // -1 if not decorated
+			bool IsImage;
+			bool ReadOnly; // declared as readonly / NonWritable
+		};
+		std::vector<StorageResource> StorageResources;
+
 		bool BarrierUsed;
 		int LocalSizeX, LocalSizeY, LocalSizeZ;
 
@@ -86,6 +86,9 @@ namespace ed {
 		Preview.LostFocusLimitFPS = false;
 		Preview.MSAA = 1;
 		Preview.EnableCubemapSeamleass = true;
+		Preview.OptimizeModels = false;
+		Preview.CompactModelVertices = false;
+		Preview.GenerateModelLODs = false;
 	}
 	void Settings::Load()
 	{
@@ -175,6 +178,9 @@ namespace ed {
 		Preview.LostFocusLimitFPS = ini.GetBoolean("preview", "fpslimitlostfocus", false);
 		Preview.MSAA = ini.GetInteger("preview", "msaa", 1);
 		Preview.EnableCubemapSeamleass = ini.GetBoolean("preview", "enablecubemapseamless", true); 
+		Preview.OptimizeModels = ini.GetBoolean("preview", "optimizemodels", false);
+		Preview.CompactModelVertices = ini.GetBoolean("preview", "compactmodelvertices", false);
+		Preview.GenerateModelLODs = ini.GetBoolean("preview", "generatemodellods", false);
 
 		m_parseExt(ini.Get("plugins", "notloaded", ""), Plugins.NotLoaded);
 
@@ -268,6 +274,9 @@ namespace ed {
 		ini << "fpslimitlostfocus=" << Preview.LostFocusLimitFPS << std::endl;
 		ini << "msaa=" << Preview.MSAA << std::endl;
 		ini << "enablecubemapseamless=" << Preview.EnableCubemapSeamleass << std::endl;
+		ini << "optimizemodels=" << Preview.OptimizeModels << std::endl;
+		ini << "compactmodelvertices=" << Preview.CompactModelVertices << std::endl;
+		ini << "generatemodellods=" << Preview.GenerateModelLODs << std::endl;
 
 		ini << "[editor]" << std::endl;
 		ini << "smartpred=" << Editor.SmartPredictions << std::endl;
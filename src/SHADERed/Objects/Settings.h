@@ -100,11 +100,15 @@ namespace ed {
 			bool LostFocusLimitFPS;	 // limit to 30FPS when app loses focus
 			int MSAA;				 // 1 (off), 2, 4, 8
 			bool EnableCubemapSeamleass; //glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+			bool OptimizeModels;		 // reorder the triangles & vertices of the imported 3D models
+			bool CompactModelVertices;	 // store the 3D models' vertices with half floats and packed normals in the VBOs
+			bool GenerateModelLODs;		 // simplified versions of the 3D models that are drawn when they're small on the screen
 		} Preview;
 
 		struct strProject {
 			bool FPCamera;
 			bool UseAlphaChannel;
+			bool HalfPrecisionWindow; // 16-bit float preview window texture instead of a 32-bit one
 			glm::vec4 ClearColor;
 			std::vector<std::string> IncludePaths;
 		} Project;
@@ -0,0 +1,186 @@
+#include <SHADERed/Objects/ShaderCache.h>
+#include <SHADERed/Objects/Settings.h>
+
+#include <fstream>
+#include <string.h>
+
+#define SHADER_CACHE_MAGIC 0x43444553 // "SEDC"
+#define SHADER_CACHE_FORMAT 2
+
+namespace ed {
+	ShaderCache::ShaderCache()
+			: m_cache(Settings::Instance().ConvertPath(SHADER_CACHE_DIRECTORY), "shader", SHADER_CACHE_MAX_SIZE)
+	{
+	}
+
+	uint64_t ShaderCache::HashData(const void* data, size_t length, uint64_t seed)
+	{
+		// FNV-1a
+		const uint8_t* bytes = (const uint8_t*)data;
+		uint64_t ret = seed;
+		for (size_t i = 0; i < length; i++) {
+			ret ^= bytes[i];
+			ret *= 1099511628211ULL;
+		}
+		return ret;
+	}
+	uint64_t ShaderCache::GetSPIRVKey(const std::string& source, const std::string& preamble, const std::string& entry, int stage, int language, const std::string& path, const std::vector<std::string>& includeDirs)
+	{
+		uint64_t key = Hash(source);
+		key = Hash(preamble, key);
+		key = Hash(entry, key);
+		key = Hash(stage, key);
+		key = Hash(language, key);
+		key = Hash(path, key);
+		for (const std::string& dir : includeDirs)
+			key = Hash(dir, key);
+		return key;
+	}
+
+	bool ShaderCache::LoadSPIRV(uint64_t key, std::vector<unsigned int>& spv, std::string& log)
+	{
+		std::vector<char> data;
+		if (!m_read(m_cache.GetFilename(key, "spv"), data))
+			return false;
+
+		size_t ptr = 0;
+		auto readU32 = [&](uint32_t& out) -> bool {
+			if (ptr + sizeof(uint32_t) > data.size())
+				return false;
+			memcpy(&out, data.data() + ptr, sizeof(uint32_t));
+			ptr += sizeof(uint32_t);
+			return true;
+		};
+
+		uint32_t magic = 0, format = 0, includeCount = 0, wordCount = 0;
+		if (!readU32(magic) || !readU32(format) || magic != SHADER_CACHE_MAGIC || format != SHADER_CACHE_FORMAT)
+			return false;
+
+		// check if any of the #include-d files changed
+		if (!readU32(includeCount))
+			return false;
+		for (uint32_t i = 0; i < includeCount; i++) {
+			uint32_t pathLength = 0;
+			uint64_t hash = 0;
+			if (!readU32(pathLength) || ptr + pathLength + sizeof(uint64_t) > data.size())
+				return false;
+
+			std::string path(data.data() + ptr, pathLength);
+			ptr += pathLength;
+			memcpy(&hash, data.data() + ptr, sizeof(uint64_t));
+			ptr += sizeof(uint64_t);
+
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+				return false;
+			std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			if (Hash(content) != hash)
+				return false;
+		}
+
+		uint32_t logLength = 0;
+		if (!readU32(logLength) || ptr + logLength > data.size())
+			return false;
+		log = std::string(data.data() + ptr, logLength);
+		ptr += logLength;
+
+		if (!readU32(wordCount) || ptr + wordCount * sizeof(unsigned int) != data.size())
+			return false;
+
+		spv.resize(wordCount);
+		memcpy(spv.data(), data.data() + ptr, wordCount * sizeof(unsigned int));
+
+		return true;
+	}
+	void ShaderCache::SaveSPIRV(uint64_t key, const std::vector<unsigned int>& spv, const std::vector<std::pair<std::string, std::string>>& includes, const std::string& log)
+	{
+		if (!m_cache.IsEnabled() || spv.empty())
+			return;
+
+		std::vector<char> data;
+		auto write = [&](const void* src, size_t size) {
+			data.insert(data.end(), (const char*)src, (const char*)src + size);
+		};
+		auto writeU32 = [&](uint32_t val) {
+			write(&val, sizeof(uint32_t));
+		};
+
+		writeU32(SHADER_CACHE_MAGIC);
+		writeU32(SHADER_CACHE_FORMAT);
+
+		writeU32(includes.size());
+		for (const auto& inc : includes) {
+			uint64_t hash = Hash(inc.second);
+			writeU32(inc.first.size());
+			write(inc.first.data(), inc.first.size());
+			write(&hash, sizeof(uint64_t));
+		}
+
+		writeU32(log.size());
+		write(log.data(), log.size());
+
+		writeU32(spv.size());
+		write(spv.data(), spv.size() * sizeof(unsigned int));
+
+		m_write(m_cache.GetFilename(key, "spv"), data);
+	}
+
+	bool ShaderCache::LoadGLSL(uint64_t key, std::string& glsl)
+	{
+		std::vector<char> data;
+		if (!m_read(m_cache.GetFilename(key, "glsl"), data))
+			return false;
+
+		uint32_t header[3] = { 0 };
+		if (data.size() < sizeof(header))
+			return false;
+		memcpy(header, data.data(), sizeof(header));
+		if (header[0] != SHADER_CACHE_MAGIC || header[1] != SHADER_CACHE_FORMAT || header[2] != data.size() - sizeof(header))
+			return false;
+
+		glsl = std::string(data.data() + sizeof(header), header[2]);
+
+		return true;
+	}
+	void ShaderCache::SaveGLSL(uint64_t key, const std::string& glsl)
+	{
+		if (!m_cache.IsEnabled() || glsl.empty())
+			return;
+
+		uint32_t header[3] = { SHADER_CACHE_MAGIC, SHADER_CACHE_FORMAT, (uint32_t)glsl.size() };
+
+		std::vector<char> data(sizeof(header) + glsl.size());
+		memcpy(data.data(), header, sizeof(header));
+		memcpy(data.data() + sizeof(header), glsl.data(), glsl.size());
+
+		m_write(m_cache.GetFilename(key, "glsl"), data);
+	}
+
+	bool ShaderCache::m_read(const std::string& filename, std::vector<char>& data)
+	{
+		if (!m_cache.IsEnabled())
+			return false;
+
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		size_t size = file.tellg();
+		file.seekg(0, std::ios::beg);
+		data.resize(size);
+		if (!file.read(data.data(), size))
+			return false;
+		file.close();
+
+		m_cache.Touch(filename);
+
+		return true;
+	}
+	void ShaderCache::m_write(const std::string& filename, const std::vector<char>& data)
+	{
+		// multiple compiler threads (or instances of SHADERed) might be writing the same entry
+		m_cache.Write(filename, [&](std::ofstream& file) {
+			file.write(data.data(), data.size());
+		});
+	}
+}
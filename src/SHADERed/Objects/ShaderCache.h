@@ -0,0 +1,47 @@
+#pragma once
+#include <SHADERed/Objects/DiskCache.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+#define SHADER_CACHE_DIRECTORY "cache/shaders/"
+#define SHADER_CACHE_MAX_SIZE (128 * 1024 * 1024)
+
+namespace ed {
+	// persistent cache for the ShaderCompiler output (SPIR-V and the transcompiled GLSL) - each entry
+	// is a file named after the hash of everything that affects the output so nothing ever has
+	// to be invalidated, old entries are just deleted once the cache grows too large
+	class ShaderCache {
+	public:
+		ShaderCache();
+
+		static inline ShaderCache& Instance()
+		{
+			static ShaderCache ret;
+			return ret;
+		}
+
+		static uint64_t HashData(const void* data, size_t length, uint64_t seed = 14695981039346656037ULL);
+		static inline uint64_t Hash(const std::string& str, uint64_t seed = 14695981039346656037ULL) { return HashData(str.data(), str.size(), Hash(str.size(), seed)); }
+		template <typename T>
+		static inline uint64_t Hash(const T& val, uint64_t seed) { return HashData(&val, sizeof(T), seed); }
+
+		// everything that affects the SPIR-V output - path is the shader's full path since it ends up in the debug info
+		static uint64_t GetSPIRVKey(const std::string& source, const std::string& preamble, const std::string& entry, int stage, int language, const std::string& path, const std::vector<std::string>& includeDirs);
+
+		// includes = (path, content) of every file that was #include-d while compiling - the entry is only
+		// used if none of them changed; log = glslang's info log (warnings)
+		bool LoadSPIRV(uint64_t key, std::vector<unsigned int>& spv, std::string& log);
+		void SaveSPIRV(uint64_t key, const std::vector<unsigned int>& spv, const std::vector<std::pair<std::string, std::string>>& includes, const std::string& log);
+
+		bool LoadGLSL(uint64_t key, std::string& glsl);
+		void SaveGLSL(uint64_t key, const std::string& glsl);
+
+	private:
+		DiskCache m_cache;
+
+		bool m_read(const std::string& filename, std::vector<char>& data);
+		void m_write(const std::string& filename, const std::vector<char>& data);
+	};
+}
@@ -0,0 +1,120 @@
+#include <SHADERed/Objects/ShaderCompileService.h>
+#include <SHADERed/Objects/ShaderCompiler.h>
+#include <SHADERed/Options.h>
+
+#include <algorithm>
+
+namespace ed {
+	ShaderCompileService::ShaderCompileService(ProjectParser* project, int threadCount)
+			: JobQueue("shader compiler", threadCount, 4, true, [this](ShaderCompileJob* job) { Process(job); })
+	{
+		m_project = project;
+	}
+	ShaderCompileService::~ShaderCompileService()
+	{
+		// Process() uses the project
+		m_stopThreads();
+	}
+
+	void ShaderCompileService::Process(ShaderCompileJob* job)
+	{
+		job->Messages.CurrentItem = job->Name;
+
+		for (ShaderCompileStage& stage : job->Stages) {
+			if (stage.Processed)
+				continue;
+
+			std::string source = stage.HasSource ? stage.Source : m_project->LoadProjectFile(stage.Path);
+
+			// SPIR-V
+			stage.Compiled = ShaderCompiler::CompileSourceToSPIRV(stage.SPV, stage.Language, stage.Path, source, stage.Stage, stage.Entry, job->Macros, &job->Messages, m_project);
+
+			// GLSL
+			if (stage.Language == ShaderLanguage::GLSL) {
+				int lineBias = 0;
+				stage.GLSL = source;
+				m_includeCheck(stage.GLSL, job->IncludePaths, std::vector<std::string>(), lineBias, &job->Messages);
+				ApplyMacros(stage.GLSL, job->Macros);
+			} else if (stage.Compiled) // HLSL / VK
+				stage.GLSL = ShaderCompiler::ConvertToGLSL(stage.SPV, stage.Language, stage.Stage, job->TSUsed, job->GSUsed, &job->Messages);
+
+			stage.Processed = true;
+		}
+	}
+
+	void ShaderCompileService::ApplyMacros(std::string& src, const std::vector<ShaderMacro>& macros)
+	{
+		size_t verLoc = src.find_first_of("#version");
+		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
+		std::string strMacro = "";
+
+#ifdef SHADERED_WEB
+		strMacro += "#define SHADERED_WEB\n";
+#else
+		strMacro += "#define SHADERED_DESKTOP\n";
+#endif
+		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
+
+		for (auto& macro : macros) {
+			if (!macro.Active)
+				continue;
+
+			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
+		}
+
+		if (strMacro.size() > 0)
+			src.insert(lineLoc, strMacro);
+	}
+	void ShaderCompileService::m_includeCheck(std::string& src, const std::vector<std::string>& includePaths, std::vector<std::string> includeStack, int& lineBias, MessageStack* msgs)
+	{
+		size_t incLoc = src.find("#include");
+
+		std::vector<std::string> paths = includePaths;
+		paths.push_back(".");
+
+		while (incLoc != std::string::npos) {
+			bool isAfterNewline = true;
+			if (incLoc != 0)
+				if (src[incLoc - 1] != '\n')
+					isAfterNewline = false;
+
+			if (!isAfterNewline) {
+				incLoc = src.find("#include", incLoc + 1);
+				continue;
+			}
+
+			size_t quotePos = src.find_first_of("\"<", incLoc);
+			size_t quoteEnd = src.find_first_of("\">", quotePos + 1);
+			std::string fileName = src.substr(quotePos + 1, quoteEnd - quotePos - 1);
+
+			for (int i = 0; i < paths.size(); i++) {
+				std::string ipath = paths[i];
+				char last = ipath[ipath.size() - 1];
+				if (last != '\\' && last != '/')
+					ipath += "/";
+
+				ipath += fileName;
+
+				src.erase(incLoc, src.find_first_of('\n', incLoc) - incLoc);
+
+				if (std::count(includeStack.begin(), includeStack.end(), ipath) > 0)
+					msgs->Add(ed::MessageStack::Type::Error, msgs->CurrentItem, "Recursive #include detected");
+
+				if (m_project->FileExists(ipath) && std::count(includeStack.begin(), includeStack.end(), ipath) == 0) {
+					includeStack.push_back(ipath);
+
+					std::string incFileSrc = m_project->LoadProjectFile(ipath);
+					lineBias = std::count(incFileSrc.begin(), incFileSrc.end(), '\n');
+
+					m_includeCheck(incFileSrc, includePaths, includeStack, lineBias, msgs);
+
+					src.insert(incLoc, incFileSrc);
+
+					break;
+				}
+			}
+
+			incLoc = src.find("#include", incLoc + 1);
+		}
+	}
+}
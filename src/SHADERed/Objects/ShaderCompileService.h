@@ -0,0 +1,84 @@
+#pragma once
+#include <SHADERed/Objects/JobQueue.h>
+#include <SHADERed/Objects/MessageStack.h>
+#include <SHADERed/Objects/ProjectParser.h>
+#include <SHADERed/Objects/ShaderLanguage.h>
+#include <SHADERed/Objects/ShaderStage.h>
+#include <SHADERed/Objects/ShaderMacro.h>
+
+#include <string>
+#include <vector>
+
+namespace ed {
+	struct PipelineItem;
+
+	// a single shader stage: source -> SPIR-V -> GLSL (the GL shader object is created by the RenderEngine)
+	struct ShaderCompileStage {
+		ShaderCompileStage()
+		{
+			Stage = ShaderStage::Vertex;
+			Language = ShaderLanguage::GLSL;
+			HasSource = false;
+			Processed = false;
+			Compiled = false;
+		}
+
+		ShaderStage Stage;
+		ShaderLanguage Language;
+		std::string Path, Entry;
+		std::string Source; // used instead of the file's content if HasSource == true
+		bool HasSource;
+
+		// output
+		bool Processed; // stages that are already processed are skipped (plugin languages are compiled on the GL thread)
+		bool Compiled;
+		std::vector<unsigned int> SPV;
+		std::string GLSL;
+	};
+
+	struct ShaderCompileJob {
+		ShaderCompileJob()
+		{
+			Item = nullptr;
+			ID = 0;
+			TSUsed = GSUsed = false;
+			Partial = false;
+			UserRequested = false;
+			Status = JobStatus::Queued;
+		}
+
+		PipelineItem* Item; // never accessed on the worker threads
+		uint64_t ID;
+		std::string Name; // message group
+
+		bool TSUsed, GSUsed;
+		bool Partial;		// only recompile the stages in the Stages list, keep the other ones
+		bool UserRequested; // Recompile*() rather than the initial caching of the item
+		std::vector<ShaderMacro> Macros;
+		std::vector<std::string> IncludePaths;
+		std::vector<ShaderCompileStage> Stages;
+
+		MessageStack Messages; // merged into the main message stack once the job is applied
+
+		JobStatus Status;
+	};
+
+	// runs the CPU side of the shader compilation (glslang, SPIRV-Cross, #include's and macros) on worker
+	// threads so that the UI thread only has to create the GL shader objects and link the program - finished
+	// jobs are returned in the order they were submitted
+	class ShaderCompileService : public JobQueue<ShaderCompileJob> {
+	public:
+		ShaderCompileService(ProjectParser* project, int threadCount = 0);
+		~ShaderCompileService();
+
+		// process the job on the calling thread
+		void Process(ShaderCompileJob* job);
+
+		static void ApplyMacros(std::string& src, const std::vector<ShaderMacro>& macros);
+
+	private:
+		ProjectParser* m_project;
+
+		void m_includeCheck(std::string& src, const std::vector<std::string>& paths, std::vector<std::string> includeStack, int& lineBias, MessageStack* msgs);
+	};
+}
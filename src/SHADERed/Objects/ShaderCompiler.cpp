@@ -9,6 +9,7 @@
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/BinaryVectorReader.h>
 
 #include <glslang/SPIRV/GlslangToSpv.h>
@@ -140,14 +141,26 @@ namespace ed {
 		if (spvIn.empty())
 			return "";
 
+		int ver = 330;
+		if (GLEW_ARB_shader_storage_buffer_object)
+			ver = 430;
+
+		// cache
+		uint64_t cacheKey = ShaderCache::HashData(spvIn.data(), spvIn.size() * sizeof(unsigned int));
+		cacheKey = ShaderCache::Hash(inLang, cacheKey);
+		cacheKey = ShaderCache::Hash(sType, cacheKey);
+		cacheKey = ShaderCache::Hash(ver, cacheKey);
+		cacheKey = ShaderCache::Hash((tsUsed ? 1 : 0) | (gsUsed ? 2 : 0) | (convertNames ? 4 : 0), cacheKey);
+
+		std::string cachedSource;
+		if (ShaderCache::Instance().LoadGLSL(cacheKey, cachedSource))
+			return cachedSource;
+
 		// Read SPIR-V
 		spirv_cross::CompilerGLSL glsl(std::move(spvIn));
 
 		// Set options
 		spirv_cross::CompilerGLSL::Options options;
-		int ver = 330;
-		if (GLEW_ARB_shader_storage_buffer_object)
-			ver = 430;
 		options.version = (sType == ShaderStage::Compute) ? 430 : ver;
 		glsl.set_common_options(options);
 
@@ -349,6 +362,8 @@ namespace ed {
 			}
 		}
 
+		ShaderCache::Instance().SaveGLSL(cacheKey, source);
+
 		return source;
 	}
 	std::string ShaderCompiler::ConvertToHLSL(const std::vector<unsigned int>& spvIn, ShaderStage sType)
@@ -495,6 +510,22 @@ namespace ed {
 			for (auto& str : Settings::Instance().Project.IncludePaths)
 				includer.pushExternalLocalDirectory(project->GetProjectPath(str));
 
+		// the output only depends on the source, the preamble (macros), the entry point, the stage, the
+		// language, the file path, the include directories and the content of the included files (checked by the ShaderCache)
+		std::vector<std::string> includeDirs;
+		if (project != nullptr)
+			for (auto& str : Settings::Instance().Project.IncludePaths)
+				includeDirs.push_back(project->GetProjectPath(str));
+		uint64_t cacheKey = ShaderCache::GetSPIRVKey(source, preambleStr, entry, (int)sType, (int)inLang, project != nullptr ? project->GetProjectPath(filename) : filename, includeDirs);
+
+		std::string cachedLog;
+		if (ShaderCache::Instance().LoadSPIRV(cacheKey, spvOut, cachedLog)) {
+			// warnings of the compilation that created the entry
+			if (msgs != nullptr)
+				msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, cachedLog));
+			return true;
+		}
+
 		std::string processedShader;
 
 		if (!shader.preprocess(&res, defVersion, ENoProfile, false, false, messages, &processedShader, includer)) {
@@ -549,6 +580,13 @@ namespace ed {
 		spvOptions.validate = true;
 
 		glslang::GlslangToSpv(*prog.getIntermediate(shaderType), spvOut, &logger, &spvOptions);
+
+		// only warnings are left in the info logs
+		std::string infoLog = std::string(shader.getInfoLog()) + prog.getInfoLog();
+		if (msgs != nullptr)
+			msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, infoLog));
+
+		ShaderCache::Instance().SaveSPIRV(cacheKey, spvOut, includer.IncludedFiles, infoLog);
 	
 		return true;
 	}
@@ -93,6 +93,9 @@ namespace ed {
 
 		ProjectParser* ProjectHandle;
 
+		// (path, content) of all the files that were included - used by the ShaderCache
+		std::vector<std::pair<std::string, std::string>> IncludedFiles;
+
 	protected:
 		typedef char tUserDataElement;
 		std::vector<std::string> directoryStack;
@@ -115,10 +118,14 @@ namespace ed {
 			for (auto it = directoryStack.rbegin(); it != directoryStack.rend(); ++it) {
 				std::string path = *it + '/' + headerName;
 				std::replace(path.begin(), path.end(), '\\', '/');
-				std::ifstream file(ProjectHandle->GetProjectPath(path), std::ios_base::binary | std::ios_base::ate);
+				std::string actualPath = ProjectHandle->GetProjectPath(path);
+				std::ifstream file(actualPath, std::ios_base::binary | std::ios_base::ate);
 				if (file) {
 					directoryStack.push_back(getDirectory(path));
-					return newIncludeResult(path, file, (int)file.tellg());
+
+					IncludeResult* ret = newIncludeResult(path, file, (int)file.tellg());
+					IncludedFiles.push_back(std::make_pair(actualPath, std::string(ret->headerData, ret->headerLength)));
+					return ret;
 				}
 			}
 
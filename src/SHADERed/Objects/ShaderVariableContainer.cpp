@@ -5,7 +5,10 @@
 #include <regex>
 
 namespace ed {
-	ShaderVariableContainer::ShaderVariableContainer() { }
+	ShaderVariableContainer::ShaderVariableContainer()
+	{
+		m_samplerProgram = 0;
+	}
 	ShaderVariableContainer::~ShaderVariableContainer()
 	{
 		for (int i = 0; i < m_vars.size(); i++) {
@@ -48,6 +51,8 @@ namespace ed {
 		GLuint samplerLoc = 0;
 
 		m_uLocs.clear();
+		m_uniforms.clear();
+		m_samplerProgram = 0;
 
 		glGetProgramiv(pass, GL_ACTIVE_UNIFORMS, &count);
 		for (GLuint i = 0; i < count; i++) {
@@ -65,6 +70,7 @@ namespace ed {
 	void ShaderVariableContainer::UpdateTextureList(const std::string& fragShader)
 	{
 		m_samplers.clear();
+		m_samplerProgram = 0;
 
 		try {
 			std::regex re("[a-z]?sampler.+ .+;");
@@ -87,24 +93,39 @@ namespace ed {
 		if (unit >= m_samplers.size())
 			return;
 
-		glUniform1i(glGetUniformLocation(pass, m_samplers[unit].c_str()), unit);
+		// sampler locations and values only change when the program is relinked
+		if (pass != m_samplerProgram || m_samplerLocs.size() != m_samplers.size()) {
+			m_samplerProgram = pass;
+			m_samplerLocs.resize(m_samplers.size());
+			m_samplerSet.assign(m_samplers.size(), false);
+
+			for (int i = 0; i < m_samplers.size(); i++)
+				m_samplerLocs[i] = glGetUniformLocation(pass, m_samplers[i].c_str());
+		}
+
+		if (!m_samplerSet[unit]) {
+			glUniform1i(m_samplerLocs[unit], unit);
+			m_samplerSet[unit] = true;
+		}
 	}
-	void ShaderVariableContainer::Bind(void* item)
+	void ShaderVariableContainer::Bind(void* item, bool onlyChanged)
 	{
+		if (!m_isUniformListValid())
+			m_buildUniformList();
+
 		for (int i = 0; i < m_vars.size(); i++) {
 			FunctionVariableManager::Instance().AddToList(m_vars[i]);
 
-			if (m_uLocs.count(m_vars[i]->Name) == 0)
+			const UniformInfo& uniform = m_uniforms[i];
+			if (!uniform.Active)
 				continue;
 
-			GLint loc = m_uLocs[m_vars[i]->Name];
+			GLint loc = uniform.Location;
 
 			// update values if needed
 			SystemVariableManager::Instance().Update(m_vars[i], item);
 			FunctionVariableManager::Instance().Update(m_vars[i]);
 
-			// update uniform every time we bind this container
-			// TODO: maybe we shouldn't update variables that havent changed
 			ShaderVariable::ValueType type = m_vars[i]->GetType();
 
 			// check the flags
@@ -121,6 +142,10 @@ namespace ed {
 				}
 			}
 
+			// the program still has the value that was uploaded last time
+			if (!m_values.Update(uniform.Entry, m_vars[i]->Data) && onlyChanged)
+				continue;
+
 			switch (type) {
 			case ShaderVariable::ValueType::Boolean1:
 				glUniform1i(loc, m_vars[i]->AsBoolean());
@@ -163,6 +188,40 @@ namespace ed {
 				break;
 			}
 		}
+
+		// the values were uploaded to some other program
+		if (!onlyChanged)
+			m_values.Invalidate();
+	}
+	bool ShaderVariableContainer::m_isUniformListValid()
+	{
+		if (m_uniforms.size() != m_vars.size())
+			return false;
+
+		for (int i = 0; i < m_vars.size(); i++) {
+			const UniformInfo& uniform = m_uniforms[i];
+			if (uniform.Variable != m_vars[i] || uniform.Type != m_vars[i]->GetType() || strcmp(uniform.Name, m_vars[i]->Name) != 0)
+				return false;
+		}
+
+		return true;
+	}
+	void ShaderVariableContainer::m_buildUniformList()
+	{
+		m_uniforms.resize(m_vars.size());
+		m_values.Clear();
+
+		for (int i = 0; i < m_vars.size(); i++) {
+			UniformInfo& uniform = m_uniforms[i];
+			uniform.Variable = m_vars[i];
+			uniform.Type = m_vars[i]->GetType();
+			memcpy(uniform.Name, m_vars[i]->Name, VARIABLE_NAME_LENGTH);
+
+			auto loc = m_uLocs.find(m_vars[i]->Name);
+			uniform.Active = loc != m_uLocs.end();
+			uniform.Location = uniform.Active ? loc->second : -1;
+			uniform.Entry = m_values.Add(uniform.Type);
+		}
 	}
 	bool ShaderVariableContainer::ContainsVariable(const char* name)
 	{
@@ -1,5 +1,6 @@
 #pragma once
 #include <SHADERed/Objects/ShaderVariable.h>
+#include <SHADERed/Objects/Std140Buffer.h>
 #include <map>
 #include <vector>
 
@@ -27,7 +28,7 @@ namespace ed {
 		void UpdateUniformInfo(GLuint pass);
 		void UpdateTexture(GLuint pass, GLuint unit);
 		void UpdateTextureList(const std::string& fragShader);
-		void Bind(void* item = nullptr);
+		void Bind(void* item = nullptr, bool onlyChanged = true); // onlyChanged == false -> program isn't the one passed to UpdateUniformInfo()
 		inline std::vector<ShaderVariable*>& GetVariables() { return m_vars; }
 		inline const std::vector<std::string>& GetSamplerList() { return m_samplers; }
 
@@ -35,5 +36,23 @@ namespace ed {
 		std::vector<ShaderVariable*> m_vars;
 		std::map<std::string, GLint> m_uLocs;
 		std::vector<std::string> m_samplers;
+
+		// m_vars resolved to uniform locations - rebuilt when a variable is added, removed, renamed or its type changes
+		struct UniformInfo {
+			ShaderVariable* Variable;
+			ShaderVariable::ValueType Type;
+			char Name[VARIABLE_NAME_LENGTH];
+			bool Active;
+			GLint Location;
+			int Entry; // index in m_values
+		};
+		std::vector<UniformInfo> m_uniforms;
+		Std140Buffer m_values; // values that were last uploaded
+		bool m_isUniformListValid();
+		void m_buildUniformList();
+
+		GLuint m_samplerProgram;
+		std::vector<GLint> m_samplerLocs;
+		std::vector<bool> m_samplerSet;
 	};
 }
\ No newline at end of file
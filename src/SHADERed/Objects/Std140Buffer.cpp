@@ -0,0 +1,111 @@
+#include <SHADERed/Objects/Std140Buffer.h>
+
+namespace ed {
+	static int getColumnCount(ShaderVariable::ValueType type)
+	{
+		switch (type) {
+		case ShaderVariable::ValueType::Float2x2: return 2;
+		case ShaderVariable::ValueType::Float3x3: return 3;
+		case ShaderVariable::ValueType::Float4x4: return 4;
+		}
+		return 1;
+	}
+	static int getComponentCount(ShaderVariable::ValueType type)
+	{
+		switch (type) {
+		case ShaderVariable::ValueType::Boolean2:
+		case ShaderVariable::ValueType::Integer2:
+		case ShaderVariable::ValueType::Float2:
+		case ShaderVariable::ValueType::Float2x2:
+			return 2;
+		case ShaderVariable::ValueType::Boolean3:
+		case ShaderVariable::ValueType::Integer3:
+		case ShaderVariable::ValueType::Float3:
+		case ShaderVariable::ValueType::Float3x3:
+			return 3;
+		case ShaderVariable::ValueType::Boolean4:
+		case ShaderVariable::ValueType::Integer4:
+		case ShaderVariable::ValueType::Float4:
+		case ShaderVariable::ValueType::Float4x4:
+			return 4;
+		}
+		return 1;
+	}
+
+	Std140Buffer::Std140Buffer()
+	{
+		m_end = 0;
+	}
+
+	int Std140Buffer::GetAlignment(ShaderVariable::ValueType type)
+	{
+		// matrices are stored as an array of column vectors -> vec4 alignment
+		if (getColumnCount(type) > 1)
+			return 16;
+
+		// scalar = N, vec2 = 2N, vec3 & vec4 = 4N
+		int components = getComponentCount(type);
+		return (components == 1 ? 1 : (components == 2 ? 2 : 4)) * 4;
+	}
+	int Std140Buffer::GetSize(ShaderVariable::ValueType type)
+	{
+		int columns = getColumnCount(type);
+		if (columns > 1)
+			return columns * 16;
+
+		// booleans are 4 bytes too
+		return getComponentCount(type) * 4;
+	}
+
+	void Std140Buffer::Clear()
+	{
+		m_entries.clear();
+		m_data.clear();
+		m_end = 0;
+	}
+	int Std140Buffer::Add(ShaderVariable::ValueType type)
+	{
+		int align = GetAlignment(type);
+
+		Entry entry;
+		entry.Type = type;
+		entry.Offset = (m_end + align - 1) / align * align;
+		entry.Valid = false;
+		m_entries.push_back(entry);
+
+		m_end = entry.Offset + GetSize(type);
+
+		// the size of a uniform block is rounded up to vec4
+		m_data.resize((m_end + 15) / 16 * 16, 0);
+
+		return m_entries.size() - 1;
+	}
+	void Std140Buffer::Invalidate()
+	{
+		for (Entry& entry : m_entries)
+			entry.Valid = false;
+	}
+
+	bool Std140Buffer::Update(int entryIndex, const char* data)
+	{
+		Entry& entry = m_entries[entryIndex];
+		uint8_t* dst = m_data.data() + entry.Offset;
+
+		int columns = getColumnCount(entry.Type);
+		int columnSize = getComponentCount(entry.Type) * 4;
+		int stride = columns > 1 ? 16 : columnSize;
+
+		bool changed = !entry.Valid;
+		for (int c = 0; c < columns; c++) {
+			const char* src = data + c * columnSize;
+			if (changed || memcmp(dst + c * stride, src, columnSize) != 0) {
+				memcpy(dst + c * stride, src, columnSize);
+				changed = true;
+			}
+		}
+
+		entry.Valid = true;
+
+		return changed;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <SHADERed/Objects/ShaderVariable.h>
+#include <vector>
+#include <stdint.h>
+
+namespace ed {
+	// CPU side copy of shader variables packed with the std140 layout rules - it remembers the values that
+	// were last sent to the GPU so that the unchanged ones can be skipped (doesn't make any GL calls)
+	class Std140Buffer {
+	public:
+		Std140Buffer();
+
+		static int GetAlignment(ShaderVariable::ValueType type);
+		static int GetSize(ShaderVariable::ValueType type);
+
+		void Clear();
+		int Add(ShaderVariable::ValueType type); // returns the entry index
+		void Invalidate();						 // next Update() call reports every entry as changed
+
+		// copy the value (in the ShaderVariable::Data format) to the buffer - returns true if it changed
+		bool Update(int entry, const char* data);
+
+		inline int GetEntryCount() const { return m_entries.size(); }
+		inline int GetOffset(int entry) const { return m_entries[entry].Offset; }
+		inline size_t GetSize() const { return m_data.size(); }
+		inline const uint8_t* GetData() const { return m_data.data(); }
+
+	private:
+		struct Entry {
+			ShaderVariable::ValueType Type;
+			int Offset;
+			bool Valid;
+		};
+		std::vector<Entry> m_entries;
+		std::vector<uint8_t> m_data;
+		int m_end;
+	};
+}
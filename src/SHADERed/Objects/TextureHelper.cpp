@@ -26,13 +26,11 @@
 #include <iostream>
 #include <map>
 #include "Logger.h"
+#include "EnvironmentCache.h"
+#include "ObjectManagerItem.h"
 
 namespace ed {
 	namespace TextureHelper {
-		static constexpr int kEnvMapSize = 1024;
-		static constexpr int kIrradianceMapSize = 128;
-		static constexpr int kBRDF_LUT_Size = 256;
-
 		//////////////////////////////////////////////////////////////////////////
 
 		class File {
@@ -446,93 +444,114 @@ namespace ed {
 			EnvironmentTexture et;
 			//Global
 			glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-			// Unfiltered environment cube map (temporary).
-			TextureDesc envTextureUnfiltered = Renderer::createTextureInternal(
-				GL_TEXTURE_CUBE_MAP, kEnvMapSize, kEnvMapSize, cubeFormat, cubeType, cubInternalFormat);
 
-			// Load & convert equirectangular environment map to a cubemap texture.
-			{
-				GLuint equirectToCubeProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/equirect2cube_cs.glsl", GL_COMPUTE_SHADER) });
+			// the bake only depends on the input image and the texture sizes - reuse it if it was done before
+			uint64_t sourceHash = EnvironmentCache::HashFile(file);
+			uint64_t envKey = EnvironmentCache::GetKey(sourceHash, EnvironmentType_Specular);
+			uint64_t irmapKey = EnvironmentCache::GetKey(sourceHash, EnvironmentType_Iradiance);
+			bool isCached = EnvironmentCache::Instance().Load(envKey, et.m_envTexture);
+			if (isCached && !EnvironmentCache::Instance().Load(irmapKey, et.m_irmapTexture)) {
+				et.m_envTexture.Destroy();
+				isCached = false;
+			}
 
-				std::shared_ptr<Image> image = Image::fromFile(file, 3);
-				if (!image) {
-					Logger::Get().Log("Image::fromFile failed for: " + file, true);
-					return et;
-				}
+			if (isCached)
+				Logger::Get().Log("Loaded the baked environment for " + file + " from the cache");
+			else {
+				// Unfiltered environment cube map (temporary).
+				TextureDesc envTextureUnfiltered = Renderer::createTextureInternal(
+					GL_TEXTURE_CUBE_MAP, kEnvMapSize, kEnvMapSize, cubeFormat, cubeType, cubInternalFormat);
 
-				// The input use a specific format
+				// Load & convert equirectangular environment map to a cubemap texture.
+				{
+					GLuint equirectToCubeProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/equirect2cube_cs.glsl", GL_COMPUTE_SHADER) });
 
-				TextureDesc envTextureEquirect = Renderer::createTexture(image, GL_RGB,
-					image->isHDR() ? GL_FLOAT : GL_UNSIGNED_BYTE,
-					GL_RGB16F, 1);
-				et.m_originTexture = envTextureEquirect;
+					std::shared_ptr<Image> image = Image::fromFile(file, 3);
+					if (!image) {
+						Logger::Get().Log("Image::fromFile failed for: " + file, true);
+						return et;
+					}
 
-				glUseProgram(equirectToCubeProgram);
-				glBindTextureUnit(0, envTextureEquirect.id);
-				glBindImageTexture(0, envTextureUnfiltered.id, 0, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
-				glDispatchCompute(envTextureUnfiltered.width / 32, envTextureUnfiltered.height / 32, 6);
+					// The input use a specific format
 
-				//glDeleteTextures(1, &envTextureEquirect.id);
-				glDeleteProgram(equirectToCubeProgram);
-			}
+					TextureDesc envTextureEquirect = Renderer::createTexture(image, GL_RGB,
+						image->isHDR() ? GL_FLOAT : GL_UNSIGNED_BYTE,
+						GL_RGB16F, 1);
+					et.m_originTexture = envTextureEquirect;
 
-			glGenerateTextureMipmap(envTextureUnfiltered.id);
+					glUseProgram(equirectToCubeProgram);
+					glBindTextureUnit(0, envTextureEquirect.id);
+					glBindImageTexture(0, envTextureUnfiltered.id, 0, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
+					glDispatchCompute(envTextureUnfiltered.width / 32, envTextureUnfiltered.height / 32, 6);
 
-			// Compute pre-filtered specular environment map.
-			{
-				GLuint spmapProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/spmap_cs.glsl", GL_COMPUTE_SHADER) });
+					//glDeleteTextures(1, &envTextureEquirect.id);
+					glDeleteProgram(equirectToCubeProgram);
+				}
 
-				et.m_envTexture = Renderer::createTextureInternal(
-					GL_TEXTURE_CUBE_MAP, kEnvMapSize, kEnvMapSize, cubeFormat, cubeType, cubInternalFormat);
+				glGenerateTextureMipmap(envTextureUnfiltered.id);
 
-				// Copy 0th mipmap level into destination environment map.
-				glCopyImageSubData(envTextureUnfiltered.id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
-					et.m_envTexture.id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
-					et.m_envTexture.width, et.m_envTexture.height, 6);
-
-				glUseProgram(spmapProgram);
-				glBindTextureUnit(0, envTextureUnfiltered.id);
-
-				// Pre-filter rest of the mip chain.
-				const float deltaRoughness = 1.0f / glm::max(float(et.m_envTexture.levels - 1), 1.0f);
-				for (int level = 1, size = kEnvMapSize / 2; level <= et.m_envTexture.levels; ++level, size /= 2) {
-					const GLuint numGroups = glm::max(1, size / 32);
-					glBindImageTexture(0, et.m_envTexture.id, level, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
-					glProgramUniform1f(spmapProgram, 0, level * deltaRoughness);
-					glDispatchCompute(numGroups, numGroups, 6);
+				// Compute pre-filtered specular environment map.
+				{
+					GLuint spmapProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/spmap_cs.glsl", GL_COMPUTE_SHADER) });
+
+					et.m_envTexture = Renderer::createTextureInternal(
+						GL_TEXTURE_CUBE_MAP, kEnvMapSize, kEnvMapSize, cubeFormat, cubeType, cubInternalFormat);
+
+					// Copy 0th mipmap level into destination environment map.
+					glCopyImageSubData(envTextureUnfiltered.id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+						et.m_envTexture.id, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+						et.m_envTexture.width, et.m_envTexture.height, 6);
+
+					glUseProgram(spmapProgram);
+					glBindTextureUnit(0, envTextureUnfiltered.id);
+
+					// Pre-filter rest of the mip chain.
+					const float deltaRoughness = 1.0f / glm::max(float(et.m_envTexture.levels - 1), 1.0f);
+					for (int level = 1, size = kEnvMapSize / 2; level <= et.m_envTexture.levels; ++level, size /= 2) {
+						const GLuint numGroups = glm::max(1, size / 32);
+						glBindImageTexture(0, et.m_envTexture.id, level, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
+						glProgramUniform1f(spmapProgram, 0, level * deltaRoughness);
+						glDispatchCompute(numGroups, numGroups, 6);
+					}
+					glDeleteProgram(spmapProgram);
 				}
-				glDeleteProgram(spmapProgram);
-			}
 
-			glDeleteTextures(1, &envTextureUnfiltered.id);
+				glDeleteTextures(1, &envTextureUnfiltered.id);
 
-			// Compute diffuse irradiance cubemap.
-			{
-				GLuint irmapProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/irmap_cs.glsl", GL_COMPUTE_SHADER) });
+				// Compute diffuse irradiance cubemap.
+				{
+					GLuint irmapProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/irmap_cs.glsl", GL_COMPUTE_SHADER) });
+
+					et.m_irmapTexture = Renderer::createTextureInternal(
+						GL_TEXTURE_CUBE_MAP, kIrradianceMapSize, kIrradianceMapSize, cubeFormat, cubeType, cubInternalFormat, 1);
 
-				et.m_irmapTexture = Renderer::createTextureInternal(
-					GL_TEXTURE_CUBE_MAP, kIrradianceMapSize, kIrradianceMapSize, cubeFormat, cubeType, cubInternalFormat, 1);
+					glUseProgram(irmapProgram);
+					glBindTextureUnit(0, et.m_envTexture.id);
+					glBindImageTexture(0, et.m_irmapTexture.id, 0, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
+					glDispatchCompute(et.m_irmapTexture.width / 32, et.m_irmapTexture.height / 32, 6);
+					glDeleteProgram(irmapProgram);
+				}
 
-				glUseProgram(irmapProgram);
-				glBindTextureUnit(0, et.m_envTexture.id);
-				glBindImageTexture(0, et.m_irmapTexture.id, 0, GL_TRUE, 0, GL_WRITE_ONLY, cubInternalFormat);
-				glDispatchCompute(et.m_irmapTexture.width / 32, et.m_irmapTexture.height / 32, 6);
-				glDeleteProgram(irmapProgram);
+				EnvironmentCache::Instance().Save(envKey, et.m_envTexture);
+				EnvironmentCache::Instance().Save(irmapKey, et.m_irmapTexture);
 			}
 
-			// Compute Cook-Torrance BRDF 2D LUT for split-sum approximation.
-			{
+			// Compute Cook-Torrance BRDF 2D LUT for split-sum approximation (same for every scene - only computed once per machine).
+			uint64_t lutKey = EnvironmentCache::GetKey(0, EnvironmentType_BrdfLut);
+			if (!EnvironmentCache::Instance().Load(lutKey, et.m_spBRDF_LUT)) {
 				GLuint spBRDFProgram = Renderer::linkProgram({ Renderer::compileShader("data/shaders/glsl/spbrdf_cs.glsl", GL_COMPUTE_SHADER) });
 
 				et.m_spBRDF_LUT = Renderer::createTextureInternal(GL_TEXTURE_2D, kBRDF_LUT_Size, kBRDF_LUT_Size, GL_RG, GL_FLOAT, GL_RG16F, 1);
-				glTextureParameteri(et.m_spBRDF_LUT.id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTextureParameteri(et.m_spBRDF_LUT.id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 				glUseProgram(spBRDFProgram);
 				glBindImageTexture(0, et.m_spBRDF_LUT.id, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG16F);
 				glDispatchCompute(et.m_spBRDF_LUT.width / 32, et.m_spBRDF_LUT.height / 32, 1);
 				glDeleteProgram(spBRDFProgram);
+
+				EnvironmentCache::Instance().Save(lutKey, et.m_spBRDF_LUT);
 			}
+			glTextureParameteri(et.m_spBRDF_LUT.id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(et.m_spBRDF_LUT.id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 			glFinish();
 
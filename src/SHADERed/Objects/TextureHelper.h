@@ -30,6 +30,9 @@ namespace ed {
 	};
 
 	namespace TextureHelper {
+		static constexpr int kEnvMapSize = 1024;
+		static constexpr int kIrradianceMapSize = 128;
+		static constexpr int kBRDF_LUT_Size = 256;
 
 		struct TextureDesc {
 			GLenum target = GL_TEXTURE_2D;
@@ -0,0 +1,125 @@
+#include <SHADERed/Objects/TextureLoadService.h>
+
+#include <algorithm>
+#include <filesystem>
+
+// private copy of stb_image - the flip flag of the shared one is a global that the UI thread changes at any time,
+// this one is never flipped and the rows are flipped in Process() instead
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <misc/stb_image.h>
+
+extern "C" {
+#include <misc/dds.h>
+}
+
+namespace ed {
+	TextureLoadJob::~TextureLoadJob()
+	{
+		for (TextureLoadImage& img : Images) {
+			if (img.DDS != nullptr)
+				dds_image_free((dds_image_t)img.DDS);
+			else if (img.Data != nullptr && img.Compressed == nullptr)
+				stbi_image_free(img.Data);
+
+			delete img.Compressed;
+		}
+	}
+
+	static void flipRows(unsigned char* data, int width, int height, size_t pixelSize)
+	{
+		size_t rowSize = width * pixelSize;
+		for (int y = 0; y < height / 2; y++)
+			std::swap_ranges(data + y * rowSize, data + (y + 1) * rowSize, data + (height - y - 1) * rowSize);
+	}
+
+	// decoding is mostly CPU bound
+	TextureLoadService::TextureLoadService(int threadCount)
+			: JobQueue("texture loader", threadCount, 8, false, &TextureLoadService::Process)
+	{
+	}
+
+	void TextureLoadService::Process(TextureLoadJob* job)
+	{
+		job->Images.resize(job->Paths.size());
+		job->Succeeded = true;
+
+		for (int i = 0; i < job->Paths.size(); i++) {
+			const std::string& path = job->Paths[i];
+			TextureLoadImage& img = job->Images[i];
+
+			std::string ext = std::filesystem::path(path).extension().u8string();
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+			if (ext == ".dds" || ext == ".ktx" || ext == ".ktx2") {
+				std::string error;
+				img.Compressed = new CompressedImage();
+				if (CompressedTexture::Load(path, *img.Compressed, error)) {
+					img.Width = img.Compressed->Width;
+					img.Height = img.Compressed->Height;
+
+					// cube map faces are always decoded (their mip levels are generated after the upload anyway)
+					bool isCubeMap = job->Paths.size() > 1;
+					if (isCubeMap || !CompressedTexture::IsSupported(img.Compressed->Format, GL_TEXTURE_2D))
+						m_decode(img, isCubeMap ? 1 : img.Compressed->Levels.size());
+				} else {
+					delete img.Compressed;
+					img.Compressed = nullptr;
+
+					if (!error.empty()) {
+						job->Error = "Failed to load a texture " + path + ": " + error;
+						job->Succeeded = false;
+						break;
+					}
+				}
+			}
+
+			if (img.Compressed == nullptr) {
+				if (ext == ".dds") {
+					dds_image_t ddsImage = dds_load_from_file(path.c_str());
+					if (ddsImage != nullptr) {
+						img.DDS = ddsImage;
+						img.Data = ddsImage->pixels;
+						img.Width = ddsImage->header.width;
+						img.Height = ddsImage->header.height;
+					}
+				} else {
+					int nrChannels = 0;
+					if (stbi_is_hdr(path.c_str())) {
+						img.Data = (unsigned char*)stbi_loadf(path.c_str(), &img.Width, &img.Height, &nrChannels, STBI_rgb_alpha);
+						img.IsFloat = true;
+					} else
+						img.Data = stbi_load(path.c_str(), &img.Width, &img.Height, &nrChannels, STBI_rgb_alpha);
+
+					if (job->Flip && img.Data != nullptr)
+						flipRows(img.Data, img.Width, img.Height, 4 * (img.IsFloat ? sizeof(float) : 1));
+				}
+			}
+
+			if ((img.Data == nullptr && img.Compressed == nullptr) || img.Width == 0 || img.Height == 0) {
+				job->Error = "Failed to load a texture " + path + " from file";
+				job->Succeeded = false;
+				break;
+			}
+		}
+	}
+
+	void TextureLoadService::m_decode(TextureLoadImage& img, int levelCount)
+	{
+		const CompressedImage& compressed = *img.Compressed;
+
+		img.IsFloat = CompressedTexture::IsDecodedFloat(compressed.Format);
+		img.Decoded.resize(levelCount);
+		for (int i = 0; i < levelCount; i++) {
+			const CompressedImage::Level& level = compressed.Levels[i];
+			img.Decoded[i].resize((size_t)level.Width * level.Height * level.Depth * 4 * (img.IsFloat ? sizeof(float) : 1));
+			CompressedTexture::Decode(compressed, i, img.Decoded[i].data());
+		}
+		img.Data = img.Decoded[0].data();
+
+		// blocks aren't needed anymore
+		img.Compressed->Data.clear();
+		img.Compressed->Data.shrink_to_fit();
+		img.Compressed->Levels.resize(levelCount);
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <SHADERed/Objects/CompressedTexture.h>
+#include <SHADERed/Objects/JobQueue.h>
+
+namespace ed {
+	class ObjectManagerItem;
+
+	// decoded pixels of a single image (always RGBA, 8 bit or 32 bit float per channel)
+	struct TextureLoadImage {
+		TextureLoadImage()
+		{
+			Data = nullptr;
+			DDS = nullptr;
+			Compressed = nullptr;
+			Width = Height = 0;
+			IsFloat = false;
+		}
+
+		unsigned char* Data;
+		void* DDS; // dds_image_t that owns Data if the image was loaded from a .dds file
+
+		// block compressed .dds/.ktx/.ktx2 file - its levels are uploaded as they are (Data is nullptr), unless the
+		// driver can't sample the format: then every level is decoded to Decoded and Data points to the first one
+		CompressedImage* Compressed;
+		std::vector<std::vector<unsigned char>> Decoded;
+
+		int Width, Height;
+		bool IsFloat;
+	};
+
+	struct TextureLoadJob {
+		TextureLoadJob()
+		{
+			Item = nullptr;
+			ID = 0;
+			Flip = false;
+			CacheKey = 0;
+			Succeeded = false;
+			Status = JobStatus::Queued;
+		}
+		~TextureLoadJob();
+
+		ObjectManagerItem* Item; // never accessed on the worker threads
+		uint64_t ID;
+
+		std::vector<std::string> Paths; // a single path for 2D textures, 6 for cube maps
+		bool Flip;						// flip on load (2D textures, ignored for .dds/.ktx/.ktx2 files)
+		uint64_t CacheKey;				// EnvironmentCache key of a baked IBL cube map, 0 otherwise
+
+		// output
+		bool Succeeded;
+		std::string Error;
+		std::vector<TextureLoadImage> Images; // one for each path
+
+		JobStatus Status;
+	};
+
+	// decodes image files (stb_image, .dds, .ktx and .ktx2) on worker threads - the UI thread only has to upload the
+	// pixels. GetFinishedJobs() returns every job that has finished so far, not necessarily in the order they were submitted.
+	class TextureLoadService : public JobQueue<TextureLoadJob> {
+	public:
+		TextureLoadService(int threadCount = 0);
+
+		// process the job on the calling thread
+		static void Process(TextureLoadJob* job);
+
+	private:
+		// decode the first levelCount levels of img.Compressed on the CPU
+		static void m_decode(TextureLoadImage& img, int levelCount);
+	};
+}
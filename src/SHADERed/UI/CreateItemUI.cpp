@@ -999,6 +999,7 @@ namespace ed {
 				data->Position = origData->Position;
 				data->Rotation = origData->Rotation;
 				data->TheModelImportFlags = origData->TheModelImportFlags;
+				data->LOD = origData->LOD;
 
 				if (strlen(data->Filename) > 0) {
 					eng::Model* mdl = m_data->Parser.LoadModel(data->Filename, data->TheModelImportFlags);
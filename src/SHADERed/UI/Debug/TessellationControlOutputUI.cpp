@@ -44,7 +44,7 @@ namespace ed {
 	DebugTessControlOutputUI::~DebugTessControlOutputUI()
 	{
 		gl::FreeSimpleFramebuffer(m_fbo, m_color, m_depth);
-		glDeleteBuffers(1, &m_triangleVBO);
+		eng::GeometryFactory::Release(m_triangleVBO);
 		glDeleteVertexArrays(1, &m_triangleVAO);
 		glDeleteShader(m_shader);
 	}
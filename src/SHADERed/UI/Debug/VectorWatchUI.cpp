@@ -84,7 +84,7 @@ namespace ed {
 
 	DebugVectorWatchUI::~DebugVectorWatchUI()
 	{
-		glDeleteBuffers(1, &m_unitSphereVBO);
+		eng::GeometryFactory::Release(m_unitSphereVBO);
 		glDeleteVertexArrays(1, &m_unitSphereVAO);
 		glDeleteBuffers(1, &m_gridVBO);
 		glDeleteVertexArrays(1, &m_gridVAO);
@@ -67,6 +67,9 @@ namespace ed {
 		ImGui::NewLine();
 		ImGui::TextWrapped("%u triangles", m_data->Analysis.GetTriangleCount());
 		ImGui::TextWrapped("%u triangles discarded", m_data->Analysis.GetTrianglesDiscarded());
+		glm::ivec2 outputSize = m_data->Analysis.GetOutputSize();
+		if (m_data->Analysis.GetPixelsAnalyzed() < outputSize.x * outputSize.y)
+			ImGui::TextWrapped("%u pixels analyzed again (the rest is reused from the previous analysis)", m_data->Analysis.GetPixelsAnalyzed());
 		ImGui::NewLine();
 
 		ImGui::TextWrapped("Pixel history");
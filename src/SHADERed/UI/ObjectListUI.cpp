@@ -74,6 +74,8 @@ namespace ed {
 				if (ImGui::IsMouseDoubleClicked(0) && (hasPluginExtendedPreview || !isPluginOwner) && !isImg3D)
 					((ObjectPreviewUI*)m_ui->Get(ViewID::ObjectPreview))->Open(oItem);
 			}
+			if (!oItem->LoadError.empty() && ImGui::IsItemHovered())
+				ImGui::SetTooltip("%s", oItem->LoadError.c_str());
 
 			if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
 				ImGui::SetDragDropPayload("ObjectPayload", &oItem, sizeof(ed::ObjectManagerItem**));
@@ -280,7 +282,7 @@ namespace ed {
 
 									if (mitem->InstanceBuffer == (void*)oItem->Buffer) {
 										for (auto& mesh : mitem->Data->Meshes)
-											gl::CreateVAO(mesh.VAO, mesh.VBO, pdata->InputLayout, mesh.EBO);
+											gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, pdata->InputLayout, mesh.EBO);
 										mitem->InstanceBuffer = nullptr;
 									}
 								} else if (pitem->Type == ed::PipelineItem::ItemType::VertexBuffer) {
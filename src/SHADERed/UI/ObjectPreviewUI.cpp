@@ -234,6 +234,7 @@ namespace ed {
 							memcpy(newData, buf->Data, std::min<int>(oldSize, buf->Size));
 							free(buf->Data);
 							buf->Data = newData;
+							buf->Version++;
 
 							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // resize
@@ -247,6 +248,7 @@ namespace ed {
 
 						if (ImGui::Button("CLEAR##objprev_clearbuf")) {
 							memset(buf->Data, 0, buf->Size);
+							buf->Version++;
 
 							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
@@ -298,9 +300,15 @@ namespace ed {
 						// update buffer data every 350ms
 						ImGui::Text(buf->PreviewPaused ? "Buffer view is paused" : "Buffer view is updated every 350ms");
 						if (!buf->PreviewPaused && m_bufUpdateClock.GetElapsedTime() > 0.350f && buf->Data != nullptr) {
+							// only a changed buffer gets a new version - its geometry (BVH) would be rebuilt every 350ms otherwise
+							m_bufReadback.resize(buf->Size);
 							glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf->ID);
-							glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buf->Size, buf->Data);
+							glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buf->Size, m_bufReadback.data());
 							glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+							if (memcmp(buf->Data, m_bufReadback.data(), buf->Size) != 0) {
+								memcpy(buf->Data, m_bufReadback.data(), buf->Size);
+								buf->Version++;
+							}
 							m_bufUpdateClock.Restart();
 						}
 
@@ -345,6 +353,8 @@ namespace ed {
 
 									int dOffset = j * perRow + curColOffset;
 									if (m_drawBufferElement(j, k, (void*)(((char*)buf->Data) + dOffset), m_cachedBufFormat[i][k])) {
+										buf->Version++;
+
 										glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
 										glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
 										glBindBuffer(GL_UNIFORM_BUFFER, 0);
@@ -33,6 +33,7 @@ namespace ed {
 
 	private:
 		eng::Timer m_bufUpdateClock;
+		std::vector<char> m_bufReadback;
 		bool m_drawBufferElement(int row, int col, void* data, ShaderVariable::ValueType type);
 		std::vector<ObjectManagerItem*> m_items;
 		std::vector<char> m_isOpen; // char since bool is packed
@@ -825,6 +825,21 @@ namespace ed {
 		ImGui::SameLine();
 		ImGui::Checkbox("##optp_enablecubemapseamless", &settings->Preview.EnableCubemapSeamleass);
 
+		/* OPTIMIZE MODELS: */
+		ImGui::Text("Optimize 3D models (changes the vertex order): ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optp_optimizemodels", &settings->Preview.OptimizeModels);
+
+		/* COMPACT MODEL VERTICES: */
+		ImGui::Text("Compact 3D model vertices (half float texcoords, packed normals): ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optp_compactmodelvertices", &settings->Preview.CompactModelVertices);
+
+		/* GENERATE MODEL LODS: */
+		ImGui::Text("Generate LOD levels for 3D models: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optp_generatemodellods", &settings->Preview.GenerateModelLODs);
+
 		/* SWITCH LEFT AND RIGHT: */
 		ImGui::Text("Switch what left and right clicks do: ");
 		ImGui::SameLine();
@@ -1021,6 +1036,14 @@ namespace ed {
 			m_data->Parser.ModifyProject();
 		}
 
+		/* HALF PRECISION WINDOW: */
+		ImGui::Text("Half precision window texture: ");
+		ImGui::SameLine();
+		if (ImGui::Checkbox("##optpr_wndhalf", &settings->Project.HalfPrecisionWindow)) {
+			m_data->Renderer.RequestTextureResize();
+			m_data->Parser.ModifyProject();
+		}
+
 		/* CLEAR COLOR: */
 		ImGui::Text("Preview window clear color: ");
 		ImGui::SameLine();
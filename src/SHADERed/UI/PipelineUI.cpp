@@ -261,10 +261,10 @@ namespace ed {
 						BufferObject* bobj = (BufferObject*)mitem->InstanceBuffer;
 						if (bobj == nullptr) {
 							for (auto& mesh : mitem->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, pass->InputLayout, mesh.EBO);
+								gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, pass->InputLayout, mesh.EBO);
 						} else {
 							for (auto& mesh : mitem->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, pass->InputLayout, mesh.EBO, bobj->ID, m_data->Objects.ParseBufferFormat(bobj->ViewFormat));
+								gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, pass->InputLayout, mesh.EBO, bobj->ID, m_data->Objects.ParseBufferFormat(bobj->ViewFormat));
 						}
 					} else if (pitem->Type == PipelineItem::ItemType::VertexBuffer) {
 						pipe::VertexBuffer* mitem = (pipe::VertexBuffer*)pitem->Data;
@@ -1793,6 +1793,7 @@ namespace ed {
 					newData->Position = origData->Position;
 					newData->Rotation = origData->Rotation;
 					newData->TheModelImportFlags = origData->TheModelImportFlags;
+					newData->LOD = origData->LOD;
 
 					if (strlen(newData->Filename) > 0) {
 						std::string objMem = m_data->Parser.LoadProjectFile(newData->Filename);
@@ -2072,6 +2073,7 @@ namespace ed {
 						newData->Position = origData->Position;
 						newData->Rotation = origData->Rotation;
 						newData->TheModelImportFlags = origData->TheModelImportFlags;
+						newData->LOD = origData->LOD;
 
 						if (strlen(newData->Filename) > 0) {
 							std::string objMem = m_data->Parser.LoadProjectFile(newData->Filename);
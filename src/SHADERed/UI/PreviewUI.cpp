@@ -1623,7 +1623,7 @@ namespace ed {
 		}
 		m_data->Analysis.SetBreakpoints(bkpts, bkptColors, bkptPaths);
 
-		// initialize buffers
+		// initialize buffers (results of the previous analysis are reused if possible)
 		glm::vec4 clearColor = Settings::Instance().Project.ClearColor;
 		clearColor.a = Settings::Instance().Project.UseAlphaChannel ? clearColor.a : 1.0f;
 		m_data->Analysis.Init(m_imgSize.x, m_imgSize.y, clearColor);
@@ -1662,11 +1662,11 @@ namespace ed {
 			}
 		}
 
-		// render the pass
-		if (passStartPos != -1 && passEndPos != -1) {
-			for (int i = passStartPos; i <= passEndPos; i++)
-				m_data->Analysis.RenderPass(passes[i]);
-		}
+		// render the passes
+		std::vector<PipelineItem*> analyzedPasses;
+		if (passStartPos != -1 && passEndPos != -1)
+			analyzedPasses.insert(analyzedPasses.end(), passes.begin() + passStartPos, passes.begin() + passEndPos + 1);
+		m_data->Analysis.Analyze(analyzedPasses);
 
 		// build a histogram and other stuff
 		((FrameAnalysisUI*)m_ui->Get(ViewID::FrameAnalysis))->Process();
@@ -1,5 +1,6 @@
 #include <SHADERed/UI/ProfilerUI.h>
 #include <SHADERed/Objects/Settings.h>
+#include <misc/ImFileDialog.h>
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <imgui/imgui_internal.h>
@@ -28,6 +29,93 @@ namespace ed {
 			timeOffset += timer.LastTime;
 			index++;
 		}
+
+		const float rowHeight = Settings::Instance().General.FontSize + 2 * PROFILER_PADDING;
+		m_renderTimeline(ImGui::GetWindowContentRegionMin().y + rowHeight * index + PROFILER_PADDING * 2);
+		m_renderStatistics();
+
+		// export
+		if (ifd::FileDialog::Instance().IsDone("SaveProfilerTraceDlg")) {
+			if (ifd::FileDialog::Instance().HasResult())
+				m_data->Renderer.GetProfiler().ExportTrace(ifd::FileDialog::Instance().GetResult().u8string());
+			ifd::FileDialog::Instance().Close();
+		}
+	}
+	void ProfilerUI::m_renderTimeline(float posY)
+	{
+		FrameProfiler& profiler = m_data->Renderer.GetProfiler();
+		const std::deque<FrameProfiler::Frame>& history = profiler.GetHistory();
+
+		// frame times - intermittent hitches show up as spikes
+		if (m_frameTimesVersion != profiler.GetVersion()) {
+			m_frameTimesVersion = profiler.GetVersion();
+			m_cpuFrameTimes.resize(history.size());
+			m_gpuFrameTimes.resize(history.size());
+			for (int i = 0; i < history.size(); i++) {
+				m_cpuFrameTimes[i] = (history[i].CPUEnd - history[i].CPUStart) / 1000000.0f;
+				m_gpuFrameTimes[i] = (history[i].GPUEnd - history[i].GPUStart) / 1000000.0f;
+			}
+		}
+
+		ImGui::SetCursorPos(ImVec2(PROFILER_PADDING, posY));
+		ImGui::Text("Last %d frames", (int)history.size());
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+			ifd::FileDialog::Instance().Save("SaveProfilerTraceDlg", "Save Chrome trace", "Chrome trace (*.json){.json},.*");
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			profiler.Clear();
+
+		if (m_cpuFrameTimes.empty())
+			return;
+
+		const float plotWidth = ImGui::GetContentRegionAvailWidth() / 2 - PROFILER_PADDING;
+		ImGui::PlotLines("##prof_cpu", m_cpuFrameTimes.data(), m_cpuFrameTimes.size(), 0, "CPU (ms)", 0.0f, FLT_MAX, ImVec2(plotWidth, 60.0f));
+		ImGui::SameLine();
+		ImGui::PlotLines("##prof_gpu", m_gpuFrameTimes.data(), m_gpuFrameTimes.size(), 0, "GPU (ms)", 0.0f, FLT_MAX, ImVec2(plotWidth, 60.0f));
+	}
+	void ProfilerUI::m_renderStatistics()
+	{
+		const std::vector<FrameProfiler::Statistics>& stats = m_data->Renderer.GetProfiler().GetStatistics();
+		if (stats.empty())
+			return;
+
+		if (ImGui::BeginTable("##prof_stats", 7, ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollFreezeTopRow | ImGuiTableFlags_ScrollY)) {
+			ImGui::TableSetupColumn("Item", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("CPU min", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableSetupColumn("CPU avg", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableSetupColumn("CPU p99", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableSetupColumn("GPU min", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableSetupColumn("GPU avg", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableSetupColumn("GPU p99", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+			ImGui::TableAutoHeaders();
+
+			uint64_t times[6];
+			for (const auto& stat : stats) {
+				ImGui::TableNextRow();
+
+				// draw calls are listed under their shader pass
+				ImGui::TableSetColumnIndex(0);
+				if (!stat.Parent.empty())
+					ImGui::Indent();
+				ImGui::TextUnformatted(stat.Name.c_str());
+				if (!stat.Parent.empty())
+					ImGui::Unindent();
+
+				times[0] = stat.CPUMin;
+				times[1] = stat.CPUAvg;
+				times[2] = stat.CPUP99;
+				times[3] = stat.GPUMin;
+				times[4] = stat.GPUAvg;
+				times[5] = stat.GPUP99;
+				for (int i = 0; i < 6; i++) {
+					ImGui::TableSetColumnIndex(i + 1);
+					ImGui::Text("%.4f ms", times[i] / 1000000.0f);
+				}
+			}
+
+			ImGui::EndTable();
+		}
 	}
 	void ProfilerUI::m_renderRow(int index, const char* name, uint64_t time, uint64_t timeOffset, uint64_t totalTime)
 	{
@@ -8,6 +8,7 @@ namespace ed {
 		ProfilerUI(GUIManager* ui, ed::InterfaceManager* objects, const std::string& name = "", bool visible = true)
 				: UIView(ui, objects, name, visible)
 		{
+			m_frameTimesVersion = -1;
 		}
 		~ProfilerUI() { }
 
@@ -16,5 +17,10 @@ namespace ed {
 
 	private:
 		void m_renderRow(int index, const char* name, uint64_t time, uint64_t timeOffset, uint64_t totalTime);
+		void m_renderTimeline(float posY);
+		void m_renderStatistics();
+
+		std::vector<float> m_cpuFrameTimes, m_gpuFrameTimes;
+		int m_frameTimesVersion;
 	};
 }
\ No newline at end of file
@@ -964,6 +964,18 @@ namespace ed {
 					ImGui::PopItemWidth();
 					ImGui::NextColumn();
 
+					/* level of detail */
+					ImGui::Text("LOD:");
+					ImGui::NextColumn();
+
+					ImGui::PushItemWidth(-1);
+					int lodCount = item->Data == nullptr ? 1 : item->Data->GetLODCount();
+					if (ImGui::SliderInt("##pui_mdllod", &item->LOD, -1, lodCount - 1, item->LOD < 0 ? "auto" : "%d"))
+						m_data->Parser.ModifyProject();
+					ImGui::PopItemWidth();
+					ImGui::NextColumn();
+					ImGui::Separator();
+
 					/* instanced */
 					ImGui::Text("Instanced:");
 					ImGui::NextColumn();
@@ -999,7 +1011,7 @@ namespace ed {
 							pipe::ShaderPass* ownerData = (pipe::ShaderPass*)(m_data->Pipeline.Get(owner)->Data);
 
 							for (auto& mesh : item->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, ownerData->InputLayout, mesh.EBO);
+								gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, ownerData->InputLayout, mesh.EBO);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -1018,7 +1030,7 @@ namespace ed {
 								pipe::ShaderPass* ownerData = (pipe::ShaderPass*)(m_data->Pipeline.Get(owner)->Data);
 
 								for (auto& mesh : item->Data->Meshes)
-									gl::CreateVAO(mesh.VAO, mesh.VBO, ownerData->InputLayout, mesh.EBO, buf->ID, fmtList);
+									gl::CreateVAO(mesh.VAO, mesh.VBO, mesh.Format, ownerData->InputLayout, mesh.EBO, buf->ID, fmtList);
 
 								m_data->Parser.ModifyProject();
 							}
@@ -1375,7 +1387,7 @@ namespace ed {
 				ImGui::SameLine();
 				if (!IsCubeMap()) {
 					if (ImGui::Button("...##pui_texbtn", ImVec2(-1, 0)))
-						ifd::FileDialog::Instance().Open("PropertyTextureDlg", "Select a texture", "Image file (*.png;*.jpg;*.jpeg;*.bmp;*.tga;*.dds){.png,.jpg,.jpeg,.bmp,.tga,.dds},.*");
+						ifd::FileDialog::Instance().Open("PropertyTextureDlg", "Select a texture", "Image file (*.png;*.jpg;*.jpeg;*.bmp;*.tga;*.dds;*.ktx;*.ktx2){.png,.jpg,.jpeg,.bmp,.tga,.dds,.ktx,.ktx2},.*");
 				} else {
 					ImGui::Text("");
 				}
@@ -1494,7 +1506,7 @@ namespace ed {
 				ImGui::PopItemWidth();
 				ImGui::SameLine();
 				if (ImGui::Button("...##pui_texbtn", ImVec2(-1, 0)))
-					ifd::FileDialog::Instance().Open("PropertyTextureDlg", "Select a texture", "DDS file (*.dds){.dds},.*");
+					ifd::FileDialog::Instance().Open("PropertyTextureDlg", "Select a texture", "DDS & KTX file (*.dds;*.ktx;*.ktx2){.dds,.ktx,.ktx2},.*");
 				ImGui::NextColumn();
 				ImGui::Separator();
 
@@ -70,7 +70,7 @@ namespace ed {
 
 	CubemapPreview::~CubemapPreview()
 	{
-		glDeleteBuffers(1, &m_fsVBO);
+		ed::eng::GeometryFactory::Release(m_fsVBO);
 		glDeleteVertexArrays(1, &m_fsVAO);
 		glDeleteTextures(1, &m_cubeTex);
 		glDeleteTextures(1, &m_cubeDepth);
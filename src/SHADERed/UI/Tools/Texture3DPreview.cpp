@@ -42,7 +42,7 @@ namespace ed {
 
 	Texture3DPreview::~Texture3DPreview()
 	{
-		glDeleteBuffers(1, &m_vbo);
+		ed::eng::GeometryFactory::Release(m_vbo);
 		glDeleteVertexArrays(1, &m_vao);
 		gl::FreeSimpleFramebuffer(m_fbo, m_color, m_depth);
 	}
@@ -65,7 +65,7 @@ namespace ed {
 	{
 		pipe::ApplyRenderStateToGL(defaultState);
 		if (m_w != w || m_h != h) {
-			glDeleteBuffers(1, &m_vbo);
+			ed::eng::GeometryFactory::Release(m_vbo);
 			glDeleteVertexArrays(1, &m_vao);
 			gl::FreeSimpleFramebuffer(m_fbo, m_color, m_depth);
 		
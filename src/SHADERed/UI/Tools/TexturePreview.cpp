@@ -46,7 +46,7 @@ namespace ed {
 
 	TexturePreview::~TexturePreview()
 	{
-		glDeleteBuffers(1, &m_fsVBO);
+		ed::eng::GeometryFactory::Release(m_fsVBO);
 		glDeleteVertexArrays(1, &m_fsVAO);
 		glDeleteTextures(1, &m_backTex);
 		glDeleteTextures(1, &m_backDepth);
@@ -0,0 +1,141 @@
+#include "Test.h"
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Engine/Ray.h>
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace ed;
+
+namespace {
+	// deterministic so that a failure can be reproduced
+	struct Random {
+		uint32_t State = 12345;
+		float Next(float minVal, float maxVal)
+		{
+			State = State * 1664525u + 1013904223u;
+			return minVal + (maxVal - minVal) * ((State >> 8) / 16777216.0f);
+		}
+		glm::vec3 NextVec3(float minVal, float maxVal) { return glm::vec3(Next(minVal, maxVal), Next(minVal, maxVal), Next(minVal, maxVal)); }
+	};
+
+	bool bruteForce(const std::vector<glm::vec3>& verts, const glm::vec3& orig, const glm::vec3& dir, float& distHit)
+	{
+		bool hit = false;
+		for (size_t i = 0; i + 2 < verts.size(); i += 3) {
+			float dist = 0.0f;
+			if (ray::IntersectTriangle(orig, dir, verts[i], verts[i + 1], verts[i + 2], dist) && (!hit || dist < distHit)) {
+				distHit = dist;
+				hit = true;
+			}
+		}
+		return hit;
+	}
+}
+
+TEST(Ray_IntersectTriangle)
+{
+	glm::vec3 v0(-1.0f, -1.0f, 0.0f), v1(1.0f, -1.0f, 0.0f), v2(0.0f, 1.0f, 0.0f);
+	float dist = 0.0f;
+
+	CHECK(ray::IntersectTriangle(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, dist));
+	CHECK(fabs(dist - 5.0f) < 1e-5f);
+
+	// distance is measured in the units of dir
+	CHECK(ray::IntersectTriangle(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, -2.0f), v0, v1, v2, dist));
+	CHECK(fabs(dist - 2.5f) < 1e-5f);
+
+	// both sides are hit
+	CHECK(ray::IntersectTriangle(glm::vec3(0.0f, 0.0f, -3.0f), glm::vec3(0.0f, 0.0f, 1.0f), v0, v1, v2, dist));
+	CHECK(fabs(dist - 3.0f) < 1e-5f);
+
+	CHECK(!ray::IntersectTriangle(glm::vec3(2.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, dist)); // outside
+	CHECK(!ray::IntersectTriangle(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, 1.0f), v0, v1, v2, dist));	 // behind the origin
+	CHECK(!ray::IntersectTriangle(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(1.0f, 0.0f, 0.0f), v0, v1, v2, dist));	 // parallel
+}
+TEST(BVH_Empty)
+{
+	eng::BVH bvh;
+	float dist = 0.0f;
+	CHECK(!bvh.IsBuilt());
+	CHECK(!bvh.Intersect(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), dist));
+
+	bvh.Build(nullptr, sizeof(glm::vec3), 0, nullptr, 0);
+	CHECK(bvh.IsBuilt());
+	CHECK(bvh.GetTriangleCount() == 0);
+	CHECK(!bvh.Intersect(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), dist));
+}
+TEST(BVH_MatchesBruteForce)
+{
+	Random rnd;
+
+	// small triangles scattered in a box, stored with an extra attribute to test the stride
+	struct Vertex {
+		glm::vec3 Position;
+		float Extra;
+	};
+	std::vector<Vertex> vertices;
+	std::vector<glm::vec3> positions;
+	for (int t = 0; t < 2000; t++) {
+		glm::vec3 center = rnd.NextVec3(-10.0f, 10.0f);
+		for (int v = 0; v < 3; v++) {
+			positions.push_back(center + rnd.NextVec3(-0.5f, 0.5f));
+			vertices.push_back(Vertex { positions.back(), 1.0f });
+		}
+	}
+
+	eng::BVH bvh;
+	bvh.Build(vertices.data(), sizeof(Vertex), vertices.size(), nullptr, 0);
+	CHECK(bvh.GetTriangleCount() == 2000);
+
+	int hits = 0;
+	for (int r = 0; r < 2000; r++) {
+		glm::vec3 orig = rnd.NextVec3(-15.0f, 15.0f);
+		glm::vec3 dir = rnd.NextVec3(-1.0f, 1.0f);
+
+		float expected = 0.0f, actual = 0.0f;
+		bool expectedHit = bruteForce(positions, orig, dir, expected);
+		bool actualHit = bvh.Intersect(orig, dir, actual);
+
+		CHECK(expectedHit == actualHit);
+		if (expectedHit && actualHit) {
+			CHECK(fabs(expected - actual) <= 1e-4f * std::max(1.0f, expected));
+			hits++;
+		}
+	}
+
+	// make sure that the rays actually test something
+	CHECK(hits > 100);
+}
+TEST(BVH_Indexed)
+{
+	// 10x10 quad grid in the XY plane, z = 1
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+	for (int y = 0; y <= 10; y++)
+		for (int x = 0; x <= 10; x++)
+			positions.push_back(glm::vec3((float)x, (float)y, 1.0f));
+	for (int y = 0; y < 10; y++)
+		for (int x = 0; x < 10; x++) {
+			unsigned int i0 = y * 11 + x, i1 = i0 + 1, i2 = i0 + 11, i3 = i2 + 1;
+			indices.insert(indices.end(), { i0, i1, i2, i2, i1, i3 });
+		}
+
+	// triangles that reference missing vertices are skipped
+	indices.insert(indices.end(), { 0, 1, 1000 });
+
+	eng::BVH bvh;
+	bvh.Build(positions.data(), sizeof(glm::vec3), positions.size(), indices.data(), indices.size());
+	CHECK(bvh.GetTriangleCount() == 200);
+
+	float dist = 0.0f;
+	CHECK(bvh.Intersect(glm::vec3(3.3f, 7.6f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), dist));
+	CHECK(fabs(dist - 4.0f) < 1e-5f);
+	CHECK(!bvh.Intersect(glm::vec3(11.5f, 5.0f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), dist));
+
+	bvh.Clear();
+	CHECK(!bvh.IsBuilt());
+	CHECK(!bvh.Intersect(glm::vec3(3.3f, 7.6f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), dist));
+}
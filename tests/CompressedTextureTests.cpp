@@ -0,0 +1,383 @@
+#include "Test.h"
+#include <SHADERed/Objects/CompressedTexture.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include <misc/dds.h>
+}
+
+using namespace ed;
+
+namespace {
+	const uint32_t DXT1 = 0x31545844;  // "DXT1"
+	const uint32_t DX10 = 0x30315844;  // "DX10"
+	const uint32_t DXGI_BC1_UNORM = 71;
+
+	// fixtures are written to the temp directory since Load() only takes a path
+	std::string writeFixture(const char* name, const std::vector<char>& data)
+	{
+		std::string path = (std::filesystem::temp_directory_path() / name).string();
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(data.data(), data.size());
+		return path;
+	}
+	template <typename T>
+	void append(std::vector<char>& data, const T& val)
+	{
+		const char* bytes = (const char*)&val;
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	dds_header makeDDSHeader(uint32_t width, uint32_t height, uint32_t mips, uint32_t fourCC)
+	{
+		dds_header header;
+		memset(&header, 0, sizeof(header));
+		header.size = sizeof(dds_header);
+		header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+		header.width = width;
+		header.height = height;
+		header.mipmap_count = mips;
+		header.pixel_format.size = sizeof(dds_pixelformat);
+		header.pixel_format.flags = DDPF_FOURCC;
+		header.pixel_format.four_cc = fourCC;
+		header.caps = DDSCAPS_TEXTURE;
+		return header;
+	}
+	std::vector<char> makeDDS(const dds_header& header, size_t dataSize, const dds_header_dxt10* header10 = nullptr)
+	{
+		std::vector<char> ret = { 'D', 'D', 'S', ' ' };
+		append(ret, header);
+		if (header10)
+			append(ret, *header10);
+		ret.resize(ret.size() + dataSize, 0x55);
+		return ret;
+	}
+
+	std::vector<char> makeKTX(uint32_t internalFormat, uint32_t width, uint32_t height, uint32_t faces, uint32_t imageSize)
+	{
+		static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+		std::vector<char> ret(identifier, identifier + 12);
+
+		uint32_t header[13] = { 0x04030201, 0, 1, 0, internalFormat, 0x1908 /* GL_RGBA */, width, height, 0, 0, faces, 1, 0 };
+		append(ret, header);
+
+		for (uint32_t f = 0; f < faces; f++) {
+			append(ret, imageSize);
+			ret.resize(ret.size() + ((imageSize + 3) & ~3u), 0x55);
+		}
+		return ret;
+	}
+	std::vector<char> makeKTX2(uint32_t vkFormat, uint32_t width, uint32_t height, uint32_t levels, uint32_t supercompression)
+	{
+		static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		std::vector<char> ret(identifier, identifier + 12);
+
+		uint32_t header[9] = { vkFormat, 1, width, height, 0, 0, 1, levels, supercompression };
+		append(ret, header);
+		ret.resize(80, 0); // no DFD, KVD or SGD
+		return ret;
+	}
+
+	// decode a single 4x4 block of the given format
+	template <typename T>
+	std::vector<T> decodeBlock(GLenum format, const std::vector<unsigned char>& block)
+	{
+		CompressedImage img;
+		img.Format = format;
+		img.Width = img.Height = img.Depth = 1;
+		img.Levels.push_back(CompressedImage::Level { 4, 4, 1, 0, block.size() });
+		img.Data = block;
+
+		std::vector<T> ret(16 * 4);
+		CompressedTexture::Decode(img, 0, ret.data());
+		return ret;
+	}
+
+	// writes the BC6H/BC7 fields, starting from the lowest bit
+	class BlockWriter {
+	public:
+		BlockWriter()
+				: Block(16, 0)
+				, m_pos(0)
+		{
+		}
+		void Write(unsigned int value, int count)
+		{
+			for (int i = 0; i < count; i++, m_pos++)
+				Block[m_pos >> 3] |= ((value >> i) & 1) << (m_pos & 7);
+		}
+
+		std::vector<unsigned char> Block;
+
+	private:
+		int m_pos;
+	};
+
+	// BC6H mode 11: one region, two 10 bit endpoints stored as they are
+	std::vector<unsigned char> makeBC6HBlock(int e0, int e1)
+	{
+		BlockWriter writer;
+		writer.Write(0x03, 5);
+		for (int c = 0; c < 3; c++)
+			writer.Write(e0 & 0x3FF, 10);
+		for (int c = 0; c < 3; c++)
+			writer.Write(e1 & 0x3FF, 10);
+		for (int i = 0; i < 16; i++)
+			writer.Write(i == 0 ? 0 : (i == 1 ? 8 : 15), i == 0 ? 3 : 4); // pixel 0: e0, pixel 1: index 8, the rest: e1
+		return writer.Block;
+	}
+}
+
+TEST(CompressedTexture_DDS)
+{
+	// 8x8 DXT1 with the full mip chain: 2x2, 1x1, 1x1, 1x1 blocks
+	std::string path = writeFixture("shadered_test_dxt1.dds", makeDDS(makeDDSHeader(8, 8, 4, DXT1), 32 + 8 + 8 + 8));
+
+	CompressedImage img;
+	std::string error;
+	CHECK(CompressedTexture::Load(path, img, error));
+	CHECK(error.empty());
+	CHECK(img.Format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+	CHECK(img.Width == 8 && img.Height == 8 && img.Depth == 1);
+	CHECK(img.Levels.size() == 4);
+	if (img.Levels.size() == 4) {
+		CHECK(img.Levels[0].Size == 32);
+		CHECK(img.Levels[1].Size == 8 && img.Levels[1].Width == 4);
+		CHECK(img.Levels[3].Offset == 48 && img.Levels[3].Width == 1);
+	}
+	CHECK(img.Data.size() == 56);
+
+	// truncated file
+	path = writeFixture("shadered_test_dxt1_small.dds", makeDDS(makeDDSHeader(8, 8, 4, DXT1), 32));
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+}
+TEST(CompressedTexture_DDSCubemap)
+{
+	dds_header header = makeDDSHeader(4, 4, 1, DXT1);
+	header.caps |= DDSCAPS_COMPLEX;
+	header.caps2 = DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEX | DDSCAPS2_CUBEMAP_NEGATIVEX | DDSCAPS2_CUBEMAP_POSITIVEY | DDSCAPS2_CUBEMAP_NEGATIVEY | DDSCAPS2_CUBEMAP_POSITIVEZ | DDSCAPS2_CUBEMAP_NEGATIVEZ;
+	std::string path = writeFixture("shadered_test_cube.dds", makeDDS(header, 6 * 8));
+
+	// the faces must not be read as one 2D texture
+	CompressedImage img;
+	std::string error;
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+
+	// DX10 header only marks cube maps with the misc flag
+	dds_header_dxt10 header10;
+	memset(&header10, 0, sizeof(header10));
+	header10.dxgi_format = DXGI_BC1_UNORM;
+	header10.resource_dimension = 3; // DDS_DIMENSION_TEXTURE2D
+	header10.misc_flag = 0x4;		 // DDS_RESOURCE_MISC_TEXTURECUBE
+	header10.array_size = 1;
+	path = writeFixture("shadered_test_cube_dx10.dds", makeDDS(makeDDSHeader(4, 4, 1, DX10), 6 * 8, &header10));
+
+	error.clear();
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+
+	// same file without the flag is a regular 2D texture
+	header10.misc_flag = 0;
+	path = writeFixture("shadered_test_2d_dx10.dds", makeDDS(makeDDSHeader(4, 4, 1, DX10), 8, &header10));
+	CHECK(CompressedTexture::Load(path, img, error));
+	CHECK(img.Format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+}
+TEST(CompressedTexture_DDSVolume)
+{
+	dds_header header = makeDDSHeader(4, 4, 1, DXT1);
+	header.flags |= DDSD_DEPTH;
+	header.depth = 4;
+	header.caps2 = DDSCAPS2_VOLUME;
+	std::string path = writeFixture("shadered_test_volume.dds", makeDDS(header, 4 * 8));
+
+	CompressedImage img;
+	std::string error;
+	CHECK(CompressedTexture::Load(path, img, error));
+	CHECK(img.Depth == 4);
+	CHECK(img.Levels.size() == 1 && img.Levels[0].Size == 32);
+}
+TEST(CompressedTexture_DDSUncompressed)
+{
+	dds_header header = makeDDSHeader(4, 4, 1, 0);
+	header.pixel_format.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+	header.pixel_format.rgb_bit_count = 32;
+	std::string path = writeFixture("shadered_test_rgba.dds", makeDDS(header, 4 * 4 * 4));
+
+	// not an error - the regular image loader handles these
+	CompressedImage img;
+	std::string error;
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(error.empty());
+}
+TEST(CompressedTexture_KTX)
+{
+	std::string path = writeFixture("shadered_test_dxt1.ktx", makeKTX(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 4, 4, 1, 8));
+
+	CompressedImage img;
+	std::string error;
+	CHECK(CompressedTexture::Load(path, img, error));
+	CHECK(img.Format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+	CHECK(img.Width == 4 && img.Height == 4 && img.Depth == 1);
+	CHECK(img.Data.size() == 8);
+
+	// cube map
+	path = writeFixture("shadered_test_cube.ktx", makeKTX(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 4, 4, 6, 8));
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+}
+TEST(CompressedTexture_KTX2)
+{
+	// 8x8 BC7 with two levels, stored smallest level first like the spec recommends
+	std::vector<char> data = makeKTX2(145, 8, 8, 2, 0);
+	uint64_t levelIndex[6] = { 144, 64, 64, 128, 16, 16 };
+	append(data, levelIndex);
+	data.resize(128 + 16, 0x11);
+	data.resize(128 + 16 + 64, 0x22);
+	std::string path = writeFixture("shadered_test_bc7.ktx2", data);
+
+	CompressedImage img;
+	std::string error;
+	CHECK(CompressedTexture::Load(path, img, error));
+	CHECK(error.empty());
+	CHECK(img.Format == GL_COMPRESSED_RGBA_BPTC_UNORM);
+	CHECK(img.Width == 8 && img.Height == 8 && img.Depth == 1);
+	CHECK(img.Levels.size() == 2);
+	if (img.Levels.size() == 2) {
+		CHECK(img.Levels[0].Size == 64 && img.Levels[1].Size == 16 && img.Levels[1].Width == 4);
+		CHECK(img.Data[img.Levels[0].Offset] == 0x22);
+		CHECK(img.Data[img.Levels[1].Offset] == 0x11);
+	}
+
+	// level size doesn't match the format
+	levelIndex[4] = 8;
+	memcpy(data.data() + 80, levelIndex, sizeof(levelIndex));
+	path = writeFixture("shadered_test_bc7_bad.ktx2", data);
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+
+	// zstd
+	data = makeKTX2(145, 4, 4, 1, 2);
+	uint64_t singleLevel[3] = { 104, 16, 16 };
+	append(data, singleLevel);
+	data.resize(104 + 16, 0);
+	path = writeFixture("shadered_test_zstd.ktx2", data);
+	error.clear();
+	CHECK(!CompressedTexture::Load(path, img, error));
+	CHECK(!error.empty());
+}
+TEST(CompressedTexture_DecodeBC1)
+{
+	// red & blue endpoints, pixel i uses the index i % 4
+	std::vector<unsigned char> px = decodeBlock<unsigned char>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4 });
+	const unsigned char opaque[4][4] = { { 255, 0, 0, 255 }, { 0, 0, 255, 255 }, { 170, 0, 85, 255 }, { 85, 0, 170, 255 } };
+	for (int i = 0; i < 16; i++)
+		CHECK(memcmp(&px[i * 4], opaque[i % 4], 4) == 0);
+
+	// c0 <= c1 switches to three colors + transparent black
+	px = decodeBlock<unsigned char>(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4 });
+	const unsigned char transparent[4][4] = { { 0, 0, 255, 255 }, { 255, 0, 0, 255 }, { 127, 0, 127, 255 }, { 0, 0, 0, 0 } };
+	for (int i = 0; i < 16; i++)
+		CHECK(memcmp(&px[i * 4], transparent[i % 4], 4) == 0);
+
+	// ... which stays opaque without the alpha
+	px = decodeBlock<unsigned char>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4 });
+	CHECK(px[3 * 4 + 3] == 255);
+}
+TEST(CompressedTexture_DecodeBC2BC3)
+{
+	// BC2: pixel i has alpha i, colors always use the four color mode
+	std::vector<unsigned char> px = decodeBlock<unsigned char>(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, { 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4 });
+	for (int i = 0; i < 16; i++)
+		CHECK(px[i * 4 + 3] == i * 17);
+	CHECK(px[2 * 4 + 0] == 85 && px[2 * 4 + 1] == 0 && px[2 * 4 + 2] == 170);
+
+	// BC3: alpha endpoints 255 & 0 with 6 interpolated values, pixel i uses the index i % 8
+	std::vector<unsigned char> block = { 255, 0 };
+	uint64_t indices = 0;
+	for (int i = 0; i < 16; i++)
+		indices |= (uint64_t)(i % 8) << (i * 3);
+	for (int i = 0; i < 6; i++)
+		block.push_back((indices >> (i * 8)) & 0xFF);
+	block.insert(block.end(), { 0x00, 0xF8, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00 });
+
+	px = decodeBlock<unsigned char>(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, block);
+	const unsigned char alpha[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+	for (int i = 0; i < 16; i++)
+		CHECK(px[i * 4 + 3] == alpha[i % 8]);
+	CHECK(px[0] == 255 && px[1] == 0 && px[2] == 0);
+}
+TEST(CompressedTexture_DecodeBC4BC5)
+{
+	// v0 <= v1: 4 interpolated values, then 0 and 255
+	std::vector<unsigned char> block = { 0, 100 };
+	uint64_t indices = 0;
+	for (int i = 0; i < 16; i++)
+		indices |= (uint64_t)(i % 8) << (i * 3);
+	for (int i = 0; i < 6; i++)
+		block.push_back((indices >> (i * 8)) & 0xFF);
+
+	std::vector<unsigned char> px = decodeBlock<unsigned char>(GL_COMPRESSED_RED_RGTC1, block);
+	const unsigned char red[8] = { 0, 100, 20, 40, 60, 80, 0, 255 };
+	for (int i = 0; i < 16; i++)
+		CHECK(px[i * 4 + 0] == red[i % 8] && px[i * 4 + 1] == 0 && px[i * 4 + 3] == 255);
+
+	// signed BC5: red goes from 1 to -1, green uses -128 which is clamped to -127
+	std::vector<unsigned char> signedBlock = { 0x7F, 0x81, 0x08, 0, 0, 0, 0, 0, 0x80, 0x80, 0, 0, 0, 0, 0, 0 };
+	std::vector<float> fpx = decodeBlock<float>(GL_COMPRESSED_SIGNED_RG_RGTC2, signedBlock);
+	CHECK(fpx[0] == 1.0f);
+	CHECK(fpx[4] == -1.0f); // index 1
+	CHECK(fpx[1] == -1.0f && fpx[5] == -1.0f);
+	CHECK(fpx[2] == 0.0f && fpx[3] == 1.0f);
+}
+TEST(CompressedTexture_DecodeBC7)
+{
+	// mode 6: white -> transparent black with 4 bit indices
+	BlockWriter writer;
+	writer.Write(1 << 6, 7);
+	for (int c = 0; c < 4; c++) {
+		writer.Write(0x7F, 7);
+		writer.Write(0, 7);
+	}
+	writer.Write(1, 1); // p-bits
+	writer.Write(0, 1);
+	for (int i = 0; i < 16; i++)
+		writer.Write(i == 0 ? 0 : (i == 1 ? 8 : 15), i == 0 ? 3 : 4);
+
+	std::vector<unsigned char> px = decodeBlock<unsigned char>(GL_COMPRESSED_RGBA_BPTC_UNORM, writer.Block);
+	for (int c = 0; c < 4; c++) {
+		CHECK(px[0 * 4 + c] == 255);
+		CHECK(px[1 * 4 + c] == 120);
+		CHECK(px[2 * 4 + c] == 0);
+	}
+
+	// reserved mode (no set bit in the first byte)
+	std::vector<unsigned char> reserved(16, 0);
+	px = decodeBlock<unsigned char>(GL_COMPRESSED_RGBA_BPTC_UNORM, reserved);
+	CHECK(px[3] == 0 && px[63] == 0);
+}
+TEST(CompressedTexture_DecodeBC6H)
+{
+	// unsigned: the largest endpoint maps to the largest finite half
+	std::vector<float> px = decodeBlock<float>(GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, makeBC6HBlock(0, 1023));
+	CHECK(px[0] == 0.0f && px[3] == 1.0f);
+	CHECK(px[1 * 4] == 2.9355469f); // 0x41DF
+	CHECK(px[2 * 4] == 65504.0f);	 // 0x7BFF
+
+	px = decodeBlock<float>(GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, makeBC6HBlock(512, 1023));
+	CHECK(px[0] == 1.5146484f); // 512 is unquantized to 32800, half 0x3E0F
+
+	// signed: negative endpoints and denormal halfs
+	px = decodeBlock<float>(GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, makeBC6HBlock(-256, 511));
+	CHECK(px[0] == -1.5302734f); // 0xBE1F
+	CHECK(px[2 * 4] == 65504.0f);
+
+	px = decodeBlock<float>(GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, makeBC6HBlock(-1, 511));
+	CHECK(px[0] == -93.0f / 16777216.0f); // 0x805D
+	CHECK(px[1] == px[0] && px[2] == px[0]);
+}
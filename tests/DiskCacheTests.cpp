@@ -0,0 +1,89 @@
+#include "Test.h"
+#include <SHADERed/Objects/DiskCache.h>
+
+#include <chrono>
+#include <filesystem>
+#include <set>
+
+using namespace ed;
+
+namespace {
+	// empty directory in the temp directory, the cache only gets full paths
+	std::string makeDirectory(const char* name)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+		std::error_code ec;
+		std::filesystem::remove_all(path, ec);
+		return path.string() + "/";
+	}
+	void writeEntry(DiskCache& cache, const std::string& filename, size_t size)
+	{
+		cache.Write(filename, [&](std::ofstream& file) {
+			std::string data(size, 'x');
+			file.write(data.data(), data.size());
+		});
+	}
+	void setAge(const std::string& filename, int seconds)
+	{
+		std::error_code ec;
+		std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now() - std::chrono::seconds(seconds), ec);
+	}
+}
+
+TEST(DiskCache_Write)
+{
+	std::string path = makeDirectory("shadered_test_cache_write");
+	DiskCache cache(path, "test", 1024);
+	CHECK(cache.IsEnabled());
+
+	std::string filename = cache.GetFilename(0xABC, "bin");
+	CHECK(filename == path + "abc.bin");
+
+	writeEntry(cache, filename, 100);
+	CHECK(std::filesystem::file_size(filename) == 100);
+
+	// nothing is left behind
+	int fileCount = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(path))
+		fileCount++;
+	CHECK(fileCount == 1);
+}
+TEST(DiskCache_TempFilename)
+{
+	std::set<std::string> names;
+	for (int i = 0; i < 1000; i++)
+		names.insert(DiskCache::GetTempFilename("entry.bin"));
+	CHECK(names.size() == 1000);
+}
+TEST(DiskCache_Trim)
+{
+	std::string path = makeDirectory("shadered_test_cache_trim");
+	DiskCache cache(path, "test", 1000);
+
+	// 5 x 250 bytes, entry 0 is the oldest
+	for (int i = 0; i < 5; i++) {
+		writeEntry(cache, cache.GetFilename(i, "bin"), 250);
+		setAge(cache.GetFilename(i, "bin"), 100 - i);
+	}
+
+	// using an entry makes it the most recently used one
+	cache.Touch(cache.GetFilename(0, "bin"));
+
+	// a write that is still in progress & one that was interrupted a long time ago
+	std::string newTemp = DiskCache::GetTempFilename(cache.GetFilename(5, "bin"));
+	std::string oldTemp = DiskCache::GetTempFilename(cache.GetFilename(6, "bin"));
+	std::ofstream(newTemp) << "x";
+	std::ofstream(oldTemp) << "x";
+	setAge(oldTemp, DISK_CACHE_TEMP_MAX_AGE * 2);
+
+	// trimmed down to half of the max size
+	cache.Trim();
+	CHECK(std::filesystem::exists(cache.GetFilename(0, "bin")));
+	CHECK(!std::filesystem::exists(cache.GetFilename(1, "bin")));
+	CHECK(!std::filesystem::exists(cache.GetFilename(2, "bin")));
+	CHECK(!std::filesystem::exists(cache.GetFilename(3, "bin")));
+	CHECK(std::filesystem::exists(cache.GetFilename(4, "bin")));
+
+	CHECK(std::filesystem::exists(newTemp));
+	CHECK(!std::filesystem::exists(oldTemp));
+}
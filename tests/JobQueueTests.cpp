@@ -0,0 +1,213 @@
+#include "Test.h"
+#include <SHADERed/Objects/JobQueue.h>
+
+#include <atomic>
+#include <chrono>
+
+using namespace ed;
+
+namespace {
+	struct TestJob {
+		TestJob(int id, void* item = nullptr)
+		{
+			ID = id;
+			Item = item;
+			Status = JobStatus::Queued;
+		}
+
+		int ID;
+		void* Item;
+		JobStatus Status;
+	};
+
+	// blocks the jobs with the given ID until it is opened
+	class Gate {
+	public:
+		Gate(int id)
+				: m_id(id)
+				, m_open(false)
+		{
+		}
+
+		void Pass(TestJob* job)
+		{
+			if (job->ID != m_id)
+				return;
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cv.wait(lock, [&] { return m_open; });
+		}
+		void Open()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_open = true;
+			}
+			m_cv.notify_all();
+		}
+
+	private:
+		int m_id;
+		bool m_open;
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+	};
+
+	void waitFor(std::atomic<int>& counter, int value)
+	{
+		auto start = std::chrono::steady_clock::now();
+		while (counter < value && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	std::vector<int> getIDs(const std::vector<TestJob*>& jobs)
+	{
+		std::vector<int> ret;
+		for (TestJob* job : jobs)
+			ret.push_back(job->ID);
+		return ret;
+	}
+	bool allFinished(const std::vector<TestJob*>& jobs)
+	{
+		for (TestJob* job : jobs)
+			if (job->Status != JobStatus::Finished)
+				return false;
+		return true;
+	}
+	void deleteJobs(const std::vector<TestJob*>& jobs)
+	{
+		for (TestJob* job : jobs)
+			delete job;
+	}
+}
+
+// shader compiler: finished jobs are only returned in the order they were submitted
+TEST(JobQueue_InOrder)
+{
+	Gate gate(1);
+	std::atomic<int> processed(0);
+
+	JobQueue<TestJob> queue("test", 2, 4, true, [&](TestJob* job) {
+		gate.Pass(job);
+		processed++;
+	});
+
+	CHECK(!queue.IsBusy());
+	queue.Submit(new TestJob(1));
+	queue.Submit(new TestJob(2));
+	queue.Submit(new TestJob(3));
+
+	// 2 and 3 are done, but 1 is still running
+	waitFor(processed, 2);
+	CHECK(processed == 2);
+	CHECK(queue.IsBusy());
+	CHECK(queue.GetFinishedJobs().empty());
+
+	gate.Open();
+	queue.Wait();
+	CHECK(!queue.IsBusy());
+
+	std::vector<TestJob*> finished = queue.GetFinishedJobs();
+	CHECK(getIDs(finished) == std::vector<int>({ 1, 2, 3 }));
+	CHECK(allFinished(finished));
+	CHECK(queue.GetFinishedJobs().empty());
+	deleteJobs(finished);
+}
+
+// texture loader: finished jobs are returned as soon as possible
+TEST(JobQueue_OutOfOrder)
+{
+	Gate gate(1);
+	std::atomic<int> processed(0);
+
+	JobQueue<TestJob> queue("test", 2, 8, false, [&](TestJob* job) {
+		gate.Pass(job);
+		processed++;
+	});
+
+	queue.Submit(new TestJob(1));
+	queue.Submit(new TestJob(2));
+	queue.Submit(new TestJob(3));
+
+	waitFor(processed, 2);
+	std::vector<TestJob*> finished = queue.GetFinishedJobs();
+	CHECK(getIDs(finished) == std::vector<int>({ 2, 3 }));
+	CHECK(allFinished(finished));
+	deleteJobs(finished);
+
+	gate.Open();
+	queue.Wait();
+
+	finished = queue.GetFinishedJobs();
+	CHECK(getIDs(finished) == std::vector<int>({ 1 }));
+	deleteJobs(finished);
+}
+
+// shader compiler: recompiling an item drops its older jobs that haven't started yet
+TEST(JobQueue_ReplaceQueued)
+{
+	int itemA = 0, itemB = 0;
+
+	Gate gate(1);
+	std::atomic<int> started(0);
+	std::vector<int> processedIDs; // single worker thread
+
+	JobQueue<TestJob> queue("test", 1, 4, true, [&](TestJob* job) {
+		started++;
+		gate.Pass(job);
+		processedIDs.push_back(job->ID);
+	});
+
+	queue.Submit(new TestJob(1, &itemA), true);
+	waitFor(started, 1);
+
+	queue.Submit(new TestJob(2, &itemB), true);
+	queue.Submit(new TestJob(3, &itemB), true); // replaces 2
+	queue.Submit(new TestJob(4, &itemA), true); // 1 is already running
+	queue.Submit(new TestJob(5, &itemB));		// 3 is kept
+
+	gate.Open();
+	queue.Wait();
+
+	std::vector<TestJob*> finished = queue.GetFinishedJobs();
+	CHECK(getIDs(finished) == std::vector<int>({ 1, 3, 4, 5 }));
+	CHECK(processedIDs == std::vector<int>({ 1, 3, 4, 5 }));
+	CHECK(allFinished(finished));
+	deleteJobs(finished);
+}
+
+// project is closed: queued jobs are dropped, the running one is waited for
+TEST(JobQueue_Clear)
+{
+	Gate gate(1);
+	std::atomic<int> started(0), processed(0);
+
+	JobQueue<TestJob> queue("test", 1, 4, true, [&](TestJob* job) {
+		started++;
+		gate.Pass(job);
+		processed++;
+	});
+
+	queue.Submit(new TestJob(1));
+	queue.Submit(new TestJob(2));
+	queue.Submit(new TestJob(3));
+	waitFor(started, 1);
+
+	std::thread opener([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		gate.Open();
+	});
+	queue.Clear();
+	opener.join();
+
+	CHECK(processed == 1);
+	CHECK(!queue.IsBusy());
+	CHECK(queue.GetFinishedJobs().empty());
+
+	// the queue can still be used
+	queue.Submit(new TestJob(4));
+	queue.Wait();
+
+	std::vector<TestJob*> finished = queue.GetFinishedJobs();
+	CHECK(getIDs(finished) == std::vector<int>({ 4 }));
+	CHECK(processed == 2);
+	deleteJobs(finished);
+}
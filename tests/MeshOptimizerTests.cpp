@@ -0,0 +1,134 @@
+#include "Test.h"
+#include <SHADERed/Engine/MeshOptimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace ed;
+
+namespace {
+	struct Vertex {
+		float Position[3];
+	};
+
+	// size x size quads in the XY plane
+	void makeGrid(int size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+		for (int y = 0; y <= size; y++)
+			for (int x = 0; x <= size; x++)
+				vertices.push_back(Vertex { { (float)x, (float)y, 0.0f } });
+
+		for (int y = 0; y < size; y++)
+			for (int x = 0; x < size; x++) {
+				unsigned int i0 = y * (size + 1) + x, i1 = i0 + 1, i2 = i0 + size + 1, i3 = i2 + 1;
+				indices.insert(indices.end(), { i0, i1, i2, i2, i1, i3 });
+			}
+	}
+
+	// triangles as sorted position triplets - the optimizations can reorder triangles, their vertices and the vertex buffer
+	std::vector<std::array<float, 9>> getTriangles(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		std::vector<std::array<float, 9>> ret;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			std::array<std::array<float, 3>, 3> tri;
+			for (int v = 0; v < 3; v++)
+				for (int c = 0; c < 3; c++)
+					tri[v][c] = vertices[indices[i + v]].Position[c];
+			std::sort(tri.begin(), tri.end());
+
+			std::array<float, 9> flat;
+			for (int v = 0; v < 3; v++)
+				for (int c = 0; c < 3; c++)
+					flat[v * 3 + c] = tri[v][c];
+			ret.push_back(flat);
+		}
+		std::sort(ret.begin(), ret.end());
+		return ret;
+	}
+}
+
+TEST(MeshOptimizer_DeduplicateVertices)
+{
+	// two triangles of a quad, stored without sharing vertices
+	std::vector<Vertex> vertices = {
+		{ { 0, 0, 0 } }, { { 1, 0, 0 } }, { { 0, 1, 0 } },
+		{ { 0, 1, 0 } }, { { 1, 0, 0 } }, { { 1, 1, 0 } }
+	};
+	std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5 };
+	auto before = getTriangles(vertices, indices);
+
+	size_t count = eng::MeshOptimizer::DeduplicateVertices(vertices.data(), vertices.size(), sizeof(Vertex), indices.data(), indices.size());
+	vertices.resize(count);
+
+	CHECK(count == 4);
+	for (unsigned int index : indices)
+		CHECK(index < count);
+	CHECK(getTriangles(vertices, indices) == before);
+}
+TEST(MeshOptimizer_VertexCache)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	makeGrid(32, vertices, indices);
+
+	// shuffle the triangles so that there's something to optimize
+	std::vector<unsigned int> shuffled;
+	size_t triCount = indices.size() / 3;
+	for (size_t i = 0; i < triCount; i++) {
+		size_t t = (i * 7919) % triCount;
+		shuffled.insert(shuffled.end(), indices.begin() + t * 3, indices.begin() + t * 3 + 3);
+	}
+	auto before = getTriangles(vertices, shuffled);
+	float acmrBefore = eng::MeshOptimizer::AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertices.size()).ACMR;
+
+	eng::MeshOptimizer::OptimizeVertexCache(shuffled.data(), shuffled.size(), vertices.size());
+	float acmrAfter = eng::MeshOptimizer::AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertices.size()).ACMR;
+
+	CHECK(getTriangles(vertices, shuffled) == before);
+	CHECK(acmrAfter < acmrBefore);
+	CHECK(acmrAfter < 1.0f); // a regular grid gets close to 0.5
+}
+TEST(MeshOptimizer_VertexFetch)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	makeGrid(4, vertices, indices);
+	vertices.push_back(Vertex { { 100.0f, 100.0f, 100.0f } }); // unused vertex
+	std::reverse(indices.begin(), indices.end());
+	auto before = getTriangles(vertices, indices);
+
+	size_t count = eng::MeshOptimizer::OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(Vertex), indices.data(), indices.size());
+	vertices.resize(count);
+
+	CHECK(count == 25);
+	CHECK(getTriangles(vertices, indices) == before);
+
+	// vertices are stored in the order of their first use
+	unsigned int next = 0;
+	for (unsigned int index : indices) {
+		CHECK(index <= next);
+		if (index == next)
+			next++;
+	}
+}
+TEST(MeshOptimizer_Simplify)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	makeGrid(16, vertices, indices);
+
+	// a flat grid can lose its interior vertices without any error
+	std::vector<unsigned int> simplified(indices.size());
+	float error = 1.0f;
+	size_t count = eng::MeshOptimizer::Simplify(simplified.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex), 0, 0.01f, &error);
+
+	CHECK(count > 0);
+	CHECK(count < indices.size() / 4);
+	CHECK(count % 3 == 0);
+	CHECK(error <= 0.01f);
+	for (size_t i = 0; i < count; i++)
+		CHECK(simplified[i] < vertices.size());
+}
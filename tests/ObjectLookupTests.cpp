@@ -0,0 +1,114 @@
+#include "Test.h"
+#include <SHADERed/Objects/ObjectLookup.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace ed;
+
+namespace {
+	// the lookup only stores the pointers - any distinct address works as an item
+	std::vector<char> itemStorage(20000);
+	ObjectManagerItem* getItem(int index) { return (ObjectManagerItem*)&itemStorage[index]; }
+
+	// average time of a Get*() call with objectCount items, in nanoseconds
+	double timeLookups(int objectCount)
+	{
+		ObjectLookup lookup;
+		std::vector<std::string> names;
+		for (int i = 0; i < objectCount; i++) {
+			names.push_back("Texture" + std::to_string(i));
+			lookup.Add(getItem(i), names.back(), i + 1, 0);
+		}
+
+		const int lookupCount = 200000;
+		int found = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < lookupCount; i++) {
+			int index = (i * 7919) % objectCount;
+			found += lookup.GetByName(names[index]) == getItem(index);
+			found += lookup.GetByTexture(index + 1) == getItem(index);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		CHECK(found == lookupCount * 2);
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / (lookupCount * 2);
+	}
+}
+
+TEST(ObjectLookup_AddRemove)
+{
+	ObjectLookup lookup;
+	lookup.Add(getItem(0), "Texture", 5, 0);
+	lookup.Add(getItem(1), "Buffer", 0, 7);
+	lookup.Add(getItem(2), "Cubemap", 5, 0); // shares a cached texture with the first item
+
+	CHECK(lookup.GetByName("Texture") == getItem(0));
+	CHECK(lookup.GetByName("Buffer") == getItem(1));
+	CHECK(lookup.GetByName("Missing") == nullptr);
+	CHECK(lookup.GetByTexture(5) == getItem(0));
+	CHECK(lookup.GetByTexture(0) == nullptr);
+	CHECK(lookup.GetByBuffer(7) == getItem(1));
+
+	// removing the second owner of a texture keeps the first one
+	lookup.Remove(getItem(2), "Cubemap", 5, 0);
+	CHECK(lookup.GetByName("Cubemap") == nullptr);
+	CHECK(lookup.GetByTexture(5) == getItem(0));
+
+	lookup.Remove(getItem(1), "Buffer", 0, 7);
+	CHECK(lookup.GetByBuffer(7) == nullptr);
+
+	lookup.Clear();
+	CHECK(lookup.GetByName("Texture") == nullptr);
+}
+TEST(ObjectLookup_RenameAndChangeTexture)
+{
+	ObjectLookup lookup;
+	lookup.Add(getItem(0), "old.png", 3, 0);
+
+	lookup.Rename(getItem(0), "old.png", "new.png");
+	CHECK(lookup.GetByName("old.png") == nullptr);
+	CHECK(lookup.GetByName("new.png") == getItem(0));
+
+	// flipped / prefiltered textures replace the item's texture ID
+	lookup.ChangeTexture(getItem(0), 3, 4);
+	CHECK(lookup.GetByTexture(3) == nullptr);
+	CHECK(lookup.GetByTexture(4) == getItem(0));
+
+	lookup.Remove(getItem(0), "new.png", 4, 0);
+	CHECK(lookup.GetByName("new.png") == nullptr);
+	CHECK(lookup.GetByTexture(4) == nullptr);
+}
+TEST(ObjectLookup_ManyObjects)
+{
+	ObjectLookup lookup;
+	std::vector<std::string> names;
+	for (int i = 0; i < 10000; i++) {
+		names.push_back("Texture" + std::to_string(i));
+		lookup.Add(getItem(i), names.back(), i + 1, 0);
+	}
+
+	// remove every other item - the rest has to stay reachable through both tables
+	for (int i = 0; i < 10000; i += 2)
+		lookup.Remove(getItem(i), names[i], i + 1, 0);
+
+	int found = 0, removed = 0;
+	for (int i = 0; i < 10000; i++) {
+		if (i % 2 == 0)
+			removed += lookup.GetByName(names[i]) == nullptr && lookup.GetByTexture(i + 1) == nullptr;
+		else
+			found += lookup.GetByName(names[i]) == getItem(i) && lookup.GetByTexture(i + 1) == getItem(i);
+	}
+	CHECK(found == 5000);
+	CHECK(removed == 5000);
+}
+
+// only runs when asked for: SHADERedTests Benchmark
+TEST(Benchmark_ObjectLookup)
+{
+	double small = timeLookups(100);
+	double large = timeLookups(10000);
+	printf("ObjectLookup: %.1f ns per lookup with 100 objects, %.1f ns with 10k objects\n", small, large);
+}
@@ -0,0 +1,30 @@
+#include "Test.h"
+#include <SHADERed/Objects/ShaderCache.h>
+
+using namespace ed;
+
+namespace {
+	uint64_t getKey(const std::string& source, const std::string& path, const std::vector<std::string>& includeDirs = { "/project/include" })
+	{
+		return ShaderCache::GetSPIRVKey(source, "#version 450\n", "main", 1, 0, path, includeDirs);
+	}
+}
+
+TEST(ShaderCache_Key)
+{
+	const std::string source = "void main() { gl_FragColor = vec4(1.0); }";
+
+	CHECK(getKey(source, "/project/a.glsl") == getKey(source, "/project/a.glsl"));
+
+	// the path ends up in the SPIR-V debug info and decides where relative includes come from
+	CHECK(getKey(source, "/project/a.glsl") != getKey(source, "/project/b.glsl"));
+	CHECK(getKey(source, "/project/a.glsl") != getKey(source, "/other/a.glsl"));
+
+	CHECK(getKey(source, "/project/a.glsl") != getKey(source + " ", "/project/a.glsl"));
+	CHECK(getKey(source, "/project/a.glsl") != getKey(source, "/project/a.glsl", {}));
+	CHECK(getKey(source, "/project/a.glsl") != getKey(source, "/project/a.glsl", { "/project/include", "/project/lib" }));
+
+	// every part of the input has a length prefix
+	CHECK(ShaderCache::GetSPIRVKey("ab", "c", "main", 1, 0, "", {}) != ShaderCache::GetSPIRVKey("a", "bc", "main", 1, 0, "", {}));
+	CHECK(getKey(source, "/project/a.glsl") != ShaderCache::GetSPIRVKey(source, "#version 450\n", "main", 0, 0, "/project/a.glsl", { "/project/include" }));
+}
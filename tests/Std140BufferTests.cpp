@@ -0,0 +1,54 @@
+#include "Test.h"
+#include <SHADERed/Objects/Std140Buffer.h>
+
+using namespace ed;
+
+TEST(Std140Buffer_Offsets)
+{
+	Std140Buffer buffer;
+	int a = buffer.Add(ShaderVariable::ValueType::Float1);
+	int b = buffer.Add(ShaderVariable::ValueType::Float3);	 // vec3 is aligned to 16 bytes
+	int c = buffer.Add(ShaderVariable::ValueType::Float1);	 // fits into the vec3's padding
+	int d = buffer.Add(ShaderVariable::ValueType::Float2);	 // aligned to 8 bytes
+	int e = buffer.Add(ShaderVariable::ValueType::Float3x3); // array of 3 vec4 columns
+	int f = buffer.Add(ShaderVariable::ValueType::Integer1);
+
+	CHECK(buffer.GetOffset(a) == 0);
+	CHECK(buffer.GetOffset(b) == 16);
+	CHECK(buffer.GetOffset(c) == 28);
+	CHECK(buffer.GetOffset(d) == 32);
+	CHECK(buffer.GetOffset(e) == 48);
+	CHECK(buffer.GetOffset(f) == 96);
+
+	// block size is rounded up to vec4
+	CHECK(buffer.GetSize() == 112);
+}
+TEST(Std140Buffer_MatrixColumns)
+{
+	Std140Buffer buffer;
+	int mat = buffer.Add(ShaderVariable::ValueType::Float3x3);
+
+	float value[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	CHECK(buffer.Update(mat, (const char*)value));
+
+	// every column starts at a 16 byte boundary
+	const float* data = (const float*)buffer.GetData();
+	for (int c = 0; c < 3; c++)
+		for (int r = 0; r < 3; r++)
+			CHECK(data[c * 4 + r] == value[c * 3 + r]);
+}
+TEST(Std140Buffer_ChangeTracking)
+{
+	Std140Buffer buffer;
+	int vec = buffer.Add(ShaderVariable::ValueType::Float4);
+
+	float value[4] = { 1, 2, 3, 4 };
+	CHECK(buffer.Update(vec, (const char*)value));	// first upload
+	CHECK(!buffer.Update(vec, (const char*)value)); // same value
+
+	value[3] = 5;
+	CHECK(buffer.Update(vec, (const char*)value));
+
+	buffer.Invalidate();
+	CHECK(buffer.Update(vec, (const char*)value));
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdio.h>
+#include <vector>
+
+namespace ed {
+	namespace test {
+		// minimal test runner - tests only cover the code that doesn't need a window or an OpenGL context
+		typedef void (*TestFunction)();
+
+		struct TestCase {
+			const char* Name;
+			TestFunction Function;
+		};
+
+		inline std::vector<TestCase>& GetTests()
+		{
+			static std::vector<TestCase> ret;
+			return ret;
+		}
+		inline int& GetFailedChecks()
+		{
+			static int ret = 0;
+			return ret;
+		}
+
+		class TestRegistrar {
+		public:
+			TestRegistrar(const char* name, TestFunction func) { GetTests().push_back(TestCase { name, func }); }
+		};
+	}
+}
+
+#define TEST(name)                                                           \
+	static void test_##name();                                               \
+	static ed::test::TestRegistrar testRegistrar_##name(#name, test_##name); \
+	static void test_##name()
+
+#define CHECK(cond)                                                                \
+	do {                                                                           \
+		if (!(cond)) {                                                             \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+			ed::test::GetFailedChecks()++;                                         \
+		}                                                                          \
+	} while (0)
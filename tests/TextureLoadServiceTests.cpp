@@ -0,0 +1,103 @@
+#include "Test.h"
+#include <SHADERed/Objects/TextureLoadService.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+using namespace ed;
+
+namespace {
+	// 1x2 binary .ppm - red pixel on the top, blue one on the bottom
+	std::string writeImage(const char* name)
+	{
+		std::string path = (std::filesystem::temp_directory_path() / name).string();
+
+		std::ofstream file(path, std::ios::binary);
+		file << "P6\n1 2\n255\n";
+		const unsigned char pixels[] = { 255, 0, 0, 0, 0, 255 };
+		file.write((const char*)pixels, sizeof(pixels));
+
+		return path;
+	}
+	TextureLoadJob* makeJob(uint64_t id, const std::vector<std::string>& paths, bool flip)
+	{
+		TextureLoadJob* job = new TextureLoadJob();
+		job->ID = id;
+		job->Paths = paths;
+		job->Flip = flip;
+		return job;
+	}
+	bool isRed(const unsigned char* px) { return px[0] == 255 && px[1] == 0 && px[2] == 0 && px[3] == 255; }
+	bool isBlue(const unsigned char* px) { return px[0] == 0 && px[1] == 0 && px[2] == 255 && px[3] == 255; }
+}
+
+TEST(TextureLoadService_Load)
+{
+	std::string image = writeImage("shadered_test_texture.ppm");
+	std::string missing = (std::filesystem::temp_directory_path() / "shadered_test_missing.png").string();
+	std::error_code ec;
+	std::filesystem::remove(missing, ec);
+
+	TextureLoadService loader(2);
+	loader.Submit(makeJob(1, { image }, false));
+	loader.Submit(makeJob(2, { image }, true));
+	loader.Submit(makeJob(3, { missing }, false));
+	loader.Submit(makeJob(4, { image, missing }, false)); // a single missing face fails the whole cube map
+
+	loader.Wait();
+	CHECK(!loader.IsBusy());
+
+	std::vector<TextureLoadJob*> finished = loader.GetFinishedJobs();
+	CHECK(finished.size() == 4);
+	CHECK(loader.GetFinishedJobs().empty());
+
+	std::map<uint64_t, TextureLoadJob*> jobs;
+	for (TextureLoadJob* job : finished) {
+		CHECK(job->Status == JobStatus::Finished);
+		jobs[job->ID] = job;
+	}
+	CHECK(jobs.size() == 4);
+
+	TextureLoadJob* plain = jobs[1];
+	CHECK(plain->Succeeded && plain->Error.empty());
+	CHECK(plain->Images.size() == 1);
+	CHECK(plain->Images[0].Width == 1 && plain->Images[0].Height == 2 && !plain->Images[0].IsFloat);
+	CHECK(isRed(plain->Images[0].Data) && isBlue(plain->Images[0].Data + 4));
+
+	TextureLoadJob* flipped = jobs[2];
+	CHECK(flipped->Succeeded);
+	CHECK(isBlue(flipped->Images[0].Data) && isRed(flipped->Images[0].Data + 4));
+
+	TextureLoadJob* failed = jobs[3];
+	CHECK(!failed->Succeeded);
+	CHECK(failed->Error.find(missing) != std::string::npos);
+
+	TextureLoadJob* cubeMap = jobs[4];
+	CHECK(!cubeMap->Succeeded);
+	CHECK(cubeMap->Error.find(missing) != std::string::npos);
+
+	for (TextureLoadJob* job : finished)
+		delete job;
+}
+TEST(TextureLoadService_Clear)
+{
+	std::string image = writeImage("shadered_test_texture_clear.ppm");
+
+	TextureLoadService loader(1);
+	for (int i = 0; i < 16; i++)
+		loader.Submit(makeJob(i, { image }, false));
+
+	// the queued jobs are dropped, the running one is waited for
+	loader.Clear();
+	CHECK(!loader.IsBusy());
+	CHECK(loader.GetFinishedJobs().empty());
+
+	loader.Submit(makeJob(100, { image }, false));
+	loader.Wait();
+
+	std::vector<TextureLoadJob*> finished = loader.GetFinishedJobs();
+	CHECK(finished.size() == 1);
+	CHECK(finished[0]->ID == 100 && finished[0]->Succeeded);
+	delete finished[0];
+}
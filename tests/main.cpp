@@ -0,0 +1,35 @@
+#include "Test.h"
+
+#include <string.h>
+
+int main(int argc, char* argv[])
+{
+	// optional argument: only run the tests whose name starts with it
+	const char* filter = argc > 1 ? argv[1] : "";
+
+	// timing tests aren't pass/fail, they only run when the filter names them
+	const char* benchPrefix = "Benchmark";
+	bool runBenchmarks = strncmp(filter, benchPrefix, strlen(benchPrefix)) == 0;
+
+	int testCount = 0, failedTests = 0;
+	for (const ed::test::TestCase& test : ed::test::GetTests()) {
+		if (strncmp(test.Name, filter, strlen(filter)) != 0)
+			continue;
+		if (!runBenchmarks && strncmp(test.Name, benchPrefix, strlen(benchPrefix)) == 0)
+			continue;
+
+		int failedBefore = ed::test::GetFailedChecks();
+		test.Function();
+
+		bool passed = ed::test::GetFailedChecks() == failedBefore;
+		printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.Name);
+
+		testCount++;
+		if (!passed)
+			failedTests++;
+	}
+
+	printf("%d/%d tests passed\n", testCount - failedTests, testCount);
+
+	return failedTests == 0 ? 0 : 1;
+}